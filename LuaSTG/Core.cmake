@@ -40,12 +40,22 @@ set(Core_SRC
     Core/Graphics/Renderer_D3D11.hpp
     Core/Graphics/Renderer_D3D11.cpp
     Core/Graphics/Renderer_Shader_D3D11.cpp
+    Core/Graphics/Renderer_Null.hpp
+    Core/Graphics/Renderer_Null.cpp
+    Core/Graphics/Device_Null.hpp
+    Core/Graphics/Device_Null.cpp
+    Core/Graphics/SwapChain_Null.hpp
+    Core/Graphics/SwapChain_Null.cpp
+    Core/Graphics/Window_Null.hpp
+    Core/Graphics/Window_Null.cpp
     Core/Graphics/Model_D3D11.hpp
     Core/Graphics/Model_D3D11.cpp
     Core/Graphics/Model_Shader_D3D11.cpp
     Core/Graphics/Sprite.hpp
     Core/Graphics/Sprite_D3D11.hpp
     Core/Graphics/Sprite_D3D11.cpp
+    Core/Graphics/SpriteInstanceBatch.hpp
+    Core/Graphics/SpriteInstanceBatch.cpp
     Core/Graphics/Font.hpp
     Core/Graphics/Font_D3D11.hpp
     Core/Graphics/Font_D3D11.cpp
@@ -71,6 +81,8 @@ set(Core_SRC
     Core/Audio/Device_MM.cpp
     Core/Audio/Device_XAUDIO2.cpp
     Core/Audio/Device_XAUDIO2.hpp
+    Core/Audio/Device_Null.hpp
+    Core/Audio/Device_Null.cpp
 )
 source_group(TREE ${CMAKE_CURRENT_LIST_DIR} FILES ${Core_SRC})
 target_precompile_headers(Core PRIVATE
@@ -89,6 +101,7 @@ target_link_libraries(Core PUBLIC
     utility
     utf8
     simdutf::simdutf
+    xxhash
     PlatformAPI
     beautiful_win32_api
     GeneratedShaderHeaders
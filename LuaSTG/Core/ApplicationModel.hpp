@@ -62,6 +62,8 @@ namespace Core
         // [工作线程]
         virtual FrameRenderStatistics getFrameRenderStatistics() = 0;
 
+        // [主线程|工作线程] 无界面模式下窗口、图形设备、交换链、渲染器和音频设备都是空实现
+        virtual bool isHeadless() = 0;
         // [主线程|工作线程]
         virtual void requestExit() = 0;
         // [主线程]
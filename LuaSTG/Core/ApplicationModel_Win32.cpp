@@ -419,11 +419,14 @@ namespace Core
 		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
 
 		// 初次收集诊断信息
-		TracyD3D11Collect(m_device->GetTracyContext());
+		if (!m_headless)
+		{
+			TracyD3D11Collect(m_device->GetTracyContext());
+		}
 		FrameMark;
 		{
 			tracy_zone_scoped_with_name("OnInitWait");
-			m_swapchain->waitFrameLatency();
+			if (!m_headless) m_swapchain->waitFrameLatency();
 			m_p_frame_rate_controller->update();
 		}
 		
@@ -453,6 +456,11 @@ namespace Core
 			runFrame();
 		}
 
+		if (m_headless)
+		{
+			reportHeadlessStatistics();
+		}
+
 		return true;
 	}
 	bool ApplicationModel_Win32::runDoubleThread()
@@ -579,8 +587,6 @@ namespace Core
 		size_t const i = (m_framestate_index + 1) % 2;
 		FrameStatistics& d = m_framestate[i];
 		ScopeTimer gt(d.total_time);
-		size_t const next_frame_query_index = (m_frame_query_index + 1) % m_frame_query_list.size();
-		FrameQuery& frame_query = m_frame_query_list[next_frame_query_index];
 		
 		bool update_result = false;
 
@@ -593,7 +599,27 @@ namespace Core
 
 		bool render_result = false;
 
-		
+		// 无界面模式：渲染回调仍然执行（绘制调用进入空渲染器），但不触碰交换链，也不等待
+		if (m_headless)
+		{
+			if (update_result)
+			{
+				tracy_zone_scoped_with_name("OnRender");
+				ScopeTimer t(d.render_time);
+				m_listener->onRender();
+			}
+			{
+				tracy_zone_scoped_with_name("OnWait");
+				ScopeTimer t(d.wait_time);
+				m_p_frame_rate_controller->update();
+			}
+			m_framestate_index = i;
+			FrameMark;
+			return;
+		}
+
+		size_t const next_frame_query_index = (m_frame_query_index + 1) % m_frame_query_list.size();
+		FrameQuery& frame_query = m_frame_query_list[next_frame_query_index];
 
 		// 渲染
 		if (update_result)
@@ -637,12 +663,33 @@ namespace Core
 	}
 	FrameRenderStatistics ApplicationModel_Win32::getFrameRenderStatistics()
 	{
+		if (m_frame_query_list.empty())
+		{
+			return {}; // 无界面模式没有 GPU 计时
+		}
 		FrameQuery& frame_query = m_frame_query_list[m_frame_query_index];
 		FrameRenderStatistics statistics{};
 		statistics.render_time = frame_query.getTime();
 		return statistics;
 	}
 
+	void ApplicationModel_Win32::reportHeadlessStatistics()
+	{
+		auto& fps = m_fixed_step_frame_rate_controller;
+		auto const& r = m_null_renderer->getStatistics();
+		auto const& a = m_null_audiosys->getStatistics();
+		spdlog::info("[core] 无界面模式统计：\n"
+			"    帧数：{}，模拟时间：{:.3f}s，实际耗时：{:.3f}s，平均帧率：{:.2f}\n"
+			"    绘制调用：{}，顶点：{}，索引：{}，批次：{}，后处理：{}，模型：{}，清屏：{}，状态切换：{}\n"
+			"    批次提交：{}，GPU 绘制命令：{}，实例化绘制的图片精灵：{}\n"
+			"    音频播放器：{}，音频数据：{}，开始播放：{}，停止：{}，重置：{}"
+			, fps.getTotalFrame(), fps.getTotalTime(), fps.getRealTime(), fps.getAvgFPS()
+			, r.draw_call, r.vertex, r.index, r.batch, r.post_effect, r.model, r.clear, r.state_change
+			, r.flush, r.gpu_draw, r.instance
+			, a.player, a.buffer, a.start, a.stop, a.reset
+		);
+	}
+
 	void ApplicationModel_Win32::requestExit()
 	{
 		SetEvent(win32_event_exit.Get());
@@ -660,7 +707,13 @@ namespace Core
 		spdlog::info("[core] System {}", Platform::WindowsVersion::GetName());
 		spdlog::info("[core] Kernel {}", Platform::WindowsVersion::GetKernelVersionString());
 		spdlog::info("[core] CPU {} {}", InstructionSet::Vendor(), InstructionSet::Brand());
-		if (m_steady_frame_rate_controller.available()) {
+		auto const& config = core::ConfigurationLoader::getInstance();
+		m_headless = config.getApplication().isHeadless() || config.getBenchmark().isEnable(); // 基准测试总是以无界面模式运行
+		if (m_headless) {
+			spdlog::info("[core] Headless mode, enable FixedStepFrameRateController");
+			m_p_frame_rate_controller = &m_fixed_step_frame_rate_controller;
+		}
+		else if (m_steady_frame_rate_controller.available()) {
 			spdlog::info("[core] High Resolution Waitable Timer available, enable SteadyFrameRateController");
 			m_p_frame_rate_controller = &m_steady_frame_rate_controller;
 		}
@@ -668,6 +721,20 @@ namespace Core
 			m_p_frame_rate_controller = &m_frame_rate_controller;
 		}
 		get_system_memory_status();
+		if (m_headless) {
+			// 不创建系统窗口和 Direct3D 设备，可以在没有显卡和桌面会话的环境下运行
+			if (!Graphics::Window_Null::create(~m_null_window))
+				throw std::runtime_error("Graphics::Window_Null::create");
+			if (!Graphics::Device_Null::create(~m_null_device))
+				throw std::runtime_error("Graphics::Device_Null::create");
+			if (!Graphics::SwapChain_Null::create(*m_null_window, ~m_null_swapchain))
+				throw std::runtime_error("Graphics::SwapChain_Null::create");
+			if (!Graphics::Renderer_Null::create(~m_null_renderer))
+				throw std::runtime_error("Graphics::Renderer_Null::create");
+			if (!Audio::Device_Null::create(~m_null_audiosys))
+				throw std::runtime_error("Audio::Device_Null::create");
+			return;
+		}
 		if (!Graphics::Window_Win32::create(~m_window))
 			throw std::runtime_error("Graphics::Window_Win32::create");
 		m_window->implSetApplicationModel(this);
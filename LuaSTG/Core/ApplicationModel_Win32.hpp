@@ -5,7 +5,12 @@
 #include "Core/Graphics/Device_D3D11.hpp"
 #include "Core/Graphics/SwapChain_D3D11.hpp"
 #include "Core/Graphics/Renderer_D3D11.hpp"
+#include "Core/Graphics/Window_Null.hpp"
+#include "Core/Graphics/Device_Null.hpp"
+#include "Core/Graphics/SwapChain_Null.hpp"
+#include "Core/Graphics/Renderer_Null.hpp"
 #include "Core/Audio/Device_XAUDIO2.hpp"
+#include "Core/Audio/Device_Null.hpp"
 
 namespace Core
 {
@@ -206,6 +211,52 @@ namespace Core
 		~SteadyFrameRateController() = default;
 	};
 
+	// 无界面模式使用的帧率控制器，不等待，每帧都按固定的时间步长推进
+	class FixedStepFrameRateController : public IFrameRateController
+	{
+	private:
+		LARGE_INTEGER m_freq{};
+		LARGE_INTEGER m_last{};
+		uint32_t m_target_frame_rate{ 60 };
+		uint64_t m_total_frame{};
+		double m_total_time{}; // 按固定步长累计的模拟时间
+		double m_real_time{}; // 实际经过的时间
+		double m_last_fps{};
+		double m_last_min_fps{};
+		double m_last_max_fps{};
+	public:
+		double update()
+		{
+			LARGE_INTEGER v_curr{};
+			QueryPerformanceCounter(&v_curr);
+			double const delta_s = std::max(double(v_curr.QuadPart - m_last.QuadPart) / double(m_freq.QuadPart), 1e-9);
+			m_last = v_curr;
+			m_last_fps = 1.0 / delta_s;
+			m_last_min_fps = m_total_frame > 0 ? std::min(m_last_min_fps, m_last_fps) : m_last_fps;
+			m_last_max_fps = m_total_frame > 0 ? std::max(m_last_max_fps, m_last_fps) : m_last_fps;
+			m_total_frame += 1;
+			m_real_time += delta_s;
+			double const step_s = 1.0 / double(m_target_frame_rate);
+			m_total_time += step_s;
+			return step_s;
+		}
+	public:
+		uint32_t getTargetFPS() { return m_target_frame_rate; }
+		void setTargetFPS(uint32_t target_frame_rate) { m_target_frame_rate = std::max<uint32_t>(1, target_frame_rate); }
+		double getFPS() { return m_last_fps; }
+		uint64_t getTotalFrame() { return m_total_frame; }
+		double getTotalTime() { return m_total_time; }
+		double getAvgFPS() { return m_real_time > 0.0 ? double(m_total_frame) / m_real_time : 0.0; }
+		double getMinFPS() { return m_last_min_fps; }
+		double getMaxFPS() { return m_last_max_fps; }
+		double getRealTime() { return m_real_time; }
+	public:
+		FixedStepFrameRateController()
+		{
+			QueryPerformanceFrequency(&m_freq);
+			QueryPerformanceCounter(&m_last);
+		}
+	};
 	class FrameQuery : public Graphics::IDeviceEventListener
 	{
 	private:
@@ -375,6 +426,17 @@ namespace Core
 		IFrameRateController* m_p_frame_rate_controller{};
 		FrameRateController m_frame_rate_controller;
 		SteadyFrameRateController m_steady_frame_rate_controller;
+
+		// 无界面模式：不创建窗口、图形设备和交换链，全部使用空实现，绘制调用和音频调用只做统计
+
+		bool m_headless{};
+		ScopeObject<Graphics::Window_Null> m_null_window;
+		ScopeObject<Graphics::Device_Null> m_null_device;
+		ScopeObject<Graphics::SwapChain_Null> m_null_swapchain;
+		ScopeObject<Graphics::Renderer_Null> m_null_renderer;
+		ScopeObject<Audio::Device_Null> m_null_audiosys;
+		FixedStepFrameRateController m_fixed_step_frame_rate_controller;
+		void reportHeadlessStatistics();
 		IApplicationEventListener* m_listener{ nullptr };
 		size_t m_framestate_index{ 0 };
 		FrameStatistics m_framestate[2]{};
@@ -395,16 +457,17 @@ namespace Core
 	public:
 		// 多个线程共享
 
-		Graphics::IWindow* getWindow() { return *m_window; }
+		Graphics::IWindow* getWindow() { return m_headless ? static_cast<Graphics::IWindow*>(*m_null_window) : *m_window; }
+		bool isHeadless() { return m_headless; }
 		void requestExit();
 
 		// 仅限工作线程
 
 		IFrameRateController* getFrameRateController() { return m_p_frame_rate_controller; };
-		Graphics::IDevice* getDevice() { return *m_device; }
-		Graphics::ISwapChain* getSwapChain() { return *m_swapchain; }
-		Graphics::IRenderer* getRenderer() { return *m_renderer; }
-		Audio::IAudioDevice* getAudioDevice() { return m_audiosys.get(); }
+		Graphics::IDevice* getDevice() { return m_headless ? static_cast<Graphics::IDevice*>(*m_null_device) : *m_device; }
+		Graphics::ISwapChain* getSwapChain() { return m_headless ? static_cast<Graphics::ISwapChain*>(*m_null_swapchain) : *m_swapchain; }
+		Graphics::IRenderer* getRenderer() { return m_headless ? static_cast<Graphics::IRenderer*>(*m_null_renderer) : *m_renderer; }
+		Audio::IAudioDevice* getAudioDevice() { return m_headless ? static_cast<Audio::IAudioDevice*>(*m_null_audiosys) : m_audiosys.get(); }
 		FrameStatistics getFrameStatistics();
 		FrameRenderStatistics getFrameRenderStatistics();
 
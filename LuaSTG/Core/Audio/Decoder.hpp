@@ -19,5 +19,7 @@ namespace Core::Audio
 		virtual bool read(uint32_t pcm_frame, void* buffer, uint32_t* read_pcm_frame) = 0; // s16
 
 		static bool create(StringView path, IDecoder** pp_decoder);
+		// 从已经读取到内存的文件创建解码器，按文件头选择格式，接管 data
+		static bool create(std::vector<uint8_t>&& data, IDecoder** pp_decoder);
 	};
 }
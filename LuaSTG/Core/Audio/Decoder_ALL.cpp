@@ -42,6 +42,48 @@ namespace Core::Audio
 			spdlog::error("[core] FLAC: {}", e.what());
 		}
 
+		*pp_decoder = nullptr;
+		return false;
+	}
+	bool IDecoder::create(std::vector<uint8_t>&& data, IDecoder** pp_decoder)
+	{
+		// 解码器会接管数据，失败后没法再换一个解码器尝试，所以先按文件头确定格式
+		auto const is_magic = [&data](size_t offset, std::string_view magic) -> bool
+		{
+			return data.size() >= offset + magic.size() && std::memcmp(data.data() + offset, magic.data(), magic.size()) == 0;
+		};
+
+		ScopeObject<IDecoder> p_decoder;
+
+		try
+		{
+			if (is_magic(0, "RIFF"))
+			{
+				p_decoder = new Decoder_WAV(std::move(data));
+			}
+			// OGG 容器的第一页只有一个段时，编码格式的标识头从第 28 字节开始
+			else if (is_magic(0, "OggS") && is_magic(28, "\x01vorbis"))
+			{
+				p_decoder = new Decoder_VorbisOGG(std::move(data));
+			}
+			else if (is_magic(0, "fLaC") || (is_magic(0, "OggS") && is_magic(28, "\x7f" "FLAC")))
+			{
+				p_decoder = new Decoder_FLAC(std::move(data));
+			}
+			else
+			{
+				spdlog::error("[core] 无法识别的音频格式");
+				*pp_decoder = nullptr;
+				return false;
+			}
+			*pp_decoder = p_decoder.get();
+			return true;
+		}
+		catch (std::exception const& e)
+		{
+			spdlog::error("[core] Decoder: {}", e.what());
+		}
+
 		*pp_decoder = nullptr;
 		return false;
 	}
@@ -313,6 +313,18 @@ namespace Core::Audio
 			throw std::runtime_error("Decoder_FLAC::Decoder_FLAC (1.3)");
 		}
 
+		initialize();
+	}
+	Decoder_FLAC::Decoder_FLAC(std::vector<uint8_t>&& data)
+		: m_data(std::move(data))
+		, m_file(NULL)
+		, m_flac(NULL)
+	{
+		m_ptr = m_data.data(); // 先到文件头
+		initialize();
+	}
+	void Decoder_FLAC::initialize()
+	{
 		// 第二步：创建解码器
 
 		m_flac = FLAC__stream_decoder_new();
@@ -62,6 +62,7 @@ namespace Core::Audio
 
 	private:
 		void destroyResources();
+		void initialize();
 
 	public:
 		uint16_t getSampleSize();
@@ -80,6 +81,7 @@ namespace Core::Audio
 
 	public:
 		Decoder_FLAC(StringView path);
+		Decoder_FLAC(std::vector<uint8_t>&& data); // 接管已经读取到内存的文件
 		~Decoder_FLAC();
 	};
 }
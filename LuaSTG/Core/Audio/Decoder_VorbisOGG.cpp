@@ -209,7 +209,18 @@ namespace Core::Audio
 			destroyResources();
 			throw std::runtime_error("Decoder_VorbisOGG::Decoder_VorbisOGG (1)");
 		}
-
+		initialize();
+	}
+	Decoder_VorbisOGG::Decoder_VorbisOGG(std::vector<uint8_t>&& data)
+		: m_data(std::move(data))
+		, m_stream({})
+		, m_ogg({})
+		, m_init(false)
+	{
+		initialize();
+	}
+	void Decoder_VorbisOGG::initialize()
+	{
 		m_stream.data = m_data.data();
 		m_stream.size = m_data.size();
 		m_stream.ptr = m_data.data();
@@ -29,6 +29,7 @@ namespace Core::Audio
 
 	private:
 		void destroyResources();
+		void initialize();
 
 	public:
 		uint16_t getSampleSize() { return 2; } // OGG 永远是 16bits
@@ -46,6 +47,7 @@ namespace Core::Audio
 
 	public:
 		Decoder_VorbisOGG(StringView path);
+		Decoder_VorbisOGG(std::vector<uint8_t>&& data); // 接管已经读取到内存的文件
 		~Decoder_VorbisOGG();
 	};
 }
@@ -83,18 +83,34 @@ namespace Core::Audio
 				destroyResources();
 				throw std::runtime_error("Decoder_WAV::Decoder_WAV (2)");
 			}
-			drwav_bool32 const result = drwav_init_memory(&m_wav, m_data.data(), m_data.size(), NULL);
-			if (DRWAV_TRUE != result)
-			{
-				destroyResources();
-				throw std::runtime_error("Decoder_WAV::Decoder_WAV (3)");
-			}
+			openMemory();
 		}
 		else
 		{
 			destroyResources();
 			throw std::runtime_error("Decoder_WAV::Decoder_WAV (4)");
 		}
+		initialize();
+	}
+	Decoder_WAV::Decoder_WAV(std::vector<uint8_t>&& data)
+		: m_data(std::move(data))
+		, m_wav({})
+		, m_init(false)
+	{
+		openMemory();
+		initialize();
+	}
+	void Decoder_WAV::openMemory()
+	{
+		drwav_bool32 const result = drwav_init_memory(&m_wav, m_data.data(), m_data.size(), NULL);
+		if (DRWAV_TRUE != result)
+		{
+			destroyResources();
+			throw std::runtime_error("Decoder_WAV::Decoder_WAV (3)");
+		}
+	}
+	void Decoder_WAV::initialize()
+	{
 		m_init = true; // 标记为需要清理
 		// 一些断言
 		if ((m_wav.bitsPerSample % 8) != 0 || !(m_wav.channels == 1 || m_wav.channels == 2))
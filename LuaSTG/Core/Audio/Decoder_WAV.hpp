@@ -15,6 +15,8 @@ namespace Core::Audio
 
 	private:
 		void destroyResources();
+		void openMemory();
+		void initialize();
 
 	public:
 		uint16_t getSampleSize() { return 2; } // 固定为 16bits
@@ -32,6 +34,7 @@ namespace Core::Audio
 
 	public:
 		Decoder_WAV(StringView path);
+		Decoder_WAV(std::vector<uint8_t>&& data); // 接管已经读取到内存的文件
 		~Decoder_WAV();
 	};
 }
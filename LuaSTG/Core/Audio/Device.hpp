@@ -39,6 +39,15 @@ namespace Core::Audio
 		virtual float* getFFT() = 0;
 	};
 
+	// 全部解码到内存中的音频数据，可以被多个播放器共享
+	struct IAudioBuffer : public IObject
+	{
+		virtual uint16_t getChannelCount() = 0;
+		virtual uint32_t getSampleRate() = 0;
+		virtual uint32_t getFrameCount() = 0;
+		virtual size_t getSize() = 0; // 字节数
+	};
+
 	struct IAudioDevice : public IObject
 	{
 		virtual uint32_t getAudioDeviceCount(bool refresh) = 0;
@@ -51,7 +60,9 @@ namespace Core::Audio
 		virtual void setMixChannelVolume(MixChannel ch, float v) = 0;
 		virtual float getMixChannelVolume(MixChannel ch) = 0;
 
+		virtual bool createAudioBuffer(IDecoder* p_decoder, IAudioBuffer** pp_buffer) = 0; // 全部解码到内存中
 		virtual bool createAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player) = 0; // 全部解码到内存中
+		virtual bool createAudioPlayer(IAudioBuffer* p_buffer, IAudioPlayer** pp_player) = 0; // 共享已解码的音频数据
 		virtual bool createLoopAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player) = 0; // 全部解码到内存中
 		virtual bool createStreamAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player) = 0; // 播放时才逐步解码
 	};
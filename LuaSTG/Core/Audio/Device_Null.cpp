@@ -0,0 +1,131 @@
+#include "Core/Audio/Device_Null.hpp"
+
+namespace Core::Audio
+{
+	void Device_Null::setMixChannelVolume(MixChannel ch, float v)
+	{
+		switch (ch)
+		{
+		case MixChannel::SoundEffect:
+			m_volume_sound_effect = v;
+			break;
+		case MixChannel::Music:
+			m_volume_music = v;
+			break;
+		default:
+			break;
+		}
+	}
+	float Device_Null::getMixChannelVolume(MixChannel ch)
+	{
+		switch (ch)
+		{
+		case MixChannel::SoundEffect:
+			return m_volume_sound_effect;
+		case MixChannel::Music:
+			return m_volume_music;
+		default:
+			return 1.0f;
+		}
+	}
+
+	bool Device_Null::createAudioBuffer(IDecoder* p_decoder, IAudioBuffer** pp_buffer)
+	{
+		try
+		{
+			*pp_buffer = new AudioBuffer_Null(p_decoder);
+			m_statistics.buffer += 1;
+			return true;
+		}
+		catch (std::exception const& e)
+		{
+			spdlog::error("[core] {}", e.what());
+			*pp_buffer = nullptr;
+			return false;
+		}
+	}
+	bool Device_Null::createAudioPlayer(IDecoder*, IAudioPlayer** pp_player)
+	{
+		try
+		{
+			*pp_player = new AudioPlayer_Null(this, false);
+			m_statistics.player += 1;
+			return true;
+		}
+		catch (std::exception const& e)
+		{
+			spdlog::error("[core] {}", e.what());
+			*pp_player = nullptr;
+			return false;
+		}
+	}
+	bool Device_Null::createAudioPlayer(IAudioBuffer*, IAudioPlayer** pp_player)
+	{
+		return createAudioPlayer(static_cast<IDecoder*>(nullptr), pp_player);
+	}
+	bool Device_Null::createLoopAudioPlayer(IDecoder*, IAudioPlayer** pp_player)
+	{
+		try
+		{
+			*pp_player = new AudioPlayer_Null(this, true);
+			m_statistics.player += 1;
+			return true;
+		}
+		catch (std::exception const& e)
+		{
+			spdlog::error("[core] {}", e.what());
+			*pp_player = nullptr;
+			return false;
+		}
+	}
+	bool Device_Null::createStreamAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player)
+	{
+		return createLoopAudioPlayer(p_decoder, pp_player);
+	}
+
+	bool Device_Null::create(Device_Null** pp_audio)
+	{
+		try
+		{
+			*pp_audio = new Device_Null();
+			return true;
+		}
+		catch (...)
+		{
+			*pp_audio = nullptr;
+			return false;
+		}
+	}
+
+	AudioBuffer_Null::AudioBuffer_Null(IDecoder* p_decoder)
+		: m_channel_count(p_decoder->getChannelCount())
+		, m_sample_rate(p_decoder->getSampleRate())
+		, m_frame_count(p_decoder->getFrameCount())
+	{
+	}
+
+	bool AudioPlayer_Null::start()
+	{
+		m_is_playing = true;
+		m_device->getStatistics().start += 1;
+		return true;
+	}
+	bool AudioPlayer_Null::stop()
+	{
+		m_is_playing = false;
+		m_device->getStatistics().stop += 1;
+		return true;
+	}
+	bool AudioPlayer_Null::reset()
+	{
+		m_is_playing = false;
+		m_device->getStatistics().reset += 1;
+		return true;
+	}
+
+	AudioPlayer_Null::AudioPlayer_Null(Device_Null* p_device, bool loop)
+		: m_device(p_device)
+		, m_is_loop(loop)
+	{
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include "Core/Object.hpp"
+#include "Core/Audio/Device.hpp"
+
+namespace Core::Audio
+{
+	// 无界面模式使用的音频设备，不解码也不输出任何声音，只统计调用次数
+	class Device_Null : public Object<IAudioDevice>
+	{
+	public:
+		struct Statistics
+		{
+			uint64_t buffer{};
+			uint64_t player{};
+			uint64_t start{};
+			uint64_t stop{};
+			uint64_t reset{};
+		};
+	private:
+		Statistics m_statistics;
+		float m_volume = 1.0f;
+		float m_volume_sound_effect = 1.0f;
+		float m_volume_music = 1.0f;
+	public:
+		Statistics& getStatistics() noexcept { return m_statistics; }
+
+	public:
+		uint32_t getAudioDeviceCount(bool) { return 0; }
+		std::string_view getAudioDeviceName(uint32_t) const noexcept { return ""; }
+		bool setTargetAudioDevice(std::string_view const) { return true; }
+		std::string_view getCurrentAudioDeviceName() const noexcept { return ""; }
+
+		void setVolume(float v) { m_volume = v; }
+		float getVolume() { return m_volume; }
+		void setMixChannelVolume(MixChannel ch, float v);
+		float getMixChannelVolume(MixChannel ch);
+
+		bool createAudioBuffer(IDecoder* p_decoder, IAudioBuffer** pp_buffer);
+		bool createAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player);
+		bool createAudioPlayer(IAudioBuffer* p_buffer, IAudioPlayer** pp_player);
+		bool createLoopAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player);
+		bool createStreamAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player);
+
+	public:
+		static bool create(Device_Null** pp_audio);
+	};
+
+	class AudioBuffer_Null : public Object<IAudioBuffer>
+	{
+	private:
+		uint16_t m_channel_count{};
+		uint32_t m_sample_rate{};
+		uint32_t m_frame_count{};
+	public:
+		uint16_t getChannelCount() { return m_channel_count; }
+		uint32_t getSampleRate() { return m_sample_rate; }
+		uint32_t getFrameCount() { return m_frame_count; }
+		size_t getSize() { return 0; } // 不保存音频数据
+
+	public:
+		AudioBuffer_Null(IDecoder* p_decoder);
+	};
+
+	// 一次性播放的音效立即视为播放结束，循环播放和流式播放的音乐保持播放状态直到被停止
+	class AudioPlayer_Null : public Object<IAudioPlayer>
+	{
+	private:
+		ScopeObject<Device_Null> m_device;
+		float m_volume = 1.0f;
+		float m_output_balance = 0.0f;
+		float m_speed = 1.0f;
+		bool m_is_loop{};
+		bool m_is_playing{};
+	public:
+		bool start();
+		bool stop();
+		bool reset();
+
+		bool isPlaying() { return m_is_loop && m_is_playing; }
+
+		double getTotalTime() { return 0.0; }
+		double getTime() { return 0.0; }
+		bool setTime(double) { return true; }
+		bool setLoop(bool, double, double) { return true; }
+
+		float getVolume() { return m_volume; }
+		bool setVolume(float v) { m_volume = v; return true; }
+		float getBalance() { return m_output_balance; }
+		bool setBalance(float v) { m_output_balance = v; return true; }
+		float getSpeed() { return m_speed; }
+		bool setSpeed(float v) { m_speed = v; return true; }
+
+		void updateFFT() {}
+		uint32_t getFFTSize() { return 0; }
+		float* getFFT() { return nullptr; }
+
+	public:
+		AudioPlayer_Null(Device_Null* p_device, bool loop);
+	};
+}
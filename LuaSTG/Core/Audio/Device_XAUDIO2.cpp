@@ -318,6 +318,35 @@ namespace Core::Audio
 		}
 	}
 
+	bool Device_XAUDIO2::createAudioBuffer(IDecoder* p_decoder, IAudioBuffer** pp_buffer)
+	{
+		try
+		{
+			*pp_buffer = new AudioBuffer_XAUDIO2(p_decoder);
+			return true;
+		}
+		catch (std::exception const& e)
+		{
+			spdlog::error("[core] {}", e.what());
+			*pp_buffer = nullptr;
+			return false;
+		}
+	}
+	bool Device_XAUDIO2::createAudioPlayer(IAudioBuffer* p_buffer, IAudioPlayer** pp_player)
+	{
+		try
+		{
+			// 目前只有 XAudio2 一种实现
+			*pp_player = new AudioPlayer_XAUDIO2(this, static_cast<AudioBuffer_XAUDIO2*>(p_buffer));
+			return true;
+		}
+		catch (std::exception const& e)
+		{
+			spdlog::error("[core] {}", e.what());
+			*pp_player = nullptr;
+			return false;
+		}
+	}
 	bool Device_XAUDIO2::createAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player)
 	{
 		try
@@ -420,7 +449,7 @@ namespace Core::Audio
 
 			m_shared = m_device->getShared();
 
-			winrt::check_hresult(m_shared->xaudio2->CreateSourceVoice(m_player.put(), &m_format, 0, XAUDIO2_DEFAULT_FREQ_RATIO, this));
+			winrt::check_hresult(m_shared->xaudio2->CreateSourceVoice(m_player.put(), &m_buffer->getFormat(), 0, XAUDIO2_DEFAULT_FREQ_RATIO, this));
 
 			XAUDIO2_SEND_DESCRIPTOR voice_send{};
 			voice_send.pOutputVoice = m_shared->voice_sound_effect.get();
@@ -545,11 +574,7 @@ namespace Core::Audio
 	uint32_t AudioPlayer_XAUDIO2::getFFTSize() { assert(false); return 0; }
 	float* AudioPlayer_XAUDIO2::getFFT() { assert(false); return s_empty_fft_data.data(); }
 
-	AudioPlayer_XAUDIO2::AudioPlayer_XAUDIO2(Device_XAUDIO2* p_device, IDecoder* p_decoder)
-		: m_device(p_device)
-	#ifndef NDEBUG
-		, m_decoder(p_decoder)
-	#endif
+	AudioBuffer_XAUDIO2::AudioBuffer_XAUDIO2(IDecoder* p_decoder)
 	{
 		// 填写格式
 
@@ -567,14 +592,21 @@ namespace Core::Audio
 		if (!p_decoder->read(p_decoder->getFrameCount(), m_pcm_data.data(), &frames_read))
 		{
 			i18n_core_system_call_report_error("IDecoder::read -> #ALL");
-			throw std::runtime_error("AudioPlayer_XAUDIO2::AudioPlayer_XAUDIO2 (4)");
+			throw std::runtime_error("AudioBuffer_XAUDIO2::AudioBuffer_XAUDIO2 (4)");
 		}
+		m_pcm_data.resize(frames_read * (uint32_t)p_decoder->getFrameSize());
+	}
+	AudioBuffer_XAUDIO2::~AudioBuffer_XAUDIO2()
+	{
+	}
 
-		// 填写缓冲区描述符
+	void AudioPlayer_XAUDIO2::initialize()
+	{
+		// 填写缓冲区描述符，音频数据由 m_buffer 持有
 
 		m_player_buffer.Flags = XAUDIO2_END_OF_STREAM;
-		m_player_buffer.AudioBytes = frames_read * p_decoder->getFrameSize();
-		m_player_buffer.pAudioData = m_pcm_data.data();
+		m_player_buffer.AudioBytes = static_cast<UINT32>(m_buffer->getSize());
+		m_player_buffer.pAudioData = m_buffer->getData();
 
 		// 创建音频
 
@@ -588,6 +620,21 @@ namespace Core::Audio
 
 		m_device->addEventListener(this);
 	}
+	AudioPlayer_XAUDIO2::AudioPlayer_XAUDIO2(Device_XAUDIO2* p_device, IDecoder* p_decoder)
+		: m_device(p_device)
+	#ifndef NDEBUG
+		, m_decoder(p_decoder)
+	#endif
+	{
+		m_buffer.attach(new AudioBuffer_XAUDIO2(p_decoder));
+		initialize();
+	}
+	AudioPlayer_XAUDIO2::AudioPlayer_XAUDIO2(Device_XAUDIO2* p_device, AudioBuffer_XAUDIO2* p_buffer)
+		: m_device(p_device)
+		, m_buffer(p_buffer)
+	{
+		initialize();
+	}
 	AudioPlayer_XAUDIO2::~AudioPlayer_XAUDIO2()
 	{
 		m_device->removeEventListener(this);
@@ -67,7 +67,9 @@ namespace Core::Audio
 		void setMixChannelVolume(MixChannel ch, float v);
 		float getMixChannelVolume(MixChannel ch);
 
+		bool createAudioBuffer(IDecoder* p_decoder, IAudioBuffer** pp_buffer);
 		bool createAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player);
+		bool createAudioPlayer(IAudioBuffer* p_buffer, IAudioPlayer** pp_player);
 		bool createLoopAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player);
 		bool createStreamAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player);
 
@@ -90,6 +92,26 @@ namespace Core::Audio
 		virtual void WINAPI OnVoiceError(void* pBufferContext, HRESULT Error) noexcept { UNREFERENCED_PARAMETER(pBufferContext); UNREFERENCED_PARAMETER(Error); }
 	};
 
+	class AudioBuffer_XAUDIO2 : public Object<IAudioBuffer>
+	{
+	private:
+		WAVEFORMATEX m_format{};
+		std::vector<BYTE> m_pcm_data;
+	public:
+		WAVEFORMATEX const& getFormat() const noexcept { return m_format; }
+		BYTE const* getData() const noexcept { return m_pcm_data.data(); }
+
+	public:
+		uint16_t getChannelCount() { return m_format.nChannels; }
+		uint32_t getSampleRate() { return m_format.nSamplesPerSec; }
+		uint32_t getFrameCount() { return m_format.nBlockAlign ? static_cast<uint32_t>(m_pcm_data.size() / m_format.nBlockAlign) : 0; }
+		size_t getSize() { return m_pcm_data.size(); }
+
+	public:
+		AudioBuffer_XAUDIO2(IDecoder* p_decoder);
+		~AudioBuffer_XAUDIO2();
+	};
+
 	class AudioPlayer_XAUDIO2
 		: public Object<IAudioPlayer>
 		, public XAudio2VoiceCallbackPlaceholder
@@ -101,10 +123,9 @@ namespace Core::Audio
 	#ifndef NDEBUG
 		ScopeObject<IDecoder> m_decoder;
 	#endif
+		ScopeObject<AudioBuffer_XAUDIO2> m_buffer; // 可能被多个播放器共享
 		winrt::xaudio2_voice_ptr<IXAudio2SourceVoice> m_player;
-		WAVEFORMATEX m_format{};
 		XAUDIO2_BUFFER m_player_buffer = {};
-		std::vector<BYTE> m_pcm_data;
 		float m_volume = 1.0f;
 		float m_output_balance = 0.0f;
 		float m_speed = 1.0f;
@@ -117,6 +138,7 @@ namespace Core::Audio
 	private:
 		bool createResources();
 		void destoryResources();
+		void initialize();
 
 	public:
 		bool start();
@@ -143,6 +165,7 @@ namespace Core::Audio
 
 	public:
 		AudioPlayer_XAUDIO2(Device_XAUDIO2* p_device, IDecoder* p_decoder);
+		AudioPlayer_XAUDIO2(Device_XAUDIO2* p_device, AudioBuffer_XAUDIO2* p_buffer);
 		~AudioPlayer_XAUDIO2();
 	};
 
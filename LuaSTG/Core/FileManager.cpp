@@ -1,6 +1,8 @@
 #include "Core/FileManager.hpp"
 #include <filesystem>
 #include <fstream>
+#include <thread>
+#include <condition_variable>
 #include "utf8.hpp"
 #include "mz.h"
 #include "mz_strm.h"
@@ -238,6 +240,42 @@ namespace Core
         return true;
     }
 
+    bool FileArchive::isEncrypted(std::string_view const& name)
+    {
+        if (!mz_zip_v)
+        {
+            return false;
+        }
+        if (MZ_OK != mz_zip_reader_locate_entry(mz_zip_v, name.data(), false))
+        {
+            return false;
+        }
+        mz_zip_file* mz_zip_file_v = nullptr;
+        if (MZ_OK != mz_zip_reader_entry_get_info(mz_zip_v, &mz_zip_file_v))
+        {
+            return false;
+        }
+        return MZ_ZIP_FLAG_ENCRYPTED == (mz_zip_file_v->flag & MZ_ZIP_FLAG_ENCRYPTED);
+    }
+    bool FileArchive::getStamp(std::string_view const& name, uint64_t& size, uint64_t& stamp)
+    {
+        if (!mz_zip_v)
+        {
+            return false;
+        }
+        if (MZ_OK != mz_zip_reader_locate_entry(mz_zip_v, name.data(), false))
+        {
+            return false;
+        }
+        mz_zip_file* mz_zip_file_v = nullptr;
+        if (MZ_OK != mz_zip_reader_entry_get_info(mz_zip_v, &mz_zip_file_v))
+        {
+            return false;
+        }
+        size = (uint64_t)mz_zip_file_v->uncompressed_size;
+        stamp = mz_zip_file_v->crc;
+        return true;
+    }
     bool FileArchive::empty()
     {
         if (!mz_zip_v)
@@ -338,6 +376,34 @@ namespace Core
         return true;
     }
     
+    std::unique_ptr<FileArchive> FileArchive::createReader()
+    {
+        if (!mz_zip_v)
+        {
+            return nullptr;
+        }
+        auto reader = std::unique_ptr<FileArchive>(new FileArchive(*this, nullptr));
+        if (reader->empty())
+        {
+            return nullptr;
+        }
+        return reader;
+    }
+    
+    FileArchive::FileArchive(FileArchive const& source, std::nullptr_t) : name_(source.name_), password_(source.password_), uuid(source.uuid)
+    {
+        mz_zip_v = mz_zip_reader_create();
+        if (mz_zip_v)
+        {
+            if (MZ_OK == mz_zip_reader_open_file(mz_zip_v, name_.c_str()))
+            {
+                if (!password_.empty())
+                {
+                    mz_zip_reader_set_password(mz_zip_v, password_.c_str());
+                }
+            }
+        }
+    }
     FileArchive::FileArchive(std::string_view const& path) : name_(path), uuid(g_uuid++)
     {
         mz_zip_v = mz_zip_reader_create();
@@ -584,6 +650,7 @@ namespace Core
             return false;
         }
         archive.insert(archive.begin(), arc);
+        clearCache();
         return true;
     }
     bool FileManager::loadFileArchive(std::string_view const& name, std::string_view const& password)
@@ -595,6 +662,7 @@ namespace Core
         }
         arc->setPassword(password);
         archive.insert(archive.begin(), arc);
+        clearCache();
         return true;
     }
     bool FileManager::containFileArchive(std::string_view const& name)
@@ -621,16 +689,19 @@ namespace Core
                 it++;
             }
         }
+        clearCache();
     }
     void FileManager::unloadAllFileArchive()
     {
         archive.clear();
+        clearCache();
     }
     
     void FileManager::addSearchPath(std::string_view const& path)
     {
         removeSearchPath(path);
         search_list.emplace_back(path);
+        clearCache();
     }
     void FileManager::removeSearchPath(std::string_view const& path)
     {
@@ -645,10 +716,12 @@ namespace Core
                 it++;
             }
         }
+        clearCache();
     }
     void FileManager::clearSearchPath()
     {
         search_list.clear();
+        clearCache();
     }
     
     bool FileManager::containEx(std::string_view const& name)
@@ -682,8 +755,89 @@ namespace Core
         }
         return false;
     }
+    bool FileManager::isEncryptedEx(std::string_view const& name)
+    {
+        // 返回值：找到文件时为 true，is_encrypted 为是否加密
+        auto proc = [&](std::string_view const& name, bool& is_encrypted) -> bool
+        {
+            for (auto& arc : archive)
+            {
+                if (arc->contain(name))
+                {
+                    is_encrypted = arc->isEncrypted(name);
+                    return true;
+                }
+            }
+            return contain(name);
+        };
+        bool is_encrypted = false;
+        if (proc(name, is_encrypted))
+        {
+            return is_encrypted;
+        }
+        for (auto& p : search_list)
+        {
+            std::string path(p); path.append(name);
+            if (proc(path, is_encrypted))
+            {
+                return is_encrypted;
+            }
+        }
+        return false;
+    }
+    bool FileManager::getStampEx(std::string_view const& name, uint64_t& size, uint64_t& stamp)
+    {
+        auto proc = [&](std::string_view const& name) -> bool
+        {
+            for (auto& arc : archive)
+            {
+                if (arc->contain(name))
+                {
+                    return arc->getStamp(name, size, stamp);
+                }
+            }
+            std::wstring wide_path(utf8::to_wstring(name));
+            std::error_code ec;
+            if (!std::filesystem::is_regular_file(wide_path, ec))
+            {
+                return false;
+            }
+            auto const file_size = std::filesystem::file_size(wide_path, ec);
+            if (ec)
+            {
+                return false;
+            }
+            auto const write_time = std::filesystem::last_write_time(wide_path, ec);
+            if (ec)
+            {
+                return false;
+            }
+            size = (uint64_t)file_size;
+            stamp = (uint64_t)write_time.time_since_epoch().count();
+            return true;
+        };
+        if (proc(name))
+        {
+            return true;
+        }
+        for (auto& p : search_list)
+        {
+            std::string path(p); path.append(name);
+            if (proc(path))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
     bool FileManager::loadEx(std::string_view const& name, std::vector<uint8_t>& buffer)
     {
+        if (ScopeObject<IData> p_data; takeCache(name, ~p_data))
+        {
+            auto const* ptr = static_cast<uint8_t const*>(p_data->data());
+            buffer.assign(ptr, ptr + p_data->size());
+            return true;
+        }
         auto proc = [&](std::string_view const& name, std::vector<uint8_t>& buffer) -> bool
         {
             for (auto& arc : archive)
@@ -715,6 +869,10 @@ namespace Core
     }
     bool FileManager::loadEx(std::string_view const& name, IData** pp_data)
     {
+        if (takeCache(name, pp_data))
+        {
+            return true;
+        }
         auto proc = [&](std::string_view const& name, IData** pp_data) -> bool
         {
             for (auto& arc : archive)
@@ -746,6 +904,7 @@ namespace Core
     }
     bool FileManager::write(std::string_view const& name, std::vector<uint8_t> const& buffer)
     {
+        eraseCache(name); // 丢弃过期的预读数据
         std::wstring wide_path(utf8::to_wstring(name));
         std::error_code ec;
         std::ofstream file(wide_path, std::ios::out | std::ios::binary | std::ios::trunc);
@@ -759,6 +918,7 @@ namespace Core
     }
     bool FileManager::write(std::string_view const& name, IData* p_data)
     {
+        eraseCache(name); // 丢弃过期的预读数据
         std::wstring wide_path(utf8::to_wstring(name));
         std::error_code ec;
         std::ofstream file(wide_path, std::ios::out | std::ios::binary | std::ios::trunc);
@@ -771,6 +931,264 @@ namespace Core
         return true;
     }
 
+    bool FileManager::takeCache(std::string_view const& name, IData** pp_data)
+    {
+        std::scoped_lock lock(cache_lock);
+        auto it = cache_map.find(name);
+        if (it == cache_map.end())
+        {
+            return false;
+        }
+        // 重复读取同一文件时仍然命中，移到最前以免被淘汰
+        auto node = it->second;
+        cache_list.splice(cache_list.begin(), cache_list, node);
+        node->data->retain();
+        *pp_data = node->data.get();
+        return true;
+    }
+    void FileManager::eraseCache(std::string_view const& name)
+    {
+        std::scoped_lock lock(cache_lock);
+        if (auto it = cache_map.find(name); it != cache_map.end())
+        {
+            auto node = it->second;
+            cache_map.erase(it);
+            cache_size -= node->data->size();
+            cache_list.erase(node);
+        }
+    }
+    void FileManager::putCache(std::string_view const& name, IData* p_data)
+    {
+        std::scoped_lock lock(cache_lock);
+        if (auto it = cache_map.find(name); it != cache_map.end())
+        {
+            auto node = it->second;
+            cache_map.erase(it);
+            cache_size -= node->data->size();
+            cache_list.erase(node);
+        }
+        if (p_data->size() > cache_capacity)
+        {
+            return;
+        }
+        // 淘汰最久未使用的数据
+        while (!cache_list.empty() && (cache_size + p_data->size()) > cache_capacity)
+        {
+            auto& last = cache_list.back();
+            cache_map.erase(last.name);
+            cache_size -= last.data->size();
+            cache_list.pop_back();
+        }
+        cache_list.emplace_front(CacheEntry{ .name = std::string(name), .data = ScopeObject<IData>(p_data) });
+        cache_map.emplace(cache_list.front().name, cache_list.begin());
+        cache_size += p_data->size();
+    }
+    void FileManager::clearCache()
+    {
+        std::scoped_lock lock(cache_lock);
+        cache_map.clear();
+        cache_list.clear();
+        cache_size = 0;
+    }
+
+    struct FileManager::LoadWorkerGroup
+    {
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable start;
+        std::condition_variable done;
+        std::function<void()> const* job{};
+        uint64_t generation{};
+        size_t running{};
+        bool exit{};
+
+        void workerMain()
+        {
+            uint64_t current = 0;
+            for (;;)
+            {
+                std::function<void()> const* p_job{};
+                {
+                    std::unique_lock lock(mutex);
+                    start.wait(lock, [&] { return exit || generation != current; });
+                    if (exit)
+                    {
+                        return;
+                    }
+                    current = generation;
+                    p_job = job;
+                }
+                (*p_job)();
+                {
+                    std::unique_lock lock(mutex);
+                    running -= 1;
+                    if (running == 0)
+                    {
+                        done.notify_one();
+                    }
+                }
+            }
+        }
+        // 在所有工作线程和调用线程上同时执行 fn，等待全部返回
+        void run(std::function<void()> const& fn)
+        {
+            if (threads.empty())
+            {
+                fn();
+                return;
+            }
+            {
+                std::unique_lock lock(mutex);
+                job = &fn;
+                running = threads.size();
+                generation += 1;
+            }
+            start.notify_all();
+            fn();
+            {
+                std::unique_lock lock(mutex);
+                done.wait(lock, [&] { return running == 0; });
+                job = nullptr;
+            }
+        }
+
+        LoadWorkerGroup()
+        {
+            size_t const worker_count = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+            threads.reserve(worker_count);
+            for (size_t i = 0; i < worker_count; i += 1)
+            {
+                threads.emplace_back(&LoadWorkerGroup::workerMain, this);
+            }
+        }
+        ~LoadWorkerGroup()
+        {
+            {
+                std::unique_lock lock(mutex);
+                exit = true;
+            }
+            start.notify_all();
+            for (auto& t : threads)
+            {
+                t.join();
+            }
+        }
+    };
+
+    size_t FileManager::loadMany(std::vector<std::string> const& names, LoadManyCallback const& callback)
+    {
+        // 在调用线程上按照 loadEx 相同的查找顺序定位文件
+
+        struct Task
+        {
+            std::string_view name;
+            std::string path;
+            FileArchive* source = nullptr; // 为空表示文件系统
+            size_t source_index = 0;
+            bool found = false;
+            ScopeObject<IData> data;
+        };
+
+        std::vector<Task> tasks(names.size());
+        auto locate = [&](Task& task, std::string_view const& path) -> bool
+        {
+            for (size_t i = 0; i < archive.size(); i += 1)
+            {
+                if (archive[i]->contain(path))
+                {
+                    task.path = path;
+                    task.source = archive[i].get();
+                    task.source_index = i;
+                    return true;
+                }
+            }
+            if (contain(path))
+            {
+                task.path = path;
+                return true;
+            }
+            return false;
+        };
+        for (size_t i = 0; i < names.size(); i += 1)
+        {
+            Task& task = tasks[i];
+            task.name = names[i];
+            task.found = locate(task, task.name);
+            for (auto it = search_list.begin(); !task.found && it != search_list.end(); it++)
+            {
+                std::string path(*it); path.append(task.name);
+                task.found = locate(task, path);
+            }
+        }
+
+        // 解压（以及解密）交给常驻的工作线程，每个线程持有独立的压缩包读取器
+        // 任务比线程少时，多余的线程取不到任务直接返回
+
+        std::atomic_size_t next_task{ 0 };
+        auto worker = [&]()
+        {
+            std::vector<std::unique_ptr<FileArchive>> readers(archive.size());
+            for (size_t i = next_task.fetch_add(1); i < tasks.size(); i = next_task.fetch_add(1))
+            {
+                Task& task = tasks[i];
+                if (!task.found)
+                {
+                    continue;
+                }
+                if (task.source)
+                {
+                    auto& reader = readers[task.source_index];
+                    if (!reader)
+                    {
+                        reader = task.source->createReader();
+                    }
+                    if (reader && !reader->load(task.path, ~task.data))
+                    {
+                        task.data.reset();
+                    }
+                }
+                else if (!load(task.path, ~task.data))
+                {
+                    task.data.reset();
+                }
+            }
+        };
+        if (tasks.size() > 1)
+        {
+            std::scoped_lock lock(load_lock); // 工作线程同一时间只服务一次批量读取
+            if (!load_workers)
+            {
+                load_workers = std::make_unique<LoadWorkerGroup>();
+            }
+            load_workers->run(worker);
+        }
+        else
+        {
+            worker();
+        }
+
+        // 回到调用线程写入缓存并回调
+
+        size_t loaded = 0;
+        for (auto& task : tasks)
+        {
+            if (task.data)
+            {
+                putCache(task.name, task.data.get());
+                loaded += 1;
+            }
+            else if (task.found)
+            {
+                spdlog::error("[core] [Core::FileManager::loadMany] 无法读取文件 '{}'", task.path);
+            }
+            if (callback)
+            {
+                callback(task.name, task.data.get());
+            }
+        }
+        return loaded;
+    }
+
     FileManager::FileManager()
     {
     }
@@ -4,6 +4,10 @@
 #include <string>
 #include <string_view>
 #include <memory>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 namespace Core
 {
@@ -45,6 +49,7 @@ namespace Core
         uint64_t uuid = 0;
         void* mz_zip_v = nullptr;
         void refresh();
+        FileArchive(FileArchive const& source, std::nullptr_t);
     public:
         size_t findIndex(std::string_view const& name);
         size_t getCount();
@@ -56,6 +61,10 @@ namespace Core
         bool contain(std::string_view const& name);
         bool load(std::string_view const& name, std::vector<uint8_t>& buffer);
         bool load(std::string_view const& name, IData** pp_data);
+        // 条目是否加密，不存在时返回 false
+        bool isEncrypted(std::string_view const& name);
+        // 不解压读取条目的大小和 CRC32
+        bool getStamp(std::string_view const& name, uint64_t& size, uint64_t& stamp);
     public:
         bool empty();
         uint64_t getUUID();
@@ -63,6 +72,8 @@ namespace Core
         bool setPassword(std::string_view const& password);
         bool loadEncrypted(std::string_view const& name, std::string_view const& password, std::vector<uint8_t>& buffer);
         bool loadEncrypted(std::string_view const& name, std::string_view const& password, IData** pp_data);
+        // minizip 的读取器不是线程安全的，其他线程需要通过该方法打开独立的读取器
+        std::unique_ptr<FileArchive> createReader();
     public:
         FileArchive() = default;
         FileArchive(std::string_view const& path);
@@ -76,7 +87,26 @@ namespace Core
         std::vector<std::string> search_list;
         FileArchive null_archive;
         std::vector<std::shared_ptr<FileArchive>> archive;
+        // 预读缓存：loadMany 解压的数据暂存于此，按 LRU 淘汰
+        // loadEx 命中时不移除数据，只把它移到最前；调用者与缓存共享同一份数据，不应修改其内容
+        struct CacheEntry
+        {
+            std::string name;
+            ScopeObject<IData> data;
+        };
+        std::mutex cache_lock;
+        std::list<CacheEntry> cache_list;
+        std::unordered_map<std::string_view, std::list<CacheEntry>::iterator> cache_map;
+        size_t cache_size = 0;
+        size_t cache_capacity = 64 * 1024 * 1024;
         void refresh();
+        bool takeCache(std::string_view const& name, IData** pp_data);
+        void putCache(std::string_view const& name, IData* p_data);
+        void eraseCache(std::string_view const& name);
+        // loadMany 使用的常驻工作线程，第一次批量读取时创建
+        struct LoadWorkerGroup;
+        std::mutex load_lock;
+        std::unique_ptr<LoadWorkerGroup> load_workers;
     public:
         size_t findIndex(std::string_view const& name);
         size_t getCount();
@@ -107,8 +137,19 @@ namespace Core
         bool containEx(std::string_view const& name);
         bool loadEx(std::string_view const& name, std::vector<uint8_t>& buffer);
         bool loadEx(std::string_view const& name, IData** pp_data);
+        // 按 loadEx 的查找顺序定位文件，判断其是否来自压缩包中的加密条目
+        bool isEncryptedEx(std::string_view const& name);
+        // 按 loadEx 的查找顺序定位文件，不读取内容，获取文件大小和用于判断内容是否变化的标记
+        // 压缩包中的文件使用 CRC32，文件系统中的文件使用最后修改时间
+        bool getStampEx(std::string_view const& name, uint64_t& size, uint64_t& stamp);
         bool write(std::string_view const& name, std::vector<uint8_t> const& buffer);
         bool write(std::string_view const& name, IData* p_data);
+    public:
+        using LoadManyCallback = std::function<void(std::string_view const& name, IData* p_data)>;
+        // 批量读取文件，解压工作分配到常驻的工作线程上，结果按传入顺序在调用线程上回调（读取失败时 p_data 为 nullptr）
+        // 读取的数据同时放入预读缓存，之后的 loadEx 会优先从缓存取走数据
+        size_t loadMany(std::vector<std::string> const& names, LoadManyCallback const& callback);
+        void clearCache();
     public:
         FileManager();
         ~FileManager();
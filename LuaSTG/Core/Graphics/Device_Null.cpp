@@ -0,0 +1,207 @@
+#include "Core/Graphics/Device_Null.hpp"
+#include "Core/FileManager.hpp"
+#include "Core/i18n.hpp"
+#include <cstring>
+
+namespace Core::Graphics
+{
+	bool Device_Null::readImageSize(StringView path, Vector2U& size)
+	{
+		std::vector<uint8_t> src;
+		if (!GFileManager().loadEx(path, src))
+		{
+			spdlog::error("[core] 无法加载文件 '{}'", path);
+			return false;
+		}
+		auto const read_u32 = [&src](size_t const offset, bool const big_endian) -> uint32_t
+		{
+			uint8_t const* p = src.data() + offset;
+			if (big_endian)
+				return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+			return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+		};
+
+		// DDS：魔数之后是 DDS_HEADER，高度和宽度分别位于第 12、16 字节
+		if (src.size() >= 20 && std::memcmp(src.data(), "DDS ", 4) == 0)
+		{
+			size = Vector2U(read_u32(16, false), read_u32(12, false));
+			return size.x > 0 && size.y > 0;
+		}
+		// QOI：魔数之后是大端序的宽度和高度
+		if (src.size() >= 12 && std::memcmp(src.data(), "qoif", 4) == 0)
+		{
+			size = Vector2U(read_u32(4, true), read_u32(8, true));
+			return size.x > 0 && size.y > 0;
+		}
+
+		// 其他格式交给 WIC，只读取第一帧的尺寸，不解码像素
+		if (!wic_factory)
+		{
+			return false;
+		}
+		HRESULT hr = S_OK;
+		Microsoft::WRL::ComPtr<IWICStream> wic_stream;
+		hr = gHR = wic_factory->CreateStream(&wic_stream);
+		if (FAILED(hr))
+		{
+			i18n_core_system_call_report_error("IWICImagingFactory::CreateStream");
+			return false;
+		}
+		hr = gHR = wic_stream->InitializeFromMemory(src.data(), static_cast<DWORD>(src.size()));
+		if (FAILED(hr))
+		{
+			i18n_core_system_call_report_error("IWICStream::InitializeFromMemory");
+			return false;
+		}
+		Microsoft::WRL::ComPtr<IWICBitmapDecoder> wic_decoder;
+		hr = gHR = wic_factory->CreateDecoderFromStream(wic_stream.Get(), NULL, WICDecodeMetadataCacheOnDemand, &wic_decoder);
+		if (FAILED(hr))
+		{
+			i18n_core_system_call_report_error("IWICImagingFactory::CreateDecoderFromStream");
+			return false;
+		}
+		Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> wic_frame;
+		hr = gHR = wic_decoder->GetFrame(0, &wic_frame);
+		if (FAILED(hr))
+		{
+			i18n_core_system_call_report_error("IWICBitmapDecoder::GetFrame");
+			return false;
+		}
+		UINT width = 0, height = 0;
+		hr = gHR = wic_frame->GetSize(&width, &height);
+		if (FAILED(hr))
+		{
+			i18n_core_system_call_report_error("IWICBitmapFrameDecode::GetSize");
+			return false;
+		}
+		size = Vector2U(width, height);
+		return size.x > 0 && size.y > 0;
+	}
+
+	bool Device_Null::createTextureFromFile(StringView path, bool, ITexture2D** pp_texutre)
+	{
+		Vector2U size;
+		if (!readImageSize(path, size))
+		{
+			*pp_texutre = nullptr;
+			return false;
+		}
+		try
+		{
+			*pp_texutre = new Texture2D_Null(size, false, false);
+			return true;
+		}
+		catch (...)
+		{
+			*pp_texutre = nullptr;
+			return false;
+		}
+	}
+	bool Device_Null::createTexture(Vector2U size, ITexture2D** pp_texutre)
+	{
+		try
+		{
+			*pp_texutre = new Texture2D_Null(size, true, false);
+			return true;
+		}
+		catch (...)
+		{
+			*pp_texutre = nullptr;
+			return false;
+		}
+	}
+
+	bool Device_Null::createRenderTarget(Vector2U size, IRenderTarget** pp_rt)
+	{
+		try
+		{
+			*pp_rt = new RenderTarget_Null(size);
+			return true;
+		}
+		catch (...)
+		{
+			*pp_rt = nullptr;
+			return false;
+		}
+	}
+	bool Device_Null::createDepthStencilBuffer(Vector2U size, IDepthStencilBuffer** pp_ds)
+	{
+		try
+		{
+			*pp_ds = new DepthStencilBuffer_Null(size);
+			return true;
+		}
+		catch (...)
+		{
+			*pp_ds = nullptr;
+			return false;
+		}
+	}
+
+	bool Device_Null::createSamplerState(SamplerState const&, ISamplerState** pp_sampler)
+	{
+		try
+		{
+			*pp_sampler = new SamplerState_Null();
+			return true;
+		}
+		catch (...)
+		{
+			*pp_sampler = nullptr;
+			return false;
+		}
+	}
+
+	Device_Null::Device_Null()
+	{
+		// 读取图片尺寸用，创建失败时只能使用 DDS 和 QOI 格式的纹理
+		HRESULT hr = gHR = CoCreateInstance(CLSID_WICImagingFactory, NULL, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&wic_factory));
+		if (FAILED(hr))
+		{
+			i18n_core_system_call_report_error("CoCreateInstance -> IWICImagingFactory");
+		}
+	}
+
+	bool Device_Null::create(Device_Null** pp_device)
+	{
+		try
+		{
+			*pp_device = new Device_Null();
+			return true;
+		}
+		catch (...)
+		{
+			*pp_device = nullptr;
+			return false;
+		}
+	}
+
+	bool Texture2D_Null::setSize(Vector2U size)
+	{
+		if (!(m_dynamic || m_isrt))
+		{
+			spdlog::error("[core] 不能修改静态纹理的大小");
+			return false;
+		}
+		m_size = size;
+		return true;
+	}
+	bool Texture2D_Null::saveToFile(StringView path)
+	{
+		spdlog::warn("[core] 无界面模式下纹理没有像素数据，无法保存到 '{}'", path);
+		return false;
+	}
+
+	Texture2D_Null::Texture2D_Null(Vector2U size, bool dynamic, bool rendertarget)
+		: m_size(size)
+		, m_dynamic(dynamic)
+		, m_premul(rendertarget) // 与 Texture2D_D3D11 一致，渲染目标默认是预乘 alpha 的
+		, m_isrt(rendertarget)
+	{
+	}
+
+	RenderTarget_Null::RenderTarget_Null(Vector2U size)
+	{
+		m_texture.attach(new Texture2D_Null(size, true, true));
+	}
+}
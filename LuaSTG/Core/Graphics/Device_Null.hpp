@@ -0,0 +1,112 @@
+#pragma once
+#include "Core/Object.hpp"
+#include "Core/Graphics/Device.hpp"
+
+namespace Core::Graphics
+{
+	// 无界面模式使用的图形设备，不创建 GPU 资源
+	// 纹理、渲染目标只记录尺寸；从文件创建纹理时只读取图片头部得到尺寸，保证精灵、字体等资源的计算结果不变
+	class Device_Null : public Object<IDevice>
+	{
+	private:
+		Microsoft::WRL::ComPtr<IWICImagingFactory> wic_factory;
+
+	public:
+		bool readImageSize(StringView path, Vector2U& size);
+
+	public:
+		void addEventListener(IDeviceEventListener*) {}
+		void removeEventListener(IDeviceEventListener*) {}
+
+		DeviceMemoryUsageStatistics getMemoryUsageStatistics() { return {}; }
+
+		bool recreate() { return true; }
+		void setPreferenceGpu(StringView) {}
+		uint32_t getGpuCount() { return 0; }
+		StringView getGpuName(uint32_t) { return ""; }
+		StringView getCurrentGpuName() const noexcept { return ""; }
+
+		void* getNativeHandle() { return nullptr; }
+		void* getNativeRendererHandle() { return nullptr; }
+
+		bool createTextureFromFile(StringView path, bool mipmap, ITexture2D** pp_texutre);
+		bool createTexture(Vector2U size, ITexture2D** pp_texutre);
+
+		bool createRenderTarget(Vector2U size, IRenderTarget** pp_rt);
+		bool createDepthStencilBuffer(Vector2U size, IDepthStencilBuffer** pp_ds);
+
+		bool createSamplerState(SamplerState const& def, ISamplerState** pp_sampler);
+
+	public:
+		Device_Null();
+
+	public:
+		static bool create(Device_Null** pp_device);
+	};
+
+	class SamplerState_Null : public Object<ISamplerState>
+	{
+	};
+
+	class Texture2D_Null : public Object<ITexture2D>
+	{
+	private:
+		ScopeObject<ISamplerState> m_sampler;
+		Vector2U m_size{};
+		bool m_dynamic{};
+		bool m_premul{};
+		bool m_isrt{};
+
+	public:
+		void* getNativeHandle() { return nullptr; }
+
+		bool isDynamic() { return m_dynamic; }
+		bool isPremultipliedAlpha() { return m_premul; }
+		void setPremultipliedAlpha(bool v) { m_premul = v; }
+		Vector2U getSize() { return m_size; }
+		bool setSize(Vector2U size);
+
+		bool uploadPixelData(RectU, void const*, uint32_t) { return m_dynamic; }
+		void setPixelData(IData*) {}
+
+		bool saveToFile(StringView path);
+
+		void setSamplerState(ISamplerState* p_sampler) { m_sampler = p_sampler; }
+		ISamplerState* getSamplerState() { return m_sampler.get(); }
+
+	public:
+		// 从文件创建的纹理是静态的，其余纹理与 Texture2D_D3D11 一样是动态的
+		Texture2D_Null(Vector2U size, bool dynamic, bool rendertarget);
+	};
+
+	class RenderTarget_Null : public Object<IRenderTarget>
+	{
+	private:
+		ScopeObject<Texture2D_Null> m_texture;
+
+	public:
+		void* getNativeHandle() { return nullptr; }
+		void* getNativeBitmapHandle() { return nullptr; }
+
+		bool setSize(Vector2U size) { return m_texture->setSize(size); }
+		ITexture2D* getTexture() { return *m_texture; }
+
+	public:
+		RenderTarget_Null(Vector2U size);
+	};
+
+	class DepthStencilBuffer_Null : public Object<IDepthStencilBuffer>
+	{
+	private:
+		Vector2U m_size{};
+
+	public:
+		void* getNativeHandle() { return nullptr; }
+
+		bool setSize(Vector2U size) { m_size = size; return true; }
+		Vector2U getSize() { return m_size; }
+
+	public:
+		DepthStencilBuffer_Null(Vector2U size) : m_size(size) {}
+	};
+}
@@ -11,6 +11,7 @@ namespace Core::Graphics
 		Vector2F size;              // 字形大小
 		Vector2F position;          // 笔触距离字形左上角坐标
 		Vector2F advance;           // 前进量
+		bool     is_pending = false; // 字形位图还在后台光栅化，此时只能用于排版，不能绘制
 	};
 
 	struct TrueTypeFontInfo
@@ -61,6 +62,8 @@ namespace Core::Graphics
 		virtual bool drawTextInSpace(StringView str,
 			Vector3F const& start, Vector3F const& right_vec, Vector3F const& down_vec,
 			Vector3F* endout) = 0;
+		// 在笔触位置绘制单个字形，用于绘制已经排版好的文字，y 轴朝上（不受到 setScale 影响，字形度量值需要事先缩放）
+		virtual bool drawGlyph(GlyphInfo const& glyph_info, Vector2F const& start_pos) = 0;
 
 		static bool create(IRenderer* p_renderer, ITextRenderer** pp_textrenderer);
 	};
@@ -1,7 +1,11 @@
 ﻿#include "Core/Graphics/Font_D3D11.hpp"
 #include "Core/FileManager.hpp"
+#include "core/Configuration.hpp"
 #include "utility/utf.hpp"
 #include "utf8.hpp"
+#include "xxhash.h"
+#include <filesystem>
+#include <fstream>
 
 static bool findSystemFont(std::string_view name, std::string& u8_path);
 
@@ -68,6 +72,351 @@ namespace Core::Graphics
 		~FT_Bitmap_Accessor() noexcept = default;
 	};
 
+	// 转换为纹理的像素格式，后台线程也会调用，不能访问共享的状态
+	static void readGlyphBitmap(FT_Bitmap const& bitmap, GlyphBitmap& output)
+	{
+		FT_Bitmap_Accessor accessor(bitmap);
+		output.width = accessor.width();
+		output.height = accessor.height();
+		output.pixels.resize((size_t)output.width * (size_t)output.height);
+		for (uint32_t y = 0; y < output.height; y += 1)
+		{
+			for (uint32_t x = 0; x < output.width; x += 1)
+			{
+				output.pixels[(size_t)y * output.width + x] = Color4B(accessor.pixel(x, y));
+			}
+		}
+	}
+
+	// 所有字形管理器共用的后台光栅化线程，有字形管理器接入时才运行
+	// FT_Library 和 FT_Face 都不能跨线程使用，后台线程有自己的 FT_Library，并为每个字形管理器再打开一份 FT_Face
+	class SharedGlyphRasterizer
+	{
+	private:
+		struct FontSource
+		{
+			FT_Byte const* data{ nullptr }; // 由字形管理器持有，分离前不会被修改
+			FT_Long size{ 0 };
+			std::string path;
+			FT_Long face_index{ 0 };
+			FT_UInt pixel_width{ 0 };
+			FT_UInt pixel_height{ 0 };
+		};
+		struct Client
+		{
+			std::vector<FontSource> source;
+			std::vector<FT_Face> faces; // 只在后台线程访问，第一次光栅化时打开
+			bool is_open{ false };
+			std::vector<GlyphRasterizeResult> result;
+		};
+		struct Request
+		{
+			TrueTypeGlyphManager_D3D11* owner{ nullptr };
+			GlyphRasterizeRequest request;
+		};
+
+		std::thread m_worker;
+		std::mutex m_lock;
+		std::condition_variable m_cv;
+		std::condition_variable m_closed_cv;
+		std::unordered_map<TrueTypeGlyphManager_D3D11*, std::unique_ptr<Client>> m_client;
+		std::deque<Request> m_request;
+		std::vector<std::unique_ptr<Client>> m_closing; // 已经分离，等待后台线程关闭 FT_Face
+		bool m_exit{ false };
+
+	private:
+		static void openFaces(FT_Library library, Client& client)
+		{
+			client.is_open = true;
+			client.faces.assign(client.source.size(), NULL);
+			if (!library)
+			{
+				return;
+			}
+			for (size_t i = 0; i < client.source.size(); i += 1)
+			{
+				auto const& f = client.source[i];
+				FT_Error error = FT_Err_Ok;
+				if (f.data)
+				{
+					error = FT_New_Memory_Face(library, f.data, f.size, f.face_index, &client.faces[i]);
+				}
+				else
+				{
+					error = FT_New_Face(library, f.path.c_str(), f.face_index, &client.faces[i]);
+				}
+				if (FT_Err_Ok != error)
+				{
+					client.faces[i] = NULL;
+				}
+				else if (FT_Err_Ok != FT_Set_Pixel_Sizes(client.faces[i], f.pixel_width, f.pixel_height))
+				{
+					FT_Done_Face(client.faces[i]);
+					client.faces[i] = NULL;
+				}
+			}
+		}
+		static void closeFaces(Client& client)
+		{
+			for (auto& face : client.faces)
+			{
+				if (face)
+				{
+					FT_Done_Face(face);
+					face = NULL;
+				}
+			}
+		}
+		static GlyphRasterizeResult rasterize(FT_Library library, Client& client, GlyphRasterizeRequest const& request)
+		{
+			if (!client.is_open)
+			{
+				openFaces(library, client);
+			}
+			GlyphRasterizeResult result;
+			result.codepoint = request.codepoint;
+			FT_Face face = request.font_index < client.faces.size() ? client.faces[request.font_index] : NULL;
+			if (face && FT_Err_Ok == FT_Load_Glyph(face, request.glyph_index, FT_LOAD_RENDER))
+			{
+				FT_GlyphSlot& glyph = face->glyph;
+				result.success = true;
+				result.size = Vector2F((float)glyph->bitmap.width, (float)glyph->bitmap.rows);
+				result.position = Vector2F((float)glyph->bitmap_left, (float)glyph->bitmap_top);
+				readGlyphBitmap(glyph->bitmap, result.bitmap);
+			}
+			return result;
+		}
+		void workerMain()
+		{
+			FT_Library library = NULL;
+			if (FT_Err_Ok != FT_Init_FreeType(&library))
+			{
+				library = NULL;
+			}
+			std::unique_lock<std::mutex> lock(m_lock);
+			while (true)
+			{
+				m_cv.wait(lock, [this]() { return m_exit || !m_request.empty() || !m_closing.empty(); });
+				// 先关闭已经分离的字形管理器的字体，退出前也要关闭
+				if (!m_closing.empty())
+				{
+					for (auto& client : m_closing)
+					{
+						closeFaces(*client);
+					}
+					m_closing.clear();
+					m_closed_cv.notify_all();
+					continue;
+				}
+				if (m_exit)
+				{
+					break;
+				}
+				Request const request = m_request.front();
+				m_request.pop_front();
+				auto it = m_client.find(request.owner);
+				if (it == m_client.end())
+				{
+					continue;
+				}
+				// 光栅化时不持有锁，分离的字形管理器的 Client 会等到这次光栅化完成后才销毁
+				Client* client = it->second.get();
+				lock.unlock();
+				GlyphRasterizeResult result = rasterize(library, *client, request.request);
+				lock.lock();
+				it = m_client.find(request.owner);
+				if (it != m_client.end() && it->second.get() == client)
+				{
+					client->result.emplace_back(std::move(result));
+				}
+			}
+			lock.unlock();
+			if (library)
+			{
+				FT_Done_FreeType(library);
+			}
+		}
+		void stop()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_lock);
+				m_exit = true;
+			}
+			m_cv.notify_one();
+			m_worker.join();
+		}
+
+	public:
+		bool attach(TrueTypeGlyphManager_D3D11* owner, std::vector<FreeTypeFontData> const& fonts)
+		{
+			auto client = std::make_unique<Client>();
+			client->source.reserve(fonts.size());
+			for (auto const& f : fonts)
+			{
+				FontSource source;
+				if (!f.buffer.empty())
+				{
+					source.data = (FT_Byte const*)f.buffer.data();
+					source.size = (FT_Long)f.buffer.size();
+				}
+				else
+				{
+					source.path = f.path;
+				}
+				source.face_index = f.face_index;
+				source.pixel_width = f.pixel_width;
+				source.pixel_height = f.pixel_height;
+				client->source.emplace_back(std::move(source));
+			}
+			std::lock_guard<std::mutex> lock(m_lock);
+			if (!m_worker.joinable())
+			{
+				m_exit = false;
+				try
+				{
+					m_worker = std::thread(&SharedGlyphRasterizer::workerMain, this);
+				}
+				catch (...)
+				{
+					return false;
+				}
+			}
+			m_client.insert_or_assign(owner, std::move(client));
+			return true;
+		}
+		void detach(TrueTypeGlyphManager_D3D11* owner)
+		{
+			std::unique_lock<std::mutex> lock(m_lock);
+			auto it = m_client.find(owner);
+			if (it == m_client.end())
+			{
+				return;
+			}
+			// 丢弃还没处理的请求，FT_Face 交给后台线程关闭
+			std::erase_if(m_request, [owner](Request const& r) { return r.owner == owner; });
+			m_closing.emplace_back(std::move(it->second));
+			m_client.erase(it);
+			if (m_client.empty())
+			{
+				// 最后一个字形管理器也分离了，线程关闭字体后退出
+				lock.unlock();
+				stop();
+				return;
+			}
+			m_cv.notify_one();
+			m_closed_cv.wait(lock, [this]() { return m_closing.empty(); });
+		}
+		void request(TrueTypeGlyphManager_D3D11* owner, GlyphRasterizeRequest const& request)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_lock);
+				m_request.push_back(Request{ owner, request });
+			}
+			m_cv.notify_one();
+		}
+		void receive(TrueTypeGlyphManager_D3D11* owner, std::vector<GlyphRasterizeResult>& result)
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			auto it = m_client.find(owner);
+			if (it != m_client.end())
+			{
+				result.swap(it->second->result);
+			}
+		}
+
+	public:
+		~SharedGlyphRasterizer()
+		{
+			// 正常情况下所有字形管理器都已经分离，线程已经退出
+			if (m_worker.joinable())
+			{
+				stop();
+			}
+		}
+		static SharedGlyphRasterizer& get()
+		{
+			static SharedGlyphRasterizer v;
+			return v;
+		}
+	};
+
+	// 字形磁盘缓存
+
+	struct GlyphDiskCacheHeader
+	{
+		char magic[8];
+		uint32_t format_version;
+		uint32_t freetype_version;
+		uint64_t font_key;
+		uint32_t texture_size;
+		uint32_t texture_count;
+		uint32_t glyph_count;
+		uint32_t reserved;
+		uint64_t payload_hash;
+		uint64_t payload_size;
+	};
+
+	struct GlyphDiskCacheFontKey
+	{
+		uint64_t source_hash;
+		uint64_t source_size;
+		uint32_t face_index;
+		uint32_t pixel_width;
+		uint32_t pixel_height;
+		uint32_t reserved;
+	};
+
+	// 纹理只保存已经使用的行，而且只保存 alpha 通道，其余通道恒为白色
+	struct GlyphDiskCachePage
+	{
+		uint32_t pen_x;
+		uint32_t pen_y;
+		uint32_t pen_bottom;
+		uint32_t row_count;
+	};
+
+	struct GlyphDiskCacheGlyph
+	{
+		uint32_t codepoint;
+		uint32_t texture_index;
+		float texture_rect[4];
+		float size[2];
+		float position[2];
+		float advance[2];
+	};
+
+	constexpr char glyph_cache_magic[8] = { 'L', 'S', 'T', 'G', 'G', 'L', 'Y', 'F' };
+	constexpr uint32_t glyph_cache_format_version = 1;
+	constexpr uint32_t glyph_cache_freetype_version = (FREETYPE_MAJOR * 10000) + (FREETYPE_MINOR * 100) + FREETYPE_PATCH;
+
+	static std::filesystem::path const& getGlyphCacheDirectory()
+	{
+		static bool initialized = false;
+		static std::filesystem::path directory;
+		if (!initialized)
+		{
+			auto const& config = core::ConfigurationLoader::getInstance().getFileSystem();
+			if (config.hasUser())
+			{
+				core::ConfigurationLoader::resolvePathWithPredefinedVariables(config.getUser(), directory, true);
+				directory /= L"cache/glyph";
+			}
+			else
+			{
+				directory = L"cache/glyph";
+			}
+			std::error_code ec;
+			std::filesystem::create_directories(directory, ec);
+			initialized = true;
+		}
+		return directory;
+	}
+
+	static std::filesystem::path getGlyphCacheFilePath(uint64_t key)
+	{
+		return getGlyphCacheDirectory() / fmt::format("{:016x}.glyph", key);
+	}
+
 #define G_FT_Library (SharedFreeTypeLibrary::get().lib)
 
 	// 宽度单位到像素
@@ -131,10 +480,13 @@ namespace Core::Graphics
 		{
 			// 准备数据
 			FreeTypeFontData& data = m_font[i];
+			data.face_index = (FT_Long)fonts[i].font_face;
+			data.pixel_width = (FT_UInt)fonts[i].font_size.x;
+			data.pixel_height = (FT_UInt)fonts[i].font_size.y;
 			auto setupFontFace = [&]()
 			{
 				// 设置一些参数
-				if (FT_Err_Ok != FT_Set_Pixel_Sizes(data.ft_face, (FT_UInt)fonts[i].font_size.x, (FT_UInt)fonts[i].font_size.y))
+				if (FT_Err_Ok != FT_Set_Pixel_Sizes(data.ft_face, data.pixel_width, data.pixel_height))
 				{
 					FT_Done_Face(data.ft_face);
 					data.ft_face = NULL;
@@ -147,8 +499,9 @@ namespace Core::Graphics
 			};
 			auto openFromFile = [&](std::string_view path)
 			{
-				// 打开
-				if (FT_Err_Ok != FT_New_Face(G_FT_Library, path.data(), (FT_Long)fonts[i].font_face, &data.ft_face))
+				// 打开，记住路径，后台线程需要再打开一次
+				data.path = path;
+				if (FT_Err_Ok != FT_New_Face(G_FT_Library, data.path.c_str(), data.face_index, &data.ft_face))
 				{
 					return;
 				}
@@ -157,7 +510,7 @@ namespace Core::Graphics
 			auto openFromBuffer = [&]()
 			{
 				// 打开
-				if (FT_Err_Ok != FT_New_Memory_Face(G_FT_Library, (FT_Byte*)data.buffer.data(), (FT_Long)data.buffer.size(), (FT_Long)fonts[i].font_face, &data.ft_face))
+				if (FT_Err_Ok != FT_New_Memory_Face(G_FT_Library, (FT_Byte*)data.buffer.data(), (FT_Long)data.buffer.size(), data.face_index, &data.ft_face))
 				{
 					return;
 				}
@@ -240,16 +593,17 @@ namespace Core::Graphics
 		//t.texture->setPremultipliedAlpha(true); // 为了支持彩色文本，需要使用预乘 alpha 模式
 		return true;
 	}
-	bool TrueTypeGlyphManager_D3D11::findGlyph(FT_ULong code, FT_Face& face, FT_UInt& index)
+	bool TrueTypeGlyphManager_D3D11::findGlyph(FT_ULong code, uint32_t& font_index, FT_UInt& index)
 	{
-		for (auto& f : m_font)
+		for (size_t n = 0; n < m_font.size(); n += 1)
 		{
+			auto& f = m_font[n];
 			if (f.ft_face)
 			{
 				FT_UInt const i = FT_Get_Char_Index(f.ft_face, code);
 				if (i != 0 || f.is_fallback)
 				{
-					face = f.ft_face;
+					font_index = (uint32_t)n;
 					index = i;
 					return true;
 				}
@@ -257,10 +611,10 @@ namespace Core::Graphics
 		}
 		return false;
 	}
-	bool TrueTypeGlyphManager_D3D11::writeBitmapToCache(GlyphCacheInfo& info, FT_Bitmap& bitmap)
+	bool TrueTypeGlyphManager_D3D11::writeBitmapToCache(GlyphCacheInfo& info, GlyphBitmap const& bitmap)
 	{
 		// 太大的不要，滚
-		if (bitmap.width > (TEXTURE_SIZE - 2) || bitmap.rows > (TEXTURE_SIZE - 2))
+		if (bitmap.width > (TEXTURE_SIZE - 2) || bitmap.height > (TEXTURE_SIZE - 2))
 		{
 			assert(false); return false;
 		}
@@ -277,7 +631,7 @@ namespace Core::Graphics
 					t.pen_y = 1;
 				}
 				// 这行能塞下吗，留出 1 像素右下边缘
-				if ((t.pen_x + bitmap.width) < (t.image.width - 1) && (t.pen_y + bitmap.rows) < (t.image.height - 1))
+				if ((t.pen_x + bitmap.width) < (t.image.width - 1) && (t.pen_y + bitmap.height) < (t.image.height - 1))
 				{
 					pt = &t;
 					break;
@@ -286,7 +640,7 @@ namespace Core::Graphics
 				uint32_t const new_pen_x = 1;
 				uint32_t const new_pen_y = std::max(t.pen_y, t.pen_bottom + 1);
 				// 这行能塞下吗，留出 1 像素右下边缘
-				if ((new_pen_x + bitmap.width) < (t.image.width - 1) && (new_pen_y + bitmap.rows) < (t.image.height - 1))
+				if ((new_pen_x + bitmap.width) < (t.image.width - 1) && (new_pen_y + bitmap.height) < (t.image.height - 1))
 				{
 					t.pen_x = new_pen_x;
 					t.pen_y = new_pen_y;
@@ -313,25 +667,25 @@ namespace Core::Graphics
 		info.texture_rect.a.x = (float)t.pen_x / (float)t.image.width;
 		info.texture_rect.a.y = (float)t.pen_y / (float)t.image.height;
 		info.texture_rect.b.x = (float)(t.pen_x + bitmap.width) / (float)t.image.width;
-		info.texture_rect.b.y = (float)(t.pen_y + bitmap.rows) / (float)t.image.height;
+		info.texture_rect.b.y = (float)(t.pen_y + bitmap.height) / (float)t.image.height;
 		// 写入 bitmap 数据，同时写入 1 像素宽的透明边缘，写的有点乱，主要是为了最大化减少 CPU Cache Miss
 		FT_Bitmap_Accessor accessor(bitmap);
-		for (int x = 0; x < (int)(accessor.width() + 2); x += 1) // 上 1 像素宽的边，宽度是 bitmap 的宽度再加 2 像素
+		for (int x = 0; x < (int)(bitmap.width + 2); x += 1) // 上 1 像素宽的边，宽度是 bitmap 的宽度再加 2 像素
 		{
 			t.image.pixel(t.pen_x - 1 + x, t.pen_y - 1) = Color4B(0x00FFFFFF);
 		}
-		for (int y = 0; y < (int)accessor.height(); y += 1)
+		for (int y = 0; y < (int)bitmap.height; y += 1)
 		{
 			t.image.pixel(t.pen_x - 1, t.pen_y + y) = Color4B(0x00FFFFFF); // 左 1 像素宽的边
-			for (int x = 0; x < (int)accessor.width(); x += 1)
+			for (int x = 0; x < (int)bitmap.width; x += 1)
 			{
-				t.image.pixel(t.pen_x + x, t.pen_y + y) = accessor.pixel(x, y);
+				t.image.pixel(t.pen_x + x, t.pen_y + y) = bitmap.pixels[(size_t)y * bitmap.width + x];
 			}
-			t.image.pixel(t.pen_x + accessor.width(), t.pen_y + y) = Color4B(0x00FFFFFF); // 右 1 像素宽的边
+			t.image.pixel(t.pen_x + bitmap.width, t.pen_y + y) = Color4B(0x00FFFFFF); // 右 1 像素宽的边
 		}
-		for (int x = 0; x < (int)(accessor.width() + 2); x += 1) // 下 1 像素宽的边，宽度是 bitmap 的宽度再加 2 像素
+		for (int x = 0; x < (int)(bitmap.width + 2); x += 1) // 下 1 像素宽的边，宽度是 bitmap 的宽度再加 2 像素
 		{
-			t.image.pixel(t.pen_x - 1 + x, t.pen_y + accessor.height()) = Color4B(0x00FFFFFF);
+			t.image.pixel(t.pen_x - 1 + x, t.pen_y + bitmap.height) = Color4B(0x00FFFFFF);
 		}
 		// 更新脏区域
 		if (t.dirty_l == INVALID_RECT)
@@ -339,46 +693,52 @@ namespace Core::Graphics
 			t.dirty_l = t.pen_x - 1;
 			t.dirty_t = t.pen_y - 1;
 			t.dirty_r = t.pen_x + bitmap.width + 1;
-			t.dirty_b = t.pen_y + bitmap.rows + 1;
+			t.dirty_b = t.pen_y + bitmap.height + 1;
 		}
 		else
 		{
 			t.dirty_l = std::min(t.dirty_l, t.pen_x - 1);
 			t.dirty_t = std::min(t.dirty_t, t.pen_y - 1);
 			t.dirty_r = std::max(t.dirty_r, t.pen_x + bitmap.width + 1);
-			t.dirty_b = std::max(t.dirty_b, t.pen_y + bitmap.rows + 1);
+			t.dirty_b = std::max(t.dirty_b, t.pen_y + bitmap.height + 1);
 		}
 		// 更新缓存
 		t.pen_x += bitmap.width + 1;
-		t.pen_bottom = std::max(t.pen_bottom, t.pen_y + bitmap.rows);
+		t.pen_bottom = std::max(t.pen_bottom, t.pen_y + bitmap.height);
+		m_disk_cache_dirty = true;
 		return true;
 	}
-	GlyphCacheInfo* TrueTypeGlyphManager_D3D11::getGlyphCacheInfo(uint32_t codepoint)
+	GlyphCacheInfo* TrueTypeGlyphManager_D3D11::getGlyphCacheInfo(uint32_t codepoint, bool async)
 	{
 		auto it = m_map.find(codepoint);
 		if (it != m_map.end())
 		{
+			// 需要立即可用时，不等后台线程了
+			if (!async && it->second.is_pending && renderCache(codepoint))
+			{
+				return &m_map[codepoint];
+			}
 			return &it->second;
 		}
-		else if (renderCache(codepoint))
+		bool const result = (async && m_async) ? requestCache(codepoint) : renderCache(codepoint);
+		if (result)
 		{
 			return &m_map[codepoint];
 		}
-		else
-		{
-			return nullptr;
-		}
+		return nullptr;
 	}
 	bool TrueTypeGlyphManager_D3D11::renderCache(uint32_t codepoint)
 	{
-		FT_Face face = nullptr;
+		uint32_t font_index = 0;
 		FT_UInt index = 0;
-		if (findGlyph((FT_ULong)codepoint, face, index))
+		if (findGlyph((FT_ULong)codepoint, font_index, index))
 		{
 			// 加载文字到字形槽并渲染
+			FT_Face face = m_font[font_index].ft_face;
 			FT_Load_Glyph(face, index, FT_LOAD_RENDER);
 			FT_GlyphSlot& glyph = face->glyph;
-			FT_Bitmap& bitmap = glyph->bitmap;
+			GlyphBitmap bitmap;
+			readGlyphBitmap(glyph->bitmap, bitmap);
 			// 写入对应属性
 			GlyphCacheInfo cache = {};
 			cache.size = Vector2F((float)glyph->bitmap.width, (float)glyph->bitmap.rows);
@@ -389,11 +749,325 @@ namespace Core::Graphics
 			{
 				return false;
 			}
-			// 塞表里
-			m_map.emplace(codepoint, cache);
+			// 塞表里，可能覆盖还在后台光栅化的字形
+			m_map.insert_or_assign(codepoint, cache);
+			m_disk_cache_dirty = true;
+			return true;
 		}
 		return false;
 	}
+	bool TrueTypeGlyphManager_D3D11::requestCache(uint32_t codepoint)
+	{
+		uint32_t font_index = 0;
+		FT_UInt index = 0;
+		if (!findGlyph((FT_ULong)codepoint, font_index, index))
+		{
+			return false;
+		}
+		// 只加载不渲染，FreeType 会预先计算好位图的尺寸和位置，足够用来排版
+		FT_Face face = m_font[font_index].ft_face;
+		if (FT_Err_Ok != FT_Load_Glyph(face, index, FT_LOAD_DEFAULT))
+		{
+			return renderCache(codepoint);
+		}
+		FT_GlyphSlot& glyph = face->glyph;
+		// 点阵字形已经加载好了，空白字形不需要光栅化，都直接写入
+		if (glyph->format == FT_GLYPH_FORMAT_BITMAP || glyph->bitmap.width == 0 || glyph->bitmap.rows == 0)
+		{
+			return renderCache(codepoint);
+		}
+		GlyphCacheInfo cache = {};
+		cache.size = Vector2F((float)glyph->bitmap.width, (float)glyph->bitmap.rows);
+		cache.position = Vector2F((float)glyph->bitmap_left, (float)glyph->bitmap_top);
+		cache.advance = Vector2F((float)glyph->advance.x / 64.f, (float)glyph->advance.y / 64.f);
+		cache.is_pending = true;
+		cache.codepoint = codepoint;
+		m_map.insert_or_assign(codepoint, cache);
+		// 交给后台线程，结果在下一次 flush 时写入纹理
+		SharedGlyphRasterizer::get().request(this, GlyphRasterizeRequest{ codepoint, font_index, index });
+		return true;
+	}
+	bool TrueTypeGlyphManager_D3D11::receiveCache()
+	{
+		if (!m_async)
+		{
+			return true;
+		}
+		std::vector<GlyphRasterizeResult> result;
+		SharedGlyphRasterizer::get().receive(this, result);
+		for (auto& r : result)
+		{
+			auto it = m_map.find(r.codepoint);
+			if (it == m_map.end() || !it->second.is_pending)
+			{
+				continue; // 已经被同步缓存了
+			}
+			if (!r.success)
+			{
+				renderCache(r.codepoint); // 后台线程失败了，在主线程再试一次
+				continue;
+			}
+			GlyphCacheInfo& info = it->second;
+			info.size = r.size;
+			info.position = r.position;
+			if (!writeBitmapToCache(info, r.bitmap))
+			{
+				return false;
+			}
+			info.is_pending = false;
+			m_disk_cache_dirty = true;
+		}
+		return true;
+	}
+	void TrueTypeGlyphManager_D3D11::startWorker()
+	{
+		m_async = SharedGlyphRasterizer::get().attach(this, m_font);
+		if (!m_async)
+		{
+			spdlog::warn("[core] 无法创建字形光栅化线程，将在主线程光栅化字形");
+		}
+	}
+	void TrueTypeGlyphManager_D3D11::stopWorker()
+	{
+		if (!m_async)
+		{
+			return;
+		}
+		SharedGlyphRasterizer::get().detach(this);
+		m_async = false;
+	}
+
+	void TrueTypeGlyphManager_D3D11::initDiskCache()
+	{
+		// 以文件方式打开的字体没有读进内存，不方便校验内容，不参与缓存
+		std::vector<GlyphDiskCacheFontKey> keys;
+		keys.reserve(m_font.size());
+		for (auto const& f : m_font)
+		{
+			if (f.buffer.empty())
+			{
+				return;
+			}
+			GlyphDiskCacheFontKey key{};
+			key.source_hash = XXH3_64bits(f.buffer.data(), f.buffer.size());
+			key.source_size = f.buffer.size();
+			key.face_index = (uint32_t)f.face_index;
+			key.pixel_width = f.pixel_width;
+			key.pixel_height = f.pixel_height;
+			keys.push_back(key);
+		}
+		m_disk_cache_key = XXH3_64bits(keys.data(), keys.size() * sizeof(GlyphDiskCacheFontKey));
+		m_disk_cache_enable = true;
+	}
+	bool TrueTypeGlyphManager_D3D11::loadDiskCache()
+	{
+		if (!m_disk_cache_enable)
+		{
+			return false;
+		}
+		std::ifstream file(getGlyphCacheFilePath(m_disk_cache_key), std::ios::in | std::ios::binary);
+		if (!file.is_open())
+		{
+			return false;
+		}
+		GlyphDiskCacheHeader header{};
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		{
+			return false;
+		}
+		if (std::memcmp(header.magic, glyph_cache_magic, sizeof(glyph_cache_magic)) != 0
+			|| header.format_version != glyph_cache_format_version
+			|| header.freetype_version != glyph_cache_freetype_version
+			|| header.font_key != m_disk_cache_key
+			|| header.texture_size != TEXTURE_SIZE
+			|| header.texture_count == 0
+			|| header.payload_size > (uint64_t)INT32_MAX)
+		{
+			return false;
+		}
+		std::vector<uint8_t> payload((size_t)header.payload_size);
+		if (!file.read(reinterpret_cast<char*>(payload.data()), (std::streamsize)payload.size()))
+		{
+			return false;
+		}
+		if (XXH3_64bits(payload.data(), payload.size()) != header.payload_hash)
+		{
+			spdlog::warn("[core] 字形缓存'{:016x}'已损坏", m_disk_cache_key);
+			return false;
+		}
+
+		size_t offset = 0;
+		auto read = [&](void* output, size_t size) -> bool
+		{
+			if (size > payload.size() - offset)
+			{
+				return false;
+			}
+			std::memcpy(output, payload.data() + offset, size);
+			offset += size;
+			return true;
+		};
+		auto fail = [&]() -> bool
+		{
+			m_tex.clear();
+			m_map.clear();
+			return false;
+		};
+
+		for (uint32_t i = 0; i < header.texture_count; i += 1)
+		{
+			GlyphDiskCachePage page{};
+			if (!read(&page, sizeof(page))
+				|| page.pen_x > TEXTURE_SIZE || page.pen_y > TEXTURE_SIZE || page.pen_bottom > TEXTURE_SIZE
+				|| page.row_count > TEXTURE_SIZE
+				|| ((size_t)page.row_count * TEXTURE_SIZE) > (payload.size() - offset))
+			{
+				return fail();
+			}
+			if (!addTexture())
+			{
+				return fail();
+			}
+			auto& t = m_tex.back();
+			uint8_t const* alpha = payload.data() + offset;
+			for (uint32_t y = 0; y < page.row_count; y += 1)
+			{
+				for (uint32_t x = 0; x < TEXTURE_SIZE; x += 1)
+				{
+					t.image.pixel(x, y) = Color4B((uint32_t(alpha[(size_t)y * TEXTURE_SIZE + x]) << 24) | 0x00FFFFFFu);
+				}
+			}
+			offset += (size_t)page.row_count * TEXTURE_SIZE;
+			t.pen_x = page.pen_x;
+			t.pen_y = page.pen_y;
+			t.pen_bottom = page.pen_bottom;
+			// 等第一次 flush 时上传
+			if (page.row_count > 0)
+			{
+				t.dirty_l = 0;
+				t.dirty_t = 0;
+				t.dirty_r = t.image.width;
+				t.dirty_b = page.row_count;
+			}
+		}
+
+		m_map.reserve(header.glyph_count);
+		for (uint32_t i = 0; i < header.glyph_count; i += 1)
+		{
+			GlyphDiskCacheGlyph glyph{};
+			if (!read(&glyph, sizeof(glyph)) || glyph.texture_index >= header.texture_count)
+			{
+				return fail();
+			}
+			GlyphCacheInfo cache = {};
+			cache.texture_index = glyph.texture_index;
+			cache.texture_rect = RectF(glyph.texture_rect[0], glyph.texture_rect[1], glyph.texture_rect[2], glyph.texture_rect[3]);
+			cache.size = Vector2F(glyph.size[0], glyph.size[1]);
+			cache.position = Vector2F(glyph.position[0], glyph.position[1]);
+			cache.advance = Vector2F(glyph.advance[0], glyph.advance[1]);
+			cache.codepoint = glyph.codepoint;
+			m_map.insert_or_assign(glyph.codepoint, cache);
+		}
+
+		m_disk_cache_dirty = false;
+		return true;
+	}
+	void TrueTypeGlyphManager_D3D11::saveDiskCache()
+	{
+		if (!m_disk_cache_enable || !m_disk_cache_dirty || m_tex.empty())
+		{
+			return;
+		}
+
+		std::vector<uint8_t> payload;
+		auto write = [&](void const* data, size_t size)
+		{
+			auto const* p = static_cast<uint8_t const*>(data);
+			payload.insert(payload.end(), p, p + size);
+		};
+
+		for (auto& t : m_tex)
+		{
+			GlyphDiskCachePage page{};
+			page.pen_x = t.pen_x;
+			page.pen_y = t.pen_y;
+			page.pen_bottom = t.pen_bottom;
+			page.row_count = (t.pen_x == 0 && t.pen_y == 0) ? 0 : std::min<uint32_t>(t.pen_bottom + 2, t.image.height); // 多一个像素的边缘
+			write(&page, sizeof(page));
+			size_t const base = payload.size();
+			payload.resize(base + (size_t)page.row_count * TEXTURE_SIZE);
+			for (uint32_t y = 0; y < page.row_count; y += 1)
+			{
+				for (uint32_t x = 0; x < TEXTURE_SIZE; x += 1)
+				{
+					payload[base + (size_t)y * TEXTURE_SIZE + x] = t.image.pixel(x, y).a;
+				}
+			}
+		}
+
+		uint32_t glyph_count = 0;
+		for (auto const& [codepoint, info] : m_map)
+		{
+			if (info.is_pending)
+			{
+				continue; // 还没写入纹理
+			}
+			GlyphDiskCacheGlyph glyph{};
+			glyph.codepoint = codepoint;
+			glyph.texture_index = info.texture_index;
+			glyph.texture_rect[0] = info.texture_rect.a.x;
+			glyph.texture_rect[1] = info.texture_rect.a.y;
+			glyph.texture_rect[2] = info.texture_rect.b.x;
+			glyph.texture_rect[3] = info.texture_rect.b.y;
+			glyph.size[0] = info.size.x;
+			glyph.size[1] = info.size.y;
+			glyph.position[0] = info.position.x;
+			glyph.position[1] = info.position.y;
+			glyph.advance[0] = info.advance.x;
+			glyph.advance[1] = info.advance.y;
+			write(&glyph, sizeof(glyph));
+			glyph_count += 1;
+		}
+
+		GlyphDiskCacheHeader header{};
+		std::memcpy(header.magic, glyph_cache_magic, sizeof(glyph_cache_magic));
+		header.format_version = glyph_cache_format_version;
+		header.freetype_version = glyph_cache_freetype_version;
+		header.font_key = m_disk_cache_key;
+		header.texture_size = TEXTURE_SIZE;
+		header.texture_count = (uint32_t)m_tex.size();
+		header.glyph_count = glyph_count;
+		header.payload_hash = XXH3_64bits(payload.data(), payload.size());
+		header.payload_size = payload.size();
+
+		// 先写入临时文件再替换，避免留下写了一半的缓存
+		std::filesystem::path const path = getGlyphCacheFilePath(m_disk_cache_key);
+		std::filesystem::path temp_path(path);
+		temp_path += L".tmp";
+		{
+			std::ofstream file(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				return;
+			}
+			file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+			file.write(reinterpret_cast<char const*>(payload.data()), (std::streamsize)payload.size());
+			if (!file.good())
+			{
+				file.close();
+				std::error_code ec;
+				std::filesystem::remove(temp_path, ec);
+				return;
+			}
+		}
+		std::error_code ec;
+		std::filesystem::rename(temp_path, path, ec);
+		if (ec)
+		{
+			std::filesystem::remove(temp_path, ec);
+		}
+		m_disk_cache_dirty = false;
+	}
 
 	float TrueTypeGlyphManager_D3D11::getLineHeight()
 	{
@@ -423,7 +1097,7 @@ namespace Core::Graphics
 
 	bool TrueTypeGlyphManager_D3D11::cacheGlyph(uint32_t codepoint)
 	{
-		if (!getGlyphCacheInfo(codepoint))
+		if (!getGlyphCacheInfo(codepoint, false))
 			return false;
 		return true;
 	}
@@ -435,7 +1109,7 @@ namespace Core::Graphics
 		bool result_ = true;
 		while (reader_(code_))
 		{
-			if (!getGlyphCacheInfo(code_))
+			if (!getGlyphCacheInfo(code_, false))
 				if (code_ != U'\n')
 					result_ = false;
 		}
@@ -443,6 +1117,11 @@ namespace Core::Graphics
 	}
 	bool TrueTypeGlyphManager_D3D11::flush()
 	{
+		// 先收下后台线程光栅化好的字形
+		if (!receiveCache())
+		{
+			return false;
+		}
 		for (auto& t : m_tex)
 		{
 			if (t.dirty_l != INVALID_RECT)
@@ -469,13 +1148,14 @@ namespace Core::Graphics
 		{
 			assert(false); return false;
 		}
-		if (GlyphCacheInfo* info = getGlyphCacheInfo(codepoint))
+		if (GlyphCacheInfo* info = getGlyphCacheInfo(codepoint, true))
 		{
 			p_ref_info->texture_index = info->texture_index;
 			p_ref_info->texture_rect = info->texture_rect;
 			p_ref_info->size = info->size;
 			p_ref_info->position = info->position;
 			p_ref_info->advance = info->advance;
+			p_ref_info->is_pending = info->is_pending;
 			return no_render ? true : flush();
 		}
 		return false;
@@ -488,16 +1168,20 @@ namespace Core::Graphics
 		{
 			throw std::runtime_error("TrueTypeGlyphManager_D3D11::TrueTypeGlyphManager_D3D11 (openFonts)");
 		}
-		if (!addTexture())
+		initDiskCache();
+		if (!loadDiskCache() && !addTexture())
 		{
 			throw std::runtime_error("TrueTypeGlyphManager_D3D11::TrueTypeGlyphManager_D3D11 (addTexture)");
 		}
 		cacheGlyph(uint32_t(U' ')); // 先缓存一个空格
+		startWorker();
 		m_device->addEventListener(this);
 	}
 	TrueTypeGlyphManager_D3D11::~TrueTypeGlyphManager_D3D11()
 	{
 		m_device->removeEventListener(this);
+		stopWorker();
+		saveDiskCache();
 		closeFonts();
 	}
 
@@ -732,11 +1416,7 @@ namespace Core::Graphics
 			return false;
 		}
 
-		// 首先，缓存所有字形
-		if (!m_glyphmgr->cacheString(str))
-		{
-			//return false; // 找不到的就忽略
-		}
+		// 首先，上传已经光栅化好的字形，没有缓存的字形会在 getGlyph 时交给后台线程，晚一帧再绘制
 		if (!m_glyphmgr->flush())
 		{
 			return false;
@@ -782,11 +1462,14 @@ namespace Core::Graphics
 				if (m_glyphmgr->getGlyph(code_, &glyph_info, true)) // 不要在这里 flush
 				{
 					// 绘制字形
-					glyph_info.size.x *= m_scale.x;
-					glyph_info.size.y *= m_scale.y;
-					glyph_info.position.x *= m_scale.x;
-					glyph_info.position.y *= m_scale.y;
-					if (!drawGlyph(glyph_info, start_pos)) return false;
+					if (!glyph_info.is_pending) // 还在后台光栅化的字形只前进，不绘制
+					{
+						glyph_info.size.x *= m_scale.x;
+						glyph_info.size.y *= m_scale.y;
+						glyph_info.position.x *= m_scale.x;
+						glyph_info.position.y *= m_scale.y;
+						if (!drawGlyph(glyph_info, start_pos)) return false;
+					}
 
 					// 前进
 					glyph_info.advance.x *= m_scale.x;
@@ -824,7 +1507,7 @@ namespace Core::Graphics
 					if (m_glyphmgr->getGlyph(code_, &glyph_info, true)) // 不要在这里 flush
 					{
 						// 绘制字形
-						if (glyph_info.texture_index == idx)
+						if (glyph_info.texture_index == idx && !glyph_info.is_pending)
 						{
 							glyph_info.size.x *= m_scale.x;
 							glyph_info.size.y *= m_scale.y;
@@ -859,11 +1542,7 @@ namespace Core::Graphics
 			assert(false); return false;
 		}
 
-		// 首先，缓存所有字形
-		if (!m_glyphmgr->cacheString(str))
-		{
-			//return false; // 找不到的就忽略
-		}
+		// 首先，上传已经光栅化好的字形，没有缓存的字形会在 getGlyph 时交给后台线程，晚一帧再绘制
 		if (!m_glyphmgr->flush())
 		{
 			return false;
@@ -910,11 +1589,14 @@ namespace Core::Graphics
 				if (m_glyphmgr->getGlyph(code_, &glyph_info, true)) // 不要在这里 flush
 				{
 					// 绘制
-					glyph_info.size.x *= m_scale.x;
-					glyph_info.size.y *= m_scale.y;
-					glyph_info.position.x *= m_scale.x;
-					glyph_info.position.y *= m_scale.y;
-					if (!drawGlyphInSpace(glyph_info, start_pos, right_vec, down_vec)) return false;
+					if (!glyph_info.is_pending) // 还在后台光栅化的字形只前进，不绘制
+					{
+						glyph_info.size.x *= m_scale.x;
+						glyph_info.size.y *= m_scale.y;
+						glyph_info.position.x *= m_scale.x;
+						glyph_info.position.y *= m_scale.y;
+						if (!drawGlyphInSpace(glyph_info, start_pos, right_vec, down_vec)) return false;
+					}
 
 					// 前进
 					glyph_info.advance.x *= m_scale.x;
@@ -953,7 +1635,7 @@ namespace Core::Graphics
 					if (m_glyphmgr->getGlyph(code_, &glyph_info, true)) // 不要在这里 flush
 					{
 						// 绘制
-						if (glyph_info.texture_index == idx)
+						if (glyph_info.texture_index == idx && !glyph_info.is_pending)
 						{
 							glyph_info.size.x *= m_scale.x;
 							glyph_info.size.y *= m_scale.y;
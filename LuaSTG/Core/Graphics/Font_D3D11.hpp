@@ -1,6 +1,9 @@
 ﻿#pragma once
 #include "Core/Object.hpp"
 #include "Core/Graphics/Font.hpp"
+#include <mutex>
+#include <condition_variable>
+#include <deque>
 
 #include "ft2build.h"
 #include FT_FREETYPE_H
@@ -44,14 +47,42 @@ namespace Core::Graphics
 		Vector2F size;              // 字形大小
 		Vector2F position;          // 笔触距离字形左上角坐标
 		Vector2F advance;           // 前进量
+		bool     is_pending = false; // 字形位图还在后台光栅化
 		// 私有
 		uint32_t codepoint = 0;     // 当前的字符
 	};
 
+	struct GlyphBitmap
+	{
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<Color4B> pixels;
+	};
+
+	struct GlyphRasterizeRequest
+	{
+		uint32_t codepoint = 0;
+		uint32_t font_index = 0;
+		FT_UInt glyph_index = 0;
+	};
+
+	struct GlyphRasterizeResult
+	{
+		uint32_t codepoint = 0;
+		bool success = false;
+		Vector2F size;
+		Vector2F position;
+		GlyphBitmap bitmap;
+	};
+
 	struct FreeTypeFontData
 	{
 		std::vector<uint8_t> buffer;
+		std::string path; // 以文件方式打开时的路径
 		FT_Face ft_face{ NULL };
+		FT_Long face_index{ 0 };
+		FT_UInt pixel_width{ 0 };
+		FT_UInt pixel_height{ 0 };
 		float ft_line_height{ 0.0f };
 		float ft_ascender{ 0.0f };
 		float ft_descender{ 0.0f };
@@ -75,6 +106,12 @@ namespace Core::Graphics
 		std::vector<FreeTypeFontData> m_font;
 		std::vector<GlyphCache2D> m_tex;
 		std::unordered_map<uint32_t, GlyphCacheInfo> m_map;
+		// 是否已经接入所有字形管理器共用的后台光栅化线程
+		bool m_async{ false };
+		// 磁盘缓存
+		uint64_t m_disk_cache_key{ 0 };
+		bool m_disk_cache_enable{ false };
+		bool m_disk_cache_dirty{ false };
 
 	public:
 		void onDeviceCreate();
@@ -84,10 +121,17 @@ namespace Core::Graphics
 		void closeFonts();
 		bool openFonts(TrueTypeFontInfo* fonts, size_t count);
 		bool addTexture();
-		bool findGlyph(FT_ULong code, FT_Face& face, FT_UInt& index);
-		bool writeBitmapToCache(GlyphCacheInfo& info, FT_Bitmap& bitmap);
-		GlyphCacheInfo* getGlyphCacheInfo(uint32_t codepoint);
+		bool findGlyph(FT_ULong code, uint32_t& font_index, FT_UInt& index);
+		bool writeBitmapToCache(GlyphCacheInfo& info, GlyphBitmap const& bitmap);
+		GlyphCacheInfo* getGlyphCacheInfo(uint32_t codepoint, bool async);
 		bool renderCache(uint32_t codepoint);
+		bool requestCache(uint32_t codepoint);
+		bool receiveCache();
+		void startWorker();
+		void stopWorker();
+		void initDiskCache();
+		bool loadDiskCache();
+		void saveDiskCache();
 
 	public:
 		float getLineHeight();
@@ -119,7 +163,6 @@ namespace Core::Graphics
 		Color4B m_color;
 
 	private:
-		bool drawGlyph(GlyphInfo const& glyph_info, Vector2F const& start_pos);
 		bool drawGlyphInSpace(GlyphInfo const& glyph_info, Vector3F const& start_pos, Vector3F const& right_vec, Vector3F const& down_vec);
 
 	public:
@@ -138,6 +181,7 @@ namespace Core::Graphics
 		bool drawTextInSpace(StringView str,
 			Vector3F const& start, Vector3F const& right_vec, Vector3F const& down_vec,
 			Vector3F* endout);
+		bool drawGlyph(GlyphInfo const& glyph_info, Vector2F const& start_pos);
 
 	public:
 		TextRenderer_D3D11(IRenderer* p_renderer);
@@ -123,7 +123,11 @@ namespace Core::Graphics
 			DrawVertex(float const x_, float const y_, float const u_, float const v_)
 				: x(x_), y(y_), z(0.5f), u(u_), v(v_), color(0xFFFFFFFFu) {} // TODO: z = 0.0f or z = 0.5f ?
 		};
+	#ifdef LUASTG_GRAPHICS_INDEX32
+		using DrawIndex = uint32_t;
+	#else
 		using DrawIndex = uint16_t;
+	#endif
 
 		virtual bool beginBatch() = 0;
 		virtual bool endBatch() = 0;
@@ -153,7 +157,26 @@ namespace Core::Graphics
 		virtual bool drawQuad(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3, DrawVertex const& v4) = 0;
 		virtual bool drawQuad(DrawVertex const* pvert) = 0;
 		virtual bool drawRaw(DrawVertex const* pvert, uint16_t nvert, DrawIndex const* pidx, uint16_t nidx) = 0;
-		virtual bool drawRequest(uint16_t nvert, uint16_t nidx, DrawVertex** ppvert, DrawIndex** ppidx, uint16_t* idxoffset) = 0;
+		virtual bool drawRequest(uint16_t nvert, uint16_t nidx, DrawVertex** ppvert, DrawIndex** ppidx, DrawIndex* idxoffset) = 0;
+
+		// 实例化绘制图片精灵，四个顶点在顶点着色器中根据精灵表展开，每个实例只需要上传 28 字节
+		struct SpriteInstanceSprite
+		{
+			RectF uv;   // 归一化纹理坐标
+			RectF rect; // 以精灵中心为原点、已经乘以 units per pixel 的四边形范围，y 轴朝上
+		};
+		struct SpriteInstance
+		{
+			Vector2F position;
+			float rotation;
+			Vector2F scale;
+			uint32_t color;  // 四个顶点共用同一个顶点颜色
+			uint32_t sprite; // 精灵表中的位置
+		};
+		static constexpr uint32_t max_sprite_instance_table_size = 1024;
+		// 使用当前的纹理和渲染状态绘制，z 固定为 0.5；精灵表不能超过 max_sprite_instance_table_size
+		// 渲染器不支持实例化绘制时返回 false，调用者应退回逐顶点绘制
+		virtual bool drawSpriteInstances(SpriteInstanceSprite const* p_sprites, uint32_t sprite_count, SpriteInstance const* p_instances, uint32_t instance_count) = 0;
 
 		virtual bool createPostEffectShader(StringView path, IPostEffectShader** pp_effect) = 0;
 		virtual bool drawPostEffect(
@@ -167,8 +190,20 @@ namespace Core::Graphics
 		virtual bool createModel(StringView path, IModel** pp_model) = 0;
 		virtual bool drawModel(IModel* p_model) = 0;
 
+		struct TextureCopyRegion
+		{
+			ITexture2D* source{};
+			RectU source_rect;
+			Vector2U target_position;
+		};
+		// 清空渲染目标后把纹理区域逐个原样复制进去（不缩放、不过滤），结果为预乘 alpha；不影响当前的渲染状态
+		virtual bool copyTextureRegions(IRenderTarget* p_target, TextureCopyRegion const* p_regions, size_t count) = 0;
+
 		virtual ISamplerState* getKnownSamplerState(SamplerState state) = 0;
 
+		// 累计产生的 GPU 绘制命令数量，调用者自行按帧求差
+		virtual uint64_t getDrawCommandCount() = 0;
+
 		static bool create(IDevice* p_device, IRenderer** pp_renderer);
 	};
 }
@@ -5,6 +5,8 @@
 
 namespace Core::Graphics
 {
+	constexpr DXGI_FORMAT draw_index_format = sizeof(IRenderer::DrawIndex) < 4 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+
 	inline ID3D11ShaderResourceView* get_view(Texture2D_D3D11* p)
 	{
 		return p ? p->GetView() : NULL;
@@ -167,8 +169,54 @@ namespace Core::Graphics
 		UINT offset[1] = { 0 };
 		m_device->GetD3D11DeviceContext()->IASetVertexBuffers(0, 1, vbo, stride, offset);
 
-		constexpr DXGI_FORMAT format = sizeof(DrawIndex) < 4 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
-		m_device->GetD3D11DeviceContext()->IASetIndexBuffer(vi.index_buffer.Get(), format, 0);
+		m_device->GetD3D11DeviceContext()->IASetIndexBuffer(vi.index_buffer.Get(), draw_index_format, 0);
+	}
+	bool Renderer_D3D11::createVertexIndexBuffer(VertexIndexBuffer& vi, size_t const vertex_capacity, size_t const index_capacity)
+	{
+		assert(m_device->GetD3D11Device());
+
+		HRESULT hr = 0;
+
+		vi.vertex_buffer.Reset();
+		vi.index_buffer.Reset();
+		vi.vertex_capacity = 0;
+		vi.index_capacity = 0;
+		vi.vertex_offset = 0;
+		vi.index_offset = 0;
+
+		{
+			D3D11_BUFFER_DESC desc_ = {
+				.ByteWidth = static_cast<UINT>(vertex_capacity * sizeof(DrawVertex)),
+				.Usage = D3D11_USAGE_DYNAMIC,
+				.BindFlags = D3D11_BIND_VERTEX_BUFFER,
+				.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+				.MiscFlags = 0,
+				.StructureByteStride = 0,
+			};
+			hr = gHR = m_device->GetD3D11Device()->CreateBuffer(&desc_, NULL, &vi.vertex_buffer);
+			if (FAILED(hr))
+				return false;
+			M_D3D_SET_DEBUG_NAME_SIMPLE(vi.vertex_buffer.Get());
+		}
+
+		{
+			D3D11_BUFFER_DESC desc_ = {
+				.ByteWidth = static_cast<UINT>(index_capacity * sizeof(DrawIndex)),
+				.Usage = D3D11_USAGE_DYNAMIC,
+				.BindFlags = D3D11_BIND_INDEX_BUFFER,
+				.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+				.MiscFlags = 0,
+				.StructureByteStride = 0,
+			};
+			hr = gHR = m_device->GetD3D11Device()->CreateBuffer(&desc_, NULL, &vi.index_buffer);
+			if (FAILED(hr))
+				return false;
+			M_D3D_SET_DEBUG_NAME_SIMPLE(vi.index_buffer.Get());
+		}
+
+		vi.vertex_capacity = vertex_capacity;
+		vi.index_capacity = index_capacity;
+		return true;
 	}
 	bool Renderer_D3D11::uploadVertexIndexBuffer(bool discard)
 	{
@@ -188,7 +236,7 @@ namespace Core::Graphics
 				spdlog::error("[core] ID3D11DeviceContext::Map -> #vertex_buffer[{}] 调用失败，无法上传顶点", _vi_buffer_index);
 				return false;
 			}
-			std::memcpy((DrawVertex*)res_.pData + vi_.vertex_offset, _draw_list.vertex.data, _draw_list.vertex.size * sizeof(DrawVertex));
+			std::memcpy((DrawVertex*)res_.pData + vi_.vertex_offset, _draw_list.vertex.data(), _draw_list.vertex.size * sizeof(DrawVertex));
 			m_device->GetD3D11DeviceContext()->Unmap(vi_.vertex_buffer.Get(), 0);
 		}
 		// copy index data
@@ -201,7 +249,7 @@ namespace Core::Graphics
 				spdlog::error("[core] ID3D11DeviceContext::Map -> #index_buffer[{}] 调用失败，无法上传顶点索引", _vi_buffer_index);
 				return false;
 			}
-			std::memcpy((DrawIndex*)res_.pData + vi_.index_offset, _draw_list.index.data, _draw_list.index.size * sizeof(DrawIndex));
+			std::memcpy((DrawIndex*)res_.pData + vi_.index_offset, _draw_list.index.data(), _draw_list.index.size * sizeof(DrawIndex));
 			m_device->GetD3D11DeviceContext()->Unmap(vi_.index_buffer.Get(), 0);
 		}
 		return true;
@@ -262,35 +310,10 @@ namespace Core::Graphics
 
 		for (auto& vi_ : _vi_buffer)
 		{
-			{
-				D3D11_BUFFER_DESC desc_ = {
-					.ByteWidth = sizeof(_draw_list.vertex.data),
-					.Usage = D3D11_USAGE_DYNAMIC,
-					.BindFlags = D3D11_BIND_VERTEX_BUFFER,
-					.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
-					.MiscFlags = 0,
-					.StructureByteStride = 0,
-				};
-				hr = gHR = m_device->GetD3D11Device()->CreateBuffer(&desc_, NULL, &vi_.vertex_buffer);
-				if (FAILED(hr))
-					return false;
-				M_D3D_SET_DEBUG_NAME_SIMPLE(vi_.vertex_buffer.Get());
-			}
-
-			{
-				D3D11_BUFFER_DESC desc_ = {
-					.ByteWidth = sizeof(_draw_list.index.data),
-					.Usage = D3D11_USAGE_DYNAMIC,
-					.BindFlags = D3D11_BIND_INDEX_BUFFER,
-					.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
-					.MiscFlags = 0,
-					.StructureByteStride = 0,
-				};
-				hr = gHR = m_device->GetD3D11Device()->CreateBuffer(&desc_, NULL, &vi_.index_buffer);
-				if (FAILED(hr))
-					return false;
-				M_D3D_SET_DEBUG_NAME_SIMPLE(vi_.index_buffer.Get());
-			}
+			if (!createVertexIndexBuffer(vi_,
+				std::max(_draw_list.vertex.capacity, DrawList::vertex_initial_capacity * _vi_buffer_scale),
+				std::max(_draw_list.index.capacity, DrawList::index_initial_capacity * _vi_buffer_scale)))
+				return false;
 		}
 
 		{
@@ -329,6 +352,28 @@ namespace Core::Graphics
 			if (FAILED(hr))
 				return false;
 			M_D3D_SET_DEBUG_NAME_SIMPLE(_user_float_buffer.Get());
+
+			desc_.ByteWidth = max_sprite_instance_table_size * sizeof(SpriteInstanceSprite);
+			hr = gHR = m_device->GetD3D11Device()->CreateBuffer(&desc_, NULL, &_sprite_table_buffer);
+			if (FAILED(hr))
+				return false;
+			M_D3D_SET_DEBUG_NAME_SIMPLE(_sprite_table_buffer.Get());
+		}
+
+		{
+			D3D11_BUFFER_DESC desc_ = {
+				.ByteWidth = static_cast<UINT>(_sprite_instance_capacity * sizeof(SpriteInstance)),
+				.Usage = D3D11_USAGE_DYNAMIC,
+				.BindFlags = D3D11_BIND_VERTEX_BUFFER,
+				.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+				.MiscFlags = 0,
+				.StructureByteStride = 0,
+			};
+			hr = gHR = m_device->GetD3D11Device()->CreateBuffer(&desc_, NULL, &_sprite_instance_buffer);
+			if (FAILED(hr))
+				return false;
+			M_D3D_SET_DEBUG_NAME_SIMPLE(_sprite_instance_buffer.Get());
+			_sprite_instance_offset = _sprite_instance_capacity; // 第一次写入时 DISCARD
 		}
 
 		return true;
@@ -648,13 +693,27 @@ namespace Core::Graphics
 	bool Renderer_D3D11::uploadVertexIndexBufferFromDrawList()
 	{
 		// upload data
-		if ((_draw_list.vertex.capacity - _vi_buffer[_vi_buffer_index].vertex_offset) < _draw_list.vertex.size
-			|| (_draw_list.index.capacity - _vi_buffer[_vi_buffer_index].index_offset) < _draw_list.index.size)
+		VertexIndexBuffer const& current_ = _vi_buffer[_vi_buffer_index];
+		if ((current_.vertex_capacity - static_cast<size_t>(current_.vertex_offset)) < _draw_list.vertex.size
+			|| (current_.index_capacity - current_.index_offset) < _draw_list.index.size)
 		{
 			// next  buffer
 			_vi_buffer_index = (_vi_buffer_index + 1) % _vi_buffer_count;
-			_vi_buffer[_vi_buffer_index].vertex_offset = 0;
-			_vi_buffer[_vi_buffer_index].index_offset = 0;
+			VertexIndexBuffer& next_ = _vi_buffer[_vi_buffer_index];
+			next_.vertex_offset = 0;
+			next_.index_offset = 0;
+			// the draw list has grown beyond this buffer
+			if (next_.vertex_capacity < _draw_list.vertex.size || next_.index_capacity < _draw_list.index.size)
+			{
+				if (!createVertexIndexBuffer(next_,
+					std::max(_draw_list.vertex.capacity, DrawList::vertex_initial_capacity * _vi_buffer_scale),
+					std::max(_draw_list.index.capacity, DrawList::index_initial_capacity * _vi_buffer_scale)))
+				{
+					spdlog::error("[core] 无法扩容顶点缓冲区 #vi_buffer[{}]", _vi_buffer_index);
+					clearDrawList();
+					return false;
+				}
+			}
 			// discard and copy
 			if (!uploadVertexIndexBuffer(true))
 			{
@@ -662,10 +721,7 @@ namespace Core::Graphics
 				return false;
 			}
 			// bind buffer
-			if (_vi_buffer_count > 1)
-			{
-				setVertexIndexBuffer(); // need to switch v/i buffers
-			}
+			setVertexIndexBuffer(); // need to switch v/i buffers
 		}
 		else
 		{
@@ -720,8 +776,9 @@ namespace Core::Graphics
 						bindTextureSamplerState(cmd_.texture.get());
 						bindTextureAlphaType(cmd_.texture.get());
 						ctx->DrawIndexed(cmd_.index_count, vi_.index_offset, vi_.vertex_offset);
+						_draw_command_count += 1;
 					}
-					vi_.vertex_offset += cmd_.vertex_count;
+					vi_.vertex_offset += static_cast<INT>(cmd_.vertex_count);
 					vi_.index_offset += cmd_.index_count;
 				}
 			}
@@ -777,6 +834,8 @@ namespace Core::Graphics
 		{
 			v.vertex_buffer.Reset();
 			v.index_buffer.Reset();
+			v.vertex_capacity = 0;
+			v.index_capacity = 0;
 			v.vertex_offset = 0;
 			v.index_offset = 0;
 		}
@@ -787,8 +846,15 @@ namespace Core::Graphics
 		_camera_pos_buffer.Reset();
 		_fog_data_buffer.Reset();
 		_user_float_buffer.Reset();
+		_sprite_table_buffer.Reset();
+		_sprite_instance_buffer.Reset();
 
 		_input_layout.Reset();
+		_sprite_instance_input_layout.Reset();
+		for (auto& v : _sprite_instance_vertex_shader)
+		{
+			v.Reset();
+		}
 		for (auto& v : _vertex_shader)
 		{
 			v.Reset();
@@ -1125,6 +1191,42 @@ namespace Core::Graphics
 		return is_same(*a, b);
 	}
 
+	DrawCommand& Renderer_D3D11::appendDrawCommand(Texture2D_D3D11* texture)
+	{
+		if (_draw_list.command.size >= _draw_list.command.data.size())
+		{
+			_draw_list.command.data.resize(_draw_list.command.data.size() * 2); // 命令数组直接扩容，不需要提交批次
+		}
+		_draw_list.command.size += 1;
+		DrawCommand& cmd_ = _draw_list.command.data[_draw_list.command.size - 1];
+		cmd_.texture = texture;
+		cmd_.vertex_count = 0;
+		cmd_.index_count = 0;
+		return cmd_;
+	}
+	DrawCommand* Renderer_D3D11::requestDrawSpace(size_t const nvert, size_t const nidx)
+	{
+		if (nvert > _draw_list.vertex.max_capacity || nidx > _draw_list.index.max_capacity || nvert > DrawList::command_vertex_limit)
+		{
+			assert(false); return nullptr;
+		}
+		// 优先扩容绘制列表，达到上限后才提交批次
+		if (!_draw_list.vertex.reserve(nvert) || !_draw_list.index.reserve(nidx))
+		{
+			if (!batchFlush()) return nullptr;
+			if (!_draw_list.vertex.reserve(nvert) || !_draw_list.index.reserve(nidx)) return nullptr;
+		}
+		assert(_draw_list.command.size > 0);
+		DrawCommand* cmd_ = &_draw_list.command.data[_draw_list.command.size - 1];
+		if ((cmd_->vertex_count + nvert) > DrawList::command_vertex_limit)
+		{
+			// 顶点索引已经无法表示更多顶点，用同一个纹理开始新的绘制命令
+			ScopeObject<Texture2D_D3D11> texture_ = cmd_->texture;
+			cmd_ = &appendDrawCommand(texture_.get());
+		}
+		return cmd_;
+	}
+
 	void Renderer_D3D11::setTexture(ITexture2D* texture)
 	{
 		if (_draw_list.command.size > 0 && is_same(_draw_list.command.data[_draw_list.command.size - 1].texture, texture))
@@ -1134,15 +1236,7 @@ namespace Core::Graphics
 		else
 		{
 			// 新的渲染命令
-			if ((_draw_list.command.capacity - _draw_list.command.size) < 1)
-			{
-				batchFlush(); // 需要腾出空间
-			}
-			_draw_list.command.size += 1;
-			DrawCommand& cmd_ = _draw_list.command.data[_draw_list.command.size - 1];
-			cmd_.texture = static_cast<Texture2D_D3D11*>(texture);
-			cmd_.vertex_count = 0;
-			cmd_.index_count = 0;
+			appendDrawCommand(static_cast<Texture2D_D3D11*>(texture));
 		}
 		// 更新当前状态的纹理
 		if (!is_same(_state_texture, texture))
@@ -1153,21 +1247,18 @@ namespace Core::Graphics
 
 	bool Renderer_D3D11::drawTriangle(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3)
 	{
-		if ((_draw_list.vertex.capacity - _draw_list.vertex.size) < 3 || (_draw_list.index.capacity - _draw_list.index.size) < 3)
-		{
-			if (!batchFlush()) return false;
-		}
-		assert(_draw_list.command.size > 0);
-		DrawCommand& cmd_ = _draw_list.command.data[_draw_list.command.size - 1];
-		DrawVertex* vbuf_ = _draw_list.vertex.data + _draw_list.vertex.size;
+		DrawCommand* p_cmd_ = requestDrawSpace(3, 3);
+		if (!p_cmd_) return false;
+		DrawCommand& cmd_ = *p_cmd_;
+		DrawVertex* vbuf_ = _draw_list.vertex.data() + _draw_list.vertex.size;
 		vbuf_[0] = v1;
 		vbuf_[1] = v2;
 		vbuf_[2] = v3;
 		_draw_list.vertex.size += 3;
-		DrawIndex* ibuf_ = _draw_list.index.data + _draw_list.index.size;
-		ibuf_[0] = cmd_.vertex_count;
-		ibuf_[1] = cmd_.vertex_count + 1;
-		ibuf_[2] = cmd_.vertex_count + 2;
+		DrawIndex* ibuf_ = _draw_list.index.data() + _draw_list.index.size;
+		ibuf_[0] = static_cast<DrawIndex>(cmd_.vertex_count);
+		ibuf_[1] = static_cast<DrawIndex>(cmd_.vertex_count + 1);
+		ibuf_[2] = static_cast<DrawIndex>(cmd_.vertex_count + 2);
 		_draw_list.index.size += 3;
 		cmd_.vertex_count += 3;
 		cmd_.index_count += 3;
@@ -1179,25 +1270,23 @@ namespace Core::Graphics
 	}
 	bool Renderer_D3D11::drawQuad(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3, DrawVertex const& v4)
 	{
-		if ((_draw_list.vertex.capacity - _draw_list.vertex.size) < 4 || (_draw_list.index.capacity - _draw_list.index.size) < 6)
-		{
-			if (!batchFlush()) return false;
-		}
-		assert(_draw_list.command.size > 0);
-		DrawCommand& cmd_ = _draw_list.command.data[_draw_list.command.size - 1];
-		DrawVertex* vbuf_ = _draw_list.vertex.data + _draw_list.vertex.size;
+		DrawCommand* p_cmd_ = requestDrawSpace(4, 6);
+		if (!p_cmd_) return false;
+		DrawCommand& cmd_ = *p_cmd_;
+		DrawVertex* vbuf_ = _draw_list.vertex.data() + _draw_list.vertex.size;
 		vbuf_[0] = v1;
 		vbuf_[1] = v2;
 		vbuf_[2] = v3;
 		vbuf_[3] = v4;
 		_draw_list.vertex.size += 4;
-		DrawIndex* ibuf_ = _draw_list.index.data + _draw_list.index.size;
-		ibuf_[0] = cmd_.vertex_count;
-		ibuf_[1] = cmd_.vertex_count + 1;
-		ibuf_[2] = cmd_.vertex_count + 2;
-		ibuf_[3] = cmd_.vertex_count;
-		ibuf_[4] = cmd_.vertex_count + 2;
-		ibuf_[5] = cmd_.vertex_count + 3;
+		DrawIndex* ibuf_ = _draw_list.index.data() + _draw_list.index.size;
+		DrawIndex const base_ = static_cast<DrawIndex>(cmd_.vertex_count);
+		ibuf_[0] = base_;
+		ibuf_[1] = base_ + 1;
+		ibuf_[2] = base_ + 2;
+		ibuf_[3] = base_;
+		ibuf_[4] = base_ + 2;
+		ibuf_[5] = base_ + 3;
 		_draw_list.index.size += 6;
 		cmd_.vertex_count += 4;
 		cmd_.index_count += 6;
@@ -1209,27 +1298,19 @@ namespace Core::Graphics
 	}
 	bool Renderer_D3D11::drawRaw(DrawVertex const* pvert, uint16_t nvert, DrawIndex const* pidx, uint16_t nidx)
 	{
-		if (nvert > _draw_list.vertex.capacity || nidx > _draw_list.index.capacity)
-		{
-			assert(false); return false;
-		}
+		DrawCommand* p_cmd_ = requestDrawSpace(nvert, nidx);
+		if (!p_cmd_) return false;
+		DrawCommand& cmd_ = *p_cmd_;
 
-		if ((_draw_list.vertex.capacity - _draw_list.vertex.size) < nvert || (_draw_list.index.capacity - _draw_list.index.size) < nidx)
-		{
-			if (!batchFlush()) return false;
-		}
-
-		assert(_draw_list.command.size > 0);
-		DrawCommand& cmd_ = _draw_list.command.data[_draw_list.command.size - 1];
-
-		DrawVertex* vbuf_ = _draw_list.vertex.data + _draw_list.vertex.size;
+		DrawVertex* vbuf_ = _draw_list.vertex.data() + _draw_list.vertex.size;
 		std::memcpy(vbuf_, pvert, nvert * sizeof(DrawVertex));
 		_draw_list.vertex.size += nvert;
 
-		DrawIndex* ibuf_ = _draw_list.index.data + _draw_list.index.size;
+		DrawIndex* ibuf_ = _draw_list.index.data() + _draw_list.index.size;
+		DrawIndex const base_ = static_cast<DrawIndex>(cmd_.vertex_count);
 		for (size_t idx_ = 0; idx_ < nidx; idx_ += 1)
 		{
-			ibuf_[idx_] = cmd_.vertex_count + pidx[idx_];
+			ibuf_[idx_] = base_ + pidx[idx_];
 		}
 		_draw_list.index.size += nidx;
 
@@ -1238,32 +1319,120 @@ namespace Core::Graphics
 
 		return true;
 	}
-	bool Renderer_D3D11::drawRequest(uint16_t nvert, uint16_t nidx, DrawVertex** ppvert, DrawIndex** ppidx, uint16_t* idxoffset)
+	bool Renderer_D3D11::drawRequest(uint16_t nvert, uint16_t nidx, DrawVertex** ppvert, DrawIndex** ppidx, DrawIndex* idxoffset)
 	{
-		if (nvert > _draw_list.vertex.capacity || nidx > _draw_list.index.capacity)
+		DrawCommand* p_cmd_ = requestDrawSpace(nvert, nidx);
+		if (!p_cmd_) return false;
+		DrawCommand& cmd_ = *p_cmd_;
+
+		*ppvert = _draw_list.vertex.data() + _draw_list.vertex.size;
+		_draw_list.vertex.size += nvert;
+
+		*ppidx = _draw_list.index.data() + _draw_list.index.size;
+		_draw_list.index.size += nidx;
+
+		*idxoffset = static_cast<DrawIndex>(cmd_.vertex_count); // 输出顶点索引偏移
+		cmd_.vertex_count += nvert;
+		cmd_.index_count += nidx;
+
+		return true;
+	}
+
+	bool Renderer_D3D11::drawSpriteInstances(SpriteInstanceSprite const* p_sprites, uint32_t const sprite_count, SpriteInstance const* p_instances, uint32_t const instance_count)
+	{
+		if (!_sprite_instance_input_layout || sprite_count > max_sprite_instance_table_size)
 		{
-			assert(false); return false;
+			return false;
+		}
+		if (instance_count == 0)
+		{
+			return true;
+		}
+		// 之前积累的顶点必须先画，保持绘制顺序
+		if (!batchFlush())
+		{
+			return false;
 		}
 
-		if ((_draw_list.vertex.capacity - _draw_list.vertex.size) < nvert || (_draw_list.index.capacity - _draw_list.index.size) < nidx)
+		tracy_zone_scoped;
+		tracy_d3d11_context_zone(m_device->GetTracyContext(), "DrawSpriteInstances");
+		auto* ctx = m_device->GetD3D11DeviceContext();
+		assert(ctx);
+		HRESULT hr = 0;
+
+		// 精灵表
+
 		{
-			if (!batchFlush()) return false;
+			D3D11_MAPPED_SUBRESOURCE res_ = {};
+			hr = gHR = ctx->Map(_sprite_table_buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &res_);
+			if (FAILED(hr))
+			{
+				spdlog::error("[core] ID3D11DeviceContext::Map -> #sprite_table_buffer 调用失败，无法上传精灵表");
+				return false;
+			}
+			std::memcpy(res_.pData, p_sprites, sprite_count * sizeof(SpriteInstanceSprite));
+			ctx->Unmap(_sprite_table_buffer.Get(), 0);
 		}
 
-		assert(_draw_list.command.size > 0);
-		DrawCommand& cmd_ = _draw_list.command.data[_draw_list.command.size - 1];
+		// [IA Stage] 不使用顶点、索引缓冲区，四边形的顶点由 SV_VertexID 决定
 
-		*ppvert = _draw_list.vertex.data + _draw_list.vertex.size;
-		_draw_list.vertex.size += nvert;
+		ctx->IASetInputLayout(_sprite_instance_input_layout.Get());
+		ID3D11Buffer* p_d3d11_vbos[1] = { _sprite_instance_buffer.Get() };
+		UINT const stride = sizeof(SpriteInstance);
+		UINT const offset = 0;
+		ctx->IASetVertexBuffers(0, 1, p_d3d11_vbos, &stride, &offset);
 
-		*ppidx = _draw_list.index.data + _draw_list.index.size;
-		_draw_list.index.size += nidx;
+		// [VS Stage]
 
-		*idxoffset = cmd_.vertex_count; // 输出顶点索引偏移
-		cmd_.vertex_count += nvert;
-		cmd_.index_count += nidx;
+		ctx->VSSetShader(_sprite_instance_vertex_shader[_state_set.fog_state == FogState::Disable ? 0 : 1].Get(), NULL, 0);
+		ID3D11Buffer* p_table[1] = { _sprite_table_buffer.Get() };
+		ctx->VSSetConstantBuffers(2, 1, p_table);
 
-		return true;
+		// [PS Stage]
+
+		ID3D11ShaderResourceView* srv[1] = { get_view(_state_texture) };
+		ctx->PSSetShaderResources(0, 1, srv);
+		bindTextureSamplerState(_state_texture.get());
+		bindTextureAlphaType(_state_texture.get());
+
+		// 上传实例并绘制，超过缓冲区容量时分多次
+
+		bool result = true;
+		uint32_t done = 0;
+		while (done < instance_count)
+		{
+			size_t const count = std::min<size_t>(instance_count - done, _sprite_instance_capacity);
+			D3D11_MAP map_type_ = D3D11_MAP_WRITE_NO_OVERWRITE;
+			if ((_sprite_instance_capacity - _sprite_instance_offset) < count)
+			{
+				_sprite_instance_offset = 0;
+				map_type_ = D3D11_MAP_WRITE_DISCARD;
+			}
+			D3D11_MAPPED_SUBRESOURCE res_ = {};
+			hr = gHR = ctx->Map(_sprite_instance_buffer.Get(), 0, map_type_, 0, &res_);
+			if (FAILED(hr))
+			{
+				spdlog::error("[core] ID3D11DeviceContext::Map -> #sprite_instance_buffer 调用失败，无法上传实例");
+				result = false;
+				break;
+			}
+			std::memcpy((SpriteInstance*)res_.pData + _sprite_instance_offset, p_instances + done, count * sizeof(SpriteInstance));
+			ctx->Unmap(_sprite_instance_buffer.Get(), 0);
+			ctx->DrawInstanced(6, static_cast<UINT>(count), 0, static_cast<UINT>(_sprite_instance_offset));
+			_draw_command_count += 1;
+			_sprite_instance_offset += count;
+			done += static_cast<uint32_t>(count);
+		}
+
+		// 恢复批量绘制使用的状态
+
+		ID3D11ShaderResourceView* null_srv[1] = { NULL };
+		ctx->PSSetShaderResources(0, 1, null_srv);
+		ctx->IASetInputLayout(_input_layout.Get());
+		setVertexIndexBuffer();
+		ctx->VSSetShader(_vertex_shader[IDX(_state_set.fog_state)].Get(), NULL, 0);
+
+		return result;
 	}
 
 	bool Renderer_D3D11::createPostEffectShader(StringView path, IPostEffectShader** pp_effect)
@@ -1366,7 +1535,7 @@ namespace Core::Graphics
 		UINT const stride = sizeof(DrawVertex);
 		UINT const offset = 0;
 		ctx->IASetVertexBuffers(0, 1, p_d3d11_vbos, &stride, &offset);
-		ctx->IASetIndexBuffer(_fx_ibuffer.Get(), DXGI_FORMAT_R16_UINT, 0);
+		ctx->IASetIndexBuffer(_fx_ibuffer.Get(), draw_index_format, 0);
 		ctx->IASetInputLayout(_input_layout.Get());
 
 		// [Stage VS]
@@ -1554,7 +1723,7 @@ namespace Core::Graphics
 		UINT const stride = sizeof(DrawVertex);
 		UINT const offset = 0;
 		ctx->IASetVertexBuffers(0, 1, p_d3d11_vbos, &stride, &offset);
-		ctx->IASetIndexBuffer(_fx_ibuffer.Get(), DXGI_FORMAT_R16_UINT, 0);
+		ctx->IASetIndexBuffer(_fx_ibuffer.Get(), draw_index_format, 0);
 		ctx->IASetInputLayout(_input_layout.Get());
 
 		// [Stage VS]
@@ -1680,6 +1849,160 @@ namespace Core::Graphics
 		return true;
 	}
 
+	bool Renderer_D3D11::copyTextureRegions(IRenderTarget* p_target, TextureCopyRegion const* p_regions, size_t count)
+	{
+		assert(p_target);
+		assert((count == 0) || (count > 0 && p_regions));
+
+		ID3D11RenderTargetView* target_rtv = static_cast<RenderTarget_D3D11*>(p_target)->GetView();
+		if (!target_rtv)
+		{
+			return false;
+		}
+		Vector2U const target_size = p_target->getTexture()->getSize();
+
+		bool const batch_scope = _batch_scope;
+		if (batch_scope && !endBatch()) return false;
+
+		// PREPARE
+
+		auto* ctx = m_device->GetD3D11DeviceContext();
+		assert(ctx);
+
+		Microsoft::WRL::ComPtr<ID3D11RenderTargetView> p_d3d11_rtv;
+		Microsoft::WRL::ComPtr<ID3D11DepthStencilView> p_d3d11_dsv;
+		ctx->OMGetRenderTargets(1, p_d3d11_rtv.GetAddressOf(), p_d3d11_dsv.GetAddressOf());
+
+		ctx->ClearState();
+
+		FLOAT const clear_color[4] = {};
+		ctx->ClearRenderTargetView(target_rtv, clear_color);
+
+		// [Stage IA]
+
+		ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		ID3D11Buffer* p_d3d11_vbos[1] = { _fx_vbuffer.Get() };
+		UINT const stride = sizeof(DrawVertex);
+		UINT const offset = 0;
+		ctx->IASetVertexBuffers(0, 1, p_d3d11_vbos, &stride, &offset);
+		ctx->IASetIndexBuffer(_fx_ibuffer.Get(), draw_index_format, 0);
+		ctx->IASetInputLayout(_input_layout.Get());
+
+		// [Stage VS]
+
+		/* upload vp matrix */ {
+			D3D11_MAPPED_SUBRESOURCE res_ = {};
+			HRESULT hr = gHR = ctx->Map(_vp_matrix_buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &res_);
+			if (SUCCEEDED(hr))
+			{
+				// 左上角为原点，和纹理坐标系一致
+				DirectX::XMFLOAT4X4 f4x4;
+				DirectX::XMStoreFloat4x4(&f4x4, DirectX::XMMatrixOrthographicOffCenterLH(0.0f, (float)target_size.x, (float)target_size.y, 0.0f, 0.0f, 1.0f));
+				std::memcpy(res_.pData, &f4x4, sizeof(f4x4));
+				ctx->Unmap(_vp_matrix_buffer.Get(), 0);
+			}
+			else
+			{
+				spdlog::error("[core] ID3D11DeviceContext::Map -> #view_projection_matrix_buffer 调用失败，无法上传摄像机变换矩阵");
+			}
+		}
+
+		ctx->VSSetShader(_vertex_shader[IDX(FogState::Disable)].Get(), NULL, 0);
+		ID3D11Buffer* p_mvp[1] = { _vp_matrix_buffer.Get() };
+		ctx->VSSetConstantBuffers(0, 1, p_mvp);
+
+		// [Stage RS]
+
+		ctx->RSSetState(_raster_state.Get());
+		D3D11_VIEWPORT viewport = {
+			.TopLeftX = 0.0f,
+			.TopLeftY = 0.0f,
+			.Width = (FLOAT)target_size.x,
+			.Height = (FLOAT)target_size.y,
+			.MinDepth = 0.0f,
+			.MaxDepth = 1.0f,
+		};
+		ctx->RSSetViewports(1, &viewport);
+		D3D11_RECT scissor = {
+			.left = 0,
+			.top = 0,
+			.right = (LONG)target_size.x,
+			.bottom = (LONG)target_size.y,
+		};
+		ctx->RSSetScissorRects(1, &scissor);
+
+		// [Stage PS]
+
+		ID3D11SamplerState* p_sampler = get_sampler(_sampler_state[IDX(SamplerState::PointClamp)]);
+		ctx->PSSetSamplers(0, 1, &p_sampler);
+
+		// [Stage OM]
+
+		ctx->OMSetDepthStencilState(_depth_state[IDX(DepthState::Disable)].Get(), D3D11_DEFAULT_STENCIL_REFERENCE);
+		FLOAT blend_factor[4] = {};
+		ctx->OMSetBlendState(_blend_state[IDX(BlendState::Disable)].Get(), blend_factor, D3D11_DEFAULT_SAMPLE_MASK);
+		ID3D11RenderTargetView* p_target_rtvs[1] = { target_rtv };
+		ctx->OMSetRenderTargets(1, p_target_rtvs, NULL);
+
+		// DRAW
+
+		bool result = true;
+		for (size_t i = 0; i < count; i += 1)
+		{
+			TextureCopyRegion const& region = p_regions[i];
+			if (!region.source)
+			{
+				continue;
+			}
+			Vector2U const source_size = region.source->getSize();
+			float const uscale = 1.0f / (float)source_size.x;
+			float const vscale = 1.0f / (float)source_size.y;
+			float const x0 = (float)region.target_position.x;
+			float const y0 = (float)region.target_position.y;
+			float const x1 = x0 + (float)(region.source_rect.b.x - region.source_rect.a.x);
+			float const y1 = y0 + (float)(region.source_rect.b.y - region.source_rect.a.y);
+			float const u0 = (float)region.source_rect.a.x * uscale;
+			float const v0 = (float)region.source_rect.a.y * vscale;
+			float const u1 = (float)region.source_rect.b.x * uscale;
+			float const v1 = (float)region.source_rect.b.y * vscale;
+
+			/* upload vertex data */ {
+				D3D11_MAPPED_SUBRESOURCE res_ = {};
+				HRESULT hr = gHR = ctx->Map(_fx_vbuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &res_);
+				if (FAILED(hr))
+				{
+					spdlog::error("[core] ID3D11DeviceContext::Map -> #_fx_vbuffer 调用失败，无法上传顶点");
+					result = false;
+					break;
+				}
+				DrawVertex const vertex_data[4] = {
+					DrawVertex(x0, y0, u0, v0),
+					DrawVertex(x1, y0, u1, v0),
+					DrawVertex(x1, y1, u1, v1),
+					DrawVertex(x0, y1, u0, v1),
+				};
+				std::memcpy(res_.pData, vertex_data, sizeof(vertex_data));
+				ctx->Unmap(_fx_vbuffer.Get(), 0);
+			}
+
+			TextureAlphaType const alpha_type = region.source->isPremultipliedAlpha() ? TextureAlphaType::PremulAlpha : TextureAlphaType::Normal;
+			ctx->PSSetShader(_pixel_shader[IDX(VertexColorBlendState::Zero)][IDX(FogState::Disable)][IDX(alpha_type)].Get(), NULL, 0);
+			ID3D11ShaderResourceView* p_srv[1] = { get_view(region.source) };
+			ctx->PSSetShaderResources(0, 1, p_srv);
+
+			ctx->DrawIndexed(6, 0, 0);
+		}
+
+		// CLEAR
+
+		ctx->ClearState();
+		ID3D11RenderTargetView* p_d3d11_rtvs[1] = { p_d3d11_rtv.Get() };
+		ctx->OMSetRenderTargets(1, p_d3d11_rtvs, p_d3d11_dsv.Get());
+
+		if (batch_scope && !beginBatch()) return false;
+		return result;
+	}
+
 	ISamplerState* Renderer_D3D11::getKnownSamplerState(SamplerState state)
 	{
 		return _sampler_state[IDX(state)].get();
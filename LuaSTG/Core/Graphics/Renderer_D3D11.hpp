@@ -56,6 +56,8 @@ namespace Core::Graphics
 	{
 		Microsoft::WRL::ComPtr<ID3D11Buffer> vertex_buffer;
 		Microsoft::WRL::ComPtr<ID3D11Buffer> index_buffer;
+		size_t vertex_capacity = 0;
+		size_t index_capacity = 0;
 		INT vertex_offset = 0;
 		UINT index_offset = 0;
 	};
@@ -63,30 +65,63 @@ namespace Core::Graphics
 	struct DrawCommand
 	{
 		ScopeObject<Texture2D_D3D11> texture;
-		uint16_t vertex_count = 0;
-		uint16_t index_count = 0;
+		uint32_t vertex_count = 0;
+		uint32_t index_count = 0;
 	};
 
-	struct DrawList
+	// 可增长的绘制数据缓冲区，在达到上限前通过扩容而不是提交批次来腾出空间
+	template<typename T>
+	struct DrawListBuffer
 	{
-		struct VertexBuffer
+		std::vector<T> storage;
+		size_t capacity = 0;
+		size_t max_capacity = 0;
+		size_t size = 0;
+
+		T* data() noexcept { return storage.data(); }
+		void init(size_t const initial, size_t const max_)
 		{
-			const size_t capacity = 32768;
-			size_t size = 0;
-			IRenderer::DrawVertex data[32768] = {};
-		} vertex;
-		struct IndexBuffer
+			storage.resize(initial);
+			capacity = initial;
+			max_capacity = max_;
+			size = 0;
+		}
+		bool reserve(size_t const n)
 		{
-			const size_t capacity = 32768;
-			size_t size = 0;
-			IRenderer::DrawIndex data[32768] = {};
-		} index;
+			if ((capacity - size) >= n) return true;
+			if ((max_capacity - size) < n) return false;
+			size_t new_capacity = capacity;
+			while ((new_capacity - size) < n) new_capacity *= 2;
+			new_capacity = std::min(new_capacity, max_capacity);
+			storage.resize(new_capacity);
+			capacity = new_capacity;
+			return true;
+		}
+	};
+
+	struct DrawList
+	{
+		static constexpr size_t vertex_initial_capacity = 32768;
+		static constexpr size_t vertex_max_capacity = 32768 * 8;
+		// 单个绘制命令能引用的顶点数受顶点索引位宽限制，超过后拆分为同纹理的新命令
+		static constexpr size_t command_vertex_limit = std::min<size_t>(std::numeric_limits<IRenderer::DrawIndex>::max(), vertex_max_capacity);
+		static constexpr size_t index_initial_capacity = 49152;
+		static constexpr size_t index_max_capacity = 49152 * 8;
+
+		DrawListBuffer<IRenderer::DrawVertex> vertex;
+		DrawListBuffer<IRenderer::DrawIndex> index;
 		struct DrawCommandBuffer
 		{
-			const size_t capacity = 2048;
+			std::vector<DrawCommand> data;
 			size_t size = 0;
-			DrawCommand data[2048] = {};
 		} command;
+
+		DrawList()
+		{
+			vertex.init(vertex_initial_capacity, vertex_max_capacity);
+			index.init(index_initial_capacity, index_max_capacity);
+			command.data.resize(256);
+		}
 	};
 
 	class PostEffectShader_D3D11
@@ -152,14 +187,20 @@ namespace Core::Graphics
 
 		Microsoft::WRL::ComPtr<ID3D11Buffer> _fx_vbuffer;
 		Microsoft::WRL::ComPtr<ID3D11Buffer> _fx_ibuffer;
-		VertexIndexBuffer _vi_buffer[1];
+		// 上传缓冲区环：每个缓冲区以 NO_OVERWRITE 方式追加写入，写满后切换到下一个，
+		// 只在重新进入某个缓冲区时 DISCARD 一次，GPU 缓冲区比绘制列表大数倍，一帧内多次提交通常不会触发重命名
+		static constexpr size_t _vi_buffer_count = 3;
+		static constexpr size_t _vi_buffer_scale = 4;
+		VertexIndexBuffer _vi_buffer[_vi_buffer_count];
 		size_t _vi_buffer_index = 0;
-		const size_t _vi_buffer_count = 1;
 		DrawList _draw_list;
 
 		void setVertexIndexBuffer(size_t index = 0xFFFFFFFFu);
+		bool createVertexIndexBuffer(VertexIndexBuffer& vi, size_t vertex_capacity, size_t index_capacity);
 		bool uploadVertexIndexBuffer(bool discard);
 		void clearDrawList();
+		DrawCommand& appendDrawCommand(Texture2D_D3D11* texture);
+		DrawCommand* requestDrawSpace(size_t nvert, size_t nidx);
 
 		Microsoft::WRL::ComPtr<ID3D11Buffer> _vp_matrix_buffer;
 		Microsoft::WRL::ComPtr<ID3D11Buffer> _world_matrix_buffer;
@@ -167,6 +208,14 @@ namespace Core::Graphics
 		Microsoft::WRL::ComPtr<ID3D11Buffer> _fog_data_buffer; // 同时也用于储存 postEffect 的 纹理大小和视口范围
 		Microsoft::WRL::ComPtr<ID3D11Buffer> _user_float_buffer; // 在 postEffect 的时候用这个
 
+		// 实例化绘制：实例缓冲区以 NO_OVERWRITE 方式追加写入，写满后 DISCARD 并从头开始；精灵表绑定在顶点着色器 b2
+		static constexpr size_t _sprite_instance_capacity = 16384;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> _sprite_instance_buffer;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> _sprite_table_buffer;
+		Microsoft::WRL::ComPtr<ID3D11InputLayout> _sprite_instance_input_layout;
+		Microsoft::WRL::ComPtr<ID3D11VertexShader> _sprite_instance_vertex_shader[2]; // 关闭雾、开启雾
+		size_t _sprite_instance_offset = _sprite_instance_capacity;
+
 		Microsoft::WRL::ComPtr<ID3D11InputLayout> _input_layout;
 		Microsoft::WRL::ComPtr<ID3D11VertexShader> _vertex_shader[IDX(FogState::MAX_COUNT)]; // FogState
 		Microsoft::WRL::ComPtr<ID3D11PixelShader> _pixel_shader[IDX(VertexColorBlendState::MAX_COUNT)][IDX(FogState::MAX_COUNT)][IDX(TextureAlphaType::MAX_COUNT)]; // VertexColorBlendState, FogState, TextureAlphaType
@@ -180,10 +229,12 @@ namespace Core::Graphics
 		RendererStateSet _state_set;
 		bool _state_dirty = false;
 		bool _batch_scope = false;
+		uint64_t _draw_command_count = 0;
 
 		bool createBuffers();
 		bool createStates();
 		bool createShaders();
+		void createSpriteInstanceShaders();
 		void initState();
 		void setSamplerState(SamplerState state, UINT index);
 		bool uploadVertexIndexBufferFromDrawList();
@@ -224,7 +275,8 @@ namespace Core::Graphics
 		bool drawQuad(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3, DrawVertex const& v4);
 		bool drawQuad(DrawVertex const* pvert);
 		bool drawRaw(DrawVertex const* pvert, uint16_t nvert, DrawIndex const* pidx, uint16_t nidx);
-		bool drawRequest(uint16_t nvert, uint16_t nidx, DrawVertex** ppvert, DrawIndex** ppidx, uint16_t* idxoffset);
+		bool drawRequest(uint16_t nvert, uint16_t nidx, DrawVertex** ppvert, DrawIndex** ppidx, DrawIndex* idxoffset);
+		bool drawSpriteInstances(SpriteInstanceSprite const* p_sprites, uint32_t sprite_count, SpriteInstance const* p_instances, uint32_t instance_count);
 
 		bool createPostEffectShader(StringView path, IPostEffectShader** pp_effect);
 		bool drawPostEffect(
@@ -238,8 +290,12 @@ namespace Core::Graphics
 		bool createModel(StringView path, IModel** pp_model);
 		bool drawModel(IModel* p_model);
 
+		bool copyTextureRegions(IRenderTarget* p_target, TextureCopyRegion const* p_regions, size_t count);
+
 		ISamplerState* getKnownSamplerState(SamplerState state);
 
+		uint64_t getDrawCommandCount() { return _draw_command_count; };
+
 	public:
 		Renderer_D3D11(Device_D3D11* p_device);
 		~Renderer_D3D11();
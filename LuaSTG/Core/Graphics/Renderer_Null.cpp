@@ -0,0 +1,232 @@
+#include "Core/Graphics/Renderer_Null.hpp"
+#include "Core/FileManager.hpp"
+
+namespace Core::Graphics
+{
+	void Renderer_Null::countDraw(size_t nvert, size_t nidx) noexcept
+	{
+		m_statistics.draw_call += 1;
+		m_statistics.vertex += nvert;
+		m_statistics.index += nidx;
+		if (!m_command_open)
+		{
+			m_command_open = true;
+			m_pending_command += 1;
+		}
+		m_pending_vertex += nvert;
+	}
+	void Renderer_Null::submit() noexcept
+	{
+		if (m_pending_vertex > 0)
+		{
+			m_statistics.flush += 1;
+			m_statistics.gpu_draw += m_pending_command;
+		}
+		m_pending_vertex = 0;
+		m_pending_command = 0;
+		m_command_open = false;
+	}
+
+	bool Renderer_Null::beginBatch()
+	{
+		submit();
+		m_batch_scope = true;
+		m_statistics.batch += 1;
+		return true;
+	}
+	bool Renderer_Null::endBatch()
+	{
+		submit();
+		m_batch_scope = false;
+		return true;
+	}
+
+	void Renderer_Null::clearRenderTarget(Color4B const&) { submit(); m_statistics.clear += 1; }
+	void Renderer_Null::clearDepthBuffer(float) { submit(); m_statistics.clear += 1; }
+	void Renderer_Null::setRenderAttachment(IRenderTarget*, IDepthStencilBuffer*) { submit(); m_statistics.state_change += 1; }
+
+	void Renderer_Null::setOrtho(BoxF const&) { submit(); m_statistics.state_change += 1; }
+	void Renderer_Null::setPerspective(Vector3F const&, Vector3F const&, Vector3F const&, float, float, float, float) { submit(); m_statistics.state_change += 1; }
+
+	void Renderer_Null::setViewport(BoxF const& box)
+	{
+		submit();
+		m_viewport = box;
+		m_statistics.state_change += 1;
+	}
+	void Renderer_Null::setScissorRect(RectF const&) { submit(); m_statistics.state_change += 1; }
+	void Renderer_Null::setViewportAndScissorRect() { submit(); m_statistics.state_change += 1; }
+
+	void Renderer_Null::setVertexColorBlendState(VertexColorBlendState state)
+	{
+		if (m_vertex_color_blend_state != state)
+		{
+			submit();
+			m_vertex_color_blend_state = state;
+		}
+		m_statistics.state_change += 1;
+	}
+	void Renderer_Null::setFogState(FogState state, Color4B const&, float, float)
+	{
+		if (m_fog_state != state)
+		{
+			submit();
+			m_fog_state = state;
+		}
+		m_statistics.state_change += 1;
+	}
+	void Renderer_Null::setDepthState(DepthState state)
+	{
+		if (m_depth_state != state)
+		{
+			submit();
+			m_depth_state = state;
+		}
+		m_statistics.state_change += 1;
+	}
+	void Renderer_Null::setBlendState(BlendState state)
+	{
+		if (m_blend_state != state)
+		{
+			submit();
+			m_blend_state = state;
+		}
+		m_statistics.state_change += 1;
+	}
+	void Renderer_Null::setTexture(ITexture2D* texture)
+	{
+		if (m_texture != texture)
+		{
+			m_texture = texture;
+			m_command_open = false;
+		}
+		m_statistics.state_change += 1;
+	}
+
+	bool Renderer_Null::drawTriangle(DrawVertex const&, DrawVertex const&, DrawVertex const&) { countDraw(3, 3); return true; }
+	bool Renderer_Null::drawTriangle(DrawVertex const*) { countDraw(3, 3); return true; }
+	bool Renderer_Null::drawQuad(DrawVertex const&, DrawVertex const&, DrawVertex const&, DrawVertex const&) { countDraw(4, 6); return true; }
+	bool Renderer_Null::drawQuad(DrawVertex const*) { countDraw(4, 6); return true; }
+	bool Renderer_Null::drawRaw(DrawVertex const*, uint16_t nvert, DrawIndex const*, uint16_t nidx) { countDraw(nvert, nidx); return true; }
+	bool Renderer_Null::drawRequest(uint16_t nvert, uint16_t nidx, DrawVertex** ppvert, DrawIndex** ppidx, DrawIndex* idxoffset)
+	{
+		// 调用者会写入顶点和索引，所以仍然需要提供足够大的缓冲区
+		if (m_vertex_scratch.size() < nvert) m_vertex_scratch.resize(nvert);
+		if (m_index_scratch.size() < nidx) m_index_scratch.resize(nidx);
+		*ppvert = m_vertex_scratch.data();
+		*ppidx = m_index_scratch.data();
+		*idxoffset = 0;
+		countDraw(nvert, nidx);
+		return true;
+	}
+	bool Renderer_Null::drawSpriteInstances(SpriteInstanceSprite const*, uint32_t sprite_count, SpriteInstance const*, uint32_t instance_count)
+	{
+		if (sprite_count > max_sprite_instance_table_size)
+		{
+			return false;
+		}
+		// 与 Renderer_D3D11 一致：先提交之前的批次，再产生一个独立的绘制命令
+		submit();
+		if (instance_count > 0)
+		{
+			m_statistics.draw_call += 1;
+			m_statistics.gpu_draw += 1;
+			m_statistics.instance += instance_count;
+		}
+		return true;
+	}
+
+	bool Renderer_Null::createPostEffectShader(StringView path, IPostEffectShader** pp_effect)
+	{
+		// 不编译着色器，只保证找不到文件时与 Renderer_D3D11 一样创建失败
+		if (!GFileManager().containEx(path))
+		{
+			spdlog::error("[core] 无法加载文件 '{}'", path);
+			*pp_effect = nullptr;
+			return false;
+		}
+		try
+		{
+			*pp_effect = new PostEffectShader_Null();
+			return true;
+		}
+		catch (...)
+		{
+			*pp_effect = nullptr;
+			return false;
+		}
+	}
+	bool Renderer_Null::drawPostEffect(IPostEffectShader*, BlendState, ITexture2D*, SamplerState, Vector4F const*, size_t, ITexture2D* const*, SamplerState const*, size_t)
+	{
+		submit();
+		m_statistics.post_effect += 1;
+		return true;
+	}
+	bool Renderer_Null::drawPostEffect(IPostEffectShader*, BlendState)
+	{
+		submit();
+		m_statistics.post_effect += 1;
+		return true;
+	}
+
+	bool Renderer_Null::createModel(StringView path, IModel** pp_model)
+	{
+		if (!GFileManager().containEx(path))
+		{
+			spdlog::error("[core] 无法加载文件 '{}'", path);
+			*pp_model = nullptr;
+			return false;
+		}
+		try
+		{
+			*pp_model = new Model_Null();
+			return true;
+		}
+		catch (...)
+		{
+			*pp_model = nullptr;
+			return false;
+		}
+	}
+	bool Renderer_Null::drawModel(IModel*)
+	{
+		submit();
+		m_statistics.model += 1;
+		return true;
+	}
+
+	bool Renderer_Null::copyTextureRegions(IRenderTarget*, TextureCopyRegion const*, size_t)
+	{
+		return true; // 纹理没有像素数据，不需要复制
+	}
+
+	ISamplerState* Renderer_Null::getKnownSamplerState(SamplerState state)
+	{
+		return *m_known_sampler_state[static_cast<size_t>(state)];
+	}
+
+	Renderer_Null::Renderer_Null()
+	{
+		for (auto& v : m_known_sampler_state)
+		{
+			v.attach(new SamplerState_Null());
+		}
+	}
+	Renderer_Null::~Renderer_Null()
+	{
+	}
+
+	bool Renderer_Null::create(Renderer_Null** pp_renderer)
+	{
+		try
+		{
+			*pp_renderer = new Renderer_Null();
+			return true;
+		}
+		catch (...)
+		{
+			*pp_renderer = nullptr;
+			return false;
+		}
+	}
+}
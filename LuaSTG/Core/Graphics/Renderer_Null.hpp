@@ -0,0 +1,128 @@
+#pragma once
+#include "Core/Object.hpp"
+#include "Core/Graphics/Renderer.hpp"
+#include "Core/Graphics/Device_Null.hpp"
+
+namespace Core::Graphics
+{
+	// 无界面模式使用的渲染器，只统计绘制调用，不提交任何绘制命令
+	// 不依赖图形设备：后处理着色器、模型只检查文件是否存在，采样器是空对象
+	class Renderer_Null : public Object<IRenderer>
+	{
+	public:
+		struct Statistics
+		{
+			uint64_t batch{};
+			uint64_t draw_call{};
+			uint64_t vertex{};
+			uint64_t index{};
+			uint64_t post_effect{};
+			uint64_t model{};
+			uint64_t clear{};
+			uint64_t state_change{};
+			uint64_t flush{};    // 按 Renderer_D3D11 的合批规则，实际提交批次的次数
+			uint64_t gpu_draw{}; // 按 Renderer_D3D11 的合批规则，实际产生的 GPU 绘制命令数量
+			uint64_t instance{}; // 实例化绘制的图片精灵数量
+		};
+	private:
+		Statistics m_statistics;
+		ScopeObject<SamplerState_Null> m_known_sampler_state[static_cast<size_t>(SamplerState::MAX_COUNT)];
+		BoxF m_viewport{};
+		std::vector<DrawVertex> m_vertex_scratch;
+		std::vector<DrawIndex> m_index_scratch;
+		bool m_batch_scope{};
+		// 模拟合批状态：渲染状态变化时提交批次，纹理变化时开始新的绘制命令
+		VertexColorBlendState m_vertex_color_blend_state{};
+		FogState m_fog_state{};
+		DepthState m_depth_state{};
+		BlendState m_blend_state{};
+		ITexture2D* m_texture{};
+		uint64_t m_pending_vertex{};
+		uint64_t m_pending_command{};
+		bool m_command_open{};
+		void countDraw(size_t nvert, size_t nidx) noexcept;
+		void submit() noexcept;
+	public:
+		Statistics const& getStatistics() const noexcept { return m_statistics; }
+
+	public:
+		bool beginBatch();
+		bool endBatch();
+		bool isBatchScope() { return m_batch_scope; }
+		bool flush() { return true; }
+
+		void clearRenderTarget(Color4B const& color);
+		void clearDepthBuffer(float zvalue);
+		void setRenderAttachment(IRenderTarget* p_rt, IDepthStencilBuffer* p_ds);
+
+		void setOrtho(BoxF const& box);
+		void setPerspective(Vector3F const& eye, Vector3F const& lookat, Vector3F const& headup, float fov, float aspect, float znear, float zfar);
+
+		BoxF getViewport() { return m_viewport; }
+		void setViewport(BoxF const& box);
+		void setScissorRect(RectF const& rect);
+		void setViewportAndScissorRect();
+
+		void setVertexColorBlendState(VertexColorBlendState state);
+		void setFogState(FogState state, Color4B const& color, float density_or_znear, float zfar);
+		void setDepthState(DepthState state);
+		void setBlendState(BlendState state);
+		void setTexture(ITexture2D* texture);
+
+		bool drawTriangle(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3);
+		bool drawTriangle(DrawVertex const* pvert);
+		bool drawQuad(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3, DrawVertex const& v4);
+		bool drawQuad(DrawVertex const* pvert);
+		bool drawRaw(DrawVertex const* pvert, uint16_t nvert, DrawIndex const* pidx, uint16_t nidx);
+		bool drawRequest(uint16_t nvert, uint16_t nidx, DrawVertex** ppvert, DrawIndex** ppidx, DrawIndex* idxoffset);
+		bool drawSpriteInstances(SpriteInstanceSprite const* p_sprites, uint32_t sprite_count, SpriteInstance const* p_instances, uint32_t instance_count);
+
+		bool createPostEffectShader(StringView path, IPostEffectShader** pp_effect);
+		bool drawPostEffect(
+			IPostEffectShader* p_effect,
+			BlendState blend,
+			ITexture2D* p_tex, SamplerState rtsv,
+			Vector4F const* cv, size_t cv_n,
+			ITexture2D* const* p_tex_arr, SamplerState const* sv, size_t tv_sv_n);
+		bool drawPostEffect(IPostEffectShader* p_effect, BlendState blend);
+
+		bool createModel(StringView path, IModel** pp_model);
+		bool drawModel(IModel* p_model);
+
+		bool copyTextureRegions(IRenderTarget* p_target, TextureCopyRegion const* p_regions, size_t count);
+
+		ISamplerState* getKnownSamplerState(SamplerState state);
+
+		uint64_t getDrawCommandCount() { return m_statistics.gpu_draw; };
+
+	public:
+		Renderer_Null();
+		~Renderer_Null();
+
+	public:
+		static bool create(Renderer_Null** pp_renderer);
+	};
+
+	class PostEffectShader_Null : public Object<IPostEffectShader>
+	{
+	public:
+		bool setFloat(StringView, float) { return true; }
+		bool setFloat2(StringView, Vector2F) { return true; }
+		bool setFloat3(StringView, Vector3F) { return true; }
+		bool setFloat4(StringView, Vector4F) { return true; }
+		bool setTexture2D(StringView, ITexture2D*) { return true; }
+		bool apply(IRenderer*) { return true; }
+	};
+
+	class Model_Null : public Object<IModel>
+	{
+	public:
+		void setAmbient(Vector3F const&, float) {}
+		void setDirectionalLight(Vector3F const&, Vector3F const&, float) {}
+
+		void setScaling(Vector3F const&) {}
+		void setPosition(Vector3F const&) {}
+		void setRotationRollPitchYaw(float, float, float) {}
+		void setRotationQuaternion(Vector4F const&) {}
+	};
+}
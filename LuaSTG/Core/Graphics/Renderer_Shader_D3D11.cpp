@@ -47,6 +47,64 @@
 
 #define IDX(x) (size_t)static_cast<uint8_t>(x)
 
+// 实例化绘制图片精灵使用的顶点着色器，输出与内置顶点着色器一致，可以搭配内置像素着色器使用
+// 需要在运行时编译，编译失败时实例化绘制不可用，调用者会退回逐顶点绘制
+static std::string_view const sprite_instance_shader(R"(
+cbuffer view_proj_buffer : register(b0)
+{
+    float4x4 view_proj;
+};
+cbuffer sprite_table_buffer : register(b2)
+{
+    float4 sprite_table[2048]; // 每个精灵占两项：纹理坐标范围、四边形范围
+};
+
+struct VS_Input
+{
+    float2 pos   : POSITION0;
+    float  rot   : TEXCOORD1;
+    float2 scale : TEXCOORD2;
+    float4 col   : COLOR0;
+    uint   id    : TEXCOORD3;
+    uint   vid   : SV_VertexID;
+};
+struct VS_Output
+{
+    float4 sxy : SV_POSITION;
+#if defined(FOG_ENABLE)
+    float4 pos : POSITION0;
+#endif
+    float2 uv  : TEXCOORD0;
+    float4 col : COLOR0;
+};
+
+// 两个三角形 (0, 1, 2) (0, 2, 3)，顶点顺序与 Sprite_D3D11 一致：左上、右上、右下、左下
+static const uint corner_index[6] = { 0, 1, 2, 0, 2, 3 };
+
+VS_Output main(VS_Input input)
+{
+    uint corner = corner_index[input.vid];
+    bool right = (corner == 1 || corner == 2);
+    bool bottom = (corner >= 2);
+    float4 uv_rect = sprite_table[input.id * 2];
+    float4 pos_rect = sprite_table[input.id * 2 + 1];
+
+    float2 p = float2(right ? pos_rect.z : pos_rect.x, bottom ? pos_rect.w : pos_rect.y) * input.scale;
+    float s, c;
+    sincos(input.rot, s, c);
+    float4 pos_world = float4(p.x * c - p.y * s + input.pos.x, p.x * s + p.y * c + input.pos.y, 0.5f, 1.0f);
+
+    VS_Output output;
+    output.sxy = mul(view_proj, pos_world);
+#if defined(FOG_ENABLE)
+    output.pos = pos_world;
+#endif
+    output.uv = float2(right ? uv_rect.z : uv_rect.x, bottom ? uv_rect.w : uv_rect.y);
+    output.col = input.col;
+    return output;
+}
+)");
+
 class D3DIncludeImpl : public ID3DInclude
 {
 public:
@@ -335,6 +393,53 @@ namespace Core::Graphics
 		#undef load
 		}
 
+		createSpriteInstanceShaders();
+
 		return true;
 	}
+	void Renderer_D3D11::createSpriteInstanceShaders()
+	{
+		HRESULT hr = 0;
+
+		D3D_SHADER_MACRO const fog_defs[] = {
+			{ "FOG_ENABLE", "1" },
+			{ NULL, NULL },
+		};
+		Microsoft::WRL::ComPtr<ID3DBlob> blob[2];
+		if (!compileVertexShaderMacro11("sprite_instance_shader", sprite_instance_shader.data(), sprite_instance_shader.size(), NULL, &blob[0])
+			|| !compileVertexShaderMacro11("sprite_instance_shader", sprite_instance_shader.data(), sprite_instance_shader.size(), fog_defs, &blob[1]))
+		{
+			spdlog::warn("[core] 无法编译实例化绘制使用的着色器，将使用逐顶点绘制");
+			return;
+		}
+
+		for (size_t i = 0; i < 2; i += 1)
+		{
+			hr = gHR = m_device->GetD3D11Device()->CreateVertexShader(blob[i]->GetBufferPointer(), blob[i]->GetBufferSize(), NULL, &_sprite_instance_vertex_shader[i]);
+			if (FAILED(hr))
+				return;
+			M_D3D_SET_DEBUG_NAME_SIMPLE(_sprite_instance_vertex_shader[i].Get());
+		}
+
+		D3D11_INPUT_ELEMENT_DESC layout_[] =
+		{
+			// SpriteInstance
+			{ "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT  , 0, 0 , D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "TEXCOORD", 1, DXGI_FORMAT_R32_FLOAT     , 0, 8 , D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "TEXCOORD", 2, DXGI_FORMAT_R32G32_FLOAT  , 0, 12, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "COLOR",    0, DXGI_FORMAT_B8G8R8A8_UNORM, 0, 20, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "TEXCOORD", 3, DXGI_FORMAT_R32_UINT      , 0, 24, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		};
+		hr = gHR = m_device->GetD3D11Device()->CreateInputLayout(
+			layout_, 5,
+			blob[0]->GetBufferPointer(),
+			blob[0]->GetBufferSize(),
+			&_sprite_instance_input_layout);
+		if (FAILED(hr))
+		{
+			_sprite_instance_input_layout.Reset();
+			return;
+		}
+		M_D3D_SET_DEBUG_NAME_SIMPLE(_sprite_instance_input_layout.Get());
+	}
 }
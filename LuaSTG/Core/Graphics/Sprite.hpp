@@ -32,6 +32,10 @@ namespace Core::Graphics
 		virtual void draw(Vector2F const& pos, Vector2F const& scale) = 0;
 		virtual void draw(Vector2F const& pos, Vector2F const& scale, float rotation) = 0;
 
+		// 计算绘制用的四个顶点但不提交给渲染器；只读取精灵状态，可以在多个线程上同时调用
+		// color 为空时使用精灵自身的顶点颜色
+		virtual void getQuad(IRenderer::DrawVertex* pvert, Vector2F const& pos, Vector2F const& scale, float rotation, float z, Color4B const* color = nullptr) = 0;
+
 		virtual bool clone(ISprite** pp_sprite) = 0;
 
 		static bool create(IRenderer* p_renderer, ITexture2D* p_texture, ISprite** pp_sprite);
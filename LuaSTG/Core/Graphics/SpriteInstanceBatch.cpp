@@ -0,0 +1,69 @@
+#include "Core/Graphics/SpriteInstanceBatch.hpp"
+
+namespace Core::Graphics
+{
+	static_assert(sizeof(IRenderer::SpriteInstance) == 28);
+	static_assert(sizeof(IRenderer::SpriteInstanceSprite) == 32);
+
+	IRenderer::SpriteInstanceSprite SpriteInstanceBatch::makeSprite(RectF const& texture_rect, Vector2F const& center, float const units_per_pixel, Vector2U const& texture_size)
+	{
+		float const uscale = 1.0f / (float)texture_size.x;
+		float const vscale = 1.0f / (float)texture_size.y;
+		RectF const rc = texture_rect - center;
+		return IRenderer::SpriteInstanceSprite{
+			.uv = RectF(texture_rect.a.x * uscale, texture_rect.a.y * vscale, texture_rect.b.x * uscale, texture_rect.b.y * vscale),
+			.rect = RectF(rc.a.x * units_per_pixel, rc.a.y * -units_per_pixel, rc.b.x * units_per_pixel, rc.b.y * -units_per_pixel),
+		};
+	}
+	IRenderer::SpriteInstanceSprite SpriteInstanceBatch::makeSprite(ISprite* sprite)
+	{
+		return makeSprite(sprite->getTextureRect(), sprite->getTextureCenter(), sprite->getUnitsPerPixel(), sprite->getTexture()->getSize());
+	}
+
+	bool SpriteInstanceBatch::push(ISprite* sprite, Vector2F const& pos, Vector2F const& scale, float const rotation, Color4B const color)
+	{
+		if (sprite != m_last_sprite)
+		{
+			auto const it = m_lookup.find(sprite);
+			if (it != m_lookup.end())
+			{
+				m_last_index = it->second;
+			}
+			else
+			{
+				if (m_sprites.size() >= IRenderer::max_sprite_instance_table_size)
+				{
+					return false;
+				}
+				m_last_index = static_cast<uint32_t>(m_sprites.size());
+				m_sprites.push_back(makeSprite(sprite));
+				m_lookup.emplace(sprite, m_last_index);
+			}
+			m_last_sprite = sprite;
+		}
+		m_instances.push_back(IRenderer::SpriteInstance{
+			.position = pos,
+			.rotation = rotation,
+			.scale = scale,
+			.color = color.color(),
+			.sprite = m_last_index,
+		});
+		return true;
+	}
+	bool SpriteInstanceBatch::submit(IRenderer* p_renderer) const
+	{
+		if (m_instances.empty())
+		{
+			return true;
+		}
+		return p_renderer->drawSpriteInstances(m_sprites.data(), getSpriteCount(), m_instances.data(), getInstanceCount());
+	}
+	void SpriteInstanceBatch::clear()
+	{
+		m_sprites.clear();
+		m_instances.clear();
+		m_lookup.clear();
+		m_last_sprite = nullptr;
+		m_last_index = 0;
+	}
+}
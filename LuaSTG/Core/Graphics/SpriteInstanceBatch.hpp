@@ -0,0 +1,35 @@
+#pragma once
+#include "Core/Graphics/Renderer.hpp"
+#include "Core/Graphics/Sprite.hpp"
+
+namespace Core::Graphics
+{
+	// 实例化绘制在 CPU 端的数据：精灵表和实例数组
+	// 只读取精灵的公开状态，不访问图形设备，因此可以脱离 GPU 单独验证
+	class SpriteInstanceBatch
+	{
+	private:
+		std::vector<IRenderer::SpriteInstanceSprite> m_sprites;
+		std::vector<IRenderer::SpriteInstance> m_instances;
+		std::unordered_map<ISprite*, uint32_t> m_lookup;
+		ISprite* m_last_sprite{}; // 同类弹幕通常连续出现，先和上一个比较可以省去大部分查表
+		uint32_t m_last_index{};
+
+	public:
+		// 与 Sprite_D3D11 计算四边形的方式一致：纹理坐标归一化，纹理坐标系 y 轴朝下、渲染坐标系 y 轴朝上
+		static IRenderer::SpriteInstanceSprite makeSprite(RectF const& texture_rect, Vector2F const& center, float units_per_pixel, Vector2U const& texture_size);
+		static IRenderer::SpriteInstanceSprite makeSprite(ISprite* sprite);
+
+		// 精灵表已满时返回 false，调用者应先提交再清空
+		bool push(ISprite* sprite, Vector2F const& pos, Vector2F const& scale, float rotation, Color4B color);
+		// 提交后不会清空，提交失败时调用者可以退回逐顶点绘制
+		bool submit(IRenderer* p_renderer) const;
+		void clear();
+
+		bool empty() const noexcept { return m_instances.empty(); }
+		IRenderer::SpriteInstanceSprite const* getSprites() const noexcept { return m_sprites.data(); }
+		uint32_t getSpriteCount() const noexcept { return static_cast<uint32_t>(m_sprites.size()); }
+		IRenderer::SpriteInstance const* getInstances() const noexcept { return m_instances.data(); }
+		uint32_t getInstanceCount() const noexcept { return static_cast<uint32_t>(m_instances.size()); }
+	};
+}
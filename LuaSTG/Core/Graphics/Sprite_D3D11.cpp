@@ -88,19 +88,8 @@ namespace Core::Graphics
 	{
 		m_renderer->setTexture(m_texture.get());
 
-		RectF const rect = RectF(
-			m_pos_rc.a.x * scale.x,
-			m_pos_rc.a.y * scale.y,
-			m_pos_rc.b.x * scale.x,
-			m_pos_rc.b.y * scale.y
-		);
-		
-		IRenderer::DrawVertex const vert[4] = {
-			IRenderer::DrawVertex(pos.x + rect.a.x, pos.y + rect.a.y, m_z, m_uv.a.x, m_uv.a.y, m_color[0].color()),
-			IRenderer::DrawVertex(pos.x + rect.b.x, pos.y + rect.a.y, m_z, m_uv.b.x, m_uv.a.y, m_color[1].color()),
-			IRenderer::DrawVertex(pos.x + rect.b.x, pos.y + rect.b.y, m_z, m_uv.b.x, m_uv.b.y, m_color[2].color()),
-			IRenderer::DrawVertex(pos.x + rect.a.x, pos.y + rect.b.y, m_z, m_uv.a.x, m_uv.b.y, m_color[3].color()),
-		};
+		IRenderer::DrawVertex vert[4];
+		getQuad(vert, pos, scale, 0.0f, m_z, nullptr);
 
 		m_renderer->drawQuad(vert);
 	}
@@ -114,6 +103,16 @@ namespace Core::Graphics
 
 		m_renderer->setTexture(m_texture.get());
 
+		IRenderer::DrawVertex vert[4];
+		getQuad(vert, pos, scale, rotation, m_z, nullptr);
+		
+		m_renderer->drawQuad(vert);
+	}
+
+	void Sprite_D3D11::getQuad(IRenderer::DrawVertex* pvert, Vector2F const& pos, Vector2F const& scale, float rotation, float z, Color4B const* color)
+	{
+		Color4B const* const vc = color ? color : m_color;
+
 		RectF const rect = RectF(
 			m_pos_rc.a.x * scale.x,
 			m_pos_rc.a.y * scale.y,
@@ -121,22 +120,29 @@ namespace Core::Graphics
 			m_pos_rc.b.y * scale.y
 		);
 
-		IRenderer::DrawVertex vert[4] = {
-			IRenderer::DrawVertex(rect.a.x, rect.a.y, m_z, m_uv.a.x, m_uv.a.y, m_color[0].color()),
-			IRenderer::DrawVertex(rect.b.x, rect.a.y, m_z, m_uv.b.x, m_uv.a.y, m_color[1].color()),
-			IRenderer::DrawVertex(rect.b.x, rect.b.y, m_z, m_uv.b.x, m_uv.b.y, m_color[2].color()),
-			IRenderer::DrawVertex(rect.a.x, rect.b.y, m_z, m_uv.a.x, m_uv.b.y, m_color[3].color()),
-		};
+		if (std::abs(rotation) < std::numeric_limits<float>::min())
+		{
+			pvert[0] = IRenderer::DrawVertex(pos.x + rect.a.x, pos.y + rect.a.y, z, m_uv.a.x, m_uv.a.y, vc[0].color());
+			pvert[1] = IRenderer::DrawVertex(pos.x + rect.b.x, pos.y + rect.a.y, z, m_uv.b.x, m_uv.a.y, vc[1].color());
+			pvert[2] = IRenderer::DrawVertex(pos.x + rect.b.x, pos.y + rect.b.y, z, m_uv.b.x, m_uv.b.y, vc[2].color());
+			pvert[3] = IRenderer::DrawVertex(pos.x + rect.a.x, pos.y + rect.b.y, z, m_uv.a.x, m_uv.b.y, vc[3].color());
+			return;
+		}
+
+		pvert[0] = IRenderer::DrawVertex(rect.a.x, rect.a.y, z, m_uv.a.x, m_uv.a.y, vc[0].color());
+		pvert[1] = IRenderer::DrawVertex(rect.b.x, rect.a.y, z, m_uv.b.x, m_uv.a.y, vc[1].color());
+		pvert[2] = IRenderer::DrawVertex(rect.b.x, rect.b.y, z, m_uv.b.x, m_uv.b.y, vc[2].color());
+		pvert[3] = IRenderer::DrawVertex(rect.a.x, rect.b.y, z, m_uv.a.x, m_uv.b.y, vc[3].color());
 
 		float const sinv = std::sinf(rotation);
 		float const cosv = std::cosf(rotation);
 
 #define rotate_xy(UNIT) \
 		{\
-			float const tx = vert[UNIT].x * cosv - vert[UNIT].y * sinv;\
-			float const ty = vert[UNIT].x * sinv + vert[UNIT].y * cosv;\
-			vert[UNIT].x = tx;\
-			vert[UNIT].y = ty;\
+			float const tx = pvert[UNIT].x * cosv - pvert[UNIT].y * sinv;\
+			float const ty = pvert[UNIT].x * sinv + pvert[UNIT].y * cosv;\
+			pvert[UNIT].x = tx + pos.x;\
+			pvert[UNIT].y = ty + pos.y;\
 		}
 
 		rotate_xy(0);
@@ -144,12 +150,7 @@ namespace Core::Graphics
 		rotate_xy(2);
 		rotate_xy(3);
 
-		vert[0].x += pos.x; vert[0].y += pos.y;
-		vert[1].x += pos.x; vert[1].y += pos.y;
-		vert[2].x += pos.x; vert[2].y += pos.y;
-		vert[3].x += pos.x; vert[3].y += pos.y;
-		
-		m_renderer->drawQuad(vert);
+#undef rotate_xy
 	}
 
 	bool Sprite_D3D11::clone(ISprite** pp_sprite)
@@ -65,6 +65,8 @@ namespace Core::Graphics
 		void draw(Vector2F const& pos, Vector2F const& scale);
 		void draw(Vector2F const& pos, Vector2F const& scale, float rotation);
 
+		void getQuad(IRenderer::DrawVertex* pvert, Vector2F const& pos, Vector2F const& scale, float rotation, float z, Color4B const* color);
+
 		bool clone(ISprite** pp_sprite);
 
 	public:
@@ -0,0 +1,47 @@
+#include "Core/Graphics/SwapChain_Null.hpp"
+
+namespace Core::Graphics
+{
+	bool SwapChain_Null::setWindowMode(Vector2U size)
+	{
+		if (size.x < 1 || size.y < 1)
+		{
+			return false;
+		}
+		return m_window->setSize(size);
+	}
+	bool SwapChain_Null::setCanvasSize(Vector2U size)
+	{
+		if (size.x < 1 || size.y < 1)
+		{
+			return false;
+		}
+		m_canvas_size = size;
+		return true;
+	}
+
+	bool SwapChain_Null::saveSnapshotToFile(StringView path)
+	{
+		spdlog::warn("[core] 无界面模式下没有画面，无法保存截图 '{}'", path);
+		return false;
+	}
+
+	SwapChain_Null::SwapChain_Null(IWindow* p_window)
+		: m_window(p_window)
+	{
+	}
+
+	bool SwapChain_Null::create(IWindow* p_window, SwapChain_Null** pp_swapchain)
+	{
+		try
+		{
+			*pp_swapchain = new SwapChain_Null(p_window);
+			return true;
+		}
+		catch (...)
+		{
+			*pp_swapchain = nullptr;
+			return false;
+		}
+	}
+}
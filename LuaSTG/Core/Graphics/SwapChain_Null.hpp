@@ -0,0 +1,42 @@
+#pragma once
+#include "Core/Object.hpp"
+#include "Core/Graphics/SwapChain.hpp"
+
+namespace Core::Graphics
+{
+	// 无界面模式使用的交换链，没有后台缓冲区，只记录画布尺寸等设置，不会产生任何交换链事件
+	class SwapChain_Null : public Object<ISwapChain>
+	{
+	private:
+		ScopeObject<IWindow> m_window;
+		Vector2U m_canvas_size{ 640, 480 };
+		SwapChainScalingMode m_scaling_mode{ SwapChainScalingMode::AspectRatio };
+		bool m_vsync{};
+
+	public:
+		void addEventListener(ISwapChainEventListener*) {}
+		void removeEventListener(ISwapChainEventListener*) {}
+
+		bool setWindowMode(Vector2U size);
+		bool setCanvasSize(Vector2U size);
+		Vector2U getCanvasSize() { return m_canvas_size; }
+
+		void setScalingMode(SwapChainScalingMode mode) { m_scaling_mode = mode; }
+		SwapChainScalingMode getScalingMode() { return m_scaling_mode; }
+
+		void clearRenderAttachment() {}
+		void applyRenderAttachment() {}
+		void waitFrameLatency() {}
+		void setVSync(bool enable) { m_vsync = enable; }
+		bool getVSync() { return m_vsync; }
+		bool present() { return true; }
+
+		bool saveSnapshotToFile(StringView path);
+
+	public:
+		SwapChain_Null(IWindow* p_window);
+
+	public:
+		static bool create(IWindow* p_window, SwapChain_Null** pp_swapchain);
+	};
+}
@@ -0,0 +1,18 @@
+#include "Core/Graphics/Window_Null.hpp"
+
+namespace Core::Graphics
+{
+	bool Window_Null::create(Window_Null** pp_window)
+	{
+		try
+		{
+			*pp_window = new Window_Null();
+			return true;
+		}
+		catch (...)
+		{
+			*pp_window = nullptr;
+			return false;
+		}
+	}
+}
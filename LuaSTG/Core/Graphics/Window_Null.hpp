@@ -0,0 +1,76 @@
+#pragma once
+#include "Core/Object.hpp"
+#include "Core/Graphics/Window.hpp"
+
+namespace Core::Graphics
+{
+	// 无界面模式使用的窗口，不创建系统窗口，只记录脚本设置的状态，也不会产生任何窗口事件
+	class Window_Null : public Object<IWindow>
+	{
+	private:
+		std::string m_title_text;
+		Vector2U m_size{ 640, 480 };
+		WindowFrameStyle m_frame_style{ WindowFrameStyle::Normal };
+		WindowLayer m_layer{ WindowLayer::Invisible };
+		WindowCursor m_cursor{ WindowCursor::Arrow };
+		bool m_ime_state{};
+		bool m_text_input_enabled{};
+
+	public:
+		void addEventListener(IWindowEventListener*) {}
+		void removeEventListener(IWindowEventListener*) {}
+
+		void* getNativeHandle() { return nullptr; }
+		void setNativeIcon(void*) {}
+
+		void setIMEState(bool enable) { m_ime_state = enable; }
+		bool getIMEState() { return m_ime_state; }
+
+		void setInputMethodPosition(Vector2I) {}
+
+		bool       textInput_isEnabled() { return m_text_input_enabled; }
+		void       textInput_setEnabled(bool enabled) { m_text_input_enabled = enabled; }
+		StringView textInput_getBuffer() { return ""; }
+		void       textInput_clearBuffer() {}
+		uint32_t   textInput_getCursorPosition() { return 0; }
+		void       textInput_setCursorPosition(uint32_t) {}
+		void       textInput_addCursorPosition(int32_t) {}
+		void       textInput_removeBufferRange(uint32_t, uint32_t) {}
+		void       textInput_insertBufferRange(uint32_t, StringView) {}
+		void       textInput_backspace(uint32_t) {}
+
+		void setTitleText(StringView str) { m_title_text = str; }
+		StringView getTitleText() { return m_title_text; }
+
+		bool setFrameStyle(WindowFrameStyle style) { m_frame_style = style; return true; }
+		WindowFrameStyle getFrameStyle() { return m_frame_style; }
+
+		Vector2U getSize() { return m_size; }
+		Vector2U _getCurrentSize() { return m_size; }
+		bool setSize(Vector2U v) { m_size = v; return true; }
+
+		WindowLayer getLayer() { return m_layer; }
+		bool setLayer(WindowLayer layer) { m_layer = layer; return true; }
+
+		uint32_t getDPI() { return USER_DEFAULT_SCREEN_DPI; }
+		float getDPIScaling() { return 1.0f; }
+
+		void setWindowMode(Vector2U size, WindowFrameStyle style, IDisplay*) { m_size = size; m_frame_style = style; }
+		void setFullScreenMode(IDisplay*) {}
+		void setCentered(bool, IDisplay*) {}
+
+		void setCustomSizeMoveEnable(bool) {}
+		void setCustomMinimizeButtonRect(RectI) {}
+		void setCustomCloseButtonRect(RectI) {}
+		void setCustomMoveButtonRect(RectI) {}
+
+		bool setCursor(WindowCursor type) { m_cursor = type; return true; }
+		WindowCursor getCursor() { return m_cursor; }
+
+		void setWindowCornerPreference(bool) {}
+		void setTitleBarAutoHidePreference(bool) {}
+
+	public:
+		static bool create(Window_Null** pp_window);
+	};
+}
@@ -3,6 +3,7 @@
 #include "Platform/XInput.hpp"
 #include "Utility/Utility.h"
 #include "Debugger/ImGuiExtension.h"
+#include "Debugger/Benchmark.hpp"
 #include "LuaBinding/LuaAppFrame.hpp"
 #include "utf8.hpp"
 #include "resource.h"
@@ -202,8 +203,16 @@ bool AppFrame::Init()noexcept
 
 		OpenInput();
 
-		// 创建手柄输入
-		try
+		// 基准测试、输入录制与回放
+		if (auto const& benchmark = core::ConfigurationLoader::getInstance().getBenchmark(); benchmark.isEnable() || benchmark.hasRecord())
+		{
+			m_Benchmark = std::make_unique<LuaSTG::Debugger::Benchmark>();
+			if (!m_Benchmark->open())
+				return false;
+		}
+
+		// 创建手柄输入，无界面模式没有窗口，不读取手柄
+		if (!m_pAppModel->isHeadless()) try
 		{
 			m_DirectInput = std::make_unique<Platform::DirectInput>((ptrdiff_t)m_pAppModel->getWindow()->getNativeHandle());
 			{
@@ -257,6 +266,8 @@ void AppFrame::Shutdown()noexcept
 		SafeCallGlobalFunction(LuaSTG::LuaEngine::G_CALLBACK_EngineStop);
 	}
 
+	m_Benchmark = nullptr; // 关闭时输出报告
+
 	m_GameObjectPool = nullptr;
 	spdlog::info("[luastg] 清空对象池");
 
@@ -268,6 +279,7 @@ void AppFrame::Shutdown()noexcept
 	}
 
 	m_stRenderTargetStack.clear();
+	m_TextLayoutCache.Clear();
 	m_ResourceMgr.ClearAllResource();
 	spdlog::info("[luastg] 清空所有游戏资源");
 
@@ -312,6 +324,10 @@ void AppFrame::Run()noexcept
 void AppFrame::onWindowCreate()
 {
 	OpenInput();
+	if (m_pAppModel->isHeadless())
+	{
+		return;
+	}
 	m_DirectInput = std::make_unique<Platform::DirectInput>((ptrdiff_t)m_pAppModel->getWindow()->getNativeHandle());
 	{
 		m_DirectInput->refresh(); // 这里因为窗口还没显示，所以应该会出现一个Aquire设备失败的错误信息，忽略即可
@@ -414,11 +430,15 @@ bool AppFrame::onUpdate()
 		// 执行帧函数
 		imgui::cancelSetCursor();
 		m_GameObjectPool->DebugNextFrame();
+		if (m_Benchmark)
+			m_Benchmark->beginUpdate();
 		if (!SafeCallGlobalFunction(LuaSTG::LuaEngine::G_CALLBACK_EngineUpdate, 1))
 		{
 			result = false;
 			m_pAppModel->requestExit();
 		}
+		if (m_Benchmark)
+			m_Benchmark->endUpdate();
 		bool tAbort = lua_toboolean(L, -1) != 0;
 		lua_pop(L, 1);
 		if (tAbort)
@@ -433,15 +453,46 @@ bool AppFrame::onRender()
 	m_bRenderStarted = true;
 
 	GetRenderTargetManager()->BeginRenderTargetStack();
+	m_ResourceMgr.UpdateTextureAtlas();
+	m_TextLayoutCache.Update();
 
 	// 执行渲染函数
+	if (m_Benchmark)
+		m_Benchmark->beginRender();
 	bool result = SafeCallGlobalFunction(LuaSTG::LuaEngine::G_CALLBACK_EngineDraw);
 	if (!result)
 		m_pAppModel->requestExit();
+	if (m_Benchmark)
+		m_Benchmark->endRender();
 
 	GetRenderTargetManager()->EndRenderTargetStack();
 
 	m_bRenderStarted = false;
+
+	// 基准测试：收集本帧统计数据，达到指定帧数后退出
+	if (m_Benchmark && m_Benchmark->isMeasuring())
+	{
+		auto const obj_info = m_GameObjectPool->DebugGetCurrentFrameStatistics();
+		LuaSTG::Debugger::Benchmark::FrameSample sample;
+		sample.update_movements_time = obj_info.update_movements_time;
+		sample.update_next_time = obj_info.update_next_time;
+		sample.detect_out_of_world_bound_time = obj_info.detect_out_of_world_bound_time;
+		sample.detect_intersection_time = obj_info.detect_intersection_time;
+		sample.render_objects_time = obj_info.render_time;
+		sample.object_alloc = obj_info.object_alloc;
+		sample.object_free = obj_info.object_free;
+		sample.object_alive = obj_info.object_alive;
+		sample.object_colli_check = obj_info.object_colli_check;
+		sample.object_colli_callback = obj_info.object_colli_callback;
+		sample.lua_memory = (uint64_t)lua_gc(L, LUA_GCCOUNT, 0) * 1024 + (uint64_t)lua_gc(L, LUA_GCCOUNTB, 0);
+		m_Benchmark->commitFrame(sample);
+		if (m_Benchmark->isFinished())
+		{
+			m_Benchmark->writeReport();
+			m_pAppModel->requestExit();
+		}
+	}
+
 	return result;
 }
 
@@ -2,9 +2,15 @@
 #include "Core/ApplicationModel.hpp"
 #include "Core/Graphics/Font.hpp"
 #include "GameResource/ResourceManager.h"
+#include "GameResource/TextLayoutCache.hpp"
 #include "GameObject/GameObjectPool.h"
 #include "Platform/DirectInput.hpp"
 
+namespace LuaSTG::Debugger
+{
+	class Benchmark;
+}
+
 namespace LuaSTGPlus
 {
 	/// @brief 应用程序状态
@@ -50,6 +56,7 @@ namespace LuaSTGPlus
 		// 应用程序框架
 		Core::ScopeObject<Core::IApplicationModel> m_pAppModel;
 		Core::ScopeObject<Core::Graphics::ITextRenderer> m_pTextRenderer;
+		TextLayoutCache m_TextLayoutCache;
 
 		// 资源管理器
 		ResourceMgr m_ResourceMgr;
@@ -72,6 +79,9 @@ namespace LuaSTGPlus
 		// 输入设备
 		std::unique_ptr<Platform::DirectInput> m_DirectInput;
 		
+		// 基准测试、输入录制与回放
+		std::unique_ptr<LuaSTG::Debugger::Benchmark> m_Benchmark;
+		
 	public:
 		/// @brief 保护模式执行脚本
 		/// @note 该函数仅限框架调用，为主逻辑最外层调用。若脚本运行时发生错误，该函数负责截获错误发出错误消息。
@@ -183,6 +193,17 @@ namespace LuaSTGPlus
 		
 		bool RenderTTF(const char* name, const char* str, float left, float right, float bottom, float top, float scale, int format, Core::Color4B c)noexcept;
 
+		TextLayoutCache& GetTextLayoutCache()noexcept { return m_TextLayoutCache; }
+
+	private:
+		// 排版文字，结果写入 layout，位置都是绝对坐标，调用者可以传入相对坐标再平移
+		void LayoutText(Core::Graphics::IGlyphManager* p, wchar_t* strBuf, Core::RectF rect, Core::Vector2F scale, FontAlignHorizontal halign, FontAlignVertical valign, bool bWordBreak, TextLayoutCache::Layout& layout)noexcept;
+		// 排版一行文字（允许有换行符），和 ITextRenderer::drawText 的规则一致
+		void LayoutTextLine(Core::Graphics::IGlyphManager* p, Core::StringView str, Core::Vector2F start, Core::Vector2F scale, TextLayoutCache::Layout& layout)noexcept;
+		bool DrawTextLayout(TextLayoutCache::Layout const& layout, Core::Vector2F anchor)noexcept;
+
+	public:
+
 		void SnapShot(const char* path)noexcept;
 		void SaveTexture(const char* tex_name, const char* path)noexcept;
 
@@ -66,6 +66,11 @@ namespace LuaSTGPlus
 		// 先初始化交换链
 		bool const result = p_swapchain->setWindowMode(Core::Vector2U(gs.getWidth(), gs.getHeight()));
 		if (!result) return false;
+		// 无界面模式下窗口保持隐藏，也不需要垂直同步
+		if (m_pAppModel->isHeadless()) {
+			p_swapchain->setVSync(false);
+			return true;
+		}
 		p_swapchain->setVSync(gs.isVsync());
 		// 先刷新一下画面，避免白屏
 		p_swapchain->clearRenderAttachment();
@@ -1,4 +1,5 @@
 ﻿#include "AppFrame.h"
+#include "utility/utf.hpp"
 #include "utf8.hpp"
 
 namespace LuaSTGPlus
@@ -15,21 +16,77 @@ namespace LuaSTGPlus
 
 	constexpr int const TEXT_FLAG_WORDBREAK = 0x10;
 
-	bool AppFrame::RenderText(IResourceFont* p, wchar_t* strBuf, Core::RectF rect, Core::Vector2F scale, FontAlignHorizontal halign, FontAlignVertical valign, bool bWordBreak)noexcept
+	constexpr uint32_t const TEXT_LAYOUT_RENDER_TEXT = 0x100;
+	constexpr uint32_t const TEXT_LAYOUT_RENDER_TTF = 0x200;
+	constexpr uint32_t const TEXT_LAYOUT_FONT_RENDERER = 0x300;
+
+	// 按纹理排序，减少纹理切换
+	static void sortTextLayoutByTexture(Core::Graphics::IGlyphManager* pGlyphManager, TextLayoutCache::Layout& layout)
+	{
+		if (pGlyphManager->getTextureCount() > 1)
+		{
+			std::stable_sort(layout.glyphs.begin(), layout.glyphs.end(), [](TextLayoutCache::Glyph const& l, TextLayoutCache::Glyph const& r) -> bool
+			{
+				return l.info.texture_index < r.info.texture_index;
+			});
+		}
+	}
+
+	void AppFrame::LayoutTextLine(Core::Graphics::IGlyphManager* pGlyphManager, Core::StringView str, Core::Vector2F start, Core::Vector2F scale, TextLayoutCache::Layout& layout)noexcept
 	{
 		using namespace Core;
 		using namespace Core::Graphics;
 
-		IGlyphManager* pGlyphManager = p->GetGlyphManager();
-		
-		// 准备渲染字体
-		m_pTextRenderer->setGlyphManager(pGlyphManager);
-		m_pTextRenderer->setScale(scale);
+		float const line_height = pGlyphManager->getLineHeight() * scale.y;
+
+		// 比较常用的空格
+		GlyphInfo space_glyph_info{};
+		pGlyphManager->getGlyph(uint32_t(U' '), &space_glyph_info, true);
+		Vector2F const space_advance(space_glyph_info.advance.x * scale.x, space_glyph_info.advance.y * scale.y);
+
+		Vector2F pen = start;
+		char32_t code_ = 0;
+		utf::utf8reader reader_(str.data(), str.size());
+		while (reader_(code_))
+		{
+			if (code_ == U'\n')
+			{
+				pen.x = start.x;
+				pen.y -= line_height;
+				continue;
+			}
+			if (code_ == U' ')
+			{
+				pen += space_advance;
+				continue;
+			}
+			GlyphInfo tGlyphInfo{};
+			if (pGlyphManager->getGlyph(code_, &tGlyphInfo, true))
+			{
+				if (tGlyphInfo.is_pending)
+				{
+					layout.is_complete = false; // 只前进，下一帧重新排版
+				}
+				else
+				{
+					tGlyphInfo.size.x *= scale.x;
+					tGlyphInfo.size.y *= scale.y;
+					tGlyphInfo.position.x *= scale.x;
+					tGlyphInfo.position.y *= scale.y;
+					layout.glyphs.push_back(TextLayoutCache::Glyph{ tGlyphInfo, pen });
+				}
+				pen.x += tGlyphInfo.advance.x * scale.x;
+				pen.y += tGlyphInfo.advance.y * scale.y;
+			}
+		}
+		layout.advance = pen;
+	}
+
+	void AppFrame::LayoutText(Core::Graphics::IGlyphManager* pGlyphManager, wchar_t* strBuf, Core::RectF rect, Core::Vector2F scale, FontAlignHorizontal halign, FontAlignVertical valign, bool bWordBreak, TextLayoutCache::Layout& layout)noexcept
+	{
+		using namespace Core;
+		using namespace Core::Graphics;
 
-		// 设置混合和颜色
-		updateGraph2DBlendMode(p->GetBlendMode());
-		m_pTextRenderer->setColor(p->GetBlendColor());
-		
 		// 第一次遍历计算要渲染多少行
 		const wchar_t* pText = strBuf;
 		int iLineCount = 1;
@@ -87,7 +144,7 @@ namespace LuaSTGPlus
 		vRenderPos.x = rect.a.x;
 		vRenderPos.y -= pGlyphManager->getAscender() * scale.y;
 		
-		// 逐行渲染文字
+		// 逐行排版文字
 		wchar_t* pScanner = strBuf;
 		wchar_t c = 0;
 		bool bEOS = false;
@@ -122,26 +179,25 @@ namespace LuaSTGPlus
 			else
 				*pScanner = L'\0';
 			
-			// 渲染从pText~pScanner的文字
+			// 排版从pText~pScanner的文字
 			std::string u8_str(utf8::to_string(pText));
-			Vector2F ignore_;
 			switch (halign)
 			{
 			case FontAlignHorizontal::Right:
-				m_pTextRenderer->drawText(u8_str, Vector2F(
+				LayoutTextLine(pGlyphManager, u8_str, Vector2F(
 					vRenderPos.x + std::abs(rect.a.x - rect.b.x) - fLineWidth,
 					vRenderPos.y
-				), &ignore_);
+				), scale, layout);
 				break;
 			case FontAlignHorizontal::Center:
-				m_pTextRenderer->drawText(u8_str, Vector2F(
+				LayoutTextLine(pGlyphManager, u8_str, Vector2F(
 					vRenderPos.x + std::abs(rect.a.x - rect.b.x) / 2.f - fLineWidth / 2.f,
 					vRenderPos.y
-				), &ignore_);
+				), scale, layout);
 				break;
 			case FontAlignHorizontal::Left:
 			default:
-				m_pTextRenderer->drawText(u8_str, vRenderPos, &ignore_);
+				LayoutTextLine(pGlyphManager, u8_str, vRenderPos, scale, layout);
 				break;
 			}
 
@@ -157,8 +213,43 @@ namespace LuaSTGPlus
 			vRenderPos.y -= pGlyphManager->getLineHeight() * scale.y;
 		}
 
+		sortTextLayoutByTexture(pGlyphManager, layout);
+	}
+
+	bool AppFrame::DrawTextLayout(TextLayoutCache::Layout const& layout, Core::Vector2F anchor)noexcept
+	{
+		for (auto const& g : layout.glyphs)
+		{
+			if (!m_pTextRenderer->drawGlyph(g.info, anchor + g.position))
+			{
+				return false;
+			}
+		}
 		return true;
 	}
+
+	bool AppFrame::RenderText(IResourceFont* p, wchar_t* strBuf, Core::RectF rect, Core::Vector2F scale, FontAlignHorizontal halign, FontAlignVertical valign, bool bWordBreak)noexcept
+	{
+		Core::Graphics::IGlyphManager* pGlyphManager = p->GetGlyphManager();
+		
+		// 准备渲染字体
+		m_pTextRenderer->setGlyphManager(pGlyphManager);
+		m_pTextRenderer->setScale(scale);
+
+		// 设置混合和颜色
+		updateGraph2DBlendMode(p->GetBlendMode());
+		m_pTextRenderer->setColor(p->GetBlendColor());
+
+		// 上传已经光栅化好的字形
+		if (!pGlyphManager->flush())
+		{
+			return false;
+		}
+		
+		TextLayoutCache::Layout layout;
+		LayoutText(pGlyphManager, strBuf, rect, scale, halign, valign, bWordBreak, layout);
+		return DrawTextLayout(layout, Core::Vector2F());
+	}
 	
 	Core::Vector2F AppFrame::CalcuTextSize(IResourceFont* p, const wchar_t* strBuf, Core::Vector2F scale)noexcept
 	{
@@ -199,55 +290,86 @@ namespace LuaSTGPlus
 			spdlog::error("[luastg] RenderText: 找不到字体资源'{}'", name);
 			return false;
 		}
-		
-		// 编码转换
-		std::wstring s_TempStringBuf;
-		try
-		{
-			s_TempStringBuf = utf8::to_wstring(str);
-		}
-		catch (const std::bad_alloc&)
+
+		Core::Graphics::IGlyphManager* pGlyphManager = p->GetGlyphManager();
+		Core::Vector2F const vScale(scale, scale);
+
+		// 准备渲染字体
+		m_pTextRenderer->setGlyphManager(pGlyphManager);
+		m_pTextRenderer->setScale(vScale);
+		updateGraph2DBlendMode(p->GetBlendMode());
+		m_pTextRenderer->setColor(p->GetBlendColor());
+		if (!pGlyphManager->flush())
 		{
-			spdlog::error("[luastg] RenderText: 内存不足");
 			return false;
 		}
-		
-		// 计算渲染位置
-		Core::Vector2F tSize = CalcuTextSize(p.get(), s_TempStringBuf.c_str(), Core::Vector2F(scale, scale));
-		switch (halign)
-		{
-		case FontAlignHorizontal::Right:
-			x -= tSize.x;
-			break;
-		case FontAlignHorizontal::Center:
-			x -= tSize.x / 2.f;
-			break;
-		case FontAlignHorizontal::Left:
-		default:
-			break;
-		}
-		switch (valign)
+
+		// 排版结果相对于 (x, y)
+		TextLayoutCache::Key key;
+		key.glyph_manager = pGlyphManager;
+		key.scale = vScale;
+		key.format = TEXT_LAYOUT_RENDER_TEXT | (uint32_t)halign | ((uint32_t)valign << 2);
+		TextLayoutCache::Layout const* pLayout = m_TextLayoutCache.Find(key, str);
+		TextLayoutCache::Layout tLayout;
+		if (!pLayout)
 		{
-		case FontAlignVertical::Bottom:
-			y += tSize.y;
-			break;
-		case FontAlignVertical::Middle:
-			y += tSize.y / 2.f;
-			break;
-		case FontAlignVertical::Top:
-		default:
-			break;
+			// 编码转换
+			std::wstring s_TempStringBuf;
+			try
+			{
+				s_TempStringBuf = utf8::to_wstring(str);
+			}
+			catch (const std::bad_alloc&)
+			{
+				spdlog::error("[luastg] RenderText: 内存不足");
+				return false;
+			}
+
+			// 计算渲染位置
+			Core::Vector2F tSize = CalcuTextSize(p.get(), s_TempStringBuf.c_str(), vScale);
+			Core::Vector2F tOffset;
+			switch (halign)
+			{
+			case FontAlignHorizontal::Right:
+				tOffset.x -= tSize.x;
+				break;
+			case FontAlignHorizontal::Center:
+				tOffset.x -= tSize.x / 2.f;
+				break;
+			case FontAlignHorizontal::Left:
+			default:
+				break;
+			}
+			switch (valign)
+			{
+			case FontAlignVertical::Bottom:
+				tOffset.y += tSize.y;
+				break;
+			case FontAlignVertical::Middle:
+				tOffset.y += tSize.y / 2.f;
+				break;
+			case FontAlignVertical::Top:
+			default:
+				break;
+			}
+
+			LayoutText(
+				pGlyphManager,
+				s_TempStringBuf.data(),
+				Core::RectF(tOffset.x, tOffset.y, tOffset.x + tSize.x, tOffset.y - tSize.y),
+				vScale,
+				halign,
+				valign,
+				false,
+				tLayout);
+			pLayout = m_TextLayoutCache.Insert(key, str, std::move(tLayout));
+			if (!pLayout)
+			{
+				pLayout = &tLayout; // 没有缓存，直接使用
+			}
 		}
-		
-		return RenderText(
-			p.get(),
-			const_cast<wchar_t*>(s_TempStringBuf.data()),
-			Core::RectF(x, y, x + tSize.x, y - tSize.y),
-			Core::Vector2F(scale, scale),
-			halign,
-			valign,
-			false
-			);
+
+		return DrawTextLayout(*pLayout, Core::Vector2F(x, y));
 	}
 	
 	bool AppFrame::RenderTTF(const char* name, const char* str,
@@ -259,16 +381,6 @@ namespace LuaSTGPlus
 			return false;
 		}
 		
-		// 编码转换
-		std::wstring s_TempStringBuf;
-		try {
-			s_TempStringBuf = utf8::to_wstring(str);
-		}
-		catch (const std::bad_alloc&) {
-			spdlog::error("[luastg] RenderTTF: 内存不足");
-			return false;
-		}
-		
 		// 计算格式
 		bool bWordBreak = false;
 		FontAlignHorizontal halign = FontAlignHorizontal::Left;
@@ -288,15 +400,57 @@ namespace LuaSTGPlus
 			bWordBreak = true;
 		
 		p->SetBlendColor(c);
-		return RenderText(
-			p.get(),
-			const_cast<wchar_t*>(s_TempStringBuf.data()),
-			Core::RectF(left, top, right, bottom),
-			Core::Vector2F(scale, scale) * 0.5f,  // TODO: 缩放系数=0.5 ????????????
-			halign,
-			valign,
-			bWordBreak
-		);
+
+		Core::Graphics::IGlyphManager* pGlyphManager = p->GetGlyphManager();
+		Core::Vector2F const vScale = Core::Vector2F(scale, scale) * 0.5f;  // TODO: 缩放系数=0.5 ????????????
+
+		// 准备渲染字体
+		m_pTextRenderer->setGlyphManager(pGlyphManager);
+		m_pTextRenderer->setScale(vScale);
+		updateGraph2DBlendMode(p->GetBlendMode());
+		m_pTextRenderer->setColor(p->GetBlendColor());
+		if (!pGlyphManager->flush())
+		{
+			return false;
+		}
+
+		// 排版结果相对于排版区域左上角
+		TextLayoutCache::Key key;
+		key.glyph_manager = pGlyphManager;
+		key.scale = vScale;
+		key.size = Core::Vector2F(right - left, bottom - top);
+		key.format = TEXT_LAYOUT_RENDER_TTF | (uint32_t)format;
+		TextLayoutCache::Layout const* pLayout = m_TextLayoutCache.Find(key, str);
+		TextLayoutCache::Layout tLayout;
+		if (!pLayout)
+		{
+			// 编码转换
+			std::wstring s_TempStringBuf;
+			try {
+				s_TempStringBuf = utf8::to_wstring(str);
+			}
+			catch (const std::bad_alloc&) {
+				spdlog::error("[luastg] RenderTTF: 内存不足");
+				return false;
+			}
+
+			LayoutText(
+				pGlyphManager,
+				s_TempStringBuf.data(),
+				Core::RectF(0.0f, 0.0f, right - left, bottom - top),
+				vScale,
+				halign,
+				valign,
+				bWordBreak,
+				tLayout);
+			pLayout = m_TextLayoutCache.Insert(key, str, std::move(tLayout));
+			if (!pLayout)
+			{
+				pLayout = &tLayout; // 没有缓存，直接使用
+			}
+		}
+
+		return DrawTextLayout(*pLayout, Core::Vector2F(left, top));
 	}
 	
 	// native interface
@@ -332,13 +486,40 @@ namespace LuaSTGPlus
 	{
 		float const last_z = m_pTextRenderer->getZ();
 
+		auto* pGlyphManager = m_pTextRenderer->getGlyphManager();
+		if (!pGlyphManager)
+		{
+			return false;
+		}
+
 		updateGraph2DBlendMode(blend);
 		m_pTextRenderer->setZ(z);
 		m_pTextRenderer->setColor(color);
-		
-		Core::Vector2F endpos;
-		const bool result = m_pTextRenderer->drawText(Core::StringView(str, len), pos, &endpos);
-		pos = endpos;
+
+		bool result = pGlyphManager->flush();
+		if (result)
+		{
+			// 排版结果相对于起始笔触位置
+			TextLayoutCache::Key key;
+			key.glyph_manager = pGlyphManager;
+			key.scale = m_pTextRenderer->getScale();
+			key.format = TEXT_LAYOUT_FONT_RENDERER;
+			std::string_view const text(str, len);
+			TextLayoutCache::Layout const* pLayout = m_TextLayoutCache.Find(key, text);
+			TextLayoutCache::Layout tLayout;
+			if (!pLayout)
+			{
+				LayoutTextLine(pGlyphManager, Core::StringView(str, len), Core::Vector2F(), key.scale, tLayout);
+				sortTextLayoutByTexture(pGlyphManager, tLayout);
+				pLayout = m_TextLayoutCache.Insert(key, text, std::move(tLayout));
+				if (!pLayout)
+				{
+					pLayout = &tLayout; // 没有缓存，直接使用
+				}
+			}
+			result = DrawTextLayout(*pLayout, pos);
+			pos += pLayout->advance;
+		}
 
 		m_pTextRenderer->setZ(last_z);
 		return result;
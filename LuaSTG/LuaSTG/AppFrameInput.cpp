@@ -5,6 +5,7 @@
 #include <Windows.h>
 #include "Mouse.h"
 #include "Platform/Keyboard.hpp"
+#include "Debugger/Benchmark.hpp"
 
 namespace LuaSTGPlus
 {
@@ -57,13 +58,23 @@ namespace LuaSTGPlus
     static std::unique_ptr<DirectX::Mouse> Mouse;
     static DirectX::Mouse::State MouseState;
 
+    // 录制与回放的单帧输入
+    struct RecordedInputFrame
+    {
+        Platform::Keyboard::State keyboard;
+        DirectX::Mouse::State mouse;
+    };
+
     void AppFrame::OpenInput()
     {
         g_Keyboard.Reset();
         Mouse = std::make_unique<DirectX::Mouse>();
         ZeroMemory(&MouseState, sizeof(MouseState));
         m_pAppModel->getWindow()->addEventListener(&g_InputEventListener);
-        Mouse->SetWindow((HWND)m_pAppModel->getWindow()->getNativeHandle());
+        if (!m_pAppModel->isHeadless())
+        {
+            Mouse->SetWindow((HWND)m_pAppModel->getWindow()->getNativeHandle());
+        }
     }
     void AppFrame::CloseInput()
     {
@@ -72,6 +83,22 @@ namespace LuaSTGPlus
     }
     void AppFrame::UpdateInput()
     {
+        if (m_Benchmark && m_Benchmark->isReplaying())
+        {
+            // 回放输入记录，忽略真实输入；记录耗尽后保持无输入状态
+            RecordedInputFrame frame{};
+            if (m_Benchmark->readInputFrame(&frame, sizeof(frame)))
+            {
+                g_KeyboardState = frame.keyboard;
+                MouseState = frame.mouse;
+            }
+            else
+            {
+                g_KeyboardState.Reset();
+                ZeroMemory(&MouseState, sizeof(MouseState));
+            }
+            return;
+        }
         g_Keyboard.GetState(g_KeyboardState, true);
         if (Mouse)
         {
@@ -82,6 +109,11 @@ namespace LuaSTGPlus
         {
             ZeroMemory(&MouseState, sizeof(MouseState));
         }
+        if (m_Benchmark && m_Benchmark->isRecording())
+        {
+            RecordedInputFrame const frame{ g_KeyboardState, MouseState };
+            m_Benchmark->writeInputFrame(&frame, sizeof(frame));
+        }
     }
     void AppFrame::ResetKeyboardInput()
     {
@@ -167,7 +199,11 @@ namespace LuaSTGPlus
     }
     Core::Vector2F AppFrame::GetCurrentWindowSizeF()
     {
-        if (m_win32_window_size.x == 0 || m_win32_window_size.y == 0)
+        if (GetAppModel()->isHeadless())
+        {
+            m_win32_window_size = GetAppModel()->getWindow()->getSize(); // 空窗口没有客户区，直接使用记录的尺寸
+        }
+        else if (m_win32_window_size.x == 0 || m_win32_window_size.y == 0)
         {
             RECT rc = {};
             GetClientRect((HWND)GetAppModel()->getWindow()->getNativeHandle(), &rc);
@@ -178,7 +214,11 @@ namespace LuaSTGPlus
     }
     Core::Vector4F AppFrame::GetMousePositionTransformF()
     {
-        if (m_win32_window_size.x == 0 || m_win32_window_size.y == 0)
+        if (GetAppModel()->isHeadless())
+        {
+            m_win32_window_size = GetAppModel()->getWindow()->getSize(); // 空窗口没有客户区，直接使用记录的尺寸
+        }
+        else if (m_win32_window_size.x == 0 || m_win32_window_size.y == 0)
         {
             RECT rc = {};
             GetClientRect((HWND)GetAppModel()->getWindow()->getNativeHandle(), &rc);
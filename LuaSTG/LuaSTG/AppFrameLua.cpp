@@ -2,6 +2,7 @@
 #include "GameResource/ResourcePassword.hpp"
 #include "LuaBinding/LuaAppFrame.hpp"
 #include "LuaBinding/LuaCustomLoader.hpp"
+#include "LuaBinding/LuaBytecodeCache.hpp"
 #include "LuaBinding/LuaInternalSource.hpp"
 #include "LuaBinding/LuaWrapper.hpp"
 extern "C" {
@@ -15,10 +16,11 @@ extern "C" {
 	extern int luaopen_socket_core(lua_State* L);
 }
 #endif
-//#include "lua_xlsx_csv.h"
+#include "lua_xlsx_csv.h"
 #include "lua_steam.h"
 #include "LuaBinding/lua_xinput.hpp"
 #include "LuaBinding/lua_random.hpp"
+#include "LuaBinding/lua_utf8ex.hpp"
 #include "LuaBinding/lua_dwrite.hpp"
 #include "LuaBinding/Resource.hpp"
 
@@ -249,6 +251,7 @@ namespace LuaSTGPlus
 				spdlog::info("[luastg] 加载脚本'{}'", path);
 		}
 		bool loaded = false;
+		bool encrypted = false;
 		std::vector<uint8_t> src;
 		if (packname)
 		{
@@ -256,11 +259,13 @@ namespace LuaSTGPlus
 			if (!arc.empty())
 			{
 				loaded = arc.load(path, src);
+				encrypted = arc.isEncrypted(path);
 			}
 		}
 		else
 		{
 			loaded = GFileManager().loadEx(path, src);
+			encrypted = GFileManager().isEncryptedEx(path);
 		}
 		if (!loaded)
 		{
@@ -268,7 +273,7 @@ namespace LuaSTGPlus
 			luaL_error(SL, "can't load file '%s'", path);
 			return;
 		}
-		if (0 != luaL_loadbuffer(SL, (char const*)src.data(), (size_t)src.size(), luaL_checkstring(SL, 1)))
+		if (0 != lua_load_buffer_cached(SL, (char const*)src.data(), (size_t)src.size(), luaL_checkstring(SL, 1), !encrypted))
 		{
 			const char* tDetail = lua_tostring(SL, -1);
 			spdlog::error("[luajit] 编译'{}'失败：{}", path, tDetail);
@@ -305,13 +310,15 @@ namespace LuaSTGPlus
 			}
 
 			luaopen_cjson(L);
+			luaopen_cjson_ext(L);
 			luaopen_lfs(L);
-			//lua_xlsx_open(L);
-			//lua_csv_open(L);
+			lua_xlsx_open(L);
+			lua_csv_open(L);
 			lua_steam_open(L);
 			lua_xinput_open(L);
 			luaopen_dwrite(L);
 			luaopen_random(L);
+			luaopen_utf8ex(L);
 			luaopen_string_pack(L);
 		#ifdef LUASTG_LINK_LUASOCKET
 			{
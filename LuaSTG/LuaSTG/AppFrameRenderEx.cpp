@@ -160,7 +160,7 @@ namespace LuaSTGPlus
             // 分割 32 份，圆周上 32 个点以及中心点，共 32 个三角形，需要 32 * 3 个索引
             IRenderer::DrawVertex* vert = nullptr;
             IRenderer::DrawIndex* vidx = nullptr;
-            uint16_t vidx_offset = 0;
+            IRenderer::DrawIndex vidx_offset = 0;
             r2d->drawRequest(32 + 1, 32 * 3, &vert, &vidx, &vidx_offset);
             // 计算顶点
             vert[0] = IRenderer::DrawVertex(x, y, 0.5f, 0.0f, 0.0f, color.color());
@@ -223,7 +223,7 @@ namespace LuaSTGPlus
             // 分割 36 份，椭圆周上 36 个点以及中心点，共 36 个三角形，需要 36 * 3 个索引
             IRenderer::DrawVertex* vert = nullptr;
             IRenderer::DrawIndex* vidx = nullptr;
-            uint16_t vidx_offset = 0;
+            IRenderer::DrawIndex vidx_offset = 0;
             r2d->drawRequest(36 + 1, 36 * 3, &vert, &vidx, &vidx_offset);
             // 计算顶点
             vert[0] = IRenderer::DrawVertex(x, y, 0.5f, 0.0f, 0.0f, color.color());
@@ -16,6 +16,15 @@
 
 #define USING_CONSOLE_OUTPUT
 
+// cache compiled Lua bytecode under the user data directory
+// scripts from encrypted archives are never cached, cached bytecode keeps debug info (line numbers in errors)
+#define USING_LUA_BYTECODE_CACHE
+
+// cache fully decoded music (LoadMusic once_decode) under the user data directory
+// music from encrypted archives is never cached, least recently used files are removed above the size limit
+#define USING_MUSIC_DECODE_CACHE
+#define MUSIC_DECODE_CACHE_SIZE_LIMIT (512ull * 1024ull * 1024ull)
+
 // ---------- ---------- game play ---------- ---------- //
 
 // Sakuya: THE WORLD!
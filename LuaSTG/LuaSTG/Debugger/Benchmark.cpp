@@ -0,0 +1,277 @@
+#include "Debugger/Benchmark.hpp"
+#include <algorithm>
+#include <cstring>
+#include "spdlog/spdlog.h"
+#include "nlohmann/json.hpp"
+#include "core/Configuration.hpp"
+
+namespace LuaSTG::Debugger
+{
+	struct InputRecordHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t frame_size;
+	};
+	static constexpr char INPUT_RECORD_MAGIC[8]{ 'L', 'S', 'T', 'G', 'I', 'N', 'P', 'T' };
+	static constexpr uint32_t INPUT_RECORD_VERSION{ 1 };
+	static constexpr uint32_t REPORT_VERSION{ 1 };
+
+	static double toSeconds(std::chrono::high_resolution_clock::duration const d)
+	{
+		return std::chrono::duration<double>(d).count();
+	}
+	static nlohmann::ordered_json makePhaseReport(std::vector<Benchmark::FrameSample> const& samples, double Benchmark::FrameSample::* field)
+	{
+		nlohmann::ordered_json report = nlohmann::ordered_json::object();
+		if (samples.empty())
+		{
+			return report;
+		}
+		std::vector<double> values;
+		values.reserve(samples.size());
+		double total{};
+		for (auto const& sample : samples)
+		{
+			values.push_back(sample.*field * 1000.0);
+			total += values.back();
+		}
+		std::sort(values.begin(), values.end());
+		// 最近秩法求百分位
+		auto const percentile = [&values](double const p) -> double
+		{
+			auto const rank = static_cast<size_t>(p * static_cast<double>(values.size()) + 0.5);
+			return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+		};
+		report["total_ms"] = total;
+		report["mean_ms"] = total / static_cast<double>(values.size());
+		report["min_ms"] = values.front();
+		report["p50_ms"] = percentile(0.50);
+		report["p95_ms"] = percentile(0.95);
+		report["p99_ms"] = percentile(0.99);
+		report["max_ms"] = values.back();
+		return report;
+	}
+
+	bool Benchmark::readInputFrame(void* data, uint32_t const size)
+	{
+		// 回放结束后保持文件打开，后续帧均视为无输入，保证结果可复现
+		if (!m_input.is_open() || m_input_exhausted)
+		{
+			return false;
+		}
+		if (size != m_input_frame_size)
+		{
+			spdlog::error("[luastg] [Benchmark] 输入记录帧大小不匹配（记录 {} 字节，需要 {} 字节），停止回放", m_input_frame_size, size);
+			m_input_exhausted = true;
+			return false;
+		}
+		if (!m_input.read(static_cast<char*>(data), size))
+		{
+			spdlog::info("[luastg] [Benchmark] 输入记录已回放完毕，共 {} 帧", m_input_frame_count);
+			m_input_exhausted = true;
+			return false;
+		}
+		m_input_frame_count += 1;
+		return true;
+	}
+	void Benchmark::writeInputFrame(void const* data, uint32_t const size)
+	{
+		if (!m_record.is_open())
+		{
+			return;
+		}
+		if (m_record_frame_count == 0)
+		{
+			InputRecordHeader header{};
+			std::memcpy(header.magic, INPUT_RECORD_MAGIC, sizeof(header.magic));
+			header.version = INPUT_RECORD_VERSION;
+			header.frame_size = size;
+			m_record.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		}
+		m_record.write(static_cast<char const*>(data), size);
+		m_record_frame_count += 1;
+	}
+
+	void Benchmark::beginUpdate()
+	{
+		m_phase_time = Clock::now();
+	}
+	void Benchmark::endUpdate()
+	{
+		m_update_time = toSeconds(Clock::now() - m_phase_time);
+	}
+	void Benchmark::beginRender()
+	{
+		m_phase_time = Clock::now();
+	}
+	void Benchmark::endRender()
+	{
+		m_render_time = toSeconds(Clock::now() - m_phase_time);
+	}
+	void Benchmark::commitFrame(FrameSample sample)
+	{
+		if (!isMeasuring() || isFinished())
+		{
+			return;
+		}
+		if (m_samples.empty())
+		{
+			m_start_time = Clock::now();
+		}
+		sample.update_time = m_update_time;
+		sample.render_time = m_render_time;
+		m_samples.push_back(sample);
+		m_update_time = 0.0;
+		m_render_time = 0.0;
+	}
+
+	bool Benchmark::writeReport()
+	{
+		if (!isMeasuring() || m_report_written)
+		{
+			return true;
+		}
+		m_report_written = true;
+
+		using json = nlohmann::ordered_json;
+		using Sample = FrameSample;
+
+		json report;
+		report["version"] = REPORT_VERSION;
+		report["completed"] = isFinished();
+		report["frames"] = m_samples.size();
+		report["requested_frames"] = m_frames;
+		report["input"] = m_input_name;
+		report["input_frames"] = m_input_frame_count;
+		report["wall_time"] = m_samples.empty() ? 0.0 : toSeconds(Clock::now() - m_start_time);
+
+		json& phases = report["phases"];
+		phases["update"] = makePhaseReport(m_samples, &Sample::update_time);
+		phases["update_movements"] = makePhaseReport(m_samples, &Sample::update_movements_time);
+		phases["update_next"] = makePhaseReport(m_samples, &Sample::update_next_time);
+		phases["detect_out_of_world_bound"] = makePhaseReport(m_samples, &Sample::detect_out_of_world_bound_time);
+		phases["detect_intersection"] = makePhaseReport(m_samples, &Sample::detect_intersection_time);
+		phases["render"] = makePhaseReport(m_samples, &Sample::render_time);
+		phases["render_objects"] = makePhaseReport(m_samples, &Sample::render_objects_time);
+
+		uint64_t object_alloc{};
+		uint64_t object_free{};
+		uint64_t object_alive_total{};
+		uint64_t object_alive_max{};
+		uint64_t object_colli_check{};
+		uint64_t object_colli_callback{};
+		uint64_t lua_memory_min{ UINT64_MAX };
+		uint64_t lua_memory_max{};
+		for (auto const& sample : m_samples)
+		{
+			object_alloc += sample.object_alloc;
+			object_free += sample.object_free;
+			object_alive_total += sample.object_alive;
+			object_alive_max = std::max(object_alive_max, sample.object_alive);
+			object_colli_check += sample.object_colli_check;
+			object_colli_callback += sample.object_colli_callback;
+			lua_memory_min = std::min(lua_memory_min, sample.lua_memory);
+			lua_memory_max = std::max(lua_memory_max, sample.lua_memory);
+		}
+		double const frame_count = m_samples.empty() ? 1.0 : static_cast<double>(m_samples.size());
+
+		json& objects = report["objects"];
+		objects["alloc"] = object_alloc;
+		objects["free"] = object_free;
+		objects["alloc_per_frame"] = static_cast<double>(object_alloc) / frame_count;
+		objects["alive_mean"] = static_cast<double>(object_alive_total) / frame_count;
+		objects["alive_max"] = object_alive_max;
+		objects["colli_check"] = object_colli_check;
+		objects["colli_callback"] = object_colli_callback;
+
+		json& lua_memory = report["lua_memory"];
+		lua_memory["begin"] = m_samples.empty() ? 0 : m_samples.front().lua_memory;
+		lua_memory["end"] = m_samples.empty() ? 0 : m_samples.back().lua_memory;
+		lua_memory["min"] = m_samples.empty() ? 0 : lua_memory_min;
+		lua_memory["max"] = lua_memory_max;
+
+		std::ofstream file(m_output_path, std::ios::out | std::ios::trunc);
+		if (!file.is_open())
+		{
+			spdlog::error("[luastg] [Benchmark] 无法写入报告 '{}'", m_output_path.generic_string());
+			return false;
+		}
+		file << report.dump(2) << '\n';
+		spdlog::info("[luastg] [Benchmark] 已输出报告 '{}'，共 {} 帧", m_output_path.generic_string(), m_samples.size());
+		return true;
+	}
+
+	bool Benchmark::open()
+	{
+		auto const& config = core::ConfigurationLoader::getInstance().getBenchmark();
+
+		if (config.isEnable())
+		{
+			m_frames = config.getFrames();
+			m_samples.reserve(m_frames);
+			if (!core::ConfigurationLoader::resolveFilePathWithPredefinedVariables(config.hasOutput() ? config.getOutput() : "benchmark.json", m_output_path, true))
+			{
+				spdlog::error("[luastg] [Benchmark] 无法解析报告路径 '{}'", config.getOutput());
+				return false;
+			}
+			if (config.hasInput())
+			{
+				std::filesystem::path input_path;
+				if (!core::ConfigurationLoader::resolveFilePathWithPredefinedVariables(config.getInput(), input_path))
+				{
+					spdlog::error("[luastg] [Benchmark] 无法解析输入记录路径 '{}'", config.getInput());
+					return false;
+				}
+				m_input.open(input_path, std::ios::in | std::ios::binary);
+				InputRecordHeader header{};
+				if (!m_input.is_open()
+					|| !m_input.read(reinterpret_cast<char*>(&header), sizeof(header))
+					|| std::memcmp(header.magic, INPUT_RECORD_MAGIC, sizeof(header.magic)) != 0
+					|| header.version != INPUT_RECORD_VERSION)
+				{
+					spdlog::error("[luastg] [Benchmark] 无法读取输入记录 '{}'", config.getInput());
+					return false;
+				}
+				m_input_name = config.getInput();
+				m_input_frame_size = header.frame_size;
+			}
+			spdlog::info("[luastg] [Benchmark] 基准测试 {} 帧，输入记录：'{}'", m_frames, m_input_name);
+		}
+
+		if (config.hasRecord())
+		{
+			std::filesystem::path record_path;
+			if (!core::ConfigurationLoader::resolveFilePathWithPredefinedVariables(config.getRecord(), record_path, true))
+			{
+				spdlog::error("[luastg] [Benchmark] 无法解析录制路径 '{}'", config.getRecord());
+				return false;
+			}
+			m_record.open(record_path, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!m_record.is_open())
+			{
+				spdlog::error("[luastg] [Benchmark] 无法创建录制文件 '{}'", config.getRecord());
+				return false;
+			}
+			spdlog::info("[luastg] [Benchmark] 录制输入到 '{}'", config.getRecord());
+		}
+
+		return true;
+	}
+	void Benchmark::close()
+	{
+		writeReport();
+		m_input.close();
+		if (m_record.is_open())
+		{
+			spdlog::info("[luastg] [Benchmark] 录制结束，共 {} 帧", m_record_frame_count);
+			m_record.close();
+		}
+	}
+
+	Benchmark::Benchmark() = default;
+	Benchmark::~Benchmark()
+	{
+		close();
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+
+namespace LuaSTG::Debugger
+{
+	// 基于录制输入回放的基准测试
+	// 录制：正常运行时把每帧的输入状态写入文件
+	// 回放：无界面模式下读取输入记录驱动游戏运行指定帧数，统计各阶段耗时并输出 JSON 报告
+	class Benchmark
+	{
+	public:
+		struct FrameSample
+		{
+			double update_time{};                    // EngineUpdate 回调总耗时
+			double render_time{};                    // EngineDraw 回调总耗时
+			double update_movements_time{};          // ObjFrame
+			double update_next_time{};               // AfterFrame
+			double detect_out_of_world_bound_time{}; // BoundCheck
+			double detect_intersection_time{};       // CollisionCheck
+			double render_objects_time{};            // ObjRender
+			uint64_t object_alloc{};
+			uint64_t object_free{};
+			uint64_t object_alive{};
+			uint64_t object_colli_check{};
+			uint64_t object_colli_callback{};
+			uint64_t lua_memory{};                   // 帧结束时 Lua 堆大小（字节）
+		};
+	private:
+		using Clock = std::chrono::high_resolution_clock;
+
+		std::ifstream m_input;
+		std::ofstream m_record;
+		std::filesystem::path m_output_path;
+		std::string m_input_name;
+		uint32_t m_input_frame_size{};
+		uint64_t m_input_frame_count{};
+		bool m_input_exhausted{};
+		uint64_t m_record_frame_count{};
+
+		uint32_t m_frames{};
+		std::vector<FrameSample> m_samples;
+		Clock::time_point m_start_time{};
+		Clock::time_point m_phase_time{};
+		double m_update_time{};
+		double m_render_time{};
+		bool m_report_written{};
+
+	public:
+		/// @brief 是否需要统计并输出报告
+		bool isMeasuring() const noexcept { return m_frames > 0; }
+		/// @brief 是否正在回放输入记录
+		bool isReplaying() const noexcept { return m_input.is_open(); }
+		/// @brief 是否正在录制输入
+		bool isRecording() const noexcept { return m_record.is_open(); }
+		/// @brief 是否已经完成指定帧数
+		bool isFinished() const noexcept { return isMeasuring() && m_samples.size() >= m_frames; }
+
+		/// @brief 读取一帧输入，记录耗尽或格式不匹配时返回 false
+		bool readInputFrame(void* data, uint32_t size);
+		/// @brief 写入一帧输入
+		void writeInputFrame(void const* data, uint32_t size);
+
+		void beginUpdate();
+		void endUpdate();
+		void beginRender();
+		void endRender();
+		/// @brief 提交一帧的统计数据，耗时字段中的 update_time 与 render_time 由计时接口填写
+		void commitFrame(FrameSample sample);
+
+		/// @brief 输出报告，多次调用只输出一次
+		bool writeReport();
+
+	public:
+		/// @brief 根据配置打开输入记录、录制文件，失败时返回 false
+		bool open();
+		void close();
+
+		Benchmark();
+		~Benchmark();
+	};
+}
@@ -660,6 +660,11 @@ static int lib_ShowFrameStatistics(lua_State* L)
 				ImGui::Text("Active : %llu", obj_info.object_alive);
 				ImGui::Text("Colli Check : %llu", obj_info.object_colli_check);
 				ImGui::Text("Colli Callback : %llu", obj_info.object_colli_callback);
+				ImGui::Text("ObjFrame : %.3fms", obj_info.update_movements_time * 1000.0);
+				ImGui::Text("AfterFrame : %.3fms", obj_info.update_next_time * 1000.0);
+				ImGui::Text("BoundCheck : %.3fms", obj_info.detect_out_of_world_bound_time * 1000.0);
+				ImGui::Text("CollisionCheck : %.3fms", obj_info.detect_intersection_time * 1000.0);
+				ImGui::Text("ObjRender : %.3fms", obj_info.render_time * 1000.0);
 
 				ImGui::SliderFloat("Timeline Height##GameObject", &height_2, 256.0f, 512.0f);
 				ImGui::Checkbox("Auto-Fit Y Axis##GameObject", &auto_fit_2);
@@ -999,11 +1004,15 @@ namespace imgui
 		setConfig();
 		loadConfig();
 
-		g_ImGuiRenderDeviceEventListener.onWindowCreate();
-		window->addEventListener(&g_ImGuiRenderDeviceEventListener);
+		// 无界面模式下没有窗口和 Direct3D 11 设备，不初始化平台和渲染后端，只保留 imgui 上下文供脚本调用
+		if (!APP.GetAppModel()->isHeadless())
+		{
+			g_ImGuiRenderDeviceEventListener.onWindowCreate();
+			window->addEventListener(&g_ImGuiRenderDeviceEventListener);
 
-		g_ImGuiRenderDeviceEventListener.onDeviceCreate();
-		device->addEventListener(&g_ImGuiRenderDeviceEventListener);
+			g_ImGuiRenderDeviceEventListener.onDeviceCreate();
+			device->addEventListener(&g_ImGuiRenderDeviceEventListener);
+		}
 
 		luaopen_imgui(L);
 		imgui_binding_lua_register_backend(L);
@@ -1029,11 +1038,14 @@ namespace imgui
 		auto* window = APP.GetAppModel()->getWindow();
 		auto* device = APP.GetAppModel()->getDevice();
 
-		device->removeEventListener(&g_ImGuiRenderDeviceEventListener);
-		g_ImGuiRenderDeviceEventListener.onDeviceDestroy();
+		if (!APP.GetAppModel()->isHeadless())
+		{
+			device->removeEventListener(&g_ImGuiRenderDeviceEventListener);
+			g_ImGuiRenderDeviceEventListener.onDeviceDestroy();
 
-		window->removeEventListener(&g_ImGuiRenderDeviceEventListener);
-		g_ImGuiRenderDeviceEventListener.onWindowDestroy();
+			window->removeEventListener(&g_ImGuiRenderDeviceEventListener);
+			g_ImGuiRenderDeviceEventListener.onWindowDestroy();
+		}
 
 		ImPlot::DestroyContext();
 		ImGui::DestroyContext();
@@ -1064,12 +1076,31 @@ namespace imgui
 				auto& io = ImGui::GetIO();
 				io.Fonts->Clear();
 				setConfig();
-				ImGui_ImplDX11_InvalidateDeviceObjects();
+				if (!LAPP.GetAppModel()->isHeadless())
+					ImGui_ImplDX11_InvalidateDeviceObjects();
 			}
 			constexpr int const mask = (~((int)ImGuiConfigFlags_NoMouseCursorChange));
 			auto& io = ImGui::GetIO();
 			if (allow_set_cursor)
 				io.ConfigFlags &= mask;
+			if (LAPP.GetAppModel()->isHeadless())
+			{
+				// 无界面模式：没有后端帮忙填写帧数据，字体图集也只在 CPU 上构建，不会绘制
+				auto const ws = LAPP.GetAppModel()->getSwapChain()->getCanvasSize();
+				io.DisplaySize = ImVec2((float)ws.x, (float)ws.y);
+				io.DeltaTime = 1.0f / (float)std::max(1u, core::ConfigurationLoader::getInstance().getTiming().getFrameRate());
+				if (!io.Fonts->IsBuilt())
+				{
+					unsigned char* pixels = nullptr;
+					int width = 0, height = 0;
+					io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+				}
+				if (io.WantCaptureKeyboard)
+					LAPP.ResetKeyboardInput();
+				if (io.WantCaptureMouse)
+					LAPP.ResetMouseInput();
+				return;
+			}
 			{
 				tracy_zone_scoped_with_name("imgui.backend.NewFrame-D3D11");
 				ImGui_ImplDX11_NewFrame();
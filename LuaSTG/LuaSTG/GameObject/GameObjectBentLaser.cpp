@@ -1,5 +1,6 @@
 ﻿#include "GameObject/GameObjectBentLaser.hpp"
 #include "AppFrame.h"
+#include "LuaBinding/LuaWrapper.hpp"
 
 using namespace LuaSTGPlus;
 
@@ -465,7 +466,7 @@ bool GameObjectBentLaser::Render(const char* tex_name, BlendMode blend, Core::Co
 	uint16_t const node_count = (uint16_t)m_Queue.Size();
 	IRenderer::DrawVertex* p_vertex = nullptr;
 	IRenderer::DrawIndex* p_index = nullptr;
-	uint16_t index_offset = 0;
+	IRenderer::DrawIndex index_offset = 0;
 	if (!p_renderer->drawRequest(
 		node_count * 2,
 		(node_count - 1) * 6,
@@ -785,14 +786,26 @@ bool GameObjectBentLaser::UpdatePositionByList(lua_State * L, int length, float
 	{
 		//获得x,y
 		lua_rawgeti(L, -1, i + 1);// ... t(list) t(object)
-		lua_pushstring(L, "x");// ... t(list) t(object) 'x'
-		lua_gettable(L, -2);// ... t(list) t(object) x
-		float x = (float)luaL_optnumber(L, -1, 0.0);
-		lua_pop(L, 1);
-		lua_pushstring(L, "y");// ... t(list) t(object) 'y'
-		lua_gettable(L, -2);// ... t(list) t(object) y
-		float y = (float)luaL_optnumber(L, -1, 0.0);// ... t(list) t(object) y
-		lua_pop(L, 2);// ... t(list)
+		float x, y;
+		if (lua_type(L, -1) == LUA_TUSERDATA)
+		{
+			// lstg.Vector2 直接读取，不走元方法查表
+			auto const v = LuaWrapper::Vector2Wrapper::CheckValue(L, -1);
+			x = (float)v.x;
+			y = (float)v.y;
+			lua_pop(L, 1);// ... t(list)
+		}
+		else
+		{
+			lua_pushstring(L, "x");// ... t(list) t(object) 'x'
+			lua_gettable(L, -2);// ... t(list) t(object) x
+			x = (float)luaL_optnumber(L, -1, 0.0);
+			lua_pop(L, 1);
+			lua_pushstring(L, "y");// ... t(list) t(object) 'y'
+			lua_gettable(L, -2);// ... t(list) t(object) y
+			y = (float)luaL_optnumber(L, -1, 0.0);// ... t(list) t(object) y
+			lua_pop(L, 2);// ... t(list)
+		}
 
 		//得到index
 		//顶点处在队列前边
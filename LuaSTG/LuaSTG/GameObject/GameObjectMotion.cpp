@@ -0,0 +1,362 @@
+#include "GameObject/GameObjectMotion.hpp"
+#include "GameResource/ResourceSprite.hpp"
+#include "GameResource/ResourceAnimation.hpp"
+#include "lua/plus.hpp"
+#include "LMathConstant.hpp"
+#include "AppFrame.h"
+
+namespace LuaSTGPlus
+{
+	using GameObjectMotionProgramPtr = std::shared_ptr<GameObjectMotionProgram const>;
+
+	// 单帧内最多连续执行的瞬时指令数量，超过时认为程序陷入了没有等待的死循环
+	constexpr uint32_t max_instant_commands = 64;
+
+	static lua::cached_metatable_t g_MotionProgramMetatable("lstg.MotionProgram");
+
+	inline lua_Number speed_of(GameObject const* p) noexcept
+	{
+		return std::sqrt(p->vx * p->vx + p->vy * p->vy);
+	}
+	// 速度为 0 时使用程序记录的方向，没有记录时使用对象的朝向
+	inline lua_Number direction_of(GameObject const* p, GameObjectMotion::State const& state) noexcept
+	{
+		if (std::abs(p->vx) > DBL_MIN || std::abs(p->vy) > DBL_MIN)
+		{
+			return std::atan2(p->vy, p->vx);
+		}
+		return state.has_heading ? state.heading : p->rot;
+	}
+	inline void set_velocity(GameObject* p, GameObjectMotion::State& state, lua_Number const speed, lua_Number const angle) noexcept
+	{
+		p->vx = speed * std::cos(angle);
+		p->vy = speed * std::sin(angle);
+		state.heading = angle;
+		state.has_heading = true;
+	}
+	static void change_image(GameObject* p, std::string const& name)
+	{
+		if (p->res)
+		{
+			// 粒子系统在 lua 侧还持有资源，不能在这里释放
+			if (p->res->GetType() == ResourceType::Particle || p->res->GetResName() == name)
+			{
+				return;
+			}
+		}
+		p->ReleaseResource();
+		p->ChangeResource(name);
+	}
+
+	void GameObjectMotion::step(GameObject* p, State& state)
+	{
+		auto const& commands = state.program->commands;
+		uint32_t budget = max_instant_commands;
+		while (state.pc < commands.size() && budget > 0)
+		{
+			GameObjectMotionCommand const& cmd = commands[state.pc];
+			switch (cmd.op)
+			{
+			case GameObjectMotionOp::Wait:
+			case GameObjectMotionOp::Accelerate:
+			case GameObjectMotionOp::Turn:
+				// 持续指令，每帧执行一次
+				if (state.remain == 0)
+				{
+					state.remain = cmd.frames;
+					if (cmd.op == GameObjectMotionOp::Accelerate)
+					{
+						state.delta = (cmd.value - speed_of(p)) / (lua_Number)cmd.frames;
+					}
+				}
+				state.remain -= 1;
+				if (cmd.op == GameObjectMotionOp::Accelerate)
+				{
+					// 最后一帧直接使用目标速度，避免累积误差
+					lua_Number const speed = (state.remain == 0) ? cmd.value : speed_of(p) + state.delta;
+					set_velocity(p, state, speed, direction_of(p, state));
+				}
+				else if (cmd.op == GameObjectMotionOp::Turn)
+				{
+					set_velocity(p, state, speed_of(p), direction_of(p, state) + cmd.angle);
+				}
+				if (state.remain == 0)
+				{
+					state.pc += 1;
+				}
+				if (state.pc < commands.size())
+				{
+					return;
+				}
+				break;
+			case GameObjectMotionOp::Speed:
+				set_velocity(p, state, cmd.value, cmd.has_angle ? cmd.angle : direction_of(p, state));
+				state.pc += 1;
+				break;
+			case GameObjectMotionOp::Aim:
+				if (state.target && state.target->status == GameObjectStatus::Active && state.target->uid == state.target_uid)
+				{
+					lua_Number const angle = std::atan2(state.target->y - p->y, state.target->x - p->x) + cmd.angle;
+					set_velocity(p, state, speed_of(p), angle);
+				}
+				state.pc += 1;
+				break;
+			case GameObjectMotionOp::Image:
+				change_image(p, state.program->names[cmd.index]);
+				state.pc += 1;
+				break;
+			case GameObjectMotionOp::Loop:
+				if (cmd.frames == 0)
+				{
+					state.pc = cmd.index;
+				}
+				else
+				{
+					if (state.loop == 0)
+					{
+						state.loop = cmd.frames;
+					}
+					state.loop -= 1;
+					state.pc = (state.loop > 0) ? cmd.index : state.pc + 1;
+				}
+				break;
+			}
+			budget -= 1;
+		}
+		if (budget == 0)
+		{
+			spdlog::warn("[luastg] 运动程序在第 {} 条指令处陷入没有等待的循环，已卸载", state.pc + 1);
+		}
+		// 执行完毕，卸载后恢复调用 frame 回调
+		Detach(p);
+	}
+
+	void GameObjectMotion::Attach(GameObject* p, GameObjectMotionProgramPtr program, GameObject* target)
+	{
+		if (p->id >= m_states.size())
+		{
+			m_states.resize(p->id + 1);
+		}
+		State& state = m_states[p->id];
+		if (!state.program)
+		{
+			m_count += 1;
+		}
+		state = State{};
+		state.program = std::move(program);
+		if (target)
+		{
+			state.target = target;
+			state.target_uid = target->uid;
+		}
+	}
+	void GameObjectMotion::Detach(GameObject* p) noexcept
+	{
+		if (p->id < m_states.size() && m_states[p->id].program)
+		{
+			m_states[p->id] = State{};
+			m_count -= 1;
+		}
+	}
+	void GameObjectMotion::Clear() noexcept
+	{
+		m_states.clear();
+		m_count = 0;
+	}
+	bool GameObjectMotion::GetProgramCounter(GameObject* p, uint32_t& pc) const noexcept
+	{
+		if (p->id < m_states.size() && m_states[p->id].program)
+		{
+			pc = m_states[p->id].pc;
+			return true;
+		}
+		return false;
+	}
+
+	// lua 接口
+
+	static int motion_program_gc(lua_State* L)
+	{
+		auto* p = static_cast<GameObjectMotionProgramPtr*>(lua_touserdata(L, 1));
+		p->~GameObjectMotionProgramPtr();
+		return 0;
+	}
+	static int motion_program_len(lua_State* L)
+	{
+		auto const& program = CheckGameObjectMotionProgram(L, 1);
+		lua_pushinteger(L, (lua_Integer)program->commands.size());
+		return 1;
+	}
+	static int motion_program_tostring(lua_State* L)
+	{
+		auto const& program = CheckGameObjectMotionProgram(L, 1);
+		lua_pushfstring(L, "lstg.MotionProgram(%d)", (int)program->commands.size());
+		return 1;
+	}
+
+	void RegisterGameObjectMotionProgram(lua_State* L)
+	{
+		luaL_Reg const mt[] = {
+			{ "__gc", &motion_program_gc },
+			{ "__len", &motion_program_len },
+			{ "__tostring", &motion_program_tostring },
+			{ NULL, NULL },
+		};
+		g_MotionProgramMetatable.create(L);	// ... mt
+		luaL_register(L, NULL, mt);			// ... mt
+		lua_pop(L, 1);						// ...
+	}
+
+	int PushGameObjectMotionProgram(lua_State* L, int idx)
+	{
+		luaL_checktype(L, idx, LUA_TTABLE);
+		int const count = (int)lua_objlen(L, idx);
+
+		// 先创建 userdata，编译出错时程序由 __gc 回收
+		auto program = std::make_shared<GameObjectMotionProgram>();
+		GameObjectMotionProgram* const raw = program.get();
+		void* const storage = lua_newuserdata(L, sizeof(GameObjectMotionProgramPtr));	// ... ud
+		new(storage) GameObjectMotionProgramPtr(std::move(program));
+		g_MotionProgramMetatable.apply(L, -1);
+		int const ud = lua_gettop(L);
+		raw->commands.reserve((size_t)count);
+
+		for (int i = 1; i <= count; i += 1)
+		{
+			lua_rawgeti(L, idx, i);													// ... ud cmd
+			if (!lua_istable(L, -1))
+			{
+				return luaL_error(L, "motion command %d: table expected", i);
+			}
+			int const t = lua_gettop(L);
+			auto const arg_number = [L, t, i](int const k, bool const optional, lua_Number const def) -> lua_Number
+			{
+				lua_rawgeti(L, t, k);
+				if (optional && lua_isnil(L, -1))
+				{
+					lua_pop(L, 1);
+					return def;
+				}
+				if (!lua_isnumber(L, -1))
+				{
+					luaL_error(L, "motion command %d: number expected at #%d", i, k);
+				}
+				lua_Number const value = lua_tonumber(L, -1);
+				lua_pop(L, 1);
+				return value;
+			};
+			auto const arg_frames = [L, &arg_number, i](int const k) -> int32_t
+			{
+				lua_Number const value = arg_number(k, false, 0.0);
+				if (!(value >= 1.0 && value <= (lua_Number)INT32_MAX))
+				{
+					luaL_error(L, "motion command %d: frame count must be positive", i);
+				}
+				return (int32_t)value;
+			};
+			auto const arg_speed = [L, &arg_number, i](int const k) -> lua_Number
+			{
+				lua_Number const value = arg_number(k, false, 0.0);
+				if (!(value >= 0.0))
+				{
+					luaL_error(L, "motion command %d: speed must not be negative", i);
+				}
+				return value;
+			};
+
+			lua_rawgeti(L, t, 1);
+			size_t len = 0;
+			char const* op_str = lua_tolstring(L, -1, &len);
+			std::string_view const op(op_str ? op_str : "", op_str ? len : 0);
+			lua_pop(L, 1);
+
+			GameObjectMotionCommand cmd;
+			if (op == "wait")
+			{
+				cmd.op = GameObjectMotionOp::Wait;
+				cmd.frames = arg_frames(2);
+			}
+			else if (op == "speed")
+			{
+				cmd.op = GameObjectMotionOp::Speed;
+				cmd.value = arg_speed(2);
+				lua_rawgeti(L, t, 3);
+				cmd.has_angle = !lua_isnil(L, -1);
+				lua_pop(L, 1);
+				cmd.angle = arg_number(3, true, 0.0) * L_DEG_TO_RAD;
+			}
+			else if (op == "accel")
+			{
+				cmd.op = GameObjectMotionOp::Accelerate;
+				cmd.value = arg_speed(2);
+				cmd.frames = arg_frames(3);
+			}
+			else if (op == "turn")
+			{
+				cmd.op = GameObjectMotionOp::Turn;
+				cmd.angle = arg_number(2, false, 0.0) * L_DEG_TO_RAD;
+				cmd.frames = arg_frames(3);
+			}
+			else if (op == "aim")
+			{
+				cmd.op = GameObjectMotionOp::Aim;
+				cmd.angle = arg_number(2, true, 0.0) * L_DEG_TO_RAD;
+			}
+			else if (op == "img")
+			{
+				cmd.op = GameObjectMotionOp::Image;
+				lua_rawgeti(L, t, 2);
+				if (!lua_isstring(L, -1))
+				{
+					return luaL_error(L, "motion command %d: image name expected", i);
+				}
+				std::string name(lua_tostring(L, -1));
+				lua_pop(L, 1);
+				if (!LRES.FindSprite(name.c_str()) && !LRES.FindAnimation(name.c_str()))
+				{
+					return luaL_error(L, "motion command %d: can't find image or animation '%s'", i, name.c_str());
+				}
+				cmd.index = (uint32_t)raw->names.size();
+				raw->names.emplace_back(std::move(name));
+			}
+			else if (op == "loop")
+			{
+				cmd.op = GameObjectMotionOp::Loop;
+				lua_Number const target = arg_number(2, false, 0.0);
+				if (!(target >= 1.0 && target < (lua_Number)i))
+				{
+					return luaL_error(L, "motion command %d: loop target must be a previous command", i);
+				}
+				lua_Number const times = arg_number(3, true, 0.0);
+				if (!(times >= 0.0 && times <= (lua_Number)INT32_MAX))
+				{
+					return luaL_error(L, "motion command %d: loop count must not be negative", i);
+				}
+				cmd.index = (uint32_t)target - 1;
+				cmd.frames = (int32_t)times;
+				// 循环计数器只有一个，循环体内不能再有循环
+				for (uint32_t j = cmd.index; j < raw->commands.size(); j += 1)
+				{
+					if (raw->commands[j].op == GameObjectMotionOp::Loop)
+					{
+						return luaL_error(L, "motion command %d: nested loop is not supported", i);
+					}
+				}
+			}
+			else
+			{
+				return luaL_error(L, "motion command %d: unknown command '%s'", i, op_str ? op_str : "?");
+			}
+			raw->commands.push_back(cmd);
+			lua_pop(L, 1);															// ... ud
+		}
+
+		lua_settop(L, ud);
+		return 1;
+	}
+
+	GameObjectMotionProgramPtr const& CheckGameObjectMotionProgram(lua_State* L, int idx)
+	{
+		return *g_MotionProgramMetatable.check<GameObjectMotionProgramPtr>(L, idx);
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "GameObject/GameObject.hpp"
+#include <memory>
+#include <vector>
+#include <string>
+
+namespace LuaSTGPlus
+{
+	// 运动程序：描述对象随时间变化的简单运动，由 lua 编译一次后挂载到对象上，在运动更新中由 C++ 逐帧解释执行
+	// 挂载运动程序期间，对象按 IsDefaultUpdate 处理，不再调用 frame 回调；程序执行完毕后自动卸载，恢复调用 frame 回调
+	// 程序只修改速度和图像，坐标仍然由对象池的运动更新计算
+	enum class GameObjectMotionOp : uint8_t
+	{
+		Wait,       // { "wait", n } 等待 n 帧
+		Speed,      // { "speed", v [, angle] } 设置速度大小，提供角度时同时设置速度方向
+		Accelerate, // { "accel", v, n } 在 n 帧内把速度大小线性变化到 v，方向不变
+		Turn,       // { "turn", angle, n } 连续 n 帧，每帧把速度方向旋转 angle 度
+		Aim,        // { "aim" [, offset] } 速度方向指向挂载时指定的目标对象，再偏移 offset 度，目标无效时忽略
+		Image,      // { "img", name } 切换图像资源，只支持精灵和动画
+		Loop,       // { "loop", index, count } 跳回第 index 条指令，中间的指令共执行 count 次，count 为 0 时无限循环，不支持嵌套
+	};
+
+	struct GameObjectMotionCommand
+	{
+		GameObjectMotionOp op{};
+		bool has_angle{};       // Speed 是否设置了方向
+		int32_t frames{};       // 持续帧数，Loop 为执行次数
+		uint32_t index{};       // Loop 的跳转目标，Image 的资源名下标
+		lua_Number value{};     // 速度大小
+		lua_Number angle{};     // 角度，弧度制
+	};
+
+	struct GameObjectMotionProgram
+	{
+		std::vector<GameObjectMotionCommand> commands;
+		std::vector<std::string> names;
+	};
+
+	class GameObjectMotion
+	{
+	public:
+		struct State
+		{
+			std::shared_ptr<GameObjectMotionProgram const> program;
+			uint32_t pc{};                // 当前指令
+			int32_t remain{};             // 当前持续指令剩余的帧数，为 0 表示尚未开始
+			int32_t loop{};               // Loop 剩余的执行次数，为 0 表示尚未开始
+			lua_Number delta{};           // Accelerate 每帧的速度变化量
+			lua_Number heading{};         // 速度为 0 时保留的速度方向
+			bool has_heading{};           // 为 false 时使用对象的朝向
+			GameObject* target{};         // Aim 的目标
+			uint64_t target_uid{};        // 对象槽位会被复用，用于校验目标
+		};
+
+	private:
+		std::vector<State> m_states; // 以对象 id 为下标
+		size_t m_count{ 0 };         // 挂载了运动程序的对象数量
+
+		void step(GameObject* p, State& state);
+
+	public:
+		/// @brief 挂载运动程序，替换已有的程序，target 可以为空
+		void Attach(GameObject* p, std::shared_ptr<GameObjectMotionProgram const> program, GameObject* target);
+		/// @brief 卸载运动程序
+		void Detach(GameObject* p) noexcept;
+		/// @brief 卸载所有运动程序
+		void Clear() noexcept;
+		/// @brief 获取正在执行的指令下标（从 0 开始），没有挂载运动程序时返回 false
+		bool GetProgramCounter(GameObject* p, uint32_t& pc) const noexcept;
+
+		/// @brief 执行一帧，返回 false 表示对象没有挂载运动程序
+		bool Step(GameObject* p)
+		{
+			if (m_count == 0 || p->id >= m_states.size() || !m_states[p->id].program)
+			{
+				return false;
+			}
+			step(p, m_states[p->id]);
+			return true;
+		}
+	};
+
+	// 创建 lstg.MotionProgram 的元表
+	void RegisterGameObjectMotionProgram(lua_State* L);
+
+	// 把 idx 处的指令列表编译为运动程序并压入栈
+	int PushGameObjectMotionProgram(lua_State* L, int idx);
+
+	// 检查 idx 处是否为运动程序
+	std::shared_ptr<GameObjectMotionProgram const> const& CheckGameObjectMotionProgram(lua_State* L, int idx);
+}
@@ -1,8 +1,10 @@
 #include "GameObject/GameObjectPool.h"
+#include "GameObject/GameObjectStateView.hpp"
 #include "LuaBinding/LuaWrapper.hpp"
 #include "LuaBinding/generated/GameObjectMember.hpp"
 #include "lua/plus.hpp"
 #include "AppFrame.h"
+#include "Utility/Utility.h"
 
 #define LOBJPOOL_SIZE_INTERNAL (LOBJPOOL_SIZE + 1)
 #define LOBJPOOL_METATABLE_IDX (LOBJPOOL_SIZE_INTERNAL)
@@ -162,6 +164,8 @@ namespace LuaSTGPlus
 		_InsertToUpdateLinkList(p);
 		_InsertToRenderList(p);
 		_InsertToColliLinkList(p, (size_t)p->group);
+		m_SpatialIndex.Insert(p, (size_t)p->group);
+		m_SpatialIndex.Insert(p, LOBJPOOL_GROUPN);
 		m_DbgData[m_DbgIdx].object_alloc += 1;
 		return p;
 	}
@@ -171,7 +175,8 @@ namespace LuaSTGPlus
 		GameObject* ret = object->pUpdateNext;
 		_RemoveFromUpdateLinkList(object);
 		_RemoveFromRenderList(object);
-		_RemoveFromColliLinkList(object);
+		_RemoveFromColliLinkList(object); // 网格中的记录在查询时通过状态和 uid 排除
+		m_Motion.Detach(object);
 		if (m_pCurrentObject == object)
 		{
 			m_pCurrentObject = nullptr;
@@ -251,6 +256,87 @@ namespace LuaSTGPlus
 		lua_pop(L, 2);							// ??? ot
 	}
 
+	GameObjectSpatialIndex::Grid const& GameObjectPool::_PrepareSpatialIndex(lua_Integer group)
+	{
+		if (group < 0 || group >= LOBJPOOL_GROUPN)
+		{
+			return m_SpatialIndex.Prepare(LOBJPOOL_GROUPN, -1, [this](std::vector<GameObject*>& objects)
+			{
+				for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second; p = p->pUpdateNext)
+				{
+					if (p->status == GameObjectStatus::Active)
+						objects.push_back(p);
+				}
+			});
+		}
+		auto& list = m_ColliLinkList[(size_t)group];
+		return m_SpatialIndex.Prepare((size_t)group, group, [&list](std::vector<GameObject*>& objects)
+		{
+			for (GameObject* p = list.first.pColliNext; p != &list.second; p = p->pColliNext)
+			{
+				if (p->status == GameObjectStatus::Active)
+					objects.push_back(p);
+			}
+		});
+	}
+	int GameObjectPool::_PushSpatialQueryResult(lua_State* L)
+	{
+		GetObjectTable(L);											// ... ot
+		lua_createtable(L, (int)m_SpatialQueryResult.size(), 0);	// ... ot t
+		int i = 1;
+		for (GameObject* p : m_SpatialQueryResult)
+		{
+			lua_rawgeti(L, -2, (int)p->id + 1);						// ... ot t object
+			lua_rawseti(L, -2, i);									// ... ot t
+			i += 1;
+		}
+		lua_remove(L, -2);											// ... t
+		return 1;
+	}
+	int GameObjectPool::_ApplySpatialQueryResult(lua_State* L, int callback)
+	{
+		// 回调中可能创建、删除对象甚至再次查询，先复制查询结果，调用前检查对象是否仍然有效
+		struct Target
+		{
+			uint64_t uid;
+			uint32_t index;
+		};
+		std::pmr::vector<Target> targets{ &local_memory_resource };
+		targets.reserve(m_SpatialQueryResult.size());
+		for (GameObject* p : m_SpatialQueryResult)
+		{
+			targets.push_back(Target{ .uid = p->uid, .index = static_cast<uint32_t>(p->id) });
+		}
+		GetObjectTable(L);											// ... ot
+		int const ot = lua_gettop(L);
+		lua_Integer count = 0;
+		for (auto const& target : targets)
+		{
+			GameObject* p = m_ObjectPool.object(target.index);
+			if (!p || p->uid != target.uid || p->status != GameObjectStatus::Active)
+				continue;
+			count += 1;
+			if (callback > 0)
+			{
+				lua_pushvalue(L, callback);							// ... ot callback
+				lua_rawgeti(L, ot, (int)target.index + 1);			// ... ot callback object
+				lua_call(L, 1, 0);									// ... ot
+			}
+			else
+			{
+				// 与 lstg.Kill 相同
+				p->status = GameObjectStatus::Killed;
+#ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+				if (!p->luaclass.IsDefaultLegacyKill)
+#endif // USING_ADVANCE_GAMEOBJECT_CLASS
+					_GameObjectCallback(L, ot, p, LGOBJ_CC_KILL);
+			}
+		}
+		lua_pop(L, 1);												// ...
+		lua_pushinteger(L, count);
+		return 1;
+	}
+
 	// --------------------------------------------------------------------------------
 
 	void GameObjectPool::DebugNextFrame()
@@ -261,6 +347,11 @@ namespace LuaSTGPlus
 		m_DbgData[m_DbgIdx].object_alive = m_ObjectPool.size();
 		m_DbgData[m_DbgIdx].object_colli_check = 0;
 		m_DbgData[m_DbgIdx].object_colli_callback = 0;
+		m_DbgData[m_DbgIdx].update_movements_time = 0.0;
+		m_DbgData[m_DbgIdx].update_next_time = 0.0;
+		m_DbgData[m_DbgIdx].detect_out_of_world_bound_time = 0.0;
+		m_DbgData[m_DbgIdx].detect_intersection_time = 0.0;
+		m_DbgData[m_DbgIdx].render_time = 0.0;
 	}
 	GameObjectPool::FrameStatistics GameObjectPool::DebugGetFrameStatistics()
 	{
@@ -268,6 +359,10 @@ namespace LuaSTGPlus
 		size_t const i = (m_DbgIdx + n - 1) % n;
 		return m_DbgData[i];
 	}
+	GameObjectPool::FrameStatistics GameObjectPool::DebugGetCurrentFrameStatistics()
+	{
+		return m_DbgData[m_DbgIdx];
+	}
 
 	int GameObjectPool::GetObjectTable(lua_State* L) noexcept
 	{
@@ -313,6 +408,8 @@ namespace LuaSTGPlus
 		// 重置其他链表
 		_ClearLinkList();
 		m_RenderList.clear();
+		m_SpatialIndex.Clear();
+		m_Motion.Clear();
 		// 重置整个对象池，恢复为线性状态
 		m_ObjectPool.clear();
 		// 重置其他数据
@@ -328,29 +425,46 @@ namespace LuaSTGPlus
 	}
 	void GameObjectPool::updateMovementsLegacy(int32_t objects_index, lua_State* L) {
 		tracy_zone_scoped_with_name("LOBJMGR.ObjFrame");
+		AccumulateTimerScope timer(m_DbgData[m_DbgIdx].update_movements_time);
 
+		// 后续对象的回调中可能进行空间查询，网格在本阶段内只构建一次，记录每次运动更新的位移用于扩大查找范围
+		auto const update = [this](GameObject* p) {
+			lua_Number const x = p->x;
+			lua_Number const y = p->y;
+			p->Update();
+			m_SpatialIndex.OnStep(p, x, y);
+		};
 		int superpause = UpdateSuperPause(); // 更新超级暂停
 		for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second; p = p->pUpdateNext) {
 			if (superpause <= 0 || p->ignore_superpause) {
+				if (m_Motion.Step(p)) {
+					update(p); // 运动程序代替 frame 回调
+					continue;
+				}
 #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
 				if (p->luaclass.IsDefaultUpdate) {
-					p->Update(); // 默认更新逻辑
+					update(p); // 默认更新逻辑
 					continue;
 				}
 #endif // USING_ADVANCE_GAMEOBJECT_CLASS
 				m_pCurrentObject = p;
 				_GameObjectCallback(L, objects_index, p, LGOBJ_CC_FRAME);
 				m_pCurrentObject = nullptr;
-				p->Update();
+				update(p);
 			}
 		}
+		m_SpatialIndex.Invalidate();
 	}
 	void GameObjectPool::updateMovements(int32_t objects_index, lua_State* L) {
 		tracy_zone_scoped_with_name("LOBJMGR.ObjFrame(New)");
+		AccumulateTimerScope timer(m_DbgData[m_DbgIdx].update_movements_time);
 
 		int superpause = GetSuperPauseTime();
 		for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second; p = p->pUpdateNext) {
 			if (superpause <= 0 || p->ignore_superpause) {
+				if (m_Motion.Step(p)) {
+					continue; // 运动程序代替 frame 回调
+				}
 #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
 				if (p->luaclass.IsDefaultUpdate) {
 					continue;
@@ -367,9 +481,12 @@ namespace LuaSTGPlus
 				p->UpdateV2();
 			}
 		}
+		m_SpatialIndex.Invalidate();
 	}
 	void GameObjectPool::DoRender() noexcept
 	{
+		AccumulateTimerScope timer(m_DbgData[m_DbgIdx].render_time);
+
 		GetObjectTable(G_L); // ot
 		int const ot_idx = lua_gettop(G_L);
 
@@ -386,6 +503,10 @@ namespace LuaSTGPlus
 			if (!p->hide)  // 只渲染可见对象
 #endif // USING_MULTI_GAME_WORLD
 			{
+				if (m_RenderQueue.IsActive() && m_RenderQueue.Push(p))
+				{
+					continue; // 延迟到同图层的对象收集完后再按批次渲染
+				}
 				m_pCurrentObject = p;
 #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
 				if (!p->luaclass.IsDefaultRender)
@@ -401,6 +522,7 @@ namespace LuaSTGPlus
 #endif // USING_ADVANCE_GAMEOBJECT_CLASS
 			}
 		}
+		m_RenderQueue.Flush();
 		m_pCurrentObject = nullptr;
 		m_IsRendering = false;
 
@@ -422,6 +544,7 @@ namespace LuaSTGPlus
 	void GameObjectPool::updateNextLegacy(int32_t objects_index, lua_State*)
 	{
 		tracy_zone_scoped_with_name("LOBJMGR.AfterFrame");
+		AccumulateTimerScope timer(m_DbgData[m_DbgIdx].update_next_time);
 
 		int superpause = GetSuperPauseTime();
 		for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second;)
@@ -446,6 +569,7 @@ namespace LuaSTGPlus
 	}
 	void GameObjectPool::updateNext(int32_t objects_index, lua_State*) {
 		tracy_zone_scoped_with_name("LOBJMGR.AfterFrame(New)");
+		AccumulateTimerScope timer(m_DbgData[m_DbgIdx].update_next_time);
 
 		int superpause = UpdateSuperPause(); // 更新超级暂停
 		for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second;)
@@ -470,6 +594,7 @@ namespace LuaSTGPlus
 	}
 	void GameObjectPool::detectOutOfWorldBoundLegacy(int32_t objects_index, lua_State* L) {
 		tracy_zone_scoped_with_name("LOBJMGR.BoundCheck");
+		AccumulateTimerScope timer(m_DbgData[m_DbgIdx].detect_out_of_world_bound_time);
 
 #ifdef USING_MULTI_GAME_WORLD
 		auto const world = GetWorldFlag();
@@ -498,6 +623,7 @@ namespace LuaSTGPlus
 	}
 	void GameObjectPool::detectOutOfWorldBound(int32_t objects_index, lua_State* L) {
 		tracy_zone_scoped_with_name("LOBJMGR.BoundCheck(New)");
+		AccumulateTimerScope timer(m_DbgData[m_DbgIdx].detect_out_of_world_bound_time);
 
 		struct OutOfWorldBoundDetectionResult {
 			uint64_t id{};
@@ -552,6 +678,7 @@ namespace LuaSTGPlus
 	}
 	void GameObjectPool::detectIntersectionLegacy(uint32_t group1_, uint32_t group2_, int32_t objects_index, lua_State* L) {
 		tracy_zone_scoped_with_name("LOBJMGR.CollisionCheck");
+		AccumulateTimerScope timer(m_DbgData[m_DbgIdx].detect_intersection_time);
 		auto& debug_data = m_DbgData[m_DbgIdx];
 		auto& group1 = m_ColliLinkList[group1_];
 		auto& group2 = m_ColliLinkList[group2_];
@@ -595,6 +722,7 @@ namespace LuaSTGPlus
 	}
 	void GameObjectPool::detectIntersection(std::pmr::vector<IntersectionDetectionGroupPair> const& group_pairs, int32_t objects_index, lua_State* L) {
 		tracy_zone_scoped_with_name("LOBJMGR.CollisionCheck(New)");
+		AccumulateTimerScope timer(m_DbgData[m_DbgIdx].detect_intersection_time);
 		std::pmr::deque<IntersectionDetectionResult> cache{ &local_memory_resource };
 		for (auto const& group_pair : group_pairs) {
 			auto& debug_data = m_DbgData[m_DbgIdx];
@@ -842,6 +970,9 @@ namespace LuaSTGPlus
 		_InsertToUpdateLinkList(p);
 		_InsertToRenderList(p);
 		_InsertToColliLinkList(p, (size_t)p->group);
+		m_SpatialIndex.Insert(p, (size_t)p->group); // uid 变了，网格中原来的记录会被排除
+		m_SpatialIndex.Insert(p, LOBJPOOL_GROUPN);
+		m_Motion.Detach(p);
 	}
 	int GameObjectPool::Del(lua_State* L, bool kill_mode) noexcept
 	{
@@ -1270,6 +1401,98 @@ namespace LuaSTGPlus
 		return 0;
 	}
 
+	int GameObjectPool::api_QueryNearest(lua_State* L) noexcept
+	{
+		lua_Integer const group = luaL_checkinteger(L, 1);
+		lua_Number const x = luaL_checknumber(L, 2);
+		lua_Number const y = luaL_checknumber(L, 3);
+		lua_Number const max_r = luaL_optnumber(L, 4, -1.0); // 小于 0 时不限制距离
+		auto const& grid = g_GameObjectPool->_PrepareSpatialIndex(group);
+		lua_Number distance = 0.0;
+		GameObject* p = g_GameObjectPool->m_SpatialIndex.QueryNearest(grid, x, y, max_r, distance);
+		if (!p)
+		{
+			lua_pushnil(L);
+			return 1;
+		}
+		g_GameObjectPool->GetObjectTable(L);	// ... ot
+		lua_rawgeti(L, -1, (int)p->id + 1);		// ... ot object
+		lua_remove(L, -2);						// ... object
+		lua_pushnumber(L, distance);			// ... object distance
+		return 2;
+	}
+	int GameObjectPool::api_QueryCircle(lua_State* L) noexcept
+	{
+		lua_Integer const group = luaL_checkinteger(L, 1);
+		lua_Number const x = luaL_checknumber(L, 2);
+		lua_Number const y = luaL_checknumber(L, 3);
+		lua_Number const r = luaL_checknumber(L, 4);
+		bool const has_callback = !lua_isnoneornil(L, 5);
+		if (has_callback)
+			luaL_checktype(L, 5, LUA_TFUNCTION);
+		auto const& grid = g_GameObjectPool->_PrepareSpatialIndex(group);
+		g_GameObjectPool->m_SpatialIndex.QueryCircle(grid, x, y, r, g_GameObjectPool->m_SpatialQueryResult);
+		if (has_callback)
+			return g_GameObjectPool->_ApplySpatialQueryResult(L, 5);
+		return g_GameObjectPool->_PushSpatialQueryResult(L);
+	}
+	int GameObjectPool::api_QueryRect(lua_State* L) noexcept
+	{
+		lua_Integer const group = luaL_checkinteger(L, 1);
+		lua_Number const left = luaL_checknumber(L, 2);
+		lua_Number const right = luaL_checknumber(L, 3);
+		lua_Number const bottom = luaL_checknumber(L, 4);
+		lua_Number const top = luaL_checknumber(L, 5);
+		auto const& grid = g_GameObjectPool->_PrepareSpatialIndex(group);
+		g_GameObjectPool->m_SpatialIndex.QueryRect(grid, left, right, bottom, top, g_GameObjectPool->m_SpatialQueryResult);
+		return g_GameObjectPool->_PushSpatialQueryResult(L);
+	}
+	int GameObjectPool::api_KillInCircle(lua_State* L) noexcept
+	{
+		lua_Integer const group = luaL_checkinteger(L, 1);
+		lua_Number const x = luaL_checknumber(L, 2);
+		lua_Number const y = luaL_checknumber(L, 3);
+		lua_Number const r = luaL_checknumber(L, 4);
+		auto const& grid = g_GameObjectPool->_PrepareSpatialIndex(group);
+		g_GameObjectPool->m_SpatialIndex.QueryCircle(grid, x, y, r, g_GameObjectPool->m_SpatialQueryResult);
+		return g_GameObjectPool->_ApplySpatialQueryResult(L, 0);
+	}
+
+	int GameObjectPool::api_GetObjectStateView(lua_State* L) noexcept
+	{
+		return PushGameObjectStateView(L, g_GameObjectPool->m_ObjectPool.data(), g_GameObjectPool->m_ObjectPool.max_size());
+	}
+
+	int GameObjectPool::api_MotionProgram(lua_State* L) noexcept
+	{
+		return PushGameObjectMotionProgram(L, 1);
+	}
+	int GameObjectPool::api_SetMotion(lua_State* L) noexcept
+	{
+		GameObject* p = g_GameObjectPool->_ToGameObject(L, 1);
+		if (lua_isnoneornil(L, 2))
+		{
+			g_GameObjectPool->m_Motion.Detach(p);
+			return 0;
+		}
+		auto const& program = CheckGameObjectMotionProgram(L, 2);
+		GameObject* target = lua_isnoneornil(L, 3) ? nullptr : g_GameObjectPool->_ToGameObject(L, 3);
+		g_GameObjectPool->m_Motion.Attach(p, program, target);
+		return 0;
+	}
+	int GameObjectPool::api_GetMotion(lua_State* L) noexcept
+	{
+		GameObject* p = g_GameObjectPool->_ToGameObject(L, 1);
+		uint32_t pc = 0;
+		if (!g_GameObjectPool->m_Motion.GetProgramCounter(p, pc))
+		{
+			lua_pushnil(L);
+			return 1;
+		}
+		lua_pushinteger(L, (lua_Integer)pc + 1);
+		return 1;
+	}
+
 	int GameObjectPool::api_SetImgState(lua_State* L) noexcept
 	{
 		GameObject* p = g_GameObjectPool->_ToGameObject(L, 1);
@@ -1305,12 +1528,18 @@ namespace LuaSTGPlus
 	int GameObjectPool::api_SetAttr(lua_State* L) noexcept
 	{
 		GameObject* p = g_GameObjectPool->_TableToGameObject(L, 1);
-		switch (p->SetAttr(L))
+		lua_Number const old_x = p->x;
+		lua_Number const old_y = p->y;
+		int const result = p->SetAttr(L);
+		if (p->x != old_x || p->y != old_y)
+			g_GameObjectPool->m_SpatialIndex.OnTeleport(p, old_x, old_y);
+		switch (result)
 		{
 		case 1: // group
 			if (p == g_GameObjectPool->m_LockObjectA || p == g_GameObjectPool->m_LockObjectB)
 				return luaL_error(L, "illegal operation, lstg object 'group' property should not be modified in 'lstg.CollisionCheck'");
 			g_GameObjectPool->_MoveToColliLinkList(p, (size_t)p->group);
+			g_GameObjectPool->m_SpatialIndex.Insert(p, (size_t)p->group); // 原碰撞组网格中的记录按碰撞组排除
 			break;
 		case 2: // layer
 			if (g_GameObjectPool->m_IsRendering)
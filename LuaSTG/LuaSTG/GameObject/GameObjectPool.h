@@ -1,5 +1,8 @@
 #pragma once
 #include "GameObject/GameObject.hpp"
+#include "GameObject/GameObjectRenderQueue.hpp"
+#include "GameObject/GameObjectSpatialIndex.hpp"
+#include "GameObject/GameObjectMotion.hpp"
 #include "Utility/fixed_object_pool.hpp"
 #include <deque>
 #include <memory_resource>
@@ -21,6 +24,12 @@ namespace LuaSTGPlus
 			uint64_t object_alive{ 0 };
 			uint64_t object_colli_check{ 0 };
 			uint64_t object_colli_callback{ 0 };
+			// 各阶段耗时（秒），同一帧内多次调用会累加
+			double update_movements_time{ 0.0 };
+			double update_next_time{ 0.0 };
+			double detect_out_of_world_bound_time{ 0.0 };
+			double detect_intersection_time{ 0.0 };
+			double render_time{ 0.0 };
 		};
 
 		struct IntersectionDetectionGroupPair {
@@ -60,6 +69,16 @@ namespace LuaSTGPlus
 
 		bool m_IsRendering{ false };
 
+		// 渲染队列，按渲染状态重排同一图层内的对象
+		GameObjectRenderQueue m_RenderQueue;
+
+		// 空间查询加速结构，槽位 0 ~ LOBJPOOL_GROUPN - 1 对应碰撞组，最后一个槽位对应所有对象
+		GameObjectSpatialIndex m_SpatialIndex;
+		std::vector<GameObject*> m_SpatialQueryResult;
+
+		// 挂载在对象上的运动程序
+		GameObjectMotion m_Motion;
+
 		FrameStatistics m_DbgData[2]{};
 		size_t m_DbgIdx{ 0 };
 
@@ -109,9 +128,18 @@ namespace LuaSTGPlus
 
 		void _GameObjectCallback(lua_State* L, int otidx, GameObject* p, int cbidx);
 
+		// 获取指定碰撞组的空间查询网格，无效的碰撞组代表所有对象
+		GameObjectSpatialIndex::Grid const& _PrepareSpatialIndex(lua_Integer group);
+		// 把空间查询结果作为数组压入栈
+		int _PushSpatialQueryResult(lua_State* L);
+		// 按 uid 顺序对空间查询结果调用 callback 处的函数，callback 为 0 时击破对象，返回处理的对象数量
+		int _ApplySpatialQueryResult(lua_State* L, int callback);
+
 	public:
 		void DebugNextFrame();
 		FrameStatistics DebugGetFrameStatistics();
+		/// @brief 获取当前帧（尚未结束）的统计数据
+		FrameStatistics DebugGetCurrentFrameStatistics();
 
 	public:
 		int PushCurrentObject(lua_State* L) noexcept;
@@ -144,6 +172,9 @@ namespace LuaSTGPlus
 		/// @brief 执行对象的Render函数
 		void DoRender() noexcept;
 
+		/// @brief 获取渲染队列
+		GameObjectRenderQueue& GetRenderQueue() noexcept { return m_RenderQueue; }
+
 		/// @brief 设置舞台边界
 		inline void SetBound(lua_Number l, lua_Number r, lua_Number b, lua_Number t) noexcept {
 			m_BoundLeft = l;
@@ -293,6 +324,17 @@ namespace LuaSTGPlus
 		static int api_Dist(lua_State* L) noexcept;
 		static int api_GetV(lua_State* L) noexcept;
 		static int api_SetV(lua_State* L) noexcept;
+
+		static int api_QueryNearest(lua_State* L) noexcept;
+		static int api_QueryCircle(lua_State* L) noexcept;
+		static int api_QueryRect(lua_State* L) noexcept;
+		static int api_KillInCircle(lua_State* L) noexcept;
+
+		static int api_GetObjectStateView(lua_State* L) noexcept;
+
+		static int api_MotionProgram(lua_State* L) noexcept;
+		static int api_SetMotion(lua_State* L) noexcept;
+		static int api_GetMotion(lua_State* L) noexcept;
 		
 		static int api_ObjFrame(lua_State* L);
 		static int api_AfterFrame(lua_State* L);
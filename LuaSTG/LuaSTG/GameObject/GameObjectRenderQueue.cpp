@@ -0,0 +1,280 @@
+#include "GameObject/GameObjectRenderQueue.hpp"
+#include <cmath>
+#include <algorithm>
+#include "AppFrame.h"
+
+namespace LuaSTGPlus
+{
+	static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+	static constexpr uint32_t MAX_QUAD_PER_REQUEST = 4096; // 16384 个顶点、24576 个索引，不超过渲染器单次提交的容量
+	static constexpr size_t PARALLEL_GRAIN = 256;
+
+	// 以精灵锚点为圆心、覆盖整张精灵的圆的包围盒，与旋转无关
+	static Core::RectF GetSpriteBound(Core::Graphics::ISprite* sprite, GameObject const* p, float gscale)
+	{
+		auto const rc = sprite->getTextureRect();
+		auto const c = sprite->getTextureCenter();
+		float const dx = std::max(std::abs(rc.a.x - c.x), std::abs(rc.b.x - c.x));
+		float const dy = std::max(std::abs(rc.a.y - c.y), std::abs(rc.b.y - c.y));
+		float const scale = std::max(std::abs(static_cast<float>(p->hscale)), std::abs(static_cast<float>(p->vscale)));
+		float const r = std::sqrt(dx * dx + dy * dy) * sprite->getUnitsPerPixel() * scale * gscale;
+		float const x = static_cast<float>(p->x);
+		float const y = static_cast<float>(p->y);
+		return Core::RectF(x - r, y - r, x + r, y + r);
+	}
+	static bool IsOverlap(Core::RectF const& x, Core::RectF const& y)
+	{
+		return x.a.x < y.b.x && y.a.x < x.b.x && x.a.y < y.b.y && y.a.y < x.b.y;
+	}
+	static Core::RectF GetUnion(Core::RectF const& x, Core::RectF const& y)
+	{
+		return Core::RectF(
+			std::min(x.a.x, y.a.x),
+			std::min(x.a.y, y.a.y),
+			std::max(x.b.x, y.b.x),
+			std::max(x.b.y, y.b.y)
+		);
+	}
+
+	void GameObjectRenderQueue::SetLayerOrderIndependent(lua_Number layer, bool independent)
+	{
+		if (independent)
+			m_order_independent_layers.insert(layer);
+		else
+			m_order_independent_layers.erase(layer);
+		if (layer == m_layer)
+			m_layer_order_independent = independent;
+	}
+	bool GameObjectRenderQueue::IsLayerOrderIndependent(lua_Number layer) const
+	{
+		return m_order_independent_layers.contains(layer);
+	}
+
+	bool GameObjectRenderQueue::Push(GameObject* p)
+	{
+		Core::Graphics::ISprite* sprite = nullptr;
+		BlendMode blend = BlendMode::MulAlpha;
+		bool override_color = false;
+		Core::Color4B color[4]{};
+	#ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+		// 顶点颜色、混合模式的取值与 GameObject::Render 一致
+		if (IsActive() && p->luaclass.IsDefaultRender && p->res)
+		{
+			switch (p->res->GetType())
+			{
+			case ResourceType::Sprite:
+				{
+					auto* res = static_cast<IResourceSprite*>(p->res);
+					sprite = res->GetSprite();
+					blend = res->GetBlendMode();
+				}
+				break;
+			case ResourceType::Animation:
+				{
+					auto* res = static_cast<IResourceAnimation*>(p->res);
+					sprite = res->GetSpriteByTimer(static_cast<int>(p->ani_timer))->GetSprite();
+					blend = res->GetBlendMode();
+					override_color = true;
+					res->GetVertexColor(color);
+				}
+				break;
+			default:
+				break;
+			}
+			if (sprite && p->luaclass.IsRenderClass)
+			{
+				blend = p->blendmode;
+				override_color = true;
+				color[0] = color[1] = color[2] = color[3] = Core::Color4B(p->vertexcolor);
+			}
+		}
+	#endif // USING_ADVANCE_GAMEOBJECT_CLASS
+		if (!sprite)
+		{
+			Flush();
+			return false;
+		}
+
+		// 只在同一图层内重排
+		if (m_items.empty() || p->layer != m_layer)
+		{
+			Flush();
+			m_layer = p->layer;
+			m_layer_order_independent = IsLayerOrderIndependent(m_layer);
+		}
+
+		float const gscale = LRES.GetGlobalImageScaleFactor();
+		Item item{
+			.object = p,
+			.sprite = sprite,
+			.texture = sprite->getTexture(),
+			.blend = blend,
+			.override_color = override_color,
+			.color = { color[0], color[1], color[2], color[3] },
+			.pos = Core::Vector2F(static_cast<float>(p->x), static_cast<float>(p->y)),
+			.scale = Core::Vector2F(static_cast<float>(p->hscale) * gscale, static_cast<float>(p->vscale) * gscale),
+			.rotation = static_cast<float>(p->rot),
+			.bound = GetSpriteBound(sprite, p, gscale),
+			.next = INVALID_INDEX,
+		};
+		auto const index = static_cast<uint32_t>(m_items.size());
+		m_items.push_back(item);
+
+		// 从后往前查找渲染状态相同的批次，对象提前到该批次意味着越过了之后所有批次，因此不能与它们重叠
+		// 未开启重排时只和最后一个批次合并，渲染顺序保持不变
+		size_t const search_depth = m_enable ? m_search_depth : 1;
+		size_t const search_end = m_batches.size() > search_depth ? m_batches.size() - search_depth : 0;
+		for (size_t i = m_batches.size(); i > search_end; i -= 1)
+		{
+			Batch& batch = m_batches[i - 1];
+			if (batch.texture == item.texture && batch.blend == item.blend)
+			{
+				m_items[batch.tail].next = index;
+				batch.tail = index;
+				batch.count += 1;
+				batch.bound = GetUnion(batch.bound, item.bound);
+				return true;
+			}
+			if (!m_layer_order_independent && IsOverlap(batch.bound, item.bound))
+			{
+				break;
+			}
+		}
+		m_batches.push_back(Batch{
+			.texture = item.texture,
+			.blend = item.blend,
+			.bound = item.bound,
+			.head = index,
+			.tail = index,
+			.count = 1,
+		});
+		return true;
+	}
+	void GameObjectRenderQueue::FlushParallel(Batch const& batch)
+	{
+		m_batch_items.clear();
+		for (uint32_t i = batch.head; i != INVALID_INDEX; i = m_items[i].next)
+		{
+			m_batch_items.push_back(i);
+		}
+
+		if (!m_parallel)
+		{
+			m_parallel = std::make_unique<ParallelFor>();
+		}
+
+		// 渲染状态在主线程设置好，之后每段顶点缓冲区只属于同一个纹理、混合模式
+		auto* renderer = LAPP.GetAppModel()->getRenderer();
+		LAPP.updateGraph2DBlendMode(batch.blend);
+		renderer->setTexture(batch.texture);
+
+		size_t offset = 0;
+		while (offset < m_batch_items.size())
+		{
+			auto const count = static_cast<uint16_t>(std::min<size_t>(m_batch_items.size() - offset, MAX_QUAD_PER_REQUEST));
+			Core::Graphics::IRenderer::DrawVertex* vertex = nullptr;
+			Core::Graphics::IRenderer::DrawIndex* index = nullptr;
+			Core::Graphics::IRenderer::DrawIndex vertex_offset = 0;
+			if (!renderer->drawRequest(count * 4, count * 6, &vertex, &index, &vertex_offset))
+			{
+				// 退回逐个渲染
+				for (size_t k = offset; k < m_batch_items.size(); k += 1)
+				{
+					m_items[m_batch_items[k]].object->Render();
+				}
+				return;
+			}
+			uint32_t const* const items = m_batch_items.data() + offset;
+			m_parallel->run(count, PARALLEL_GRAIN, [&](size_t const begin, size_t const end)
+			{
+				for (size_t k = begin; k < end; k += 1)
+				{
+					Item const& item = m_items[items[k]];
+					item.sprite->getQuad(vertex + k * 4, item.pos, item.scale, item.rotation, 0.5f, item.override_color ? item.color : nullptr);
+					auto const base = static_cast<Core::Graphics::IRenderer::DrawIndex>(vertex_offset + k * 4);
+					auto* const idx = index + k * 6;
+					idx[0] = base;
+					idx[1] = base + 1;
+					idx[2] = base + 2;
+					idx[3] = base;
+					idx[4] = base + 2;
+					idx[5] = base + 3;
+				}
+			});
+			offset += count;
+		}
+	}
+	bool GameObjectRenderQueue::FlushInstanced(Batch const& batch)
+	{
+		// 实例只有一个顶点颜色，四个顶点颜色不一致的对象会让整个批次退回原来的绘制方式
+		m_batch_items.clear();
+		for (uint32_t i = batch.head; i != INVALID_INDEX; i = m_items[i].next)
+		{
+			Item& item = m_items[i];
+			if (!item.override_color)
+			{
+				item.sprite->getColor(item.color);
+			}
+			if (item.color[0] != item.color[1] || item.color[0] != item.color[2] || item.color[0] != item.color[3])
+			{
+				return false;
+			}
+			m_batch_items.push_back(i);
+		}
+
+		auto* renderer = LAPP.GetAppModel()->getRenderer();
+		LAPP.updateGraph2DBlendMode(batch.blend);
+		renderer->setTexture(batch.texture);
+
+		// 精灵表写满时先提交一次；渲染器不支持实例化绘制时，尚未提交的对象逐个渲染
+		size_t submitted = 0;
+		bool supported = true;
+		m_instance_batch.clear();
+		for (size_t k = 0; k < m_batch_items.size(); k += 1)
+		{
+			Item const& item = m_items[m_batch_items[k]];
+			if (!m_instance_batch.push(item.sprite, item.pos, item.scale, item.rotation, item.color[0]))
+			{
+				if (!m_instance_batch.submit(renderer))
+				{
+					supported = false;
+					break;
+				}
+				submitted = k;
+				m_instance_batch.clear();
+				m_instance_batch.push(item.sprite, item.pos, item.scale, item.rotation, item.color[0]);
+			}
+		}
+		if (supported && m_instance_batch.submit(renderer))
+		{
+			submitted = m_batch_items.size();
+		}
+		m_instance_batch.clear();
+		for (size_t k = submitted; k < m_batch_items.size(); k += 1)
+		{
+			m_items[m_batch_items[k]].object->Render();
+		}
+		return true;
+	}
+	void GameObjectRenderQueue::Flush()
+	{
+		for (auto const& batch : m_batches)
+		{
+			if (m_instancing_threshold > 0 && batch.count >= m_instancing_threshold && FlushInstanced(batch))
+			{
+				continue;
+			}
+			if (m_enable && m_parallel_threshold > 0 && batch.count >= m_parallel_threshold)
+			{
+				FlushParallel(batch);
+				continue;
+			}
+			for (uint32_t i = batch.head; i != INVALID_INDEX; i = m_items[i].next)
+			{
+				m_items[i].object->Render();
+			}
+		}
+		m_items.clear();
+		m_batches.clear();
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "GameObject/GameObject.hpp"
+#include "Core/Graphics/Renderer.hpp"
+#include "Core/Graphics/Sprite.hpp"
+#include "Core/Graphics/SpriteInstanceBatch.hpp"
+#include "Utility/ParallelFor.hpp"
+#include <set>
+#include <vector>
+
+namespace LuaSTGPlus
+{
+	// 渲染队列
+	// 在同一图层内，将使用默认渲染的精灵、动画对象按渲染状态（混合模式、纹理）重新排列，减少渲染器的批次提交
+	// 只有互不重叠的对象会被重排；被标记为与顺序无关的图层则不检查重叠
+	// 对象数量足够多的批次会由工作线程直接把顶点写入渲染器的顶点缓冲区，主线程只负责设置渲染状态
+	// 渲染器支持时，对象数量足够多的批次优先使用实例化绘制，每个对象只上传位置、旋转、缩放、颜色和精灵编号
+	// 未开启重排但开启了实例化绘制时，默认渲染的对象也经过队列：只合并按原顺序连续、渲染状态相同的对象，批次足够大时使用实例化绘制
+	// 实例化绘制默认禁用，两者都关闭时默认渲染与不使用队列时完全一致
+	class GameObjectRenderQueue
+	{
+	private:
+		struct Item
+		{
+			GameObject* object;
+			Core::Graphics::ISprite* sprite;
+			Core::Graphics::ITexture2D* texture;
+			BlendMode blend;
+			bool override_color;
+			Core::Color4B color[4];
+			Core::Vector2F pos;
+			Core::Vector2F scale;
+			float rotation;
+			Core::RectF bound;
+			uint32_t next;
+		};
+		struct Batch
+		{
+			Core::Graphics::ITexture2D* texture;
+			BlendMode blend;
+			Core::RectF bound; // 批次内所有对象包围盒的并集
+			uint32_t head;
+			uint32_t tail;
+			uint32_t count;
+		};
+
+		std::vector<Item> m_items;
+		std::vector<Batch> m_batches;
+		std::vector<uint32_t> m_batch_items;
+		std::unique_ptr<ParallelFor> m_parallel;
+		Core::Graphics::SpriteInstanceBatch m_instance_batch;
+		std::set<lua_Number> m_order_independent_layers;
+		lua_Number m_layer{};
+		bool m_layer_order_independent{ false };
+		bool m_enable{ false };
+		uint32_t m_search_depth{ 16 }; // 向前查找可合并批次的最大数量
+		uint32_t m_parallel_threshold{ 1024 }; // 批次内对象数量达到该值时并行生成顶点，为 0 时禁用
+		uint32_t m_instancing_threshold{ 0 }; // 批次内对象数量达到该值时使用实例化绘制，为 0 时禁用（默认禁用，需要脚本主动开启）
+
+		void FlushParallel(Batch const& batch);
+		bool FlushInstanced(Batch const& batch);
+
+	public:
+		void SetEnable(bool enable) noexcept { m_enable = enable; }
+		bool IsEnable() const noexcept { return m_enable; }
+		/// @brief 未开启重排时，只有脚本开启了实例化绘制，队列才参与默认渲染
+		bool IsActive() const noexcept { return m_enable || m_instancing_threshold > 0; }
+		void SetSearchDepth(uint32_t depth) noexcept { m_search_depth = depth; }
+		uint32_t GetSearchDepth() const noexcept { return m_search_depth; }
+		void SetParallelThreshold(uint32_t threshold) noexcept { m_parallel_threshold = threshold; }
+		uint32_t GetParallelThreshold() const noexcept { return m_parallel_threshold; }
+		void SetInstancingThreshold(uint32_t threshold) noexcept { m_instancing_threshold = threshold; }
+		uint32_t GetInstancingThreshold() const noexcept { return m_instancing_threshold; }
+		void SetLayerOrderIndependent(lua_Number layer, bool independent);
+		bool IsLayerOrderIndependent(lua_Number layer) const;
+		void ClearLayerOrderIndependent() { m_order_independent_layers.clear(); }
+
+		/// @brief 尝试将对象加入队列
+		/// @return 对象不能参与重排时返回 false，此时队列已经提交，调用者应直接渲染该对象
+		bool Push(GameObject* p);
+		/// @brief 按批次顺序渲染队列中的对象并清空队列
+		void Flush();
+	};
+}
@@ -0,0 +1,256 @@
+#include "GameObject/GameObjectSpatialIndex.hpp"
+
+namespace LuaSTGPlus
+{
+	// 对象较少时不划分网格，直接遍历
+	constexpr size_t grid_object_threshold = 32;
+	// 每个网格单元平均容纳的对象数量
+	constexpr lua_Number grid_objects_per_cell = 2.0;
+	// 单个方向上的最大网格数量
+	constexpr int32_t grid_max_cells = 256;
+	// 构建后加入的对象超过网格内对象数量的 1 / 8 时重新构建
+	constexpr size_t grid_extra_ratio = 8;
+	// 构建后直接修改坐标造成的位移之和超过该数量的单元时重新构建
+	constexpr lua_Number grid_max_teleport_cells = 2.0;
+
+	inline bool is_less_uid(GameObject const* a, GameObject const* b) noexcept { return a->uid < b->uid; }
+
+	// 对象修改碰撞组后又改回来时会在网格和额外列表中各出现一次
+	inline void sort_result(std::vector<GameObject*>& result)
+	{
+		std::sort(result.begin(), result.end(), &is_less_uid);
+		result.erase(std::unique(result.begin(), result.end()), result.end());
+	}
+
+	bool GameObjectSpatialIndex::isStale(Grid const& grid) const noexcept
+	{
+		if (grid.extra.size() > grid_object_threshold + grid.objects.size() / grid_extra_ratio)
+			return true;
+		// m_step 在阶段内不会减小，重新构建也无法缩小查找范围，只考虑直接修改坐标的部分
+		if (grid.cols > 1 || grid.rows > 1)
+			return (m_teleport - grid.teleport) > grid.cell_size * grid_max_teleport_cells;
+		return false;
+	}
+
+	void GameObjectSpatialIndex::build(Grid& grid, std::vector<GameObject*>& objects)
+	{
+		grid.objects.clear();
+		grid.cell_start.clear();
+		grid.extra.clear();
+		grid.min_x = 0.0;
+		grid.min_y = 0.0;
+		grid.cell_size = 1.0;
+		grid.cols = 1;
+		grid.rows = 1;
+		if (objects.empty())
+		{
+			grid.cell_start.assign(2, 0);
+			return;
+		}
+
+		lua_Number min_x = objects[0]->x, max_x = objects[0]->x;
+		lua_Number min_y = objects[0]->y, max_y = objects[0]->y;
+		for (GameObject* p : objects)
+		{
+			min_x = std::min(min_x, p->x);
+			max_x = std::max(max_x, p->x);
+			min_y = std::min(min_y, p->y);
+			max_y = std::max(max_y, p->y);
+		}
+		lua_Number const width = max_x - min_x;
+		lua_Number const height = max_y - min_y;
+		grid.min_x = min_x;
+		grid.min_y = min_y;
+
+		if (objects.size() < grid_object_threshold || !std::isfinite(width) || !std::isfinite(height))
+		{
+			// 单个单元，覆盖所有对象
+			grid.cell_size = std::max({ width, height, 1.0 }) * 2.0;
+			grid.objects.reserve(objects.size());
+			for (GameObject* p : objects)
+				grid.objects.push_back(Entry{ p, p->uid });
+			grid.cell_start = { 0, (uint32_t)grid.objects.size() };
+			return;
+		}
+
+		lua_Number const area = std::max(width, 1.0) * std::max(height, 1.0);
+		lua_Number cell_size = std::sqrt(area * grid_objects_per_cell / (lua_Number)objects.size());
+		cell_size = std::max({ cell_size, 1.0, width / (grid_max_cells - 1), height / (grid_max_cells - 1) });
+		grid.cell_size = cell_size;
+		grid.cols = std::clamp((int32_t)std::floor(width / cell_size) + 1, 1, grid_max_cells);
+		grid.rows = std::clamp((int32_t)std::floor(height / cell_size) + 1, 1, grid_max_cells);
+
+		// 计数排序，同一单元内保持链表中的顺序
+		size_t const cell_count = (size_t)grid.cols * (size_t)grid.rows;
+		grid.cell_start.assign(cell_count + 1, 0);
+		std::vector<uint32_t> cell_of(objects.size());
+		for (size_t i = 0; i < objects.size(); i += 1)
+		{
+			uint32_t const cell = (uint32_t)(cellY(grid, objects[i]->y) * grid.cols + cellX(grid, objects[i]->x));
+			cell_of[i] = cell;
+			grid.cell_start[cell + 1] += 1;
+		}
+		for (size_t i = 1; i <= cell_count; i += 1)
+		{
+			grid.cell_start[i] += grid.cell_start[i - 1];
+		}
+		std::vector<uint32_t> cursor(grid.cell_start.begin(), grid.cell_start.end() - 1);
+		grid.objects.resize(objects.size(), Entry{ nullptr, 0 });
+		for (size_t i = 0; i < objects.size(); i += 1)
+		{
+			grid.objects[cursor[cell_of[i]]++] = Entry{ objects[i], objects[i]->uid };
+		}
+	}
+	int32_t GameObjectSpatialIndex::cellX(Grid const& grid, lua_Number const x) const noexcept
+	{
+		lua_Number const v = std::floor((x - grid.min_x) / grid.cell_size);
+		if (!(v > 0.0)) return 0; // 同时处理 NaN
+		if (v >= (lua_Number)(grid.cols - 1)) return grid.cols - 1;
+		return (int32_t)v;
+	}
+	int32_t GameObjectSpatialIndex::cellY(Grid const& grid, lua_Number const y) const noexcept
+	{
+		lua_Number const v = std::floor((y - grid.min_y) / grid.cell_size);
+		if (!(v > 0.0)) return 0; // 同时处理 NaN
+		if (v >= (lua_Number)(grid.rows - 1)) return grid.rows - 1;
+		return (int32_t)v;
+	}
+
+	GameObject* GameObjectSpatialIndex::QueryNearest(Grid const& grid, lua_Number const x, lua_Number const y, lua_Number const max_r, lua_Number& distance) const
+	{
+		GameObject* best = nullptr;
+		lua_Number best_d2 = (max_r >= 0.0) ? (max_r * max_r) : std::numeric_limits<lua_Number>::infinity();
+		auto const test_entry = [&](Entry const& e)
+		{
+			if (!isMatch(grid, e))
+				return;
+			GameObject* p = e.object;
+			lua_Number const dx = p->x - x;
+			lua_Number const dy = p->y - y;
+			lua_Number const d2 = dx * dx + dy * dy;
+			if (!best ? (d2 <= best_d2) : (d2 < best_d2 || (d2 == best_d2 && p->uid < best->uid)))
+			{
+				best = p;
+				best_d2 = d2;
+			}
+		};
+		auto const test_cell = [&](int32_t const i, int32_t const j)
+		{
+			size_t const cell = (size_t)j * (size_t)grid.cols + (size_t)i;
+			for (uint32_t k = grid.cell_start[cell]; k < grid.cell_start[cell + 1]; k += 1)
+				test_entry(grid.objects[k]);
+		};
+		for (Entry const& e : grid.extra)
+			test_entry(e);
+
+		// 从查询点（投影到网格内）所在的单元开始，一圈一圈向外查找
+		// 第 k 圈的单元与投影点的距离不小于 (k - 1) 个单元，投影不会缩短到网格内任意点的距离
+		// 对象在构建后最多移动 pad，实际距离至少还要再减去 pad
+		lua_Number const pad = padding(grid);
+		int32_t const cx = cellX(grid, x);
+		int32_t const cy = cellY(grid, y);
+		int32_t const max_ring = std::max(grid.cols, grid.rows);
+		for (int32_t ring = 0; ring <= max_ring; ring += 1)
+		{
+			if (ring > 1)
+			{
+				lua_Number const bound = (lua_Number)(ring - 1) * grid.cell_size - pad;
+				if (bound > 0.0 && bound * bound > best_d2)
+					break;
+			}
+			int32_t const j0 = std::max(cy - ring, 0);
+			int32_t const j1 = std::min(cy + ring, grid.rows - 1);
+			for (int32_t j = j0; j <= j1; j += 1)
+			{
+				if (j == cy - ring || j == cy + ring)
+				{
+					int32_t const i0 = std::max(cx - ring, 0);
+					int32_t const i1 = std::min(cx + ring, grid.cols - 1);
+					for (int32_t i = i0; i <= i1; i += 1)
+						test_cell(i, j);
+				}
+				else
+				{
+					if (cx - ring >= 0)
+						test_cell(cx - ring, j);
+					if (cx + ring < grid.cols)
+						test_cell(cx + ring, j);
+				}
+			}
+		}
+
+		if (best)
+		{
+			distance = std::sqrt(best_d2);
+		}
+		return best;
+	}
+	void GameObjectSpatialIndex::QueryCircle(Grid const& grid, lua_Number const x, lua_Number const y, lua_Number const r, std::vector<GameObject*>& result) const
+	{
+		result.clear();
+		if (!(r >= 0.0))
+			return;
+		lua_Number const r2 = r * r;
+		auto const test_entry = [&](Entry const& e)
+		{
+			if (!isMatch(grid, e))
+				return;
+			lua_Number const dx = e.object->x - x;
+			lua_Number const dy = e.object->y - y;
+			if (dx * dx + dy * dy <= r2)
+				result.push_back(e.object);
+		};
+		lua_Number const rp = r + padding(grid);
+		int32_t const i0 = cellX(grid, x - rp), i1 = cellX(grid, x + rp);
+		int32_t const j0 = cellY(grid, y - rp), j1 = cellY(grid, y + rp);
+		for (int32_t j = j0; j <= j1; j += 1)
+		{
+			for (int32_t i = i0; i <= i1; i += 1)
+			{
+				size_t const cell = (size_t)j * (size_t)grid.cols + (size_t)i;
+				for (uint32_t k = grid.cell_start[cell]; k < grid.cell_start[cell + 1]; k += 1)
+					test_entry(grid.objects[k]);
+			}
+		}
+		for (Entry const& e : grid.extra)
+			test_entry(e);
+		sort_result(result);
+	}
+	void GameObjectSpatialIndex::QueryRect(Grid const& grid, lua_Number left, lua_Number right, lua_Number bottom, lua_Number top, std::vector<GameObject*>& result) const
+	{
+		result.clear();
+		if (left > right)
+			std::swap(left, right);
+		if (bottom > top)
+			std::swap(bottom, top);
+		auto const test_entry = [&](Entry const& e)
+		{
+			if (!isMatch(grid, e))
+				return;
+			GameObject* p = e.object;
+			if (p->x >= left && p->x <= right && p->y >= bottom && p->y <= top)
+				result.push_back(p);
+		};
+		lua_Number const pad = padding(grid);
+		int32_t const i0 = cellX(grid, left - pad), i1 = cellX(grid, right + pad);
+		int32_t const j0 = cellY(grid, bottom - pad), j1 = cellY(grid, top + pad);
+		for (int32_t j = j0; j <= j1; j += 1)
+		{
+			for (int32_t i = i0; i <= i1; i += 1)
+			{
+				size_t const cell = (size_t)j * (size_t)grid.cols + (size_t)i;
+				for (uint32_t k = grid.cell_start[cell]; k < grid.cell_start[cell + 1]; k += 1)
+					test_entry(grid.objects[k]);
+			}
+		}
+		for (Entry const& e : grid.extra)
+			test_entry(e);
+		sort_result(result);
+	}
+
+	void GameObjectSpatialIndex::Clear()
+	{
+		m_grids.clear();
+		Invalidate();
+	}
+}
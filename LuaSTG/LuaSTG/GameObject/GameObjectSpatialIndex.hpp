@@ -0,0 +1,127 @@
+#pragma once
+#include "GameObject/GameObject.hpp"
+#include <vector>
+
+namespace LuaSTGPlus
+{
+	// 空间查询加速结构
+	// 按对象中心坐标把碰撞组内的对象放入均匀网格，每个阶段（两次 Invalidate 之间）在第一次查询时构建一次
+	// 网格构建后对象仍然可以移动，查询时使用对象的实时坐标，并按构建后对象可能移动的最大距离扩大查找的单元范围
+	// 构建后新创建的对象、修改了碰撞组的对象记录在额外列表中，查询时逐个检查
+	// 对象被回收后槽位可能被复用，网格中同时记录 uid 用于校验
+	// 查询只返回处于活跃状态的对象，结果按 uid 升序排列，保证确定性
+	class GameObjectSpatialIndex
+	{
+	public:
+		struct Entry
+		{
+			GameObject* object;
+			uint64_t uid;
+		};
+		struct Grid
+		{
+			uint64_t version{ ~0ull };
+			lua_Integer group{ -1 };          // 小于 0 时不限制碰撞组
+			std::vector<Entry> objects;       // 按网格单元连续存放
+			std::vector<uint32_t> cell_start; // 每个单元在 objects 中的起始位置，最后一项为对象总数
+			std::vector<Entry> extra;         // 构建后加入的对象
+			lua_Number teleport{};            // 构建时的 m_teleport
+			lua_Number min_x{};
+			lua_Number min_y{};
+			lua_Number cell_size{ 1.0 };
+			int32_t cols{ 1 };
+			int32_t rows{ 1 };
+		};
+
+	private:
+		std::vector<Grid> m_grids;
+		uint64_t m_version{ 0 };
+		uint64_t m_built_uid{ 0 };   // 已经放入网格的对象的最大 uid
+		lua_Number m_step{};         // 本阶段对象单次运动更新的最大位移
+		lua_Number m_teleport{};     // 本阶段直接修改坐标造成的位移之和
+
+		void build(Grid& grid, std::vector<GameObject*>& objects);
+		bool isStale(Grid const& grid) const noexcept;
+		lua_Number padding(Grid const& grid) const noexcept { return m_step + (m_teleport - grid.teleport); }
+		bool isMatch(Grid const& grid, Entry const& e) const noexcept
+		{
+			GameObject const* p = e.object;
+			return p->uid == e.uid && p->status == GameObjectStatus::Active && (grid.group < 0 || p->group == grid.group);
+		}
+		int32_t cellX(Grid const& grid, lua_Number x) const noexcept;
+		int32_t cellY(Grid const& grid, lua_Number y) const noexcept;
+
+	public:
+		// 进入新的阶段，所有网格在下次查询时重新构建
+		// 每个对象在一个阶段内最多进行一次运动更新，否则 m_step 不足以覆盖对象的位移
+		void Invalidate() noexcept
+		{
+			m_version += 1;
+			m_built_uid = 0;
+			m_step = 0.0;
+			m_teleport = 0.0;
+		}
+
+		// 对象进行了一次运动更新，(x, y) 为更新前的坐标
+		void OnStep(GameObject const* p, lua_Number const x, lua_Number const y) noexcept
+		{
+			lua_Number const d = std::abs(p->x - x) + std::abs(p->y - y);
+			if (!std::isfinite(d))
+				Invalidate(); // 无法估计查找范围，在当前坐标上重新构建
+			else if (d > m_step)
+				m_step = d;
+		}
+		// 对象的坐标被直接修改，(x, y) 为修改前的坐标
+		void OnTeleport(GameObject const* p, lua_Number const x, lua_Number const y) noexcept
+		{
+			// 构建后才加入的对象不在网格中，不影响查找范围
+			if (p->uid > m_built_uid)
+				return;
+			lua_Number const d = std::abs(p->x - x) + std::abs(p->y - y);
+			if (!std::isfinite(d))
+				Invalidate();
+			else
+				m_teleport += d;
+		}
+		// 对象被创建、修改了碰撞组或者被分配了新的 uid，加入已经构建的网格
+		void Insert(GameObject* p, size_t slot)
+		{
+			if (slot < m_grids.size() && m_grids[slot].version == m_version)
+				m_grids[slot].extra.push_back(Entry{ p, p->uid });
+		}
+
+		/// @brief 获取指定槽位的网格，已经失效时用 objects 中的对象重新构建
+		/// @param group 网格对应的碰撞组，小于 0 时不限制
+		/// @param collect 仅在需要重新构建时调用，向参数中写入槽位内的所有对象
+		template<typename F>
+		Grid const& Prepare(size_t slot, lua_Integer group, F&& collect)
+		{
+			if (slot >= m_grids.size())
+			{
+				m_grids.resize(slot + 1);
+			}
+			Grid& grid = m_grids[slot];
+			if (grid.version != m_version || isStale(grid))
+			{
+				std::vector<GameObject*> objects;
+				collect(objects);
+				for (GameObject* p : objects)
+					m_built_uid = std::max(m_built_uid, p->uid);
+				build(grid, objects);
+				grid.version = m_version;
+				grid.group = group;
+				grid.teleport = m_teleport;
+			}
+			return grid;
+		}
+
+		/// @brief 查找中心与 (x, y) 距离不超过 max_r 的最近的对象，距离相同时返回 uid 较小的对象
+		GameObject* QueryNearest(Grid const& grid, lua_Number x, lua_Number y, lua_Number max_r, lua_Number& distance) const;
+		/// @brief 查找中心位于圆内的对象
+		void QueryCircle(Grid const& grid, lua_Number x, lua_Number y, lua_Number r, std::vector<GameObject*>& result) const;
+		/// @brief 查找中心位于矩形内的对象
+		void QueryRect(Grid const& grid, lua_Number left, lua_Number right, lua_Number bottom, lua_Number top, std::vector<GameObject*>& result) const;
+
+		void Clear();
+	};
+}
@@ -0,0 +1,101 @@
+#include "GameObject/GameObjectStateView.hpp"
+
+#define LUASTG_OBJECT_STATE_VIEW_TYPE "lstg_ObjectStateV1"
+
+namespace LuaSTGPlus
+{
+	static_assert(sizeof(GameObjectStatus) == sizeof(uint32_t));
+	static_assert(sizeof(lua_Number) == sizeof(double));
+	static_assert(sizeof(lua_Integer) == sizeof(ptrdiff_t));
+
+	static char const* const registry_key = "lstg.ObjectStateView.cdef";
+
+	struct GameObjectStateViewField
+	{
+		char const* name;
+		char const* type;
+		size_t offset;
+		size_t size;
+	};
+
+#define FIELD(NAME, TYPE) GameObjectStateViewField{ #NAME, TYPE, offsetof(GameObject, NAME), sizeof(GameObject::NAME) }
+
+	static std::string generateDefinition()
+	{
+		std::vector<GameObjectStateViewField> fields = {
+			FIELD(status, "uint32_t"),
+			FIELD(uid, "uint64_t"),
+			FIELD(group, "ptrdiff_t"),
+			FIELD(x, "double"),
+			FIELD(y, "double"),
+			FIELD(dx, "double"),
+			FIELD(dy, "double"),
+			FIELD(vx, "double"),
+			FIELD(vy, "double"),
+			FIELD(rot, "double"),
+			FIELD(timer, "ptrdiff_t"),
+		};
+		std::sort(fields.begin(), fields.end(), [](GameObjectStateViewField const& a, GameObjectStateViewField const& b) { return a.offset < b.offset; });
+
+		// 字段之间用字节数组填充，对象中的字段本身已经对齐，FFI 不会再插入额外的填充
+		std::string def = "typedef struct " LUASTG_OBJECT_STATE_VIEW_TYPE " {\n";
+		size_t cursor = 0;
+		size_t pad = 0;
+		auto const padding = [&](size_t const to)
+		{
+			if (to > cursor)
+			{
+				def.append("\tuint8_t _pad").append(std::to_string(pad)).append("[").append(std::to_string(to - cursor)).append("];\n");
+				pad += 1;
+			}
+		};
+		for (auto const& field : fields)
+		{
+			padding(field.offset);
+			def.append("\tconst ").append(field.type).append(" ").append(field.name).append(";\n");
+			cursor = field.offset + field.size;
+		}
+		padding(sizeof(GameObject));
+		def.append("} " LUASTG_OBJECT_STATE_VIEW_TYPE ";\n");
+		return def;
+	}
+
+#undef FIELD
+
+	std::string const& GetGameObjectStateViewDefinition()
+	{
+		static std::string const definition = generateDefinition();
+		return definition;
+	}
+
+	int PushGameObjectStateView(lua_State* L, GameObject* base, size_t capacity)
+	{
+		lua_getglobal(L, "require");				// ... require
+		lua_pushstring(L, "ffi");					// ... require "ffi"
+		lua_call(L, 1, 1);							// ... ffi
+		int const ffi = lua_gettop(L);
+
+		// 同一个类型在一个 lua 虚拟机中只能定义一次
+		lua_getfield(L, LUA_REGISTRYINDEX, registry_key);	// ... ffi defined
+		bool const defined = lua_toboolean(L, -1);
+		lua_pop(L, 1);										// ... ffi
+		if (!defined)
+		{
+			std::string const& definition = GetGameObjectStateViewDefinition();
+			lua_getfield(L, ffi, "cdef");								// ... ffi cdef
+			lua_pushlstring(L, definition.data(), definition.size());	// ... ffi cdef def
+			lua_call(L, 1, 0);											// ... ffi
+			lua_pushboolean(L, true);									// ... ffi true
+			lua_setfield(L, LUA_REGISTRYINDEX, registry_key);			// ... ffi
+		}
+
+		lua_getfield(L, ffi, "cast");									// ... ffi cast
+		lua_pushstring(L, "const " LUASTG_OBJECT_STATE_VIEW_TYPE "*");	// ... ffi cast ctype
+		lua_pushlightuserdata(L, base);									// ... ffi cast ctype base
+		lua_call(L, 2, 1);												// ... ffi view
+		lua_remove(L, ffi);												// ... view
+		lua_pushinteger(L, (lua_Integer)capacity);						// ... view capacity
+		lua_pushinteger(L, (lua_Integer)GameObjectStateViewVersion);	// ... view capacity version
+		return 3;
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "GameObject/GameObject.hpp"
+
+namespace LuaSTGPlus
+{
+	// 对象状态视图，通过 LuaJIT FFI 直接读取对象池中的对象数据，不经过 GetAttr
+	// 视图是一个以对象 id（即对象表中的 obj[2]）为下标的数组，长度为对象池容量，元素的内存布局如下：
+	//
+	//     typedef struct lstg_ObjectStateV1 {
+	//         const uint32_t status;  // 0 空闲，1 活跃，2 被删除，4 被击破
+	//         const uint64_t uid;     // 对象全局唯一标识符，对象被回收后槽位会被复用，用于校验
+	//         const ptrdiff_t group;
+	//         const double x, y;
+	//         const double dx, dy;
+	//         const double vx, vy;
+	//         const double rot;       // 弧度
+	//         const ptrdiff_t timer;
+	//     } lstg_ObjectStateV1;
+	//
+	// 实际的字段顺序和填充由编译时的对象布局决定，定义在运行时生成
+	// 字段都是只读的，修改对象仍然需要通过对象表，否则空间查询等加速结构无法得知对象的变化
+	// 布局发生不兼容的变化时递增版本号，类型名也会随之改变
+	constexpr uint32_t GameObjectStateViewVersion = 1;
+
+	// 获取 ffi.cdef 所需的类型定义
+	std::string const& GetGameObjectStateViewDefinition();
+
+	// 压入 const lstg_ObjectStateV1* 类型的 cdata、数组长度以及版本号
+	int PushGameObjectStateView(lua_State* L, GameObject* base, size_t capacity);
+}
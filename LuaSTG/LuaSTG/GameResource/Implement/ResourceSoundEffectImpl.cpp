@@ -1,53 +1,143 @@
 #include "GameResource/Implement/ResourceSoundEffectImpl.hpp"
+#include "AppFrame.h"
 
 namespace LuaSTGPlus
 {
-	void ResourceSoundEffectImpl::FlushCommand()
+	void ResourceSoundEffectImpl::enqueue()
 	{
-		// 根据最后的命令对音效进行操作
+		if (!m_queued)
+		{
+			m_queued = LRES.EnqueueSoundCommand(this);
+		}
+	}
+	void ResourceSoundEffectImpl::startVoice(bool start)
+	{
+		auto& pool = LRES.GetSoundVoicePool();
+		releaseVoices(ReleaseMode::Stolen);
+		// 超出实例数量限制时，抢占自己最早的实例
+		while (!m_voices.empty() && m_voices.size() >= m_max_voices)
+		{
+			pool.Release(this, m_voices.front());
+			m_voices.erase(m_voices.begin());
+		}
+		SoundVoicePool::Handle handle;
+		Core::Audio::IAudioPlayer* p_player = pool.Acquire(this, m_buffer.get(), m_last_command.vol, handle);
+		if (!p_player)
+		{
+			return;
+		}
+		p_player->reset();
+		p_player->setVolume(m_last_command.vol);
+		p_player->setBalance(m_last_command.pan);
+		p_player->setSpeed(m_last_command.speed);
+		if (start)
+		{
+			p_player->start();
+		}
+		m_voices.push_back(handle);
+	}
+	void ResourceSoundEffectImpl::releaseVoices(ReleaseMode mode)
+	{
+		auto& pool = LRES.GetSoundVoicePool();
+		std::erase_if(m_voices, [&](SoundVoicePool::Handle const& handle) -> bool
+		{
+			Core::Audio::IAudioPlayer* p_player = pool.Get(this, handle);
+			if (!p_player)
+			{
+				return true; // 已被抢占
+			}
+			if (mode == ReleaseMode::Stolen || (mode == ReleaseMode::Finished && p_player->isPlaying()))
+			{
+				return false;
+			}
+			pool.Release(this, handle);
+			return true;
+		});
+	}
+	bool ResourceSoundEffectImpl::FlushCommand()
+	{
+		auto& pool = LRES.GetSoundVoicePool();
+		// 根据最后的命令对音效进行操作，播放命令开始一个新的实例，其他命令作用于全部实例
 		switch (m_last_command.type)
 		{
 		case CommandType::None:
 			break;
 		case CommandType::Play:
-			m_player->start();
+			for (auto const& handle : m_voices)
+			{
+				if (auto* p_player = pool.Get(this, handle)) p_player->start();
+				pool.SetPaused(this, handle, false);
+			}
 			break;
 		case CommandType::Stop:
-			m_player->stop();
+			for (auto const& handle : m_voices)
+			{
+				if (auto* p_player = pool.Get(this, handle)) p_player->stop();
+				pool.SetPaused(this, handle, true); // 停止时会在下面归还，暂停时保留
+			}
 			break;
 		case CommandType::Reset:
-			m_player->reset();
-			m_player->setVolume(m_last_command.vol);
-			m_player->setBalance(m_last_command.pan);
-			m_player->start();
+			startVoice(true);
 			break;
 		case CommandType::ResetAndStop:
-			m_player->reset();
-			m_player->setVolume(m_last_command.vol);
-			m_player->setBalance(m_last_command.pan);
+			for (auto const& handle : m_voices)
+			{
+				if (auto* p_player = pool.Get(this, handle)) p_player->stop();
+				pool.SetPaused(this, handle, true);
+			}
+			startVoice(false); // 准备好一个从头开始的实例，恢复时播放
+			if (!m_voices.empty())
+			{
+				pool.SetPaused(this, m_voices.back(), true);
+			}
 			break;
 		default:
 			assert(false);
 			break;
 		}
 		// 重置为无命令
-		m_last_command.type = CommandType::None;
-		m_last_command.vol = 0.0f;
-		m_last_command.pan = 0.0f;
-		// 刷新状态
-		if (m_status == 2) {
-			if (!m_player->isPlaying()) {
+		m_last_command = Command{};
+		// 刷新状态，归还已经停止、结束播放或者被抢占的实例
+		switch (m_status)
+		{
+		case 0:
+			releaseVoices(ReleaseMode::All);
+			break;
+		case 1:
+			releaseVoices(ReleaseMode::Stolen);
+			break;
+		case 2:
+			releaseVoices(ReleaseMode::Finished);
+			if (m_voices.empty()) {
 				m_status = 0; // 已结束播放
 			}
+			break;
 		}
+		// 播放中的音效需要继续刷新状态，其他的从待刷新列表中移除
+		m_queued = (m_status == 2);
+		return m_queued;
 	}
-	void ResourceSoundEffectImpl::Play(float vol, float pan)
+	void ResourceSoundEffectImpl::Play(float vol, float pan, float speed)
 	{
 		// 优先级最高的命令，覆盖其他一切命令
 		m_last_command.type = CommandType::Reset;
-		m_last_command.vol = std::max(m_last_command.vol, vol); // 取音量最高
-		m_last_command.pan = pan;
+		if (LRES.IsSoundEffectMixing())
+		{
+			// 按能量叠加音量，声像按音量加权平均
+			m_last_command.vol_energy += vol * vol;
+			m_last_command.vol_sum += vol;
+			m_last_command.pan_weighted += vol * pan;
+			m_last_command.vol = std::min(1.0f, std::sqrt(m_last_command.vol_energy));
+			m_last_command.pan = m_last_command.vol_sum > 0.0f ? (m_last_command.pan_weighted / m_last_command.vol_sum) : pan;
+		}
+		else
+		{
+			m_last_command.vol = std::max(m_last_command.vol, vol); // 取音量最高
+			m_last_command.pan = pan;
+		}
+		m_last_command.speed = speed;
 		m_status = 2; // playing
+		enqueue();
 	}
 	void ResourceSoundEffectImpl::Resume()
 	{
@@ -77,6 +167,7 @@ namespace LuaSTGPlus
 			break;
 		}
 		m_status = 2; // playing
+		enqueue();
 	}
 	void ResourceSoundEffectImpl::Pause()
 	{
@@ -106,6 +197,7 @@ namespace LuaSTGPlus
 			break;
 		}
 		m_status = 1; // pause
+		enqueue();
 	}
 	void ResourceSoundEffectImpl::Stop()
 	{
@@ -135,15 +227,56 @@ namespace LuaSTGPlus
 			break;
 		}
 		m_status = 0; // stop
+		enqueue();
+	}
+	bool ResourceSoundEffectImpl::IsPlaying()
+	{
+		if (m_status == 2)
+		{
+			return true;
+		}
+		auto& pool = LRES.GetSoundVoicePool();
+		for (auto const& handle : m_voices)
+		{
+			auto* p_player = pool.Get(this, handle);
+			if (p_player && p_player->isPlaying())
+			{
+				return true;
+			}
+		}
+		return false;
 	}
-	bool ResourceSoundEffectImpl::IsPlaying() { return m_player->isPlaying() || m_status == 2; }
 	bool ResourceSoundEffectImpl::IsStopped() { return !IsPlaying() && m_status != 1; }
-	bool ResourceSoundEffectImpl::SetSpeed(float speed) { return m_player->setSpeed(speed); }
-	float ResourceSoundEffectImpl::GetSpeed() { return m_player->getSpeed(); }
+	bool ResourceSoundEffectImpl::SetSpeed(float speed)
+	{
+		// 作用于正在播放的实例以及之后默认的播放速度
+		m_speed = speed;
+		bool result = true;
+		auto& pool = LRES.GetSoundVoicePool();
+		for (auto const& handle : m_voices)
+		{
+			if (auto* p_player = pool.Get(this, handle))
+			{
+				result = p_player->setSpeed(speed) && result;
+			}
+		}
+		return result;
+	}
+	float ResourceSoundEffectImpl::GetSpeed() { return m_speed; }
+	void ResourceSoundEffectImpl::SetMaxVoices(uint32_t count) { m_max_voices = std::max(1u, count); }
+	uint32_t ResourceSoundEffectImpl::GetMaxVoices() { return m_max_voices; }
 
-	ResourceSoundEffectImpl::ResourceSoundEffectImpl(const char* name, Core::Audio::IAudioPlayer* p_player)
+	ResourceSoundEffectImpl::ResourceSoundEffectImpl(const char* name, Core::Audio::IAudioBuffer* p_buffer)
 		: ResourceBaseImpl(ResourceType::SoundEffect, name)
-		, m_player(p_player)
+		, m_buffer(p_buffer)
+	{
+	}
+	ResourceSoundEffectImpl::~ResourceSoundEffectImpl()
 	{
+		LRES.GetSoundVoicePool().Purge(this, m_buffer.get());
+		if (m_queued)
+		{
+			LRES.CancelSoundCommand(this);
+		}
 	}
 }
@@ -1,7 +1,7 @@
 #pragma once
 #include "GameResource/ResourceSoundEffect.hpp"
 #include "GameResource/Implement/ResourceBaseImpl.hpp"
-#include "Core/Audio/Device.hpp"
+#include "GameResource/SoundVoicePool.hpp"
 
 namespace LuaSTGPlus
 {
@@ -21,14 +21,32 @@ namespace LuaSTGPlus
 			CommandType type = CommandType::None;
 			float vol = 0.0f;
 			float pan = 0.0f;
+			float speed = 1.0f;
+			// 混音模式下同一帧内多次播放的累计值
+			float vol_energy = 0.0f;
+			float vol_sum = 0.0f;
+			float pan_weighted = 0.0f;
 		};
 	private:
-		Core::ScopeObject<Core::Audio::IAudioPlayer> m_player;
+		Core::ScopeObject<Core::Audio::IAudioBuffer> m_buffer; // 解码后的音频数据，所有实例共享
+		std::vector<SoundVoicePool::Handle> m_voices; // 从发声单元池分配的实例，按开始播放的先后排列
+		uint32_t m_max_voices = 1;
+		float m_speed = 1.0f;
 		int m_status = 0; // 0停止 1暂停 2播放
 		Command m_last_command;
+		bool m_queued = false; // 是否已在资源管理器的待刷新列表中
+		void enqueue();
+		enum class ReleaseMode
+		{
+			Stolen,   // 只丢弃被抢占的实例
+			Finished, // 同时归还已经结束播放的实例
+			All,      // 归还全部实例
+		};
+		void startVoice(bool start);
+		void releaseVoices(ReleaseMode mode);
 	public:
-		void FlushCommand();
-		void Play(float vol, float pan);
+		bool FlushCommand();
+		void Play(float vol, float pan, float speed);
 		void Resume();
 		void Pause();
 		void Stop();
@@ -36,8 +54,11 @@ namespace LuaSTGPlus
 		bool IsStopped();
 		bool SetSpeed(float speed);
 		float GetSpeed();
+		void SetMaxVoices(uint32_t count);
+		uint32_t GetMaxVoices();
 
 	public:
-		ResourceSoundEffectImpl(const char* name, Core::Audio::IAudioPlayer* p_player);
+		ResourceSoundEffectImpl(const char* name, Core::Audio::IAudioBuffer* p_buffer);
+		~ResourceSoundEffectImpl();
 	};
 }
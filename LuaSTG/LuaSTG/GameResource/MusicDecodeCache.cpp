@@ -0,0 +1,362 @@
+#include "GameResource/MusicDecodeCache.hpp"
+#include "Core/Object.hpp"
+#include "Core/FileManager.hpp"
+#include "core/Configuration.hpp"
+#include "xxhash.h"
+#include "wil/resource.h"
+
+#ifdef USING_MUSIC_DECODE_CACHE
+
+namespace
+{
+	struct MusicCacheHeader
+	{
+		char magic[8];
+		uint32_t format_version;
+		uint16_t sample_size;
+		uint16_t channel_count;
+		uint32_t sample_rate;
+		uint32_t frame_count;
+		uint64_t source_stamp;
+		uint64_t source_size;
+		double decode_time;
+	};
+
+	constexpr char music_cache_magic[8] = { 'L', 'S', 'T', 'G', 'P', 'C', 'M', '\0' };
+	constexpr uint32_t music_cache_format_version = 2;
+
+	LuaSTGPlus::MusicDecodeCache::Statistics g_statistics;
+
+	std::filesystem::path const& getCacheDirectory()
+	{
+		static bool initialized = false;
+		static std::filesystem::path directory;
+		if (!initialized)
+		{
+			auto const& config = core::ConfigurationLoader::getInstance().getFileSystem();
+			if (config.hasUser())
+			{
+				core::ConfigurationLoader::resolvePathWithPredefinedVariables(config.getUser(), directory, true);
+				directory /= L"cache/pcm";
+			}
+			else
+			{
+				directory = L"cache/pcm";
+			}
+			std::error_code ec;
+			std::filesystem::create_directories(directory, ec);
+			initialized = true;
+		}
+		return directory;
+	}
+
+	double getTime()
+	{
+		LARGE_INTEGER freq{}, t{};
+		QueryPerformanceFrequency(&freq);
+		QueryPerformanceCounter(&t);
+		return (double)t.QuadPart / (double)freq.QuadPart;
+	}
+
+	// 从内存或者映射的缓存文件中读取 PCM 数据，样本格式与写入缓存的解码器一致
+	class PCMDecoder : public Core::Object<Core::Audio::IDecoder>
+	{
+	private:
+		std::vector<uint8_t> m_data;
+		wil::unique_hfile m_file;
+		wil::unique_handle m_mapping;
+		wil::unique_mapview_ptr<uint8_t> m_view;
+		uint8_t const* m_pcm = nullptr;
+		uint16_t m_sample_size = 2;
+		uint16_t m_channel_count = 2;
+		uint32_t m_sample_rate = 44100;
+		uint32_t m_frame_count = 0;
+		uint32_t m_cursor = 0;
+	public:
+		uint16_t getSampleSize() { return m_sample_size; }
+		uint16_t getChannelCount() { return m_channel_count; }
+		uint16_t getFrameSize() { return m_channel_count * m_sample_size; }
+		uint32_t getSampleRate() { return m_sample_rate; }
+		uint32_t getByteRate() { return m_sample_rate * getFrameSize(); }
+		uint32_t getFrameCount() { return m_frame_count; }
+
+		bool seek(uint32_t pcm_frame)
+		{
+			m_cursor = std::min(pcm_frame, m_frame_count);
+			return true;
+		}
+		bool seekByTime(double sec) { return seek((uint32_t)(sec * (double)m_sample_rate)); }
+		bool tell(uint32_t* pcm_frame) { *pcm_frame = m_cursor; return true; }
+		bool tellAsTime(double* sec) { *sec = (double)m_cursor / (double)m_sample_rate; return true; }
+		bool read(uint32_t pcm_frame, void* buffer, uint32_t* read_pcm_frame)
+		{
+			uint32_t const count = std::min(pcm_frame, m_frame_count - m_cursor);
+			size_t const frame_size = getFrameSize();
+			std::memcpy(buffer, m_pcm + (size_t)m_cursor * frame_size, (size_t)count * frame_size);
+			m_cursor += count;
+			if (read_pcm_frame) *read_pcm_frame = count;
+			return true;
+		}
+
+	public:
+		// 接管解码得到的数据
+		PCMDecoder(Core::Audio::IDecoder* p_decoder, std::vector<uint8_t>&& data, uint32_t frame_count)
+			: m_data(std::move(data))
+			, m_sample_size(p_decoder->getSampleSize())
+			, m_channel_count(p_decoder->getChannelCount())
+			, m_sample_rate(p_decoder->getSampleRate())
+			, m_frame_count(frame_count)
+		{
+			m_pcm = m_data.data();
+		}
+		// 映射缓存文件，校验失败时抛出异常
+		PCMDecoder(std::filesystem::path const& path, uint64_t source_stamp, uint64_t source_size, double* decode_time)
+		{
+			m_file.reset(CreateFileW(path.c_str(), GENERIC_READ | FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL));
+			if (!m_file)
+			{
+				throw std::runtime_error("cache not found");
+			}
+			LARGE_INTEGER file_size{};
+			if (!GetFileSizeEx(m_file.get(), &file_size) || (uint64_t)file_size.QuadPart < sizeof(MusicCacheHeader))
+			{
+				throw std::runtime_error("invalid cache size");
+			}
+			m_mapping.reset(CreateFileMappingW(m_file.get(), NULL, PAGE_READONLY, 0, 0, NULL));
+			if (!m_mapping)
+			{
+				throw std::runtime_error("CreateFileMappingW failed");
+			}
+			m_view.reset(static_cast<uint8_t*>(MapViewOfFile(m_mapping.get(), FILE_MAP_READ, 0, 0, 0)));
+			if (!m_view)
+			{
+				throw std::runtime_error("MapViewOfFile failed");
+			}
+			MusicCacheHeader header{};
+			std::memcpy(&header, m_view.get(), sizeof(header));
+			uint64_t const pcm_size = (uint64_t)header.frame_count * header.channel_count * header.sample_size;
+			if (std::memcmp(header.magic, music_cache_magic, sizeof(music_cache_magic)) != 0
+				|| header.format_version != music_cache_format_version
+				|| header.source_stamp != source_stamp
+				|| header.source_size != source_size
+				|| header.sample_size == 0 || header.sample_size > 4
+				|| header.channel_count == 0
+				|| header.sample_rate == 0
+				|| (uint64_t)file_size.QuadPart != sizeof(MusicCacheHeader) + pcm_size)
+			{
+				throw std::runtime_error("cache mismatch");
+			}
+			m_sample_size = header.sample_size;
+			m_channel_count = header.channel_count;
+			m_sample_rate = header.sample_rate;
+			m_frame_count = header.frame_count;
+			m_pcm = m_view.get() + sizeof(MusicCacheHeader);
+			*decode_time = header.decode_time;
+			g_statistics.bytes_mapped += pcm_size;
+			// 修改时间用作最近使用时间，清理缓存时先删除最久没有使用的文件
+			FILETIME now{};
+			GetSystemTimeAsFileTime(&now);
+			SetFileTime(m_file.get(), NULL, NULL, &now);
+		}
+	};
+
+	void saveCache(std::filesystem::path const& path, Core::Audio::IDecoder* p_decoder, std::vector<uint8_t> const& data, uint32_t frame_count, uint64_t source_stamp, uint64_t source_size, double decode_time)
+	{
+		MusicCacheHeader header{};
+		std::memcpy(header.magic, music_cache_magic, sizeof(music_cache_magic));
+		header.format_version = music_cache_format_version;
+		header.sample_size = p_decoder->getSampleSize();
+		header.channel_count = p_decoder->getChannelCount();
+		header.sample_rate = p_decoder->getSampleRate();
+		header.frame_count = frame_count;
+		header.source_stamp = source_stamp;
+		header.source_size = source_size;
+		header.decode_time = decode_time;
+		// 先写入临时文件再替换，避免留下写了一半的缓存
+		std::filesystem::path temp_path(path);
+		temp_path += L".tmp";
+		{
+			std::ofstream file(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				return;
+			}
+			file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+			file.write(reinterpret_cast<char const*>(data.data()), (std::streamsize)data.size());
+			if (!file.good())
+			{
+				file.close();
+				std::error_code ec;
+				std::filesystem::remove(temp_path, ec);
+				return;
+			}
+		}
+		std::error_code ec;
+		std::filesystem::rename(temp_path, path, ec);
+		if (ec)
+		{
+			std::filesystem::remove(temp_path, ec);
+		}
+	}
+
+	// 缓存总大小超出限制时，按修改时间从旧到新删除缓存文件，正在使用（已映射）的文件会删除失败，直接跳过
+	void trimCache(std::filesystem::path const& keep_path)
+	{
+		struct CacheFile
+		{
+			std::filesystem::path path;
+			std::filesystem::file_time_type time;
+			uint64_t size = 0;
+		};
+		std::vector<CacheFile> files;
+		uint64_t total_size = 0;
+		std::error_code ec;
+		for (auto const& entry : std::filesystem::directory_iterator(getCacheDirectory(), ec))
+		{
+			std::error_code entry_ec;
+			if (!entry.is_regular_file(entry_ec) || entry.path().extension() != L".pcm")
+			{
+				continue;
+			}
+			CacheFile file;
+			file.path = entry.path();
+			file.time = entry.last_write_time(entry_ec);
+			file.size = entry.file_size(entry_ec);
+			if (entry_ec)
+			{
+				continue;
+			}
+			total_size += file.size;
+			files.emplace_back(std::move(file));
+		}
+		if (total_size <= MUSIC_DECODE_CACHE_SIZE_LIMIT)
+		{
+			return;
+		}
+		std::sort(files.begin(), files.end(), [](CacheFile const& a, CacheFile const& b) { return a.time < b.time; });
+		for (auto const& file : files)
+		{
+			if (total_size <= MUSIC_DECODE_CACHE_SIZE_LIMIT)
+			{
+				break;
+			}
+			if (file.path == keep_path)
+			{
+				continue;
+			}
+			if (std::filesystem::remove(file.path, ec))
+			{
+				total_size -= file.size;
+			}
+		}
+	}
+}
+
+namespace LuaSTGPlus
+{
+	bool MusicDecodeCache::createDecoder(std::string_view path, Core::Audio::IDecoder** pp_decoder)
+	{
+		// 缓存以路径为键，用文件大小和修改标记（压缩包内为 CRC32）校验，命中时不需要读取源文件
+		// 加密压缩包中的音乐不写入缓存，否则解码后的数据会以明文形式留在用户数据目录下
+
+		uint64_t source_size = 0;
+		uint64_t source_stamp = 0;
+		bool const cacheable = !GFileManager().isEncryptedEx(path) && GFileManager().getStampEx(path, source_size, source_stamp);
+		std::filesystem::path cache_path;
+		if (cacheable)
+		{
+			XXH64_hash_t const key = XXH3_64bits(path.data(), path.size());
+			cache_path = getCacheDirectory() / fmt::format("{:016x}.pcm", key);
+			try
+			{
+				double decode_time = 0.0;
+				*pp_decoder = new PCMDecoder(cache_path, source_stamp, source_size, &decode_time);
+				g_statistics.hit_count += 1;
+				g_statistics.decode_time_saved += decode_time;
+				return true;
+			}
+			catch (std::exception const&)
+			{
+				// 没有缓存或者缓存已失效
+			}
+		}
+
+		// 只读取一次源文件，直接从内存解码
+
+		std::vector<uint8_t> source;
+		if (!GFileManager().loadEx(path, source))
+		{
+			spdlog::error("[luastg] MusicDecodeCache: 无法读取 '{}'", path);
+			*pp_decoder = nullptr;
+			return false;
+		}
+		// WAV 本身就是 PCM，不需要缓存
+		bool const is_wav = source.size() >= 4 && std::memcmp(source.data(), "RIFF", 4) == 0;
+		Core::ScopeObject<Core::Audio::IDecoder> p_decoder;
+		if (!Core::Audio::IDecoder::create(std::move(source), ~p_decoder))
+		{
+			*pp_decoder = nullptr;
+			return false;
+		}
+		if (is_wav)
+		{
+			*pp_decoder = p_decoder.detach();
+			return true;
+		}
+
+		// 解码并写入缓存
+
+		try
+		{
+			double const t0 = getTime();
+			std::vector<uint8_t> data((size_t)p_decoder->getFrameCount() * p_decoder->getFrameSize());
+			uint32_t frames_read = 0;
+			if (!p_decoder->seek(0) || !p_decoder->read(p_decoder->getFrameCount(), data.data(), &frames_read))
+			{
+				spdlog::error("[luastg] MusicDecodeCache: 解码 '{}' 失败", path);
+				*pp_decoder = nullptr;
+				return false;
+			}
+			data.resize((size_t)frames_read * p_decoder->getFrameSize());
+			double const decode_time = getTime() - t0;
+			g_statistics.miss_count += 1;
+			g_statistics.decode_time += decode_time;
+			if (cacheable && data.size() <= MUSIC_DECODE_CACHE_SIZE_LIMIT)
+			{
+				saveCache(cache_path, p_decoder.get(), data, frames_read, source_stamp, source_size, decode_time);
+				trimCache(cache_path);
+			}
+			*pp_decoder = new PCMDecoder(p_decoder.get(), std::move(data), frames_read);
+			return true;
+		}
+		catch (std::exception const& e)
+		{
+			// 内存不足等情况，退化为普通的解码器
+			spdlog::error("[luastg] MusicDecodeCache: {}", e.what());
+			p_decoder->seek(0);
+			*pp_decoder = p_decoder.detach();
+			return true;
+		}
+	}
+	MusicDecodeCache::Statistics const& MusicDecodeCache::getStatistics() noexcept
+	{
+		return g_statistics;
+	}
+}
+
+#else
+
+namespace LuaSTGPlus
+{
+	bool MusicDecodeCache::createDecoder(std::string_view path, Core::Audio::IDecoder** pp_decoder)
+	{
+		return Core::Audio::IDecoder::create(path, pp_decoder);
+	}
+	MusicDecodeCache::Statistics const& MusicDecodeCache::getStatistics() noexcept
+	{
+		static Statistics const empty{};
+		return empty;
+	}
+}
+
+#endif
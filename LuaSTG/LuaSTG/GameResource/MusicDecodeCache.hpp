@@ -0,0 +1,25 @@
+#pragma once
+#include "Core/Audio/Decoder.hpp"
+
+namespace LuaSTGPlus
+{
+	// 一次性解码的背景音乐的 PCM 缓存，以源文件路径的哈希值为键保存在用户数据目录下，
+	// 用文件大小和修改标记校验，再次加载时直接映射缓存文件，不读取源文件，跳过解码
+	// 加密压缩包中的音乐不缓存；缓存总大小超过 MUSIC_DECODE_CACHE_SIZE_LIMIT 时删除最久没有使用的文件
+	class MusicDecodeCache
+	{
+	public:
+		struct Statistics
+		{
+			uint32_t hit_count = 0;
+			uint32_t miss_count = 0;
+			double decode_time = 0.0;       // 未命中时实际花费的解码时间（秒）
+			double decode_time_saved = 0.0; // 命中时省下的解码时间（秒），按写入缓存时记录的解码时间计算
+			uint64_t bytes_mapped = 0;
+		};
+	public:
+		// 创建可以直接读取已解码 PCM 数据的解码器，无法使用缓存时退化为普通的解码器
+		static bool createDecoder(std::string_view path, Core::Audio::IDecoder** pp_decoder);
+		static Statistics const& getStatistics() noexcept;
+	};
+}
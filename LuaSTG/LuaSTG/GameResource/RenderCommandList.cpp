@@ -0,0 +1,139 @@
+#include "GameResource/RenderCommandList.hpp"
+#include "AppFrame.h"
+
+namespace LuaSTGPlus
+{
+	// 单个批次的上限，drawRequest 一次最多只能申请 uint16 个顶点和索引
+	constexpr uint32_t batch_vertex_limit = 16384;
+	constexpr uint32_t batch_index_limit = 32768;
+
+	inline uint8_t mul_color_channel(uint8_t const a, uint8_t const b)
+	{
+		return (uint8_t)(((uint32_t)a * (uint32_t)b + 127u) / 255u);
+	}
+
+	RenderCommandList::Batch* RenderCommandList::requestBatch(Core::Graphics::ITexture2D* p_texture, BlendMode const blend, uint32_t const vertex_count, uint32_t const index_count)
+	{
+		if (!p_texture || vertex_count == 0 || index_count == 0 || vertex_count > batch_vertex_limit || index_count > batch_index_limit)
+		{
+			return nullptr;
+		}
+		if (!m_batch.empty())
+		{
+			Batch& last = m_batch.back();
+			if (last.texture.get() == p_texture && last.blend == blend
+				&& (last.vertex_count + vertex_count) <= batch_vertex_limit
+				&& (last.index_count + index_count) <= batch_index_limit)
+			{
+				return &last;
+			}
+		}
+		Batch batch;
+		batch.texture = p_texture;
+		batch.blend = blend;
+		batch.vertex_offset = (uint32_t)m_vertex.size();
+		batch.index_offset = (uint32_t)m_index.size();
+		m_batch.emplace_back(std::move(batch));
+		return &m_batch.back();
+	}
+
+	bool RenderCommandList::AddQuad(Core::Graphics::ITexture2D* p_texture, BlendMode const blend, DrawVertex const* p_vertex)
+	{
+		DrawIndex const index[6] = { 0, 1, 2, 0, 2, 3 };
+		return AddMesh(p_texture, blend, p_vertex, 4, index, 6);
+	}
+	bool RenderCommandList::AddMesh(Core::Graphics::ITexture2D* p_texture, BlendMode const blend, DrawVertex const* p_vertex, uint32_t const vertex_count, DrawIndex const* p_index, uint32_t const index_count)
+	{
+		for (uint32_t i = 0; i < index_count; i += 1)
+		{
+			if ((uint32_t)p_index[i] >= vertex_count)
+			{
+				spdlog::error("[luastg] RenderCommandList::AddMesh failed: index {} out of range (vertex count {})", p_index[i], vertex_count);
+				return false;
+			}
+		}
+		Batch* batch = requestBatch(p_texture, blend, vertex_count, index_count);
+		if (!batch)
+		{
+			return false;
+		}
+		DrawIndex const base = (DrawIndex)batch->vertex_count;
+		m_vertex.insert(m_vertex.end(), p_vertex, p_vertex + vertex_count);
+		for (uint32_t i = 0; i < index_count; i += 1)
+		{
+			m_index.emplace_back((DrawIndex)(base + p_index[i]));
+		}
+		batch->vertex_count += vertex_count;
+		batch->index_count += index_count;
+		return true;
+	}
+	void RenderCommandList::Clear()
+	{
+		m_vertex.clear();
+		m_index.clear();
+		m_batch.clear();
+	}
+	bool RenderCommandList::Draw(Core::Graphics::IRenderer* p_renderer, Core::Vector2F const& position, float const rotation, Core::Vector2F const& scale, Core::Color4B const color)
+	{
+		bool const is_identity = position.x == 0.0f && position.y == 0.0f
+			&& std::abs(rotation) < std::numeric_limits<float>::min()
+			&& scale.x == 1.0f && scale.y == 1.0f;
+		bool const is_white = color.color() == 0xFFFFFFFFu;
+		float const sinv = std::sinf(rotation);
+		float const cosv = std::cosf(rotation);
+
+		for (auto const& batch : m_batch)
+		{
+			LAPP.updateGraph2DBlendMode(batch.blend);
+			p_renderer->setTexture(batch.texture.get());
+
+			DrawVertex* p_vert = nullptr;
+			DrawIndex* p_idx = nullptr;
+			DrawIndex vert_offset = 0;
+			if (!p_renderer->drawRequest((uint16_t)batch.vertex_count, (uint16_t)batch.index_count, &p_vert, &p_idx, &vert_offset))
+			{
+				return false;
+			}
+
+			DrawVertex const* const src_vert = m_vertex.data() + batch.vertex_offset;
+			if (is_identity && is_white)
+			{
+				std::memcpy(p_vert, src_vert, sizeof(DrawVertex) * batch.vertex_count);
+			}
+			else
+			{
+				for (uint32_t i = 0; i < batch.vertex_count; i += 1)
+				{
+					DrawVertex v = src_vert[i];
+					if (!is_identity)
+					{
+						float const sx = v.x * scale.x;
+						float const sy = v.y * scale.y;
+						v.x = sx * cosv - sy * sinv + position.x;
+						v.y = sx * sinv + sy * cosv + position.y;
+					}
+					if (!is_white)
+					{
+						Core::Color4B c(v.color);
+						c.r = mul_color_channel(c.r, color.r);
+						c.g = mul_color_channel(c.g, color.g);
+						c.b = mul_color_channel(c.b, color.b);
+						c.a = mul_color_channel(c.a, color.a);
+						v.color = c.color();
+					}
+					p_vert[i] = v;
+				}
+			}
+
+			DrawIndex const* const src_idx = m_index.data() + batch.index_offset;
+			for (uint32_t i = 0; i < batch.index_count; i += 1)
+			{
+				p_idx[i] = vert_offset + src_idx[i];
+			}
+		}
+		return true;
+	}
+
+	RenderCommandList::RenderCommandList() = default;
+	RenderCommandList::~RenderCommandList() = default;
+}
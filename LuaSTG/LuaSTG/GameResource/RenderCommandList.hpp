@@ -0,0 +1,43 @@
+#pragma once
+#include "GameResource/ResourceBase.hpp"
+#include "Core/Graphics/Renderer.hpp"
+
+namespace LuaSTGPlus
+{
+	// 保留模式的绘制命令列表，适合静态的背景层：只录制一次，之后每帧一次调用即可重放
+	// 顶点和索引紧凑地存放在一起，纹理和混合模式相同的连续绘制会合并为一个批次
+	class RenderCommandList
+	{
+	public:
+		using DrawVertex = Core::Graphics::IRenderer::DrawVertex;
+		using DrawIndex = Core::Graphics::IRenderer::DrawIndex;
+	private:
+		struct Batch
+		{
+			Core::ScopeObject<Core::Graphics::ITexture2D> texture;
+			BlendMode blend = BlendMode::MulAlpha;
+			uint32_t vertex_offset = 0;
+			uint32_t vertex_count = 0;
+			uint32_t index_offset = 0;
+			uint32_t index_count = 0;
+		};
+		std::vector<DrawVertex> m_vertex;
+		std::vector<DrawIndex> m_index; // 相对于所在批次的第一个顶点
+		std::vector<Batch> m_batch;
+	private:
+		Batch* requestBatch(Core::Graphics::ITexture2D* p_texture, BlendMode blend, uint32_t vertex_count, uint32_t index_count);
+	public:
+		// 顶点按 drawQuad 的顺序排列，纹理坐标已经归一化
+		bool AddQuad(Core::Graphics::ITexture2D* p_texture, BlendMode blend, DrawVertex const* p_vertex);
+		bool AddMesh(Core::Graphics::ITexture2D* p_texture, BlendMode blend, DrawVertex const* p_vertex, uint32_t vertex_count, DrawIndex const* p_index, uint32_t index_count);
+		void Clear();
+		// 先缩放、旋转再平移，顶点颜色与 color 逐通道相乘
+		bool Draw(Core::Graphics::IRenderer* p_renderer, Core::Vector2F const& position, float rotation, Core::Vector2F const& scale, Core::Color4B color);
+		uint32_t GetVertexCount() const noexcept { return (uint32_t)m_vertex.size(); }
+		uint32_t GetIndexCount() const noexcept { return (uint32_t)m_index.size(); }
+		uint32_t GetBatchCount() const noexcept { return (uint32_t)m_batch.size(); }
+	public:
+		RenderCommandList();
+		~RenderCommandList();
+	};
+}
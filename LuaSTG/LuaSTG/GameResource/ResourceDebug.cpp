@@ -1,4 +1,6 @@
 #include "GameResource/ResourceManager.h"
+#include "GameResource/MusicDecodeCache.hpp"
+#include "AppFrame.h"
 #ifdef USING_DEAR_IMGUI
 #include "imgui.h"
 #endif
@@ -98,7 +100,7 @@ namespace LuaSTGPlus
 					ImVec4(1.0f, 1.0f, 1.0f, 1.0f),
 					ImVec4(0.5f, 0.5f, 0.5f, 1.0f));
 			};
-			auto draw_sprite = [](Core::Graphics::ISprite* p_res, bool show_info, bool focus, float scale) -> void {
+			auto draw_sprite = [this](Core::Graphics::ISprite* p_res, bool show_info, bool focus, float scale) -> void {
 				auto color = ImVec4(0.5f, 0.5f, 0.5f, 1.0f);
 				if (focus)
 				{
@@ -110,7 +112,8 @@ namespace LuaSTGPlus
 				auto cp = p_res->getTextureCenter() - rc.a;
 				if (show_info)
 				{
-					ImGui::Text("Pos: %.2f x %.2f", rc.a.x, rc.a.y);
+					auto const src_rc = GetSpriteTextureRect(p_res);
+					ImGui::Text("Pos: %.2f x %.2f", src_rc.a.x, src_rc.a.y);
 					ImGui::Text("Size: %.2f x %.2f", rc.b.x - rc.a.x, rc.b.y - rc.a.y);
 					ImGui::Text("Center: %.2f x %.2f", cp.x, cp.y);
 					ImGui::Text("Units Per Pixel: %.4f", p_res->getUnitsPerPixel());
@@ -249,10 +252,63 @@ namespace LuaSTGPlus
 						ImGui::EndTabItem();
 					}
 
+					if (ImGui::BeginTabItem("Texture Atlas"))
+					{
+						bool atlas_enable = IsTextureAtlasEnable();
+						if (ImGui::Checkbox("Enable (All Resource Pools)", &atlas_enable))
+						{
+							SetTextureAtlasEnable(atlas_enable);
+						}
+						double const draw_on = GetDrawCommandPerFrame(true);
+						double const draw_off = GetDrawCommandPerFrame(false);
+						ImGui::Text("Draw Commands Per Frame (Atlas On): %.1f", draw_on);
+						ImGui::Text("Draw Commands Per Frame (Atlas Off): %.1f", draw_off);
+						if (draw_on > 0.0 && draw_off > 0.0)
+						{
+							ImGui::Text("Draw Commands Reduced: %.1f%%", 100.0 * (1.0 - draw_on / draw_off));
+						}
+						else
+						{
+							ImGui::TextDisabled("Toggle the atlas once to compare draw commands");
+						}
+
+						auto& atlas = p_pool->GetTextureAtlas();
+						ImGui::Text("Total Pages: %u", atlas.GetPageCount());
+						ImGui::Text("Total Sprites: %u", atlas.GetSpriteCount());
+
+						for (size_t i = 0; i < atlas.GetPageCount(); i += 1)
+						{
+							auto const info = atlas.GetPageInfo(i);
+							double const area = (double)info.size.x * (double)info.size.y;
+							if (ImGui::TreeNode(atlas.GetPageTexture(i),
+								"%u. %u x %u, %u Textures, %.1f%% Occupied",
+								(uint32_t)i,
+								info.size.x, info.size.y,
+								info.texture_count,
+								100.0 * (double)info.used_area / area
+							))
+							{
+								static float preview_scale = 0.5f;
+								draw_preview_scaling(preview_scale);
+								draw_texture0(atlas.GetPageTexture(i), preview_scale);
+								ImGui::TreePop();
+							}
+						}
+
+						ImGui::EndTabItem();
+					}
+
 					if (ImGui::BeginTabItem("Music"))
 					{
 						ImGui::Text("Total Resources: %u", p_pool->m_MusicPool.size());
 
+						auto const& cache = MusicDecodeCache::getStatistics();
+						uint32_t const cache_total = cache.hit_count + cache.miss_count;
+						ImGui::Text("Decode Cache: %u hit / %u miss (%.1f%%)", cache.hit_count, cache.miss_count,
+							cache_total > 0 ? 100.0 * (double)cache.hit_count / (double)cache_total : 0.0);
+						ImGui::Text("Decode Time: %.3f s spent, %.3f s saved", cache.decode_time, cache.decode_time_saved);
+						ImGui::Text("Decode Cache Mapped: %s", bytes_count_to_string(cache.bytes_mapped).c_str());
+
 						static ImGuiTextFilter filter;
 						filter.Draw();
 
@@ -376,6 +432,24 @@ namespace LuaSTGPlus
 					{
 						ImGui::Text("Total Resources: %u", p_pool->m_TTFFontPool.size());
 
+						auto& layout_cache = LAPP.GetTextLayoutCache();
+						bool layout_cache_enable = layout_cache.IsEnable();
+						if (ImGui::Checkbox("Text Layout Cache", &layout_cache_enable))
+						{
+							layout_cache.SetEnable(layout_cache_enable);
+						}
+						ImGui::SameLine();
+						if (ImGui::Button("Reset Statistics"))
+						{
+							layout_cache.ResetStatistics();
+						}
+						auto const& layout_stat = layout_cache.GetStatistics();
+						uint64_t const layout_total = layout_stat.hit_count + layout_stat.miss_count;
+						ImGui::Text("Layout Cache: %llu hit / %llu miss (%.1f%%)", layout_stat.hit_count, layout_stat.miss_count,
+							layout_total > 0 ? 100.0 * (double)layout_stat.hit_count / (double)layout_total : 0.0);
+						ImGui::Text("Layout Cache Entries: %u (%llu evicted, %llu not cached while glyphs rasterizing)",
+							(uint32_t)layout_cache.GetEntryCount(), layout_stat.evict_count, layout_stat.incomplete_count);
+
 						static ImGuiTextFilter filter;
 						filter.Draw();
 
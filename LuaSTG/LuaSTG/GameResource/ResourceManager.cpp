@@ -1,4 +1,5 @@
 ﻿#include "GameResource/ResourceManager.h"
+#include "AppFrame.h"
 
 namespace LuaSTGPlus
 {
@@ -134,16 +135,86 @@ namespace LuaSTGPlus
 
 	void ResourceMgr::UpdateSound()
 	{
-		for (auto& snd : m_GlobalResourcePool.m_SoundSpritePool)
+		// 只处理本帧收到命令或者仍在播放的音效
+		size_t count = 0;
+		for (auto* snd : m_SoundCommandQueue)
 		{
-			snd.second->FlushCommand();
+			if (snd->FlushCommand())
+			{
+				m_SoundCommandQueue[count] = snd;
+				count += 1;
+			}
 		}
-		for (auto& snd : m_StageResourcePool.m_SoundSpritePool)
+		m_SoundCommandQueue.resize(count);
+	}
+
+	void ResourceMgr::UpdateTextureAtlas() noexcept
+	{
+		auto* p_renderer = LAPP.GetAppModel()->getRenderer();
+
+		// 上一帧的绘制命令数量
+		uint64_t const draw_command_count = p_renderer->getDrawCommandCount();
+		if (m_LastDrawCommandCount > 0 && draw_command_count >= m_LastDrawCommandCount)
+		{
+			double& average = m_DrawCommandPerFrame[m_TextureAtlasEnable ? 1 : 0];
+			double const current = (double)(draw_command_count - m_LastDrawCommandCount);
+			average = (average > 0.0) ? (average * 0.95 + current * 0.05) : current;
+		}
+		m_LastDrawCommandCount = draw_command_count;
+
+		for (auto* p_pool : { &m_GlobalResourcePool, &m_StageResourcePool })
 		{
-			snd.second->FlushCommand();
+			if (!p_pool->m_TextureAtlas.IsEmpty())
+			{
+				p_pool->m_TextureAtlas.SetEnable(m_TextureAtlasEnable);
+				p_pool->m_TextureAtlas.Update(p_renderer);
+			}
 		}
 	}
 
+	Core::Vector2F ResourceMgr::GetTextureAtlasOffset(Core::Graphics::ISprite* p_sprite) noexcept
+	{
+		// 关卡资源池中的图片精灵也可能放在全局资源池的图集里
+		Core::Vector2F offset;
+		for (auto* p_pool : { &m_GlobalResourcePool, &m_StageResourcePool })
+		{
+			if (p_pool->m_TextureAtlas.FindSprite(p_sprite, &offset))
+			{
+				return offset;
+			}
+		}
+		return Core::Vector2F(0.0f, 0.0f);
+	}
+	Core::RectF ResourceMgr::GetSpriteTextureRect(Core::Graphics::ISprite* p_sprite) noexcept
+	{
+		Core::Vector2F const offset = GetTextureAtlasOffset(p_sprite);
+		return p_sprite->getTextureRect() - offset;
+	}
+	void ResourceMgr::SetSpriteTextureCenter(Core::Graphics::ISprite* p_sprite, Core::Vector2F const& center) noexcept
+	{
+		Core::Vector2F const offset = GetTextureAtlasOffset(p_sprite);
+		p_sprite->setTextureCenter(center + offset);
+	}
+
+	bool ResourceMgr::EnqueueSoundCommand(IResourceSoundEffect* p) noexcept
+	{
+		try
+		{
+			m_SoundCommandQueue.push_back(p);
+			return true;
+		}
+		catch (...)
+		{
+			spdlog::error("[luastg] EnqueueSoundCommand: 内存不足");
+			return false;
+		}
+	}
+
+	void ResourceMgr::CancelSoundCommand(IResourceSoundEffect* p) noexcept
+	{
+		std::erase(m_SoundCommandQueue, p);
+	}
+
 	// 其他
 
 	#ifdef LDEVVERSION
@@ -8,6 +8,8 @@
 #include "GameResource/ResourceFont.hpp"
 #include "GameResource/ResourcePostEffectShader.hpp"
 #include "GameResource/ResourceModel.hpp"
+#include "GameResource/SoundVoicePool.hpp"
+#include "GameResource/TextureAtlas.hpp"
 #include "lua.hpp"
 #include "xxhash.h"
 
@@ -86,8 +88,12 @@ namespace LuaSTGPlus
         dictionary_t<Core::ScopeObject<IResourceFont>> m_TTFFontPool;
         dictionary_t<Core::ScopeObject<IResourcePostEffectShader>> m_FXPool;
         dictionary_t<Core::ScopeObject<IResourceModel>> m_ModelPool;
+        TextureAtlas m_TextureAtlas;
     private:
         const char* getResourcePoolTypeName();
+        void applyTextureAtlas(Core::Graphics::ISprite* p_sprite) noexcept;
+        void releaseTextureAtlas(IResourceSprite* p_res) noexcept;
+        void releaseTextureAtlas(IResourceAnimation* p_res) noexcept;
     public:
         void Clear() noexcept;
         void RemoveResource(ResourceType t, const char* name) noexcept;
@@ -131,6 +137,9 @@ namespace LuaSTGPlus
         bool LoadFX(const char* name, const char* path) noexcept;
         // 模型
         bool LoadModel(const char* name, const char* path) noexcept;
+        // 纹理图集，只接受本资源池中的纹理；返回新加入图集的纹理数量
+        uint32_t BuildTextureAtlas(std::vector<std::string_view> const& names, uint32_t page_size = 2048, uint32_t padding = 2) noexcept;
+        TextureAtlas& GetTextureAtlas() noexcept { return m_TextureAtlas; }
         
         Core::ScopeObject<IResourceTexture> GetTexture(std::string_view name) noexcept;
         Core::ScopeObject<IResourceSprite> GetSprite(std::string_view name) noexcept;
@@ -153,6 +162,14 @@ namespace LuaSTGPlus
     {
     private:
         ResourcePoolType m_ActivedPool = ResourcePoolType::Global;
+        // 有待执行命令或者正在播放的音效，必须在资源池之前声明（资源池析构时会从中移除音效）
+        std::vector<IResourceSoundEffect*> m_SoundCommandQueue;
+        bool m_SoundEffectMixing = false;
+        bool m_TextureAtlasEnable = true;
+        uint64_t m_LastDrawCommandCount = 0;
+        double m_DrawCommandPerFrame[2]{}; // 分别为关闭、开启纹理图集时的平滑平均值
+        // 音效发声单元池，同样必须在资源池之前声明（音效析构时会归还发声单元）
+        SoundVoicePool m_SoundVoicePool;
         ResourcePool m_GlobalResourcePool;
         ResourcePool m_StageResourcePool;
     public:
@@ -176,6 +193,22 @@ namespace LuaSTGPlus
         bool GetTextureSize(const char* name, Core::Vector2U& out) noexcept;
         void CacheTTFFontString(const char* name, const char* text, size_t len) noexcept;
         void UpdateSound();
+        bool EnqueueSoundCommand(IResourceSoundEffect* p) noexcept;
+        void CancelSoundCommand(IResourceSoundEffect* p) noexcept;
+        // 混音模式：同一帧内多次播放同一音效时，按能量叠加音量、按音量加权平均声像，而不是只取最大音量
+        bool IsSoundEffectMixing() const noexcept { return m_SoundEffectMixing; }
+        void SetSoundEffectMixing(bool v) noexcept { m_SoundEffectMixing = v; }
+        SoundVoicePool& GetSoundVoicePool() noexcept { return m_SoundVoicePool; }
+        // 在渲染开始时调用：复制内容过期的纹理图集页面，并统计每帧绘制命令数量
+        void UpdateTextureAtlas() noexcept;
+        // 关闭后图片精灵临时恢复引用原来的纹理，用于对比图集减少了多少绘制命令
+        bool IsTextureAtlasEnable() const noexcept { return m_TextureAtlasEnable; }
+        void SetTextureAtlasEnable(bool v) noexcept { m_TextureAtlasEnable = v; }
+        double GetDrawCommandPerFrame(bool atlas_enable) const noexcept { return m_DrawCommandPerFrame[atlas_enable ? 1 : 0]; }
+        // 以原纹理上的坐标读写图片精灵的纹理坐标和中心点，图片精灵在纹理图集中时自动换算到图集页面上
+        Core::Vector2F GetTextureAtlasOffset(Core::Graphics::ISprite* p_sprite) noexcept;
+        Core::RectF GetSpriteTextureRect(Core::Graphics::ISprite* p_sprite) noexcept;
+        void SetSpriteTextureCenter(Core::Graphics::ISprite* p_sprite, Core::Vector2F const& center) noexcept;
     private:
         static bool g_ResourceLoadingLog;
         float m_GlobalImageScaleFactor = 1.0f;
@@ -71,7 +71,7 @@ namespace LuaSTGPlus
         float const v_scale = 1.0f / (float)p_texture->getSize().y;
         Core::Graphics::IRenderer::DrawVertex* p_vert = nullptr;
         Core::Graphics::IRenderer::DrawIndex* p_idx = nullptr;
-        uint16_t vert_offset = 0;
+        Core::Graphics::IRenderer::DrawIndex vert_offset = 0;
         if (!p_renderer->drawRequest((uint16_t)vertex_.size(), (uint16_t)index_.size(), &p_vert, &p_idx, &vert_offset))
             return false;
         for (size_t i = 0; i < vertex_.size(); i += 1)
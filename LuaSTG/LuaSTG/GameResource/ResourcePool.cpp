@@ -8,6 +8,7 @@
 #include "GameResource/Implement/ResourceFontImpl.hpp"
 #include "GameResource/Implement/ResourcePostEffectShaderImpl.hpp"
 #include "GameResource/Implement/ResourceModelImpl.hpp"
+#include "GameResource/MusicDecodeCache.hpp"
 #include "Core/FileManager.hpp"
 #include "AppFrame.h"
 #include "lua/plus.hpp"
@@ -18,6 +19,19 @@ namespace LuaSTGPlus
 
     void ResourcePool::Clear() noexcept
     {
+        if (m_iType == ResourcePoolType::Stage)
+        {
+            // 关卡资源池的图片精灵可能引用了全局资源池的纹理图集
+            for (auto& v : m_SpritePool)
+            {
+                releaseTextureAtlas(v.second.get());
+            }
+            for (auto& v : m_AnimationPool)
+            {
+                releaseTextureAtlas(v.second.get());
+            }
+        }
+        m_TextureAtlas.Clear();
         m_TexturePool.clear();
         m_SpritePool.clear();
         m_AnimationPool.clear();
@@ -67,9 +81,17 @@ namespace LuaSTGPlus
             removeResource(m_TexturePool, name);
             break;
         case ResourceType::Sprite:
+            if (auto it = m_SpritePool.find(std::string_view(name)); it != m_SpritePool.end())
+            {
+                releaseTextureAtlas(it->second.get());
+            }
             removeResource(m_SpritePool, name);
             break;
         case ResourceType::Animation:
+            if (auto it = m_AnimationPool.find(std::string_view(name)); it != m_AnimationPool.end())
+            {
+                releaseTextureAtlas(it->second.get());
+            }
             removeResource(m_AnimationPool, name);
             break;
         case ResourceType::Music:
@@ -99,6 +121,86 @@ namespace LuaSTGPlus
         }
     }
 
+    // 纹理图集
+
+    void ResourcePool::applyTextureAtlas(Core::Graphics::ISprite* p_sprite) noexcept
+    {
+        if (m_TextureAtlas.Apply(p_sprite))
+        {
+            return;
+        }
+        if (m_iType == ResourcePoolType::Stage)
+        {
+            m_pMgr->GetResourcePool(ResourcePoolType::Global)->GetTextureAtlas().Apply(p_sprite);
+        }
+    }
+
+    void ResourcePool::releaseTextureAtlas(IResourceSprite* p_res) noexcept
+    {
+        m_TextureAtlas.Remove(p_res->GetSprite());
+        if (m_iType == ResourcePoolType::Stage)
+        {
+            m_pMgr->GetResourcePool(ResourcePoolType::Global)->GetTextureAtlas().Remove(p_res->GetSprite());
+        }
+    }
+
+    void ResourcePool::releaseTextureAtlas(IResourceAnimation* p_res) noexcept
+    {
+        for (uint32_t i = 0; i < (uint32_t)p_res->GetCount(); i += 1)
+        {
+            releaseTextureAtlas(p_res->GetSprite(i));
+        }
+    }
+
+    uint32_t ResourcePool::BuildTextureAtlas(std::vector<std::string_view> const& names, uint32_t const page_size, uint32_t const padding) noexcept
+    {
+        std::vector<Core::Graphics::ITexture2D*> textures;
+        textures.reserve(names.size());
+        for (auto const& name : names)
+        {
+            auto const it = m_TexturePool.find(name);
+            if (it == m_TexturePool.end())
+            {
+                spdlog::error("[luastg] BuildTextureAtlas: 找不到纹理 '{}' ({})", name, getResourcePoolTypeName());
+                continue;
+            }
+            Core::Graphics::ITexture2D* p_texture = it->second->GetTexture();
+            // 渲染目标和动态纹理的内容会变化，自定义了采样器的纹理可能依赖寻址模式，都不能放进图集
+            if (it->second->IsRenderTarget() || p_texture->isDynamic() || p_texture->getSamplerState())
+            {
+                spdlog::warn("[luastg] BuildTextureAtlas: 纹理 '{}' 是渲染目标、动态纹理或者使用了自定义采样器，已跳过", name);
+                continue;
+            }
+            textures.push_back(p_texture);
+        }
+
+        uint32_t count = 0;
+        try
+        {
+            count = m_TextureAtlas.Add(textures, page_size, padding);
+            // 已经创建的图片精灵、动画精灵也改为引用图集，重复应用不会有副作用
+            for (auto& v : m_SpritePool)
+            {
+                applyTextureAtlas(v.second->GetSprite());
+            }
+            for (auto& v : m_AnimationPool)
+            {
+                for (uint32_t i = 0; i < (uint32_t)v.second->GetCount(); i += 1)
+                {
+                    applyTextureAtlas(v.second->GetSprite(i)->GetSprite());
+                }
+            }
+        }
+        catch (std::exception const& e)
+        {
+            spdlog::error("[luastg] BuildTextureAtlas: 创建纹理图集失败 ({})", e.what());
+            return count;
+        }
+
+        spdlog::info("[luastg] BuildTextureAtlas: 已将 {} 个纹理放入纹理图集，共 {} 个页面 ({})", count, m_TextureAtlas.GetPageCount(), getResourcePoolTypeName());
+        return count;
+    }
+
     bool ResourcePool::CheckResourceExists(ResourceType t, std::string_view name) const noexcept
     {
         switch (t)
@@ -347,6 +449,7 @@ namespace LuaSTGPlus
         }
         p_sprite->setTextureRect(Core::RectF((float)x, (float)y, (float)(x + w), (float)(y + h)));
         p_sprite->setTextureCenter(Core::Vector2F((float)(x + w * 0.5), (float)(y + h * 0.5)));
+        applyTextureAtlas(p_sprite.get());
     
         try
         {
@@ -399,6 +502,10 @@ namespace LuaSTGPlus
                     n, m, intv,
                     a, b, rect)
             );
+            for (uint32_t i = 0; i < (uint32_t)tRes->GetCount(); i += 1)
+            {
+                applyTextureAtlas(tRes->GetSprite(i)->GetSprite());
+            }
             m_AnimationPool.emplace(name, tRes);
         }
         catch (std::exception const& e)
@@ -467,9 +574,9 @@ namespace LuaSTGPlus
         using namespace Core;
         using namespace Core::Audio;
 
-        // 创建解码器
+        // 创建解码器，一次性解码时优先使用已解码的缓存
         ScopeObject<IDecoder> p_decoder;
-        if (!IDecoder::create(path, ~p_decoder))
+        if (!(once_decode ? MusicDecodeCache::createDecoder(path, ~p_decoder) : IDecoder::create(path, ~p_decoder)))
         {
             spdlog::error("[luastg] LoadMusic: 无法解码文件 '{}'，要求文件格式为 WAV 或 OGG", path);
             return false;
@@ -562,18 +669,18 @@ namespace LuaSTGPlus
             return false;
         }
 
-        // 创建播放器
-        ScopeObject<IAudioPlayer> p_player;
-        if (!LAPP.GetAppModel()->getAudioDevice()->createAudioPlayer(p_decoder.get(), ~p_player))
+        // 全部解码，播放器由发声单元池按需创建
+        ScopeObject<IAudioBuffer> p_buffer;
+        if (!LAPP.GetAppModel()->getAudioDevice()->createAudioBuffer(p_decoder.get(), ~p_buffer))
         {
-            spdlog::error("[luastg] LoadSoundEffect: 无法创建音频播放器");
+            spdlog::error("[luastg] LoadSoundEffect: 无法解码音频数据");
             return false;
         }
 
         try
         {
             Core::ScopeObject<IResourceSoundEffect> tRes;
-            tRes.attach(new ResourceSoundEffectImpl(name, p_player.get()));
+            tRes.attach(new ResourceSoundEffectImpl(name, p_buffer.get()));
             m_SoundSpritePool.emplace(name, tRes);
         }
         catch (std::exception const& e)
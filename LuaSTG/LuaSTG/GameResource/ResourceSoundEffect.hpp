@@ -5,8 +5,10 @@ namespace LuaSTGPlus
 {
 	struct IResourceSoundEffect : public IResourceBase
 	{
-		virtual void FlushCommand() = 0;
-		virtual void Play(float vol, float pan) = 0;
+		// 执行本帧积累的命令，返回 false 表示之后不再需要刷新（没有命令也没有在播放）
+		virtual bool FlushCommand() = 0;
+		// 开始播放一个新的实例，音量、声像、速度只作用于这个实例
+		virtual void Play(float vol, float pan, float speed) = 0;
 		virtual void Resume() = 0;
 		virtual void Pause() = 0;
 		virtual void Stop() = 0;
@@ -14,5 +16,8 @@ namespace LuaSTGPlus
 		virtual bool IsStopped() = 0;
 		virtual bool SetSpeed(float speed) = 0;
 		virtual float GetSpeed() = 0;
+		// 允许同时播放的实例数量，超出后抢占自己最早的实例，默认为 1
+		virtual void SetMaxVoices(uint32_t count) = 0;
+		virtual uint32_t GetMaxVoices() = 0;
 	};
 }
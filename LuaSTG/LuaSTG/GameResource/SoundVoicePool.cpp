@@ -0,0 +1,189 @@
+#include "GameResource/SoundVoicePool.hpp"
+#include "AppFrame.h"
+
+namespace LuaSTGPlus
+{
+	SoundVoicePool::Voice* SoundVoicePool::findVictim() noexcept
+	{
+		// 优先抢占已经播放结束的，被暂停的不算
+		for (auto& v : m_voices)
+		{
+			if (v.owner && !v.paused && !v.player->isPlaying())
+			{
+				return &v;
+			}
+		}
+		// 其次按策略抢占正在播放的，全部被暂停时才按策略抢占被暂停的
+		if (Voice* victim = findVictim(false))
+		{
+			return victim;
+		}
+		return findVictim(true);
+	}
+	SoundVoicePool::Voice* SoundVoicePool::findVictim(bool const paused) noexcept
+	{
+		Voice* victim = nullptr;
+		for (auto& v : m_voices)
+		{
+			if (v.paused != paused)
+			{
+				continue;
+			}
+			if (!victim)
+			{
+				victim = &v;
+				continue;
+			}
+			switch (m_policy)
+			{
+			case StealPolicy::Quietest:
+				if (v.volume < victim->volume || (v.volume == victim->volume && v.serial < victim->serial))
+				{
+					victim = &v;
+				}
+				break;
+			case StealPolicy::Oldest:
+			default:
+				if (v.serial < victim->serial)
+				{
+					victim = &v;
+				}
+				break;
+			}
+		}
+		return victim;
+	}
+
+	Core::Audio::IAudioPlayer* SoundVoicePool::Acquire(IResourceSoundEffect const* owner, Core::Audio::IAudioBuffer* p_buffer, float volume, Handle& handle)
+	{
+		// 空闲且音频数据相同的发声单元可以直接复用播放器，其次才是其他空闲的
+		Voice* target = nullptr;
+		Voice* spare = nullptr;
+		for (auto& v : m_voices)
+		{
+			if (v.owner)
+			{
+				continue;
+			}
+			if (v.buffer.get() == p_buffer)
+			{
+				target = &v;
+				break;
+			}
+			if (!spare)
+			{
+				spare = &v;
+			}
+		}
+		if (!target)
+		{
+			target = spare;
+		}
+		if (!target && m_voices.size() < m_capacity)
+		{
+			target = &m_voices.emplace_back();
+		}
+		if (!target)
+		{
+			target = findVictim();
+		}
+		if (!target)
+		{
+			return nullptr; // 容量为 0
+		}
+
+		// 音频数据不同，需要重新创建播放器
+
+		if (target->buffer.get() != p_buffer || !target->player)
+		{
+			target->owner = nullptr;
+			target->player.reset();
+			target->buffer = p_buffer;
+			if (!LAPP.GetAppModel()->getAudioDevice()->createAudioPlayer(p_buffer, ~target->player))
+			{
+				spdlog::error("[luastg] SoundVoicePool: 无法创建音频播放器");
+				target->buffer.reset();
+				return nullptr;
+			}
+		}
+
+		m_serial += 1;
+		target->owner = owner;
+		target->serial = m_serial;
+		target->volume = volume;
+		target->paused = false;
+		handle.index = static_cast<uint32_t>(target - m_voices.data());
+		handle.serial = m_serial;
+		return target->player.get();
+	}
+	Core::Audio::IAudioPlayer* SoundVoicePool::Get(IResourceSoundEffect const* owner, Handle const& handle) noexcept
+	{
+		if (handle.index < m_voices.size())
+		{
+			auto& v = m_voices[handle.index];
+			if (v.owner == owner && v.serial == handle.serial)
+			{
+				return v.player.get();
+			}
+		}
+		return nullptr;
+	}
+	void SoundVoicePool::SetPaused(IResourceSoundEffect const* owner, Handle const& handle, bool const paused) noexcept
+	{
+		if (Get(owner, handle))
+		{
+			m_voices[handle.index].paused = paused;
+		}
+	}
+	void SoundVoicePool::Release(IResourceSoundEffect const* owner, Handle const& handle) noexcept
+	{
+		if (auto* p = Get(owner, handle))
+		{
+			p->stop();
+			m_voices[handle.index].owner = nullptr;
+			m_voices[handle.index].paused = false;
+		}
+	}
+	void SoundVoicePool::Purge(IResourceSoundEffect const* owner, Core::Audio::IAudioBuffer* p_buffer) noexcept
+	{
+		for (auto& v : m_voices)
+		{
+			if (v.owner == owner)
+			{
+				v.owner = nullptr;
+				v.paused = false;
+			}
+			if (!v.owner && v.buffer.get() == p_buffer)
+			{
+				v.player.reset();
+				v.buffer.reset();
+			}
+		}
+	}
+	void SoundVoicePool::Clear() noexcept
+	{
+		m_voices.clear();
+	}
+
+	void SoundVoicePool::SetCapacity(uint32_t capacity) noexcept
+	{
+		m_capacity = capacity;
+		// 超出容量的发声单元直接丢弃，持有它们的音效会在下次刷新时发现句柄失效
+		if (m_voices.size() > m_capacity)
+		{
+			m_voices.resize(m_capacity);
+		}
+	}
+	uint32_t SoundVoicePool::GetActiveCount() const noexcept
+	{
+		uint32_t count = 0;
+		for (auto const& v : m_voices)
+		{
+			if (v.owner)
+			{
+				count += 1;
+			}
+		}
+		return count;
+	}
+}
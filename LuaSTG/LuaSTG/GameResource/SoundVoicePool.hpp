@@ -0,0 +1,58 @@
+#pragma once
+#include "Core/Audio/Device.hpp"
+
+namespace LuaSTGPlus
+{
+	struct IResourceSoundEffect;
+
+	// 全局共享的音效发声单元池，限制同时播放的音效实例总数，满了以后按策略抢占已有的发声单元
+	class SoundVoicePool
+	{
+	public:
+		enum class StealPolicy
+		{
+			Oldest,   // 抢占最早开始播放的
+			Quietest, // 抢占音量最小的
+		};
+		// 音效持有的发声单元句柄，发声单元被抢占或者归还后失效
+		struct Handle
+		{
+			uint32_t index = 0;
+			uint64_t serial = 0;
+		};
+	private:
+		struct Voice
+		{
+			Core::ScopeObject<Core::Audio::IAudioBuffer> buffer;
+			Core::ScopeObject<Core::Audio::IAudioPlayer> player;
+			IResourceSoundEffect const* owner = nullptr; // 为空表示空闲
+			uint64_t serial = 0; // 每次分配时递增，用于校验句柄以及找出最早开始播放的
+			float volume = 0.0f;
+			bool paused = false; // 被暂停的播放器同样不在播放，需要和已经播放结束的区分开
+		};
+		std::vector<Voice> m_voices;
+		uint32_t m_capacity = 64;
+		StealPolicy m_policy = StealPolicy::Oldest;
+		uint64_t m_serial = 0;
+		Voice* findVictim() noexcept;
+		Voice* findVictim(bool paused) noexcept;
+	public:
+		// 分配一个发声单元，失败时返回 nullptr；返回的播放器需要调用者重置后再开始播放
+		Core::Audio::IAudioPlayer* Acquire(IResourceSoundEffect const* owner, Core::Audio::IAudioBuffer* p_buffer, float volume, Handle& handle);
+		// 句柄仍然有效时返回对应的播放器，否则返回 nullptr
+		Core::Audio::IAudioPlayer* Get(IResourceSoundEffect const* owner, Handle const& handle) noexcept;
+		// 标记发声单元是否被暂停，暂停的发声单元不会被当作已经播放结束而抢占
+		void SetPaused(IResourceSoundEffect const* owner, Handle const& handle, bool paused) noexcept;
+		// 停止播放并归还发声单元，空闲的发声单元会保留播放器以便同一音效再次使用
+		void Release(IResourceSoundEffect const* owner, Handle const& handle) noexcept;
+		// 归还音效的全部发声单元，并丢弃引用该音效音频数据的播放器，音效销毁时调用
+		void Purge(IResourceSoundEffect const* owner, Core::Audio::IAudioBuffer* p_buffer) noexcept;
+		void Clear() noexcept;
+
+		uint32_t GetCapacity() const noexcept { return m_capacity; }
+		void SetCapacity(uint32_t capacity) noexcept;
+		StealPolicy GetStealPolicy() const noexcept { return m_policy; }
+		void SetStealPolicy(StealPolicy policy) noexcept { m_policy = policy; }
+		uint32_t GetActiveCount() const noexcept;
+	};
+}
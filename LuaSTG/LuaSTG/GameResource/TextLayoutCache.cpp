@@ -0,0 +1,111 @@
+#include "GameResource/TextLayoutCache.hpp"
+#include "xxhash.h"
+
+namespace LuaSTGPlus
+{
+	constexpr uint64_t const TEXT_LAYOUT_EVICT_FRAMES = 120;  // 连续这么多帧没有用到就清理
+	constexpr size_t const TEXT_LAYOUT_MAX_ENTRIES = 4096;    // 超过后不再加入新的排版结果，等待清理
+
+	uint64_t TextLayoutCache::hashKey(Key const& key, std::string_view text) noexcept
+	{
+		struct PackedKey
+		{
+			uint64_t glyph_manager;
+			uint64_t text_hash;
+			float scale[2];
+			float size[2];
+			uint32_t format;
+			uint32_t text_size;
+		};
+		PackedKey packed{};
+		packed.glyph_manager = (uint64_t)(uintptr_t)key.glyph_manager;
+		packed.text_hash = XXH3_64bits(text.data(), text.size());
+		packed.scale[0] = key.scale.x;
+		packed.scale[1] = key.scale.y;
+		packed.size[0] = key.size.x;
+		packed.size[1] = key.size.y;
+		packed.format = key.format;
+		packed.text_size = (uint32_t)text.size();
+		return XXH3_64bits(&packed, sizeof(packed));
+	}
+
+	TextLayoutCache::Layout const* TextLayoutCache::Find(Key const& key, std::string_view text)
+	{
+		if (!m_enable)
+		{
+			return nullptr;
+		}
+		auto it = m_entries.find(hashKey(key, text));
+		if (it != m_entries.end())
+		{
+			Entry& entry = it->second;
+			if (entry.key.glyph_manager == key.glyph_manager
+				&& entry.key.scale == key.scale
+				&& entry.key.size == key.size
+				&& entry.key.format == key.format
+				&& entry.text == text)
+			{
+				entry.last_used_frame = m_frame;
+				m_statistics.hit_count += 1;
+				return &entry.layout;
+			}
+		}
+		m_statistics.miss_count += 1;
+		return nullptr;
+	}
+	TextLayoutCache::Layout const* TextLayoutCache::Insert(Key const& key, std::string_view text, Layout&& layout)
+	{
+		if (!m_enable)
+		{
+			return nullptr;
+		}
+		if (!layout.is_complete)
+		{
+			m_statistics.incomplete_count += 1;
+			return nullptr;
+		}
+		if (m_entries.size() >= TEXT_LAYOUT_MAX_ENTRIES)
+		{
+			return nullptr;
+		}
+		Entry& entry = m_entries[hashKey(key, text)]; // 散列冲突时直接覆盖
+		entry.key = key;
+		entry.text.assign(text);
+		entry.glyph_manager = key.glyph_manager;
+		entry.layout = std::move(layout);
+		entry.last_used_frame = m_frame;
+		return &entry.layout;
+	}
+	void TextLayoutCache::Update()
+	{
+		m_frame += 1;
+		if ((m_frame % TEXT_LAYOUT_EVICT_FRAMES) != 0)
+		{
+			return;
+		}
+		for (auto it = m_entries.begin(); it != m_entries.end();)
+		{
+			if ((m_frame - it->second.last_used_frame) > TEXT_LAYOUT_EVICT_FRAMES)
+			{
+				it = m_entries.erase(it);
+				m_statistics.evict_count += 1;
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+	void TextLayoutCache::Clear()
+	{
+		m_entries.clear();
+	}
+	void TextLayoutCache::SetEnable(bool const enable)
+	{
+		m_enable = enable;
+		if (!m_enable)
+		{
+			m_entries.clear();
+		}
+	}
+}
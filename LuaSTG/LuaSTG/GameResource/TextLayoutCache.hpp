@@ -0,0 +1,73 @@
+#pragma once
+#include "Core/Graphics/Font.hpp"
+
+namespace LuaSTGPlus
+{
+	// 文字排版缓存，保存排版好的字形（位置相对于锚点，平移文字不会导致缓存失效）
+	// 以字形管理器、文本内容、缩放、对齐方式和排版区域大小为键，长时间没有用到的排版结果会被清理
+	// 字形纹理只增不减，已经写入纹理的字形的纹理坐标不会变化，所以只有仍在后台光栅化的字形会让排版结果不能缓存
+	class TextLayoutCache
+	{
+	public:
+		struct Key
+		{
+			Core::Graphics::IGlyphManager* glyph_manager = nullptr;
+			Core::Vector2F scale;
+			Core::Vector2F size; // 排版区域大小，不需要排版区域时为 0
+			uint32_t format = 0; // 对齐方式、换行方式以及调用来源
+		};
+		struct Glyph
+		{
+			Core::Graphics::GlyphInfo info; // 已经应用缩放
+			Core::Vector2F position;        // 笔触位置，相对于锚点
+		};
+		struct Layout
+		{
+			std::vector<Glyph> glyphs;      // 按纹理排序，减少纹理切换
+			Core::Vector2F advance;         // 最终笔触位置，相对于锚点
+			bool is_complete = true;        // 包含仍在后台光栅化的字形时为 false，不会被缓存
+		};
+		struct Statistics
+		{
+			uint64_t hit_count = 0;
+			uint64_t miss_count = 0;
+			uint64_t incomplete_count = 0; // 因为字形还没光栅化好而没有缓存的次数
+			uint64_t evict_count = 0;
+		};
+	private:
+		struct Entry
+		{
+			Key key;
+			std::string text;
+			Core::ScopeObject<Core::Graphics::IGlyphManager> glyph_manager; // 保持字形管理器存活，避免地址被重用
+			Layout layout;
+			uint64_t last_used_frame = 0;
+		};
+		std::unordered_map<uint64_t, Entry> m_entries;
+		Statistics m_statistics;
+		uint64_t m_frame = 0;
+		bool m_enable = true;
+
+		static uint64_t hashKey(Key const& key, std::string_view text) noexcept;
+	public:
+		// 查找排版结果，找不到时返回 nullptr
+		Layout const* Find(Key const& key, std::string_view text);
+		// 保存排版结果，不完整的排版结果会被忽略；返回可以直接使用的排版结果
+		Layout const* Insert(Key const& key, std::string_view text, Layout&& layout);
+		// 每帧调用一次，清理长时间没有用到的排版结果
+		void Update();
+		void Clear();
+		// 关闭后每次都重新排版，用于对比
+		void SetEnable(bool enable);
+		bool IsEnable() const noexcept { return m_enable; }
+
+		size_t GetEntryCount() const noexcept { return m_entries.size(); }
+		Statistics const& GetStatistics() const noexcept { return m_statistics; }
+		void ResetStatistics() noexcept { m_statistics = {}; }
+	public:
+		TextLayoutCache() = default;
+		TextLayoutCache(TextLayoutCache const&) = delete;
+		TextLayoutCache& operator=(TextLayoutCache const&) = delete;
+		~TextLayoutCache() = default;
+	};
+}
@@ -0,0 +1,373 @@
+#include "GameResource/TextureAtlas.hpp"
+#include "AppFrame.h"
+
+namespace LuaSTGPlus
+{
+	// 天际线算法：页面底部的轮廓由一串水平线段表示，每次选择放置后底边最低的位置
+
+	bool TextureAtlas::skylineFit(Page const& page, size_t const index, uint32_t const width, uint32_t const height, uint32_t& y)
+	{
+		uint32_t const x = page.skyline[index].x;
+		if (x + width > page.size.x)
+		{
+			return false;
+		}
+		uint32_t top = 0;
+		uint32_t remaining = width;
+		for (size_t i = index; remaining > 0; i += 1)
+		{
+			if (i >= page.skyline.size())
+			{
+				return false;
+			}
+			top = std::max(top, page.skyline[i].y);
+			if (top + height > page.size.y)
+			{
+				return false;
+			}
+			remaining = (page.skyline[i].width >= remaining) ? 0 : (remaining - page.skyline[i].width);
+		}
+		y = top;
+		return true;
+	}
+	bool TextureAtlas::skylineInsert(Page& page, uint32_t const width, uint32_t const height, Core::Vector2U& position)
+	{
+		size_t best_index = SIZE_MAX;
+		uint32_t best_bottom = UINT32_MAX;
+		uint32_t best_width = UINT32_MAX;
+		uint32_t best_y = 0;
+		for (size_t i = 0; i < page.skyline.size(); i += 1)
+		{
+			uint32_t y = 0;
+			if (skylineFit(page, i, width, height, y))
+			{
+				uint32_t const bottom = y + height;
+				if (bottom < best_bottom || (bottom == best_bottom && page.skyline[i].width < best_width))
+				{
+					best_index = i;
+					best_bottom = bottom;
+					best_width = page.skyline[i].width;
+					best_y = y;
+				}
+			}
+		}
+		if (best_index == SIZE_MAX)
+		{
+			return false;
+		}
+
+		position = Core::Vector2U(page.skyline[best_index].x, best_y);
+		page.skyline.insert(page.skyline.begin() + (ptrdiff_t)best_index, SkylineNode{ position.x, best_bottom, width });
+
+		// 被新线段遮住的部分需要裁掉
+		for (size_t i = best_index + 1; i < page.skyline.size();)
+		{
+			SkylineNode const& prev = page.skyline[i - 1];
+			SkylineNode& node = page.skyline[i];
+			uint32_t const prev_right = prev.x + prev.width;
+			if (node.x >= prev_right)
+			{
+				break;
+			}
+			uint32_t const shrink = prev_right - node.x;
+			if (node.width <= shrink)
+			{
+				page.skyline.erase(page.skyline.begin() + (ptrdiff_t)i);
+				continue;
+			}
+			node.x += shrink;
+			node.width -= shrink;
+			break;
+		}
+		// 合并等高的相邻线段
+		for (size_t i = 0; i + 1 < page.skyline.size();)
+		{
+			if (page.skyline[i].y == page.skyline[i + 1].y)
+			{
+				page.skyline[i].width += page.skyline[i + 1].width;
+				page.skyline.erase(page.skyline.begin() + (ptrdiff_t)(i + 1));
+			}
+			else
+			{
+				i += 1;
+			}
+		}
+		return true;
+	}
+	bool TextureAtlas::createPage(Core::Vector2U const size)
+	{
+		auto* p_device = LAPP.GetAppModel()->getDevice();
+		Core::ScopeObject<Core::Graphics::IRenderTarget> p_target;
+		if (!p_device->createRenderTarget(size, ~p_target))
+		{
+			spdlog::error("[luastg] TextureAtlas: 创建图集页面 ({}x{}) 失败", size.x, size.y);
+			return false;
+		}
+		// 复制时统一转换为预乘 alpha
+		p_target->getTexture()->setPremultipliedAlpha(true);
+
+		Page page;
+		page.target = p_target;
+		page.size = size;
+		page.skyline.push_back(SkylineNode{ 0, 0, size.x });
+		m_pages.emplace_back(std::move(page));
+
+		if (!m_device)
+		{
+			p_device->addEventListener(this);
+			m_device = p_device;
+		}
+		return true;
+	}
+
+	uint32_t TextureAtlas::Add(std::vector<Core::Graphics::ITexture2D*> const& textures, uint32_t const page_size, uint32_t const padding)
+	{
+		// 先放高的，天际线更平整
+		std::vector<Core::Graphics::ITexture2D*> pending;
+		pending.reserve(textures.size());
+		for (auto* p_texture : textures)
+		{
+			if (!p_texture || m_lookup.contains(p_texture) || std::find(pending.begin(), pending.end(), p_texture) != pending.end())
+			{
+				continue;
+			}
+			pending.push_back(p_texture);
+		}
+		std::stable_sort(pending.begin(), pending.end(), [](Core::Graphics::ITexture2D* a, Core::Graphics::ITexture2D* b) -> bool
+		{
+			auto const sa = a->getSize();
+			auto const sb = b->getSize();
+			return sa.y != sb.y ? sa.y > sb.y : sa.x > sb.x;
+		});
+
+		uint32_t added = 0;
+		for (auto* p_texture : pending)
+		{
+			Core::Vector2U const size = p_texture->getSize();
+			uint32_t const width = size.x + padding * 2;
+			uint32_t const height = size.y + padding * 2;
+			if (width > page_size || height > page_size)
+			{
+				spdlog::warn("[luastg] TextureAtlas: 纹理 ({}x{}) 超出图集页面大小 ({}x{})，已跳过", size.x, size.y, page_size, page_size);
+				continue;
+			}
+
+			Core::Vector2U position;
+			size_t page_index = SIZE_MAX;
+			for (size_t i = 0; i < m_pages.size(); i += 1)
+			{
+				if (skylineInsert(m_pages[i], width, height, position))
+				{
+					page_index = i;
+					break;
+				}
+			}
+			if (page_index == SIZE_MAX)
+			{
+				if (!createPage(Core::Vector2U(page_size, page_size)))
+				{
+					break;
+				}
+				page_index = m_pages.size() - 1;
+				if (!skylineInsert(m_pages[page_index], width, height, position))
+				{
+					assert(false); continue;
+				}
+			}
+
+			Page& page = m_pages[page_index];
+			Region region;
+			region.source = p_texture;
+			region.page = page_index;
+			region.position = Core::Vector2U(position.x + padding, position.y + padding);
+			page.regions.push_back(m_regions.size());
+			page.used_area += (uint64_t)size.x * (uint64_t)size.y;
+			page.dirty = true;
+			m_lookup.emplace(p_texture, m_regions.size());
+			m_regions.emplace_back(std::move(region));
+			added += 1;
+		}
+		return added;
+	}
+	bool TextureAtlas::Find(Core::Graphics::ITexture2D* texture, Core::Graphics::ITexture2D** pp_page, Core::Vector2U* p_offset) const
+	{
+		auto const it = m_lookup.find(texture);
+		if (it == m_lookup.end())
+		{
+			return false;
+		}
+		Region const& region = m_regions[it->second];
+		*pp_page = m_pages[region.page].target->getTexture();
+		*p_offset = region.position;
+		return true;
+	}
+	void TextureAtlas::moveSprite(Core::Graphics::ISprite* sprite, Core::Graphics::ITexture2D* texture, Core::Vector2F const delta)
+	{
+		Core::RectF const rect = sprite->getTextureRect();
+		Core::Vector2F const center = sprite->getTextureCenter();
+		sprite->setTexture(texture);
+		sprite->setTextureRect(rect + delta);
+		sprite->setTextureCenter(center + delta);
+	}
+	bool TextureAtlas::Apply(Core::Graphics::ISprite* sprite)
+	{
+		if (m_sprites.contains(sprite))
+		{
+			return true;
+		}
+		Core::Graphics::ITexture2D* p_texture = sprite->getTexture();
+		auto const it = m_lookup.find(p_texture);
+		if (it == m_lookup.end())
+		{
+			return false;
+		}
+		// 超出纹理范围的纹理坐标依赖采样器的寻址模式，放进图集以后会采样到相邻的纹理
+		Core::Vector2U const size = p_texture->getSize();
+		Core::RectF const rect = sprite->getTextureRect();
+		if (std::min(rect.a.x, rect.b.x) < 0.0f || std::min(rect.a.y, rect.b.y) < 0.0f
+			|| std::max(rect.a.x, rect.b.x) > (float)size.x || std::max(rect.a.y, rect.b.y) > (float)size.y)
+		{
+			return false;
+		}
+		Region const& region = m_regions[it->second];
+		m_sprites.emplace(sprite, std::make_pair(Core::ScopeObject<Core::Graphics::ISprite>(sprite), it->second));
+		if (m_enable)
+		{
+			moveSprite(sprite, m_pages[region.page].target->getTexture(), Core::Vector2F((float)region.position.x, (float)region.position.y));
+		}
+		return true;
+	}
+	void TextureAtlas::Remove(Core::Graphics::ISprite* sprite)
+	{
+		auto const it = m_sprites.find(sprite);
+		if (it == m_sprites.end())
+		{
+			return;
+		}
+		if (m_enable)
+		{
+			Region const& region = m_regions[it->second.second];
+			moveSprite(sprite, region.source.get(), Core::Vector2F(-(float)region.position.x, -(float)region.position.y));
+		}
+		m_sprites.erase(it);
+	}
+	bool TextureAtlas::FindSprite(Core::Graphics::ISprite* sprite, Core::Vector2F* p_offset) const
+	{
+		auto const it = m_sprites.find(sprite);
+		if (it == m_sprites.end())
+		{
+			return false;
+		}
+		if (m_enable)
+		{
+			Region const& region = m_regions[it->second.second];
+			*p_offset = Core::Vector2F((float)region.position.x, (float)region.position.y);
+		}
+		else
+		{
+			*p_offset = Core::Vector2F(0.0f, 0.0f);
+		}
+		return true;
+	}
+	void TextureAtlas::SetEnable(bool const enable)
+	{
+		if (m_enable == enable)
+		{
+			return;
+		}
+		m_enable = enable;
+		for (auto& [p_sprite, v] : m_sprites)
+		{
+			Region const& region = m_regions[v.second];
+			Core::Vector2F const delta((float)region.position.x, (float)region.position.y);
+			if (enable)
+			{
+				moveSprite(p_sprite, m_pages[region.page].target->getTexture(), delta);
+			}
+			else
+			{
+				moveSprite(p_sprite, region.source.get(), Core::Vector2F(-delta.x, -delta.y));
+			}
+		}
+	}
+	bool TextureAtlas::Update(Core::Graphics::IRenderer* p_renderer)
+	{
+		bool result = true;
+		std::vector<Core::Graphics::IRenderer::TextureCopyRegion> copy_regions;
+		for (auto& page : m_pages)
+		{
+			if (!page.dirty)
+			{
+				continue;
+			}
+			copy_regions.clear();
+			copy_regions.reserve(page.regions.size());
+			for (size_t const index : page.regions)
+			{
+				Region const& region = m_regions[index];
+				Core::Vector2U const size = region.source->getSize();
+				copy_regions.push_back(Core::Graphics::IRenderer::TextureCopyRegion{
+					.source = region.source.get(),
+					.source_rect = Core::RectU(0, 0, size.x, size.y),
+					.target_position = region.position,
+				});
+			}
+			if (p_renderer->copyTextureRegions(page.target.get(), copy_regions.data(), copy_regions.size()))
+			{
+				page.dirty = false;
+			}
+			else
+			{
+				spdlog::error("[luastg] TextureAtlas: 复制图集页面内容失败");
+				result = false;
+			}
+		}
+		return result;
+	}
+	void TextureAtlas::Clear()
+	{
+		if (m_device)
+		{
+			m_device->removeEventListener(this);
+			m_device.reset();
+		}
+		// 资源池外可能还有图片精灵的引用，让它们恢复引用原来的纹理
+		SetEnable(false);
+		m_sprites.clear();
+		m_lookup.clear();
+		m_regions.clear();
+		m_pages.clear();
+		m_enable = true;
+	}
+
+	TextureAtlas::PageInfo TextureAtlas::GetPageInfo(size_t const index) const
+	{
+		Page const& page = m_pages.at(index);
+		return PageInfo{
+			.size = page.size,
+			.texture_count = (uint32_t)page.regions.size(),
+			.used_area = page.used_area,
+		};
+	}
+	Core::Graphics::ITexture2D* TextureAtlas::GetPageTexture(size_t const index) const
+	{
+		return m_pages.at(index).target->getTexture();
+	}
+
+	void TextureAtlas::onDeviceCreate()
+	{
+		// 渲染目标重建以后内容是空的，等下一次渲染开始时重新复制
+		for (auto& page : m_pages)
+		{
+			page.dirty = true;
+		}
+	}
+	void TextureAtlas::onDeviceDestroy()
+	{
+	}
+
+	TextureAtlas::~TextureAtlas()
+	{
+		Clear();
+	}
+}
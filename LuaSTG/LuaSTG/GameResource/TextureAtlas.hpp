@@ -0,0 +1,85 @@
+#pragma once
+#include "Core/Graphics/Device.hpp"
+#include "Core/Graphics/Renderer.hpp"
+#include "Core/Graphics/Sprite.hpp"
+
+namespace LuaSTGPlus
+{
+	// 运行时纹理图集，把许多小纹理复制到少数几个大的渲染目标页面中，图片精灵改为引用页面上对应的区域，
+	// 同一页面上的图片精灵可以合并到同一个绘制命令里
+	// 页面内容不会立即复制，而是在下一次渲染开始时（以及设备重建以后）由 Update 完成
+	class TextureAtlas : public Core::Graphics::IDeviceEventListener
+	{
+	public:
+		struct PageInfo
+		{
+			Core::Vector2U size;
+			uint32_t texture_count = 0;
+			uint64_t used_area = 0; // 纹理本身占用的面积，不含留白
+		};
+	private:
+		struct SkylineNode
+		{
+			uint32_t x = 0;
+			uint32_t y = 0;
+			uint32_t width = 0;
+		};
+		struct Region
+		{
+			Core::ScopeObject<Core::Graphics::ITexture2D> source;
+			size_t page = 0;
+			Core::Vector2U position; // 纹理左上角在页面上的位置
+		};
+		struct Page
+		{
+			Core::ScopeObject<Core::Graphics::IRenderTarget> target;
+			Core::Vector2U size;
+			std::vector<SkylineNode> skyline;
+			std::vector<size_t> regions;
+			uint64_t used_area = 0;
+			bool dirty = true;
+		};
+		std::vector<Page> m_pages;
+		std::vector<Region> m_regions;
+		std::unordered_map<Core::Graphics::ITexture2D*, size_t> m_lookup;
+		std::unordered_map<Core::Graphics::ISprite*, std::pair<Core::ScopeObject<Core::Graphics::ISprite>, size_t>> m_sprites; // 引用了图集的图片精灵及其区域
+		bool m_enable = true;
+		Core::ScopeObject<Core::Graphics::IDevice> m_device; // 注册了设备事件监听时不为空
+
+		static bool skylineFit(Page const& page, size_t index, uint32_t width, uint32_t height, uint32_t& y);
+		static bool skylineInsert(Page& page, uint32_t width, uint32_t height, Core::Vector2U& position);
+		bool createPage(Core::Vector2U size);
+		static void moveSprite(Core::Graphics::ISprite* sprite, Core::Graphics::ITexture2D* texture, Core::Vector2F delta);
+	public:
+		// 把纹理加入图集，已经在图集中的纹理会被忽略，放不进页面的纹理会被跳过；返回新加入的纹理数量
+		uint32_t Add(std::vector<Core::Graphics::ITexture2D*> const& textures, uint32_t page_size, uint32_t padding);
+		// 查找纹理所在的页面和偏移
+		bool Find(Core::Graphics::ITexture2D* texture, Core::Graphics::ITexture2D** pp_page, Core::Vector2U* p_offset) const;
+		// 让图片精灵改为引用图集页面，纹理不在图集中、纹理坐标超出纹理范围时保持不变
+		bool Apply(Core::Graphics::ISprite* sprite);
+		// 图片精灵恢复引用原来的纹理，并且不再受图集管理
+		void Remove(Core::Graphics::ISprite* sprite);
+		// 查找受图集管理的图片精灵当前在页面上的偏移，图集关闭时偏移为 0
+		bool FindSprite(Core::Graphics::ISprite* sprite, Core::Vector2F* p_offset) const;
+		// 关闭后图片精灵恢复引用原来的纹理，用于对比绘制命令数量
+		void SetEnable(bool enable);
+		bool IsEnable() const noexcept { return m_enable; }
+		// 复制内容过期的页面
+		bool Update(Core::Graphics::IRenderer* p_renderer);
+		void Clear();
+
+		bool IsEmpty() const noexcept { return m_regions.empty(); }
+		size_t GetSpriteCount() const noexcept { return m_sprites.size(); }
+		size_t GetPageCount() const noexcept { return m_pages.size(); }
+		PageInfo GetPageInfo(size_t index) const;
+		Core::Graphics::ITexture2D* GetPageTexture(size_t index) const;
+
+		void onDeviceCreate();
+		void onDeviceDestroy();
+	public:
+		TextureAtlas() = default;
+		TextureAtlas(TextureAtlas const&) = delete;
+		TextureAtlas& operator=(TextureAtlas const&) = delete;
+		~TextureAtlas();
+	};
+}
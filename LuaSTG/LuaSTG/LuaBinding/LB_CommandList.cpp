@@ -0,0 +1,286 @@
+#include "LuaBinding/LuaWrapper.hpp"
+#include "lua/plus.hpp"
+
+namespace LuaSTGPlus::LuaWrapper
+{
+	std::string_view const CommandListBinding::ClassID = "lstg.CommandList";
+
+	static lua::cached_metatable_t g_CommandListMetatable("lstg.CommandList");
+
+	RenderCommandList* CommandListBinding::Cast(lua_State* L, int idx)
+	{
+		return g_CommandListMetatable.check<RenderCommandList>(L, idx);
+	}
+
+	RenderCommandList* CommandListBinding::Create(lua_State* L)
+	{
+		RenderCommandList* p = static_cast<RenderCommandList*>(lua_newuserdata(L, sizeof(RenderCommandList))); // udata
+		new(p) RenderCommandList();
+		g_CommandListMetatable.push(L); // udata mt
+		lua_setmetatable(L, -2); // udata
+		return p;
+	}
+
+	void CommandListBinding::Register(lua_State* L)
+	{
+		using DrawVertex = RenderCommandList::DrawVertex;
+
+		struct Binding
+		{
+			static Core::Graphics::ITexture2D* find_texture(lua_State* L, int idx, char const* method)
+			{
+				char const* name = luaL_checkstring(L, idx);
+				Core::ScopeObject<IResourceTexture> ptex2dres = LRES.FindTexture(name);
+				if (!ptex2dres)
+				{
+					spdlog::error("[luastg] lstg.CommandList.{} failed: can't find texture '{}'", method, name);
+					luaL_error(L, "can't find texture '%s'", name);
+					return nullptr;
+				}
+				return ptex2dres->GetTexture(); // 纹理由资源池持有，录制时会再增加引用计数
+			}
+			static IResourceSprite* find_sprite(lua_State* L, int idx, char const* method)
+			{
+				char const* name = luaL_checkstring(L, idx);
+				Core::ScopeObject<IResourceSprite> pimg2dres = LRES.FindSprite(name);
+				if (!pimg2dres)
+				{
+					spdlog::error("[luastg] lstg.CommandList.{} failed: can't find sprite '{}'", method, name);
+					luaL_error(L, "can't find sprite '%s'", name);
+					return nullptr;
+				}
+				return *pimg2dres;
+			}
+			static void read_vertex(lua_State* L, int idx, DrawVertex& vertex)
+			{
+				luaL_checktype(L, idx, LUA_TTABLE);
+				lua_rawgeti(L, idx, 1);
+				lua_rawgeti(L, idx, 2);
+				lua_rawgeti(L, idx, 3);
+				lua_rawgeti(L, idx, 4);
+				lua_rawgeti(L, idx, 5);
+				lua_rawgeti(L, idx, 6);
+				vertex.x = (float)lua_tonumber(L, -6);
+				vertex.y = (float)lua_tonumber(L, -5);
+				vertex.z = (float)lua_tonumber(L, -4);
+				vertex.u = (float)lua_tonumber(L, -3);
+				vertex.v = (float)lua_tonumber(L, -2);
+				if (lua_type(L, -1) == LUA_TNUMBER)
+				{
+					vertex.color = (uint32_t)lua_tonumber(L, -1);
+				}
+				else
+				{
+					vertex.color = ColorWrapper::Cast(L, -1)->color();
+				}
+				lua_pop(L, 6);
+			}
+			static void add_quad(lua_State* L, RenderCommandList* self, Core::Graphics::ITexture2D* p_texture, BlendMode blend, DrawVertex const* vertex)
+			{
+				if (!self->AddQuad(p_texture, blend, vertex))
+				{
+					luaL_error(L, "record draw command failed");
+				}
+			}
+
+			static int clear(lua_State* L) noexcept
+			{
+				RenderCommandList* self = Cast(L, 1);
+				self->Clear();
+				return 0;
+			}
+			static int getVertexCount(lua_State* L) noexcept
+			{
+				lua::stack_t S(L);
+				RenderCommandList* self = Cast(L, 1);
+				S.push_value(self->GetVertexCount());
+				return 1;
+			}
+			static int getIndexCount(lua_State* L) noexcept
+			{
+				lua::stack_t S(L);
+				RenderCommandList* self = Cast(L, 1);
+				S.push_value(self->GetIndexCount());
+				return 1;
+			}
+			static int getBatchCount(lua_State* L) noexcept
+			{
+				lua::stack_t S(L);
+				RenderCommandList* self = Cast(L, 1);
+				S.push_value(self->GetBatchCount());
+				return 1;
+			}
+
+			// 与 lstg.Renderer.drawTexture 相同，纹理坐标以像素为单位
+			static int drawTexture(lua_State* L) noexcept
+			{
+				RenderCommandList* self = Cast(L, 1);
+				Core::Graphics::ITexture2D* p_texture = find_texture(L, 2, "drawTexture");
+				BlendMode const blend = TranslateBlendMode(L, 3);
+				DrawVertex vertex[4];
+				for (int i = 0; i < 4; i += 1)
+				{
+					read_vertex(L, 4 + i, vertex[i]);
+				}
+				float const uscale = 1.0f / (float)p_texture->getSize().x;
+				float const vscale = 1.0f / (float)p_texture->getSize().y;
+				for (auto& v : vertex)
+				{
+					v.u *= uscale;
+					v.v *= vscale;
+				}
+				add_quad(L, self, p_texture, blend, vertex);
+				return 0;
+			}
+			// 与 lstg.Renderer.drawMesh 相同，纹理坐标已经归一化
+			static int drawMesh(lua_State* L) noexcept
+			{
+				RenderCommandList* self = Cast(L, 1);
+				Core::Graphics::ITexture2D* p_texture = find_texture(L, 2, "drawMesh");
+				BlendMode const blend = TranslateBlendMode(L, 3);
+				Mesh* mesh = MeshBinding::Cast(L, 4);
+				if (!self->AddMesh(p_texture, blend,
+					mesh->getVertexPointer(), mesh->getVertexCount(),
+					mesh->getIndexPointer(), mesh->getIndexCount()))
+				{
+					return luaL_error(L, "record draw command failed");
+				}
+				return 0;
+			}
+			static int drawSprite(lua_State* L) noexcept
+			{
+				RenderCommandList* self = Cast(L, 1);
+				IResourceSprite* pimg2dres = find_sprite(L, 2, "drawSprite");
+				float const x = (float)luaL_checknumber(L, 3);
+				float const y = (float)luaL_checknumber(L, 4);
+				float const rot = (float)(luaL_optnumber(L, 5, 0.0) * L_DEG_TO_RAD);
+				float const hscale = (float)luaL_optnumber(L, 6, 1.0);
+				float const vscale = (float)luaL_optnumber(L, 7, hscale);
+				float const z = (float)luaL_optnumber(L, 8, 0.5);
+				float const factor = LRES.GetGlobalImageScaleFactor();
+				Core::Graphics::ISprite* p_sprite = pimg2dres->GetSprite();
+				DrawVertex vertex[4];
+				p_sprite->getQuad(vertex, Core::Vector2F(x, y), Core::Vector2F(hscale * factor, vscale * factor), rot, z);
+				add_quad(L, self, p_sprite->getTexture(), pimg2dres->GetBlendMode(), vertex);
+				return 0;
+			}
+			static int drawSpriteRect(lua_State* L) noexcept
+			{
+				RenderCommandList* self = Cast(L, 1);
+				IResourceSprite* pimg2dres = find_sprite(L, 2, "drawSpriteRect");
+				float const l = (float)luaL_checknumber(L, 3);
+				float const r = (float)luaL_checknumber(L, 4);
+				float const b = (float)luaL_checknumber(L, 5);
+				float const t = (float)luaL_checknumber(L, 6);
+				float const z = (float)luaL_optnumber(L, 7, 0.5);
+				Core::Graphics::ISprite* p_sprite = pimg2dres->GetSprite();
+				DrawVertex vertex[4];
+				p_sprite->getQuad(vertex, Core::Vector2F(), Core::Vector2F(1.0f, 1.0f), 0.0f, z); // 只需要纹理坐标和颜色
+				vertex[0].x = l; vertex[0].y = t;
+				vertex[1].x = r; vertex[1].y = t;
+				vertex[2].x = r; vertex[2].y = b;
+				vertex[3].x = l; vertex[3].y = b;
+				add_quad(L, self, p_sprite->getTexture(), pimg2dres->GetBlendMode(), vertex);
+				return 0;
+			}
+			static int drawSprite4V(lua_State* L) noexcept
+			{
+				RenderCommandList* self = Cast(L, 1);
+				IResourceSprite* pimg2dres = find_sprite(L, 2, "drawSprite4V");
+				Core::Graphics::ISprite* p_sprite = pimg2dres->GetSprite();
+				DrawVertex vertex[4];
+				p_sprite->getQuad(vertex, Core::Vector2F(), Core::Vector2F(1.0f, 1.0f), 0.0f, 0.5f); // 只需要纹理坐标和颜色
+				for (int i = 0; i < 4; i += 1)
+				{
+					vertex[i].x = (float)luaL_checknumber(L, 3 + i * 3);
+					vertex[i].y = (float)luaL_checknumber(L, 4 + i * 3);
+					vertex[i].z = (float)luaL_checknumber(L, 5 + i * 3);
+				}
+				add_quad(L, self, p_sprite->getTexture(), pimg2dres->GetBlendMode(), vertex);
+				return 0;
+			}
+			static int drawSpriteSequence(lua_State* L) noexcept
+			{
+				RenderCommandList* self = Cast(L, 1);
+				char const* name = luaL_checkstring(L, 2);
+				Core::ScopeObject<IResourceAnimation> pani2dres = LRES.FindAnimation(name);
+				if (!pani2dres)
+				{
+					spdlog::error("[luastg] lstg.CommandList.drawSpriteSequence failed: can't find animation '{}'", name);
+					return luaL_error(L, "can't find animation '%s'", name);
+				}
+				int const timer = (int)luaL_checkinteger(L, 3);
+				float const x = (float)luaL_checknumber(L, 4);
+				float const y = (float)luaL_checknumber(L, 5);
+				float const rot = (float)(luaL_optnumber(L, 6, 0.0) * L_DEG_TO_RAD);
+				float const hscale = (float)luaL_optnumber(L, 7, 1.0);
+				float const vscale = (float)luaL_optnumber(L, 8, hscale);
+				float const z = (float)luaL_optnumber(L, 9, 0.5);
+				float const factor = LRES.GetGlobalImageScaleFactor();
+				Core::Color4B color[4] = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF };
+				pani2dres->GetVertexColor(color);
+				Core::Graphics::ISprite* p_sprite = pani2dres->GetSpriteByTimer(timer)->GetSprite();
+				DrawVertex vertex[4];
+				p_sprite->getQuad(vertex, Core::Vector2F(x, y), Core::Vector2F(hscale * factor, vscale * factor), rot, z, color);
+				add_quad(L, self, p_sprite->getTexture(), pani2dres->GetBlendMode(), vertex);
+				return 0;
+			}
+
+			static int __gc(lua_State* L) noexcept
+			{
+				RenderCommandList* self = Cast(L, 1);
+				self->~RenderCommandList();
+				return 0;
+			}
+			static int __tostring(lua_State* L) noexcept
+			{
+				lua::stack_t S(L);
+				std::ignore = Cast(L, 1);
+				S.push_value(ClassID);
+				return 1;
+			}
+
+			static int create(lua_State* L) noexcept
+			{
+				std::ignore = Create(L);
+				return 1;
+			}
+		};
+
+		luaL_Reg const lib[] = {
+			{ "clear", &Binding::clear },
+			{ "getVertexCount", &Binding::getVertexCount },
+			{ "getIndexCount", &Binding::getIndexCount },
+			{ "getBatchCount", &Binding::getBatchCount },
+			{ "drawTexture", &Binding::drawTexture },
+			{ "drawMesh", &Binding::drawMesh },
+			{ "drawSprite", &Binding::drawSprite },
+			{ "drawSpriteRect", &Binding::drawSpriteRect },
+			{ "drawSprite4V", &Binding::drawSprite4V },
+			{ "drawSpriteSequence", &Binding::drawSpriteSequence },
+			{ NULL, NULL },
+		};
+
+		luaL_Reg const mt[] = {
+			{ "__gc", &Binding::__gc },
+			{ "__tostring", &Binding::__tostring },
+			{ NULL, NULL },
+		};
+
+		luaL_Reg const api[] = {
+			{ "CommandList", &Binding::create },
+			{ NULL, NULL },
+		};
+
+		g_CommandListMetatable.create(L);     // ... mt
+		luaL_register(L, NULL, mt);           // ... mt
+		lua_pushstring(L, "__index");         // ... mt '__index'
+		lua_newtable(L);                      // ... mt '__index' lib
+		luaL_register(L, NULL, lib);          // ... mt '__index' lib
+		lua_rawset(L, -3);                    // ... mt
+		lua_pop(L, 1);                        // ...
+
+		luaL_register(L, LUASTG_LUA_LIBNAME, api); // ... lstg
+		lua_pop(L, 1);                             // ...
+	}
+}
@@ -5,16 +5,18 @@ namespace LuaSTGPlus::LuaWrapper
 {
 	std::string_view const MeshBinding::ClassID = "lstg.Mesh";
 
+	static lua::cached_metatable_t g_MeshMetatable("lstg.Mesh");
+
 	Mesh* MeshBinding::Cast(lua_State* L, int idx)
 	{
-		return static_cast<Mesh*>(luaL_checkudata(L, idx, ClassID.data()));
+		return g_MeshMetatable.check<Mesh>(L, idx);
 	}
 
 	Mesh* MeshBinding::Create(lua_State* L)
 	{
 		Mesh* p = static_cast<Mesh*>(lua_newuserdata(L, sizeof(Mesh))); // udata
 		new(p) Mesh();
-		luaL_getmetatable(L, ClassID.data()); // udata mt
+		g_MeshMetatable.push(L); // udata mt
 		lua_setmetatable(L, -2); // udata
 		return p;
 	}
@@ -174,7 +176,7 @@ namespace LuaSTGPlus::LuaWrapper
 			{ NULL, NULL },
 		};
 
-		luaL_newmetatable(L, ClassID.data()); // ... mt
+		g_MeshMetatable.create(L);            // ... mt
 		luaL_register(L, NULL, mt);           // ... mt
 		lua_pushstring(L, "__index");         // ... mt '__index'
 		lua_newtable(L);                      // ... mt '__index' lib
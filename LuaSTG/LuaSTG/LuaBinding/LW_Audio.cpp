@@ -58,7 +58,7 @@ void LuaSTGPlus::LuaWrapper::AudioWrapper::Register(lua_State* L)noexcept
 			Core::ScopeObject<IResourceSoundEffect> p = LRES.FindSound(s);
 			if (!p)
 				return luaL_error(L, "sound '%s' not found.", s);
-			p->Play((float)luaL_optnumber(L, 2, 1.), (float)luaL_optnumber(L, 3, 0.0));
+			p->Play((float)luaL_optnumber(L, 2, 1.), (float)luaL_optnumber(L, 3, 0.0), (float)luaL_optnumber(L, 4, p->GetSpeed()));
 			return 0;
 		}
 		static int StopSound(lua_State* L)noexcept
@@ -131,6 +131,51 @@ void LuaSTGPlus::LuaWrapper::AudioWrapper::Register(lua_State* L)noexcept
 			lua_pushnumber(L, p->GetSpeed());
 			return 1;
 		}
+		static int SetSEMixing(lua_State* L)noexcept
+		{
+			LRES.SetSoundEffectMixing(lua_toboolean(L, 1));
+			return 0;
+		}
+		static int GetSEMixing(lua_State* L)noexcept
+		{
+			lua_pushboolean(L, LRES.IsSoundEffectMixing());
+			return 1;
+		}
+		static int SetSEMaxVoices(lua_State* L)noexcept
+		{
+			const char* s = luaL_checkstring(L, 1);
+			Core::ScopeObject<IResourceSoundEffect> p = LRES.FindSound(s);
+			if (!p)
+				return luaL_error(L, "sound '%s' not found.", s);
+			p->SetMaxVoices((uint32_t)std::max<lua_Integer>(1, luaL_checkinteger(L, 2)));
+			return 0;
+		}
+		static int GetSEMaxVoices(lua_State* L)noexcept
+		{
+			const char* s = luaL_checkstring(L, 1);
+			Core::ScopeObject<IResourceSoundEffect> p = LRES.FindSound(s);
+			if (!p)
+				return luaL_error(L, "sound '%s' not found.", s);
+			lua_pushinteger(L, (lua_Integer)p->GetMaxVoices());
+			return 1;
+		}
+		static int SetSEVoicePool(lua_State* L)noexcept
+		{
+			static char const* const policy_list[] = { "oldest", "quietest", NULL };
+			auto& pool = LRES.GetSoundVoicePool();
+			pool.SetCapacity((uint32_t)std::max<lua_Integer>(0, luaL_checkinteger(L, 1)));
+			if (!lua_isnoneornil(L, 2))
+				pool.SetStealPolicy((SoundVoicePool::StealPolicy)luaL_checkoption(L, 2, NULL, policy_list));
+			return 0;
+		}
+		static int GetSEVoicePool(lua_State* L)noexcept
+		{
+			auto& pool = LRES.GetSoundVoicePool();
+			lua_pushinteger(L, (lua_Integer)pool.GetCapacity());
+			lua_pushstring(L, pool.GetStealPolicy() == SoundVoicePool::StealPolicy::Quietest ? "quietest" : "oldest");
+			lua_pushinteger(L, (lua_Integer)pool.GetActiveCount());
+			return 3;
+		}
 		static int UpdateSound(lua_State*)noexcept
 		{
 			// 否决的方法
@@ -390,6 +435,12 @@ void LuaSTGPlus::LuaWrapper::AudioWrapper::Register(lua_State* L)noexcept
 		{ "GetSoundState", &Wrapper::GetSoundState },
 		{ "SetSEVolume", &Wrapper::SetSEVolume },
 		{ "GetSEVolume", &Wrapper::GetSEVolume },
+		{ "SetSEMixing", &Wrapper::SetSEMixing },
+		{ "GetSEMixing", &Wrapper::GetSEMixing },
+		{ "SetSEMaxVoices", &Wrapper::SetSEMaxVoices },
+		{ "GetSEMaxVoices", &Wrapper::GetSEMaxVoices },
+		{ "SetSEVoicePool", &Wrapper::SetSEVoicePool },
+		{ "GetSEVoicePool", &Wrapper::GetSEVoicePool },
 		{ "SetSESpeed", &Wrapper::SetSESpeed },
 		{ "GetSESpeed", &Wrapper::GetSESpeed },
 		{ "UpdateSound", &Wrapper::UpdateSound },
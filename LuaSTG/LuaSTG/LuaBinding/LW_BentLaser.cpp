@@ -1,4 +1,5 @@
 #include "LuaBinding/LuaWrapper.hpp"
+#include "lua/plus.hpp"
 #include "GameObject/GameObjectBentLaser.hpp"
 #include "AppFrame.h"
 
@@ -9,11 +10,13 @@ namespace LuaSTGPlus::LuaWrapper
 		GameObjectBentLaser* handle;
 	};
 
+	static lua::cached_metatable_t g_BentLaserMetatable(LUASTG_LUA_TYPENAME_BENTLASER);
+
 	void BentLaserWrapper::Register(lua_State* L)noexcept
 	{
 		struct Function
 		{
-		#define GETUDATA(p, i) Wrapper* (p) = static_cast<Wrapper*>(luaL_checkudata(L, (i), LUASTG_LUA_TYPENAME_BENTLASER));
+		#define GETUDATA(p, i) Wrapper* (p) = g_BentLaserMetatable.check<Wrapper>(L, (i));
 		#define CHECKUDATA(p) if (!(p)->handle) return luaL_error(L, "%s was released.", LUASTG_LUA_TYPENAME_BENTLASER);
 
 			static int Update(lua_State* L)noexcept
@@ -290,6 +293,7 @@ namespace LuaSTGPlus::LuaWrapper
 		};
 		
 		RegisterClassIntoTable(L, ".CurveLaser", tMethods, LUASTG_LUA_TYPENAME_BENTLASER, tMetaTable);
+		g_BentLaserMetatable.bind(L);
 	}
 
 	void BentLaserWrapper::CreateAndPush(lua_State* L)
@@ -301,7 +305,7 @@ namespace LuaSTGPlus::LuaWrapper
 		catch (const std::bad_alloc&) {
 			p->handle = nullptr;
 		}
-		luaL_getmetatable(L, LUASTG_LUA_TYPENAME_BENTLASER); // udata mt
+		g_BentLaserMetatable.push(L); // udata mt
 		lua_setmetatable(L, -2); // udata
 	}
 }
@@ -1,5 +1,6 @@
 ﻿#include "LuaBinding/LuaWrapper.hpp"
 #include "LuaBinding/generated/ColorMember.hpp"
+#include "lua/plus.hpp"
 #include <DirectXMath.h>
 
 namespace LuaSTGPlus::LuaWrapper
@@ -33,9 +34,11 @@ namespace LuaSTGPlus::LuaWrapper
 
 	std::string_view const ColorWrapper::ClassID = "lstg.Color";
 
+	static lua::cached_metatable_t g_ColorMetatable("lstg.Color");
+
 	Core::Color4B* ColorWrapper::Cast(lua_State* L, int idx)
 	{
-		return static_cast<Core::Color4B*>(luaL_checkudata(L, idx, ClassID.data()));
+		return g_ColorMetatable.check<Core::Color4B>(L, idx);
 	}
 
 	constexpr lua_Number const _1_255 = 1.0 / 255.0;
@@ -410,6 +413,7 @@ namespace LuaSTGPlus::LuaWrapper
 
 		luaL_register(L, LUASTG_LUA_LIBNAME, lib);
 		RegisterClassIntoTable2(L, ".Color", tMethods, ClassID.data(), tMetaTable);
+		g_ColorMetatable.bind(L);
 		lua_pop(L, 1);
 	}
 
@@ -417,7 +421,7 @@ namespace LuaSTGPlus::LuaWrapper
 	{
 		Core::Color4B* p = static_cast<Core::Color4B*>(lua_newuserdata(L, sizeof(Core::Color4B))); // udata
 		p->color(color.color());
-		luaL_getmetatable(L, ClassID.data()); // udata mt
+		g_ColorMetatable.push(L); // udata mt
 		lua_setmetatable(L, -2); // udata
 	}
 }
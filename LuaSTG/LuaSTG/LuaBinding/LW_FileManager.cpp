@@ -386,6 +386,24 @@ void LuaSTGPlus::FileManagerWrapper::Register(lua_State* L)noexcept
 			lua_pushboolean(L, GFileManager().containEx(path));
 			return 1;
 		}
+		static int Prefetch(lua_State* L)
+		{
+			lua::stack_t S(L);
+			// list
+			luaL_checktype(L, 1, LUA_TTABLE);
+			size_t const count = S.get_array_size(1);
+			std::vector<std::string> names;
+			names.reserve(count);
+			for (size_t index = 0; index < count; index += 1)
+			{
+				S.push_array_value_zero_base(1, index);		// list s
+				names.emplace_back(S.get_value<std::string_view>(-1));
+				S.pop_value();								// list
+			}
+			size_t const loaded = GFileManager().loadMany(names, nullptr);
+			lua_pushinteger(L, (lua_Integer)loaded);
+			return 1;
+		}
 		
 		static int FindFiles(lua_State* L)
 		{
@@ -560,6 +578,7 @@ void LuaSTGPlus::FileManagerWrapper::Register(lua_State* L)noexcept
 		{ "EnumFilesEx", &Wrapper::EnumFilesEx }, // 要移除
 		{ "FileExist", &Wrapper::FileExist },
 		{ "FileExistEx", &Wrapper::FileExistEx }, // 要移除
+		{ "Prefetch", &Wrapper::Prefetch },
 
 		{ "AddSearchPath", &Wrapper::AddSearchPath },
 		{ "RemoveSearchPath", &Wrapper::RemoveSearchPath },
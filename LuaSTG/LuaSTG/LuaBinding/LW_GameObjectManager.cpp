@@ -121,6 +121,56 @@ void LuaSTGPlus::LuaWrapper::GameObjectManagerWrapper::Register(lua_State* L) no
 		{
 			return LPOOL.PushCurrentObject(L);
 		}
+		// 渲染队列
+		static int SetRenderQueue(lua_State* L) noexcept
+		{
+			auto& queue = LPOOL.GetRenderQueue();
+			queue.SetEnable(lua_toboolean(L, 1));
+			if (lua_gettop(L) >= 2)
+			{
+				lua_Integer const depth = luaL_checkinteger(L, 2);
+				if (depth < 1)
+					return luaL_error(L, "search depth must be greater than 0");
+				queue.SetSearchDepth((uint32_t)depth);
+			}
+			if (lua_gettop(L) >= 3)
+			{
+				lua_Integer const threshold = luaL_checkinteger(L, 3);
+				if (threshold < 0)
+					return luaL_error(L, "parallel threshold must not be negative");
+				queue.SetParallelThreshold((uint32_t)threshold);
+			}
+			if (lua_gettop(L) >= 4)
+			{
+				lua_Integer const threshold = luaL_checkinteger(L, 4);
+				if (threshold < 0)
+					return luaL_error(L, "instancing threshold must not be negative");
+				queue.SetInstancingThreshold((uint32_t)threshold);
+			}
+			return 0;
+		}
+		static int GetRenderQueue(lua_State* L) noexcept
+		{
+			auto& queue = LPOOL.GetRenderQueue();
+			lua_pushboolean(L, queue.IsEnable());
+			lua_pushinteger(L, (lua_Integer)queue.GetSearchDepth());
+			lua_pushinteger(L, (lua_Integer)queue.GetParallelThreshold());
+			lua_pushinteger(L, (lua_Integer)queue.GetInstancingThreshold());
+			return 4;
+		}
+		static int SetLayerOrderIndependent(lua_State* L) noexcept
+		{
+			LPOOL.GetRenderQueue().SetLayerOrderIndependent(
+				luaL_checknumber(L, 1),
+				lua_gettop(L) < 2 || lua_toboolean(L, 2)
+			);
+			return 0;
+		}
+		static int IsLayerOrderIndependent(lua_State* L) noexcept
+		{
+			lua_pushboolean(L, LPOOL.GetRenderQueue().IsLayerOrderIndependent(luaL_checknumber(L, 1)));
+			return 1;
+		}
 	};
 
 	luaL_Reg const lib[] = {
@@ -151,6 +201,17 @@ void LuaSTGPlus::LuaWrapper::GameObjectManagerWrapper::Register(lua_State* L) no
 		{ "Dist", &GameObjectPool::api_Dist },
 		{ "GetV", &GameObjectPool::api_GetV },
 		{ "SetV", &GameObjectPool::api_SetV },
+		// 空间查询
+		{ "QueryNearest", &GameObjectPool::api_QueryNearest },
+		{ "QueryCircle", &GameObjectPool::api_QueryCircle },
+		{ "QueryRect", &GameObjectPool::api_QueryRect },
+		{ "KillInCircle", &GameObjectPool::api_KillInCircle },
+		// 对象状态视图（LuaJIT FFI）
+		{ "GetObjectStateView", &GameObjectPool::api_GetObjectStateView },
+		// 运动程序
+		{ "MotionProgram", &GameObjectPool::api_MotionProgram },
+		{ "SetMotion", &GameObjectPool::api_SetMotion },
+		{ "GetMotion", &GameObjectPool::api_GetMotion },
 		// 对象属性访问
 		{ "GetAttr", &GameObjectPool::api_GetAttr },
 		{ "SetAttr", &GameObjectPool::api_SetAttr },
@@ -175,6 +236,10 @@ void LuaSTGPlus::LuaWrapper::GameObjectManagerWrapper::Register(lua_State* L) no
 		{ "IsSameWorld", &Wrapper::CheckWorlds },
 		{ "ActiveWorlds", &Wrapper::ActiveWorlds },
 		{ "GetCurrentObject", &Wrapper::GetCurrentObject },
+		{ "SetRenderQueue", &Wrapper::SetRenderQueue },
+		{ "GetRenderQueue", &Wrapper::GetRenderQueue },
+		{ "SetLayerOrderIndependent", &Wrapper::SetLayerOrderIndependent },
+		{ "IsLayerOrderIndependent", &Wrapper::IsLayerOrderIndependent },
 		{ NULL, NULL },
 	};
 
@@ -182,6 +247,7 @@ void LuaSTGPlus::LuaWrapper::GameObjectManagerWrapper::Register(lua_State* L) no
 		{ NULL, NULL },
 	};
 
+	RegisterGameObjectMotionProgram(L);
 	luaL_register(L, LUASTG_LUA_LIBNAME, lib);                      // ??? lstg
 	luaL_register(L, LUASTG_LUA_LIBNAME ".GameObjectManager", lib); // ??? lstg lstg.GameObjectManager
 	lua_setfield(L, -1, "GameObjectManager");                       // ??? lstg
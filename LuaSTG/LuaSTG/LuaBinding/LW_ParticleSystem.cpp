@@ -1,34 +1,6 @@
 ﻿#include "LuaBinding/LuaWrapper.hpp"
 #include "lua/plus.hpp"
 
-inline void lua_push_vec2(lua_State* L, Core::Vector2F const& v)
-{
-	lua_createtable(L, 0, 2);
-	lua_pushlstring(L, "x", 1);
-	lua_pushnumber(L, v.x);
-	lua_rawset(L, -3);
-	lua_pushlstring(L, "y", 1);
-	lua_pushnumber(L, v.y);
-	lua_rawset(L, -3);
-}
-inline Core::Vector2F luaL_check_vec2(lua_State* L, int idx)
-{
-	Core::Vector2F ret;
-	if (!lua_istable(L, idx))
-	{
-		luaL_typerror(L, idx, "table  (vector2f)");
-		return ret;
-	}
-	lua_pushlstring(L, "x", 1);
-	lua_gettable(L, idx);
-	ret.x = (float)luaL_checknumber(L, -1);
-	lua_pop(L, 1);
-	lua_pushlstring(L, "y", 1);
-	lua_gettable(L, idx);
-	ret.y = (float)luaL_checknumber(L, -1);
-	lua_pop(L, 1);
-	return ret;
-}
 inline Core::Color4B Color4f_to_Color4B(float c[4])
 {
 	return Core::Color4B(
@@ -300,7 +272,19 @@ namespace LuaSTGPlus::LuaWrapper
 				UserData* self = (UserData*)luaL_checkudata(L, 1, ClassID.data());
 				if (self->ptr)
 				{
-					lua_push_vec2(L, self->ptr->GetCenter());
+					// 传入 lstg.Vector2 时原地写入，避免每次创建新对象
+					Core::Vector2F const center = self->ptr->GetCenter();
+					if (lua_isnoneornil(L, 2))
+					{
+						Vector2Wrapper::CreateAndPush(L, Vector2Wrapper::Vector2(center.x, center.y));
+					}
+					else
+					{
+						Vector2Wrapper::Vector2* out = Vector2Wrapper::Cast(L, 2);
+						out->x = center.x;
+						out->y = center.y;
+						lua_settop(L, 2);
+					}
 					return 1;
 				}
 				else
@@ -725,8 +709,8 @@ namespace LuaSTGPlus::LuaWrapper
 				UserData* self = (UserData*)luaL_checkudata(L, 1, ClassID.data());
 				if (self->ptr)
 				{
-					Core::Vector2F const vec2 = luaL_check_vec2(L, 2);
-					self->ptr->SetCenter(vec2);
+					Vector2Wrapper::Vector2 const vec2 = Vector2Wrapper::CheckValue(L, 2);
+					self->ptr->SetCenter(Core::Vector2F((float)vec2.x, (float)vec2.y));
 					return 0;
 				}
 				else
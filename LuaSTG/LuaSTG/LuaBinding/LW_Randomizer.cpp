@@ -1,4 +1,5 @@
 ﻿#include "LuaBinding/LuaWrapper.hpp"
+#include "lua/plus.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief WELL512随机数算法
@@ -162,11 +163,13 @@ namespace LuaSTGPlus::LuaWrapper
 		}
 	}
 
+	static lua::cached_metatable_t g_RandomizerMetatable(LUASTG_LUA_TYPENAME_RANDGEN);
+
 	void RandomizerWrapper::Register(lua_State* L)noexcept
 	{
 		struct Function
 		{
-		#define GETUDATA(p, i) fcyRandomWELL512* (p) = static_cast<fcyRandomWELL512*>(luaL_checkudata(L, (i), LUASTG_LUA_TYPENAME_RANDGEN));
+		#define GETUDATA(p, i) fcyRandomWELL512* (p) = g_RandomizerMetatable.check<fcyRandomWELL512>(L, (i));
 			static int Seed(lua_State* L)noexcept
 			{
 				GETUDATA(p, 1);
@@ -252,13 +255,14 @@ namespace LuaSTGPlus::LuaWrapper
 		};
 
 		RegisterClassIntoTable(L, ".Rand", tMethods, LUASTG_LUA_TYPENAME_RANDGEN, tMetaTable);
+		g_RandomizerMetatable.bind(L);
 	}
 
 	void RandomizerWrapper::CreateAndPush(lua_State* L)
 	{
 		fcyRandomWELL512* p = static_cast<fcyRandomWELL512*>(lua_newuserdata(L, sizeof(fcyRandomWELL512))); // udata
 		new(p) fcyRandomWELL512();
-		luaL_getmetatable(L, LUASTG_LUA_TYPENAME_RANDGEN); // udata mt
+		g_RandomizerMetatable.push(L); // udata mt
 		lua_setmetatable(L, -2); // udata
 	}
 }
@@ -648,6 +648,32 @@ static int lib_drawMesh(lua_State* L) noexcept
 
     return 0;
 }
+static int lib_drawCommandList(lua_State* L) noexcept
+{
+    validate_render_scope();
+
+    LuaSTGPlus::RenderCommandList* list = LuaSTGPlus::LuaWrapper::CommandListBinding::Cast(L, 1);
+    float const x = (float)luaL_optnumber(L, 2, 0.0);
+    float const y = (float)luaL_optnumber(L, 3, 0.0);
+    float const rot = (float)(luaL_optnumber(L, 4, 0.0) * L_DEG_TO_RAD);
+    float const hscale = (float)luaL_optnumber(L, 5, 1.0);
+    float const vscale = (float)luaL_optnumber(L, 6, hscale);
+    Core::Color4B color(0xFFFFFFFFu);
+    if (!lua_isnoneornil(L, 7))
+    {
+        if (lua_type(L, 7) == LUA_TNUMBER)
+            color = Core::Color4B((uint32_t)lua_tonumber(L, 7));
+        else
+            color = *LuaSTGPlus::LuaWrapper::ColorWrapper::Cast(L, 7);
+    }
+
+    if (!list->Draw(LR2D(), Core::Vector2F(x, y), rot, Core::Vector2F(hscale, vscale), color))
+    {
+        return luaL_error(L, "draw command list failed");
+    }
+
+    return 0;
+}
 
 static int lib_drawModel(lua_State* L)
 {
@@ -711,6 +737,8 @@ static luaL_Reg const lib_func[] = {
     MKFUNC(drawSpriteSequence),
 
     MKFUNC(drawTexture),
+    MKFUNC(drawCommandList),
+
 
     { NULL, NULL },
 };
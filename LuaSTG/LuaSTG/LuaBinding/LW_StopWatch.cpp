@@ -1,4 +1,5 @@
 ﻿#include "LuaBinding/LuaWrapper.hpp"
+#include "lua/plus.hpp"
 #include "Platform/CleanWindows.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -65,11 +66,13 @@ double fcyStopWatch::GetElapsed()
 
 namespace LuaSTGPlus::LuaWrapper
 {
+	static lua::cached_metatable_t g_StopWatchMetatable(LUASTG_LUA_TYPENAME_STOPWATCH);
+
 	void StopWatchWrapper::Register(lua_State* L)noexcept
 	{
 		struct Function
 		{
-		#define GETUDATA(p, i) fcyStopWatch* (p) = static_cast<fcyStopWatch*>(luaL_checkudata(L, (i), LUASTG_LUA_TYPENAME_STOPWATCH));
+		#define GETUDATA(p, i) fcyStopWatch* (p) = g_StopWatchMetatable.check<fcyStopWatch>(L, (i));
 			static int Reset(lua_State* L)
 			{
 				GETUDATA(p, 1);
@@ -117,13 +120,14 @@ namespace LuaSTGPlus::LuaWrapper
 		};
 
 		RegisterClassIntoTable(L, ".StopWatch", tMethods, LUASTG_LUA_TYPENAME_STOPWATCH, tMetaTable);
+		g_StopWatchMetatable.bind(L);
 	}
 
 	void StopWatchWrapper::CreateAndPush(lua_State* L)
 	{
 		fcyStopWatch* p = static_cast<fcyStopWatch*>(lua_newuserdata(L, sizeof(fcyStopWatch))); // udata
 		new(p) fcyStopWatch();
-		luaL_getmetatable(L, LUASTG_LUA_TYPENAME_STOPWATCH); // udata mt
+		g_StopWatchMetatable.push(L); // udata mt
 		lua_setmetatable(L, -2); // udata
 	}
 }
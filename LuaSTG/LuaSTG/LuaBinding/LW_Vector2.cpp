@@ -0,0 +1,410 @@
+﻿#include "LuaBinding/LuaWrapper.hpp"
+#include "lua/plus.hpp"
+#include "LMathConstant.hpp"
+
+// lstg.Vector2：脚本用的二维向量
+// 运算符（+ - * / 和取负）会创建新的对象；原地修改的方法（add、scale、rotate 等）不分配内存，并返回自身以便链式调用
+// 角度统一使用角度制，与 lstg 其他接口一致
+
+namespace LuaSTGPlus::LuaWrapper
+{
+	std::string_view const Vector2Wrapper::ClassID = "lstg.Vector2";
+
+	static lua::cached_metatable_t g_Vector2Metatable("lstg.Vector2");
+
+	Vector2Wrapper::Vector2* Vector2Wrapper::Cast(lua_State* L, int idx)
+	{
+		return g_Vector2Metatable.check<Vector2>(L, idx);
+	}
+
+	Vector2Wrapper::Vector2 Vector2Wrapper::CheckValue(lua_State* L, int idx)
+	{
+		if (g_Vector2Metatable.is(L, idx))
+		{
+			return *static_cast<Vector2*>(lua_touserdata(L, idx));
+		}
+		// 兼容旧接口的 { x = ..., y = ... } 表
+		if (!lua_istable(L, idx))
+		{
+			luaL_typerror(L, idx, ClassID.data());
+			return {};
+		}
+		Vector2 ret;
+		lua_getfield(L, idx, "x");
+		ret.x = luaL_checknumber(L, -1);
+		lua_pop(L, 1);
+		lua_getfield(L, idx, "y");
+		ret.y = luaL_checknumber(L, -1);
+		lua_pop(L, 1);
+		return ret;
+	}
+
+	void Vector2Wrapper::Register(lua_State* L) noexcept
+	{
+		struct Function
+		{
+		#define GETUDATA(p, i) Vector2* (p) = Cast(L, i);
+
+			static void Rotate(Vector2& v, lua_Number const degree)
+			{
+				lua_Number const rad = degree * L_DEG_TO_RAD;
+				lua_Number const c = std::cos(rad);
+				lua_Number const s = std::sin(rad);
+				v = Vector2(v.x * c - v.y * s, v.x * s + v.y * c);
+			}
+
+			// 方法
+
+			static int Set(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				if (lua_isnumber(L, 2))
+				{
+					p->x = luaL_checknumber(L, 2);
+					p->y = luaL_checknumber(L, 3);
+				}
+				else
+				{
+					*p = CheckValue(L, 2);
+				}
+				lua_settop(L, 1);
+				return 1;
+			}
+			static int Get(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				lua_pushnumber(L, p->x);
+				lua_pushnumber(L, p->y);
+				return 2;
+			}
+			static int Clone(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				CreateAndPush(L, *p);
+				return 1;
+			}
+			static int Length(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				lua_pushnumber(L, p->length());
+				return 1;
+			}
+			static int Angle(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				lua_pushnumber(L, p->angle() * L_RAD_TO_DEG);
+				return 1;
+			}
+			static int Dot(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				Vector2 const w = CheckValue(L, 2);
+				lua_pushnumber(L, p->x * w.x + p->y * w.y);
+				return 1;
+			}
+			static int Cross(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				Vector2 const w = CheckValue(L, 2);
+				lua_pushnumber(L, p->x * w.y - p->y * w.x);
+				return 1;
+			}
+			static int Distance(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				Vector2 const w = CheckValue(L, 2);
+				lua_pushnumber(L, (*p - w).length());
+				return 1;
+			}
+			static int Normalize(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				p->normalize();
+				lua_settop(L, 1);
+				return 1;
+			}
+			static int Add(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				*p += CheckValue(L, 2);
+				lua_settop(L, 1);
+				return 1;
+			}
+			static int Sub(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				*p -= CheckValue(L, 2);
+				lua_settop(L, 1);
+				return 1;
+			}
+			static int Scale(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				*p *= luaL_checknumber(L, 2);
+				lua_settop(L, 1);
+				return 1;
+			}
+			static int AddScaled(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				Vector2 const w = CheckValue(L, 2);
+				lua_Number const s = luaL_checknumber(L, 3);
+				p->x += w.x * s;
+				p->y += w.y * s;
+				lua_settop(L, 1);
+				return 1;
+			}
+			static int RotateSelf(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				Rotate(*p, luaL_checknumber(L, 2));
+				lua_settop(L, 1);
+				return 1;
+			}
+			static int Lerp(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				Vector2 const w = CheckValue(L, 2);
+				lua_Number const t = luaL_checknumber(L, 3);
+				p->x += (w.x - p->x) * t;
+				p->y += (w.y - p->y) * t;
+				lua_settop(L, 1);
+				return 1;
+			}
+
+			// 元方法
+
+			static int Meta_Index(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				size_t len{};
+				char const* key = lua_tolstring(L, 2, &len);
+				if (key && len == 1)
+				{
+					if (key[0] == 'x')
+					{
+						lua_pushnumber(L, p->x);
+						return 1;
+					}
+					if (key[0] == 'y')
+					{
+						lua_pushnumber(L, p->y);
+						return 1;
+					}
+				}
+				lua_pushvalue(L, 2);
+				lua_rawget(L, lua_upvalueindex(1));
+				return 1;
+			}
+			static int Meta_NewIndex(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				size_t len{};
+				char const* key = luaL_checklstring(L, 2, &len);
+				if (len == 1 && key[0] == 'x')
+				{
+					p->x = luaL_checknumber(L, 3);
+				}
+				else if (len == 1 && key[0] == 'y')
+				{
+					p->y = luaL_checknumber(L, 3);
+				}
+				else
+				{
+					return luaL_error(L, "Invalid index key.");
+				}
+				return 0;
+			}
+			static int Meta_Eq(lua_State* L) noexcept
+			{
+				GETUDATA(pA, 1);
+				GETUDATA(pB, 2);
+				lua_pushboolean(L, *pA == *pB);
+				return 1;
+			}
+			static int Meta_Add(lua_State* L) noexcept
+			{
+				CreateAndPush(L, CheckValue(L, 1) + CheckValue(L, 2));
+				return 1;
+			}
+			static int Meta_Sub(lua_State* L) noexcept
+			{
+				CreateAndPush(L, CheckValue(L, 1) - CheckValue(L, 2));
+				return 1;
+			}
+			static int Meta_Mul(lua_State* L) noexcept
+			{
+				if (lua_isnumber(L, 1))
+				{
+					lua_Number const v = luaL_checknumber(L, 1);
+					GETUDATA(p, 2);
+					CreateAndPush(L, *p * v);
+				}
+				else
+				{
+					GETUDATA(p, 1);
+					CreateAndPush(L, *p * luaL_checknumber(L, 2));
+				}
+				return 1;
+			}
+			static int Meta_Div(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				CreateAndPush(L, *p / luaL_checknumber(L, 2));
+				return 1;
+			}
+			static int Meta_Unm(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				CreateAndPush(L, -*p);
+				return 1;
+			}
+			static int Meta_ToString(lua_State* L) noexcept
+			{
+				GETUDATA(p, 1);
+				lua_pushfstring(L, "lstg.Vector2(%f, %f)", p->x, p->y);
+				return 1;
+			}
+
+			// 库函数
+
+			static int Create(lua_State* L) noexcept
+			{
+				CreateAndPush(L, Vector2(luaL_optnumber(L, 1, 0.0), luaL_optnumber(L, 2, 0.0)));
+				return 1;
+			}
+			// lstg.SampleBezier(points, n [, out]) -> out
+			// 在贝塞尔曲线上均匀取 n 个参数点（包括两端），写入 out[1..n]
+			// out 中已有的 lstg.Vector2 会被原地覆盖，多余的元素会被清除，因此复用同一个 out 时不会分配内存
+			static int SampleBezier(lua_State* L) noexcept
+			{
+				luaL_checktype(L, 1, LUA_TTABLE);
+				int const count = (int)lua_objlen(L, 1);
+				lua_Integer const n = luaL_checkinteger(L, 2);
+				luaL_argcheck(L, count >= 1, 1, "at least 1 control point required");
+				luaL_argcheck(L, n >= 2, 2, "at least 2 samples required");
+				if (lua_isnoneornil(L, 3))
+				{
+					lua_settop(L, 2);
+					lua_createtable(L, (int)n, 0);
+				}
+				else
+				{
+					luaL_checktype(L, 3, LUA_TTABLE);
+					lua_settop(L, 3);
+				}
+
+				// 控制点和 De Casteljau 的工作区，只在控制点变多时扩容
+				static std::vector<Vector2> points;
+				static std::vector<Vector2> work;
+				points.resize((size_t)count);
+				work.resize((size_t)count);
+				for (int i = 0; i < count; i += 1)
+				{
+					lua_rawgeti(L, 1, i + 1);
+					points[(size_t)i] = CheckValue(L, -1);
+					lua_pop(L, 1);
+				}
+
+				lua_Number const step = 1.0 / (lua_Number)(n - 1);
+				for (lua_Integer i = 0; i < n; i += 1)
+				{
+					lua_Number const t = (i == n - 1) ? 1.0 : step * (lua_Number)i;
+					std::copy(points.begin(), points.end(), work.begin());
+					for (int k = count - 1; k > 0; k -= 1)
+					{
+						for (int j = 0; j < k; j += 1)
+						{
+							work[(size_t)j].x += (work[(size_t)j + 1].x - work[(size_t)j].x) * t;
+							work[(size_t)j].y += (work[(size_t)j + 1].y - work[(size_t)j].y) * t;
+						}
+					}
+					lua_rawgeti(L, 3, (int)(i + 1));
+					if (g_Vector2Metatable.is(L, -1))
+					{
+						*static_cast<Vector2*>(lua_touserdata(L, -1)) = work[0];
+						lua_pop(L, 1);
+					}
+					else
+					{
+						lua_pop(L, 1);
+						CreateAndPush(L, work[0]);
+						lua_rawseti(L, 3, (int)(i + 1));
+					}
+				}
+				for (int i = (int)n + 1;; i += 1)
+				{
+					lua_rawgeti(L, 3, i);
+					bool const last = lua_isnil(L, -1);
+					lua_pop(L, 1);
+					if (last)
+					{
+						break;
+					}
+					lua_pushnil(L);
+					lua_rawseti(L, 3, i);
+				}
+				return 1;
+			}
+
+		#undef GETUDATA
+		};
+
+		luaL_Reg tMethods[] = {
+			{ "set", &Function::Set },
+			{ "get", &Function::Get },
+			{ "clone", &Function::Clone },
+			{ "length", &Function::Length },
+			{ "angle", &Function::Angle },
+			{ "dot", &Function::Dot },
+			{ "cross", &Function::Cross },
+			{ "distance", &Function::Distance },
+			{ "normalize", &Function::Normalize },
+			{ "add", &Function::Add },
+			{ "sub", &Function::Sub },
+			{ "scale", &Function::Scale },
+			{ "addScaled", &Function::AddScaled },
+			{ "rotate", &Function::RotateSelf },
+			{ "lerp", &Function::Lerp },
+			{ NULL, NULL }
+		};
+
+		luaL_Reg tMetaTable[] = {
+			{ "__newindex", &Function::Meta_NewIndex },
+			{ "__eq", &Function::Meta_Eq },
+			{ "__add", &Function::Meta_Add },
+			{ "__sub", &Function::Meta_Sub },
+			{ "__mul", &Function::Meta_Mul },
+			{ "__div", &Function::Meta_Div },
+			{ "__unm", &Function::Meta_Unm },
+			{ "__tostring", &Function::Meta_ToString },
+			{ NULL, NULL }
+		};
+
+		luaL_Reg lib[] = {
+			{ "Vector2", &Function::Create },
+			{ "SampleBezier", &Function::SampleBezier },
+			{ NULL, NULL }
+		};
+
+		luaL_register(L, LUASTG_LUA_LIBNAME, lib); // lstg
+		RegisterClassIntoTable2(L, ".Vector2", tMethods, ClassID.data(), tMetaTable);
+		g_Vector2Metatable.bind(L);
+		// __index 先处理 x、y，其余的键从方法表中查找
+		g_Vector2Metatable.push(L); // lstg mt
+		lua_getfield(L, -2, ".Vector2"); // lstg mt methods
+		lua_pushcclosure(L, &Function::Meta_Index, 1); // lstg mt f
+		lua_setfield(L, -2, "__index"); // lstg mt
+		lua_pop(L, 2);
+	}
+
+	Vector2Wrapper::Vector2* Vector2Wrapper::CreateAndPush(lua_State* L, Vector2 const& value)
+	{
+		Vector2* p = static_cast<Vector2*>(lua_newuserdata(L, sizeof(Vector2))); // udata
+		p->x = value.x;
+		p->y = value.y;
+		g_Vector2Metatable.push(L); // udata mt
+		lua_setmetatable(L, -2); // udata
+		return p;
+	}
+}
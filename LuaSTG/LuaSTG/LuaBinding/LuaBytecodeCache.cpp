@@ -0,0 +1,187 @@
+#include "LuaBinding/LuaBytecodeCache.hpp"
+#include "core/Configuration.hpp"
+#include "xxhash.h"
+
+#ifdef USING_LUA_BYTECODE_CACHE
+
+namespace
+{
+	struct BytecodeCacheHeader
+	{
+		char magic[8];
+		uint32_t format_version;
+		uint32_t luajit_version;
+		uint64_t source_hash;
+		uint64_t source_size;
+		uint64_t bytecode_hash;
+		uint64_t bytecode_size;
+	};
+
+	constexpr char bytecode_cache_magic[8] = { 'L', 'S', 'T', 'G', 'L', 'J', 'B', 'C' };
+	constexpr uint32_t bytecode_cache_format_version = 3;
+
+	std::filesystem::path const& getCacheDirectory()
+	{
+		static bool initialized = false;
+		static std::filesystem::path directory;
+		if (!initialized)
+		{
+			auto const& config = core::ConfigurationLoader::getInstance().getFileSystem();
+			if (config.hasUser())
+			{
+				core::ConfigurationLoader::resolvePathWithPredefinedVariables(config.getUser(), directory, true);
+				directory /= L"cache/bytecode";
+			}
+			else
+			{
+				directory = L"cache/bytecode";
+			}
+			std::error_code ec;
+			std::filesystem::create_directories(directory, ec);
+			initialized = true;
+		}
+		return directory;
+	}
+
+	std::filesystem::path getCacheFilePath(char const* chunkname)
+	{
+		XXH64_hash_t const key = XXH3_64bits(chunkname, std::strlen(chunkname));
+		return getCacheDirectory() / fmt::format("{:016x}.ljbc", key);
+	}
+
+	bool loadCache(lua_State* L, std::filesystem::path const& path, XXH64_hash_t source_hash, size_t source_size, char const* chunkname)
+	{
+		std::ifstream file(path, std::ios::in | std::ios::binary);
+		if (!file.is_open())
+		{
+			return false;
+		}
+		BytecodeCacheHeader header{};
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		{
+			return false;
+		}
+		if (std::memcmp(header.magic, bytecode_cache_magic, sizeof(bytecode_cache_magic)) != 0
+			|| header.format_version != bytecode_cache_format_version
+			|| header.luajit_version != LUAJIT_VERSION_NUM
+			|| header.source_hash != source_hash
+			|| header.source_size != source_size
+			|| header.bytecode_size == 0
+			|| header.bytecode_size > (uint64_t)INT32_MAX)
+		{
+			return false;
+		}
+		std::vector<char> bytecode((size_t)header.bytecode_size);
+		if (!file.read(bytecode.data(), (std::streamsize)bytecode.size()))
+		{
+			return false;
+		}
+		if (XXH3_64bits(bytecode.data(), bytecode.size()) != header.bytecode_hash)
+		{
+			spdlog::warn("[luastg] 脚本'{}'的字节码缓存已损坏", chunkname);
+			return false;
+		}
+		if (0 != luaL_loadbuffer(L, bytecode.data(), bytecode.size(), chunkname))
+		{
+			spdlog::warn("[luastg] 无法加载脚本'{}'的字节码缓存：{}", chunkname, lua_tostring(L, -1));
+			lua_pop(L, 1);
+			return false;
+		}
+		return true;
+	}
+
+	int writeBytecode(lua_State*, void const* p, size_t size, void* ud)
+	{
+		static_cast<std::string*>(ud)->append(static_cast<char const*>(p), size);
+		return 0;
+	}
+
+	bool dumpBytecode(lua_State* L, std::string& bytecode)
+	{
+		// 保留调试信息，从缓存加载的脚本报错时仍然有行号；加密的脚本不会走到这里
+		if (0 != lua_dump(L, &writeBytecode, &bytecode))
+		{
+			bytecode.clear();
+		}
+		return !bytecode.empty();
+	}
+
+	void saveCache(lua_State* L, std::filesystem::path const& path, XXH64_hash_t source_hash, size_t source_size)
+	{
+		// 栈顶为刚编译好的函数
+		std::string bytecode;
+		if (!dumpBytecode(L, bytecode))
+		{
+			return;
+		}
+		BytecodeCacheHeader header{};
+		std::memcpy(header.magic, bytecode_cache_magic, sizeof(bytecode_cache_magic));
+		header.format_version = bytecode_cache_format_version;
+		header.luajit_version = LUAJIT_VERSION_NUM;
+		header.source_hash = source_hash;
+		header.source_size = source_size;
+		header.bytecode_hash = XXH3_64bits(bytecode.data(), bytecode.size());
+		header.bytecode_size = bytecode.size();
+		// 先写入临时文件再替换，避免留下写了一半的缓存
+		std::filesystem::path temp_path(path);
+		temp_path += L".tmp";
+		{
+			std::ofstream file(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				return;
+			}
+			file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+			file.write(bytecode.data(), (std::streamsize)bytecode.size());
+			if (!file.good())
+			{
+				file.close();
+				std::error_code ec;
+				std::filesystem::remove(temp_path, ec);
+				return;
+			}
+		}
+		std::error_code ec;
+		std::filesystem::rename(temp_path, path, ec);
+		if (ec)
+		{
+			std::filesystem::remove(temp_path, ec);
+		}
+	}
+}
+
+namespace LuaSTGPlus
+{
+	int lua_load_buffer_cached(lua_State* L, char const* source, size_t size, char const* chunkname, bool cacheable)
+	{
+		// 已经是字节码的脚本不需要缓存，加密的脚本不能缓存
+		if (!cacheable || size == 0 || source[0] == LUA_SIGNATURE[0])
+		{
+			return luaL_loadbuffer(L, source, size, chunkname);
+		}
+		XXH64_hash_t const source_hash = XXH3_64bits(source, size);
+		std::filesystem::path const path = getCacheFilePath(chunkname);
+		if (loadCache(L, path, source_hash, size, chunkname))
+		{
+			return 0;
+		}
+		int const result = luaL_loadbuffer(L, source, size, chunkname);
+		if (0 == result)
+		{
+			saveCache(L, path, source_hash, size);
+		}
+		return result;
+	}
+};
+
+#else
+
+namespace LuaSTGPlus
+{
+	int lua_load_buffer_cached(lua_State* L, char const* source, size_t size, char const* chunkname, bool)
+	{
+		return luaL_loadbuffer(L, source, size, chunkname);
+	}
+};
+
+#endif
@@ -0,0 +1,10 @@
+#pragma once
+#include "lua.hpp"
+
+namespace LuaSTGPlus
+{
+	/// @brief 编译脚本，优先从字节码缓存中读取，缓存以脚本路径和源码哈希为键，存放在用户数据目录下
+	/// @param cacheable 为 false 时直接编译源码，不读写缓存；来自加密压缩包的脚本必须传 false，否则会以明文字节码的形式落盘
+	/// @note 返回值与 luaL_loadbuffer 一致，缓存无效或者损坏时回退到编译源码；缓存的字节码保留调试信息
+	int lua_load_buffer_cached(lua_State* L, char const* source, size_t size, char const* chunkname, bool cacheable);
+};
@@ -1,4 +1,5 @@
 ﻿#include "LuaBinding/LuaCustomLoader.hpp"
+#include "LuaBinding/LuaBytecodeCache.hpp"
 #include "Core/FileManager.hpp"
 
 static int readable(const char* filename) {
@@ -74,10 +75,11 @@ static int package_loader_luastg(lua_State* L) {
     if (!GFileManager().loadEx(filename, src))
         loaderror(L, filename);
     else {
-        if (luaL_loadbuffer(L,
-            (char*)src.data(),
+        if (LuaSTGPlus::lua_load_buffer_cached(L,
+            (char const*)src.data(),
             src.size(),
-            filename) != 0)
+            filename,
+            !GFileManager().isEncryptedEx(filename)) != 0)
             loaderror(L, filename);
     }
     return 1;  /* library loaded successfully */
@@ -38,12 +38,14 @@ namespace LuaSTGPlus
 
 		luaL_register(L, LUASTG_LUA_LIBNAME, tMethod);	// ? t
 		ColorWrapper::Register(L);
+		Vector2Wrapper::Register(L);
 		ParticleSystemWrapper::Register(L);
 		StopWatchWrapper::Register(L);
 		RandomizerWrapper::Register(L);
 		BentLaserWrapper::Register(L);
 		DInputWrapper::Register(L);
 		MeshBinding::Register(L);
+		CommandListBinding::Register(L);
 		lua_pop(L, 1);									// ?
 	}
 	
@@ -3,6 +3,7 @@
 #pragma once
 #include "AppFrame.h"
 #include "LuaBinding/LuaWrapperMisc.hpp"
+#include "GameResource/RenderCommandList.hpp"
 
 #define LUASTG_LUA_LIBNAME "lstg"
 
@@ -91,6 +92,18 @@ namespace LuaSTGPlus
 			static void CreateAndPush(lua_State* L, Core::Color4B const& color);
 		};
 
+		class Vector2Wrapper
+		{
+		public:
+			using Vector2 = Core::Vector2<lua_Number>;
+			static std::string_view const ClassID;
+			static Vector2* Cast(lua_State* L, int idx);
+			/// @brief 读取 lstg.Vector2 或者 { x = ..., y = ... } 表
+			static Vector2 CheckValue(lua_State* L, int idx);
+			static void Register(lua_State* L) noexcept;
+			static Vector2* CreateAndPush(lua_State* L, Vector2 const& value);
+		};
+
 		class StopWatchWrapper
 		{
 		public:
@@ -144,6 +157,15 @@ namespace LuaSTGPlus
 			static void Register(lua_State* L);
 		};
 
+		class CommandListBinding
+		{
+		public:
+			static std::string_view const ClassID;
+			static RenderCommandList* Cast(lua_State* L, int idx);
+			static RenderCommandList* Create(lua_State* L);
+			static void Register(lua_State* L);
+		};
+
 		void Register(lua_State* L) noexcept;
 	}
 
@@ -165,7 +165,8 @@ namespace LuaSTG::Sub::LuaBinding
 			auto* self = cast(L, 1);
 			auto const x = S.get_value<float>(2);
 			auto const y = S.get_value<float>(3);
-			self->data->GetSprite()->setTextureCenter(Core::Vector2F(x, y));
+			// 坐标是原纹理上的坐标，图片精灵在纹理图集中时需要换算到图集页面上
+			LRES.SetSpriteTextureCenter(self->data->GetSprite(), Core::Vector2F(x, y));
 			return 0;
 		}
 		static int api_setUnitsPerPixel(lua_State* L)
@@ -538,6 +539,32 @@ namespace LuaSTG::Sub::LuaBinding
 			}
 			return 0;
 		}
+		static int api_buildTextureAtlas(lua_State* L)
+		{
+			lua::stack_t S(L);
+			auto* self = cast(L, 1);
+			size_t const texture_count = S.get_array_size(2);
+			std::vector<std::string> texture_names;
+			texture_names.reserve(texture_count);
+			for (size_t index = 0; index < texture_count; index += 1)
+			{
+				S.push_array_value_zero_base(2, index);
+				if (S.is_string(-1)) {
+					texture_names.emplace_back(S.get_value<std::string_view>(-1));
+				}
+				else {
+					auto* p_tex = ResourceTexture::cast(L, -1);
+					texture_names.emplace_back(p_tex->data->GetResName());
+				}
+				S.pop_value();
+			}
+			auto const page_size = S.get_value<uint32_t>(3, 2048);
+			auto const padding = S.get_value<uint32_t>(4, 2);
+			std::vector<std::string_view> names(texture_names.begin(), texture_names.end());
+			auto const count = self->data->BuildTextureAtlas(names, page_size, padding);
+			S.push_value<uint32_t>(count);
+			return 1;
+		}
 		static int api_getTexture(lua_State* L)
 		{
 			lua::stack_t S(L);
@@ -665,6 +692,7 @@ namespace LuaSTG::Sub::LuaBinding
 			S.set_map_value(method_table, "removeTexture", &api_removeTexture);
 			S.set_map_value(method_table, "removeSprite", &api_removeSprite);
 			S.set_map_value(method_table, "removeSpriteSequence", &api_removeSpriteSequence);
+			S.set_map_value(method_table, "buildTextureAtlas", &api_buildTextureAtlas);
 			S.set_map_value(method_table, "getTexture", &api_getTexture);
 			S.set_map_value(method_table, "getSprite", &api_getSprite);
 			S.set_map_value(method_table, "getSpriteSequence", &api_getSpriteSequence);
@@ -2141,11 +2141,16 @@ namespace DirectWrite
 
 			Microsoft::WRL::ComPtr<ID2D1DeviceContext> d2d1_device_context;
 			d2d1_device_context = (ID2D1DeviceContext*)LAPP.GetAppModel()->getDevice()->getNativeRendererHandle();
-			assert(d2d1_device_context);
 			
 			Microsoft::WRL::ComPtr<ID2D1Bitmap1> d2d1_bitmap_target;
 			d2d1_bitmap_target = (ID2D1Bitmap1*)tex_ptr->GetRenderTarget()->getNativeBitmapHandle();
-			assert(d2d1_bitmap_target);
+
+			// 无界面模式下没有 Direct2D 设备，也就没有可以绘制的像素
+
+			if (!d2d1_device_context || !d2d1_bitmap_target)
+			{
+				return 0;
+			}
 
 			// 创建画笔
 
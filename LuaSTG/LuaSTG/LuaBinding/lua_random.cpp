@@ -3,6 +3,7 @@
 #pragma warning(disable:4244) // 'argument': conversion from 'unsigned int' to 'const pcg_extras::bitcount_t', possible loss of data
 
 #include "lua_random.hpp"
+#include "lua/plus.hpp"
 #include "Utility/xorshift.hpp"
 #include "pcg_random.hpp"
 #include "Utility/sfc.hpp"
@@ -10,6 +11,106 @@
 
 static std::string_view const LibraryID("random");
 
+// 批量生成接口，所有随机数生成器共用
+// 批量生成与逐个调用 number 消耗的是同一个随机数序列，结果完全一致，
+// 因此无论脚本使用哪种方式，录像回放都是可重现的
+namespace RandomBulk
+{
+	using NumberRange = std::uniform_real_distribution<lua_Number>::param_type;
+
+	// 从 index 开始读取取值范围，规则与 number 相同：无参数为 [0, 1]，一个参数为 [0, |b|]，两个参数为 [a, b]
+	static NumberRange checkNumberRange(lua_State* L, int const index)
+	{
+		int const argc = lua_gettop(L);
+		if (argc < index)
+		{
+			return NumberRange(0.0, std::nextafter(1.0, std::numeric_limits<lua_Number>::max()));
+		}
+		else if (argc == index)
+		{
+			lua_Number b = luaL_checknumber(L, index);
+			if (b < 0.0) b = -b;
+			return NumberRange(0.0, std::nextafter(b, std::numeric_limits<lua_Number>::max()));
+		}
+		else if (argc == index + 1)
+		{
+			lua_Number a = luaL_checknumber(L, index);
+			lua_Number b = luaL_checknumber(L, index + 1);
+			if (a > b) std::swap(a, b);
+			return NumberRange(a, std::nextafter(b, std::numeric_limits<lua_Number>::max()));
+		}
+		else
+		{
+			luaL_error(L, "invalid parameter");
+			return NumberRange();
+		}
+	}
+	static int checkCount(lua_State* L, int const index)
+	{
+		lua_Integer const n = luaL_checkinteger(L, index);
+		luaL_argcheck(L, n >= 0 && n <= std::numeric_limits<int>::max(), index, "count out of range");
+		return static_cast<int>(n);
+	}
+
+	// rng:fill(t, n [, a [, b]]) -> t，填充 t[1] 到 t[n]
+	template<typename Data>
+	static int fill(lua_State* L, Data* self)
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+		int const n = checkCount(L, 3);
+		NumberRange const range = checkNumberRange(L, 4);
+		for (int i = 1; i <= n; i += 1)
+		{
+			lua_pushnumber(L, self->num_gn(self->rng, range));
+			lua_rawseti(L, 2, i);
+		}
+		lua_settop(L, 2);
+		return 1;
+	}
+	// rng:numbers(n [, a [, b]]) -> ...，返回 n 个值，n 受 lua 栈大小限制
+	template<typename Data>
+	static int numbers(lua_State* L, Data* self)
+	{
+		int const n = checkCount(L, 2);
+		NumberRange const range = checkNumberRange(L, 3);
+		luaL_checkstack(L, n, "too many results");
+		for (int i = 0; i < n; i += 1)
+		{
+			lua_pushnumber(L, self->num_gn(self->rng, range));
+		}
+		return n;
+	}
+	// rng:buffer(n [, a [, b]]) -> const double*, n
+	// 结果写入生成器自带的缓冲区，通过 LuaJIT FFI 读取，下标从 0 开始
+	// 缓冲区在下一次调用 buffer 或者生成器被回收后失效，需要保存的话请自行复制
+	template<typename Data>
+	static int buffer(lua_State* L, Data* self)
+	{
+		int const n = checkCount(L, 2);
+		NumberRange const range = checkNumberRange(L, 3);
+		if (self->buffer.size() < static_cast<size_t>(n))
+		{
+			self->buffer.resize(static_cast<size_t>(n));
+		}
+		lua_Number* const data = self->buffer.data();
+		for (int i = 0; i < n; i += 1)
+		{
+			data[i] = self->num_gn(self->rng, range);
+		}
+
+		lua_getglobal(L, "require");			// ... require
+		lua_pushstring(L, "ffi");				// ... require "ffi"
+		lua_call(L, 1, 1);						// ... ffi
+		lua_getfield(L, -1, "cast");			// ... ffi cast
+		lua_pushstring(L, "const double*");		// ... ffi cast ctype
+		lua_pushlightuserdata(L, data);			// ... ffi cast ctype data
+		lua_call(L, 2, 1);						// ... ffi view
+		lua_remove(L, -2);						// ... view
+		lua_pushinteger(L, n);					// ... view n
+		return 2;
+	}
+}
+
 template<typename RNG>
 class RandomBase
 {
@@ -20,6 +121,7 @@ public:
 		std::uniform_int_distribution<lua_Integer> int_gn;
 		std::uniform_real_distribution<lua_Number> num_gn;
 		lua_Integer seed;
+		std::vector<lua_Number> buffer;
 		Data() : rng(0), seed(0) {  }
 		~Data() {}
 	};
@@ -28,6 +130,7 @@ public:
 
 private:
 	static std::string_view const CreateID;
+	static lua::cached_metatable_t Metatable;
 
 	static int seed(lua_State* L)
 	{
@@ -111,6 +214,18 @@ private:
 			return luaL_error(L, "invalid parameter");
 		}
 	}
+	static int fill(lua_State* L)
+	{
+		return RandomBulk::fill(L, Cast(L, 1));
+	}
+	static int numbers(lua_State* L)
+	{
+		return RandomBulk::numbers(L, Cast(L, 1));
+	}
+	static int buffer(lua_State* L)
+	{
+		return RandomBulk::buffer(L, Cast(L, 1));
+	}
 	static int sign(lua_State* L)
 	{
 		Data* self = Cast(L, 1);
@@ -162,13 +277,13 @@ private:
 public:
 	static Data* Cast(lua_State* L, int idx)
 	{
-		return static_cast<Data*>(luaL_checkudata(L, idx, ClassID.data()));
+		return Metatable.check<Data>(L, idx);
 	}
 	static Data* Create(lua_State* L)
 	{
 		Data* self = static_cast<Data*>(lua_newuserdata(L, sizeof(Data)));
 		new(self) Data();
-		luaL_getmetatable(L, ClassID.data());
+		Metatable.push(L);
 		lua_setmetatable(L, -2);
 		return self;
 	}
@@ -178,6 +293,9 @@ public:
 			{ "seed", &seed },
 			{ "integer", &integer },
 			{ "number", &number },
+			{ "fill", &fill },
+			{ "numbers", &numbers },
+			{ "buffer", &buffer },
 			{ "sign", &sign },
 			{ "clone", &clone },
 			{ "serialize", &serialize },
@@ -197,7 +315,7 @@ public:
 			{ NULL, NULL }
 		};
 
-		luaL_newmetatable(L, ClassID.data()); // ... mt
+		Metatable.create(L);                  // ... mt
 		luaL_register(L, NULL, mt);           // ... mt
 		lua_pushstring(L, "__index");   // ... mt "__index"
 		lua_createtable(L, 0, 4);             // ... mt "__index" lib
@@ -219,6 +337,7 @@ public:
 	template class RandomBase<random::T>;\
 	std::string_view const RandomBase<random::T>::ClassID("random." #T);\
 	std::string_view const RandomBase<random::T>::CreateID(#T);\
+	lua::cached_metatable_t RandomBase<random::T>::Metatable("random." #T);\
 	using lua_##T##_t = RandomBase<random::T>;
 
 MAKE_TYPE(splitmix64);
@@ -265,6 +384,7 @@ public:
 		std::uniform_int_distribution<lua_Integer> int_gn;
 		std::uniform_real_distribution<lua_Number> num_gn;
 		lua_Integer seed;
+		std::vector<lua_Number> buffer;
 
 		constexpr size_t _Size() { return sizeof(*this); }
 
@@ -283,6 +403,7 @@ public:
 
 private:
 	static std::string_view const CreateID;
+	static lua::cached_metatable_t Metatable;
 
 	static int seed(lua_State* L)
 	{
@@ -366,6 +487,18 @@ private:
 			return luaL_error(L, "invalid parameter");
 		}
 	}
+	static int fill(lua_State* L)
+	{
+		return RandomBulk::fill(L, Cast(L, 1));
+	}
+	static int numbers(lua_State* L)
+	{
+		return RandomBulk::numbers(L, Cast(L, 1));
+	}
+	static int buffer(lua_State* L)
+	{
+		return RandomBulk::buffer(L, Cast(L, 1));
+	}
 	static int sign(lua_State* L)
 	{
 		Data* self = Cast(L, 1);
@@ -417,13 +550,13 @@ private:
 public:
 	static Data* Cast(lua_State* L, int idx)
 	{
-		return static_cast<Data*>(luaL_checkudata(L, idx, ClassID.data()));
+		return Metatable.check<Data>(L, idx);
 	}
 	static Data* Create(lua_State* L)
 	{
 		Data* self = static_cast<Data*>(lua_newuserdata(L, sizeof(Data)));
 		new(self) Data();
-		luaL_getmetatable(L, ClassID.data());
+		Metatable.push(L);
 		lua_setmetatable(L, -2);
 		return self;
 	}
@@ -433,6 +566,9 @@ public:
 			{ "seed", &seed },
 			{ "integer", &integer },
 			{ "number", &number },
+			{ "fill", &fill },
+			{ "numbers", &numbers },
+			{ "buffer", &buffer },
 			{ "sign", &sign },
 			{ "clone", &clone },
 			{ "serialize", &serialize },
@@ -452,7 +588,7 @@ public:
 			{ NULL, NULL }
 		};
 
-		luaL_newmetatable(L, ClassID.data()); // ... mt
+		Metatable.create(L);                  // ... mt
 		luaL_register(L, NULL, mt);           // ... mt
 		lua_pushstring(L, "__index");   // ... mt "__index"
 		lua_createtable(L, 0, 4);             // ... mt "__index" lib
@@ -701,6 +837,7 @@ namespace random
 	template class RandomBasePCG<random::T##_ex>;\
 	std::string_view const RandomBasePCG<random::T##_ex>::ClassID("random." #T);\
 	std::string_view const RandomBasePCG<random::T##_ex>::CreateID(#T);\
+	lua::cached_metatable_t RandomBasePCG<random::T##_ex>::Metatable("random." #T);\
 	using lua_##T##_t = RandomBasePCG<random::T##_ex>;
 
 // pcg family
@@ -724,6 +861,7 @@ public:
 		std::uniform_int_distribution<lua_Integer> int_gn;
 		std::uniform_real_distribution<lua_Number> num_gn;
 		lua_Integer seed;
+		std::vector<lua_Number> buffer;
 
 		constexpr size_t _Size() { return sizeof(*this); }
 
@@ -752,6 +890,7 @@ public:
 
 private:
 	static std::string_view const CreateID;
+	static lua::cached_metatable_t Metatable;
 
 	static int seed(lua_State* L)
 	{
@@ -835,6 +974,18 @@ private:
 			return luaL_error(L, "invalid parameter");
 		}
 	}
+	static int fill(lua_State* L)
+	{
+		return RandomBulk::fill(L, Cast(L, 1));
+	}
+	static int numbers(lua_State* L)
+	{
+		return RandomBulk::numbers(L, Cast(L, 1));
+	}
+	static int buffer(lua_State* L)
+	{
+		return RandomBulk::buffer(L, Cast(L, 1));
+	}
 	static int sign(lua_State* L)
 	{
 		Data* self = Cast(L, 1);
@@ -874,13 +1025,13 @@ private:
 public:
 	static Data* Cast(lua_State* L, int idx)
 	{
-		return static_cast<Data*>(luaL_checkudata(L, idx, ClassID.data()));
+		return Metatable.check<Data>(L, idx);
 	}
 	static Data* Create(lua_State* L)
 	{
 		Data* self = static_cast<Data*>(lua_newuserdata(L, sizeof(Data)));
 		new(self) Data();
-		luaL_getmetatable(L, ClassID.data());
+		Metatable.push(L);
 		lua_setmetatable(L, -2);
 		return self;
 	}
@@ -890,6 +1041,9 @@ public:
 			{ "seed", &seed },
 			{ "integer", &integer },
 			{ "number", &number },
+			{ "fill", &fill },
+			{ "numbers", &numbers },
+			{ "buffer", &buffer },
 			{ "sign", &sign },
 			{ "clone", &clone },
 			// compatible api
@@ -907,7 +1061,7 @@ public:
 			{ NULL, NULL }
 		};
 
-		luaL_newmetatable(L, ClassID.data()); // ... mt
+		Metatable.create(L);                  // ... mt
 		luaL_register(L, NULL, mt);           // ... mt
 		lua_pushstring(L, "__index");   // ... mt "__index"
 		lua_createtable(L, 0, 4);             // ... mt "__index" lib
@@ -929,6 +1083,7 @@ public:
 	template class RandomBaseOther<T>;\
 	std::string_view const RandomBaseOther<T>::ClassID("random." #T);\
 	std::string_view const RandomBaseOther<T>::CreateID(#T);\
+	lua::cached_metatable_t RandomBaseOther<T>::Metatable("random." #T);\
 	using lua_##T##_t = RandomBaseOther<T>;
 
 // jsf family
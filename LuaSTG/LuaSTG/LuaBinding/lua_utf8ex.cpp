@@ -0,0 +1,183 @@
+#include "lua_utf8ex.hpp"
+#include "simdutf.h"
+
+// utf8ex：基于 simdutf 的 UTF-8 字符串工具
+// 下标规则与 string.sub 相同：从 1 开始，负数表示从末尾倒数
+// 除 valid 和 len 以外的函数不检查编码，非法的后续字节会被视为前一个字符的一部分
+
+static bool utf8ex_isLeadByte(char const c)
+{
+	return (static_cast<uint8_t>(c) & 0xC0) != 0x80;
+}
+
+// 第 n 个（从 0 开始）字符的字节偏移，n 等于字符数时返回字符串长度，超出范围返回 npos
+static size_t utf8ex_codepointOffset(std::string_view const str, size_t n)
+{
+	// 先按块跳过，每块用 simdutf 统计字符数，剩余部分逐字节查找
+	constexpr size_t block_size = 256;
+	size_t offset = 0;
+	while (str.size() - offset > block_size)
+	{
+		size_t const count = simdutf::count_utf8(str.data() + offset, block_size);
+		if (count > n)
+		{
+			break;
+		}
+		n -= count;
+		offset += block_size;
+	}
+	for (; offset < str.size(); offset += 1)
+	{
+		if (utf8ex_isLeadByte(str[offset]))
+		{
+			if (n == 0)
+			{
+				return offset;
+			}
+			n -= 1;
+		}
+	}
+	return n == 0 ? str.size() : std::string_view::npos;
+}
+
+// 与 string.sub 相同的负数下标处理，返回从 1 开始的下标，可能超出 [1, length]
+static lua_Integer utf8ex_relativeIndex(lua_Integer const index, size_t const length)
+{
+	if (index >= 0)
+	{
+		return index;
+	}
+	else if (static_cast<size_t>(-index) > length)
+	{
+		return 0;
+	}
+	else
+	{
+		return static_cast<lua_Integer>(length) + index + 1;
+	}
+}
+
+// utf8ex.valid(s) -> true | false, position
+static int utf8ex_valid(lua_State* L)
+{
+	size_t size = 0;
+	char const* str = luaL_checklstring(L, 1, &size);
+	simdutf::result const result = simdutf::validate_utf8_with_errors(str, size);
+	if (result.error == simdutf::error_code::SUCCESS)
+	{
+		lua_pushboolean(L, true);
+		return 1;
+	}
+	lua_pushboolean(L, false);
+	lua_pushinteger(L, static_cast<lua_Integer>(result.count) + 1);
+	return 2;
+}
+
+// utf8ex.len(s [, i [, j]]) -> count | nil, position
+// 统计从字节 i 到字节 j 之间开始的字符数，编码错误时返回 nil 和出错的字节位置
+static int utf8ex_len(lua_State* L)
+{
+	size_t size = 0;
+	char const* str = luaL_checklstring(L, 1, &size);
+	lua_Integer const i = utf8ex_relativeIndex(luaL_optinteger(L, 2, 1), size);
+	lua_Integer const j = utf8ex_relativeIndex(luaL_optinteger(L, 3, -1), size);
+	luaL_argcheck(L, 1 <= i && i <= static_cast<lua_Integer>(size) + 1, 2, "initial position out of string");
+	luaL_argcheck(L, j <= static_cast<lua_Integer>(size), 3, "final position out of string");
+	if (i > j)
+	{
+		lua_pushinteger(L, 0);
+		return 1;
+	}
+	// 包含在 j 处开始的字符的后续字节
+	size_t const begin = static_cast<size_t>(i - 1);
+	size_t end = static_cast<size_t>(j);
+	while (end < size && !utf8ex_isLeadByte(str[end]))
+	{
+		end += 1;
+	}
+	simdutf::result const result = simdutf::validate_utf8_with_errors(str + begin, end - begin);
+	if (result.error != simdutf::error_code::SUCCESS)
+	{
+		lua_pushnil(L);
+		lua_pushinteger(L, static_cast<lua_Integer>(begin + result.count) + 1);
+		return 2;
+	}
+	lua_pushinteger(L, static_cast<lua_Integer>(simdutf::count_utf8(str + begin, end - begin)));
+	return 1;
+}
+
+// utf8ex.offset(s, n) -> position | nil
+// 第 n 个字符开始的字节位置，n 为字符数 + 1 时返回 #s + 1
+static int utf8ex_offset(lua_State* L)
+{
+	size_t size = 0;
+	char const* str = luaL_checklstring(L, 1, &size);
+	lua_Integer n = luaL_checkinteger(L, 2);
+	std::string_view const view(str, size);
+	if (n < 0)
+	{
+		n = static_cast<lua_Integer>(simdutf::count_utf8(str, size)) + n + 1;
+	}
+	if (n < 1)
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+	size_t const offset = utf8ex_codepointOffset(view, static_cast<size_t>(n - 1));
+	if (offset == std::string_view::npos)
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+	lua_pushinteger(L, static_cast<lua_Integer>(offset) + 1);
+	return 1;
+}
+
+// utf8ex.sub(s, i [, j]) -> string
+// 按字符截取，规则与 string.sub 相同
+static int utf8ex_sub(lua_State* L)
+{
+	size_t size = 0;
+	char const* str = luaL_checklstring(L, 1, &size);
+	lua_Integer i = luaL_checkinteger(L, 2);
+	lua_Integer j = luaL_optinteger(L, 3, -1);
+	std::string_view const view(str, size);
+	if (i < 0 || j < 0)
+	{
+		size_t const length = simdutf::count_utf8(str, size);
+		i = utf8ex_relativeIndex(i, length);
+		j = utf8ex_relativeIndex(j, length);
+	}
+	if (i < 1)
+	{
+		i = 1;
+	}
+	if (i > j)
+	{
+		lua_pushliteral(L, "");
+		return 1;
+	}
+	size_t const begin = utf8ex_codepointOffset(view, static_cast<size_t>(i - 1));
+	if (begin == std::string_view::npos || begin == size)
+	{
+		lua_pushliteral(L, "");
+		return 1;
+	}
+	size_t end = utf8ex_codepointOffset(view.substr(begin), static_cast<size_t>(j - i + 1));
+	end = (end == std::string_view::npos) ? size : begin + end;
+	lua_pushlstring(L, str + begin, end - begin);
+	return 1;
+}
+
+int luaopen_utf8ex(lua_State* L)
+{
+	luaL_Reg const lib[] = {
+		{ "valid", &utf8ex_valid },
+		{ "len", &utf8ex_len },
+		{ "offset", &utf8ex_offset },
+		{ "sub", &utf8ex_sub },
+		{ NULL, NULL },
+	};
+	luaL_register(L, "utf8ex", lib);
+	return 1;
+}
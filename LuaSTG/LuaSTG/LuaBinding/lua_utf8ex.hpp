@@ -0,0 +1,4 @@
+#pragma once
+#include "lua.hpp"
+
+int luaopen_utf8ex(lua_State* L);
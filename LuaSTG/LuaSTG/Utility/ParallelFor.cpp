@@ -0,0 +1,97 @@
+#include "Utility/ParallelFor.hpp"
+#include <algorithm>
+
+namespace LuaSTGPlus
+{
+	void ParallelFor::execute()
+	{
+		for (;;)
+		{
+			size_t const begin = m_next.fetch_add(m_grain);
+			if (begin >= m_count)
+			{
+				break;
+			}
+			(*m_task)(begin, std::min(begin + m_grain, m_count));
+		}
+	}
+	void ParallelFor::workerMain()
+	{
+		uint64_t generation = 0;
+		for (;;)
+		{
+			{
+				std::unique_lock lock(m_mutex);
+				m_start.wait(lock, [&] { return m_exit || m_generation != generation; });
+				if (m_exit)
+				{
+					return;
+				}
+				generation = m_generation;
+			}
+			execute();
+			{
+				std::unique_lock lock(m_mutex);
+				m_running -= 1;
+				if (m_running == 0)
+				{
+					m_done.notify_one();
+				}
+			}
+		}
+	}
+
+	void ParallelFor::run(size_t count, size_t grain, Task const& task)
+	{
+		grain = std::max<size_t>(grain, 1);
+		if (m_threads.empty() || count <= grain)
+		{
+			if (count > 0)
+			{
+				task(0, count);
+			}
+			return;
+		}
+		{
+			std::unique_lock lock(m_mutex);
+			m_task = &task;
+			m_count = count;
+			m_grain = grain;
+			m_next.store(0);
+			m_running = m_threads.size();
+			m_generation += 1;
+		}
+		m_start.notify_all();
+		execute();
+		{
+			std::unique_lock lock(m_mutex);
+			m_done.wait(lock, [&] { return m_running == 0; });
+			m_task = nullptr;
+		}
+	}
+
+	ParallelFor::ParallelFor(size_t worker_count)
+	{
+		if (worker_count == 0)
+		{
+			worker_count = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+		}
+		m_threads.reserve(worker_count);
+		for (size_t i = 0; i < worker_count; i += 1)
+		{
+			m_threads.emplace_back(&ParallelFor::workerMain, this);
+		}
+	}
+	ParallelFor::~ParallelFor()
+	{
+		{
+			std::unique_lock lock(m_mutex);
+			m_exit = true;
+		}
+		m_start.notify_all();
+		for (auto& t : m_threads)
+		{
+			t.join();
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+
+namespace LuaSTGPlus
+{
+	// 常驻工作线程组，把下标区间 [0, count) 按 grain 切块后分给多个线程执行，调用线程也参与计算
+	// 同一时间只能有一个调用者，适合在主线程每帧分发计算量较大但互不依赖的任务
+	class ParallelFor
+	{
+	public:
+		using Task = std::function<void(size_t begin, size_t end)>;
+	private:
+		std::vector<std::thread> m_threads;
+		std::mutex m_mutex;
+		std::condition_variable m_start;
+		std::condition_variable m_done;
+		Task const* m_task{};
+		size_t m_count{};
+		size_t m_grain{};
+		std::atomic_size_t m_next{};
+		uint64_t m_generation{};
+		size_t m_running{};
+		bool m_exit{};
+
+		void execute();
+		void workerMain();
+	public:
+		/// @brief 工作线程数量（不含调用线程）
+		size_t getWorkerCount() const noexcept { return m_threads.size(); }
+		/// @brief 执行任务并等待全部完成；区间不足两块时直接在调用线程上执行
+		void run(size_t count, size_t grain, Task const& task);
+	public:
+		/// @param worker_count 工作线程数量，为 0 时按硬件线程数减一
+		explicit ParallelFor(size_t worker_count = 0);
+		ParallelFor(ParallelFor const&) = delete;
+		ParallelFor& operator=(ParallelFor const&) = delete;
+		~ParallelFor();
+	};
+}
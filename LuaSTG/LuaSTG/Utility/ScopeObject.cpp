@@ -39,6 +39,29 @@ namespace LuaSTGPlus
         _out = float(double(time.QuadPart - _time) / double(_freq));
     }
     
+    static int64_t GetPerformanceFrequency()
+    {
+        static int64_t const s_freq = []() -> int64_t
+        {
+            LARGE_INTEGER freq = {};
+            ::QueryPerformanceFrequency(&freq);
+            return freq.QuadPart;
+        }();
+        return s_freq;
+    }
+    AccumulateTimerScope::AccumulateTimerScope(double& inout) : _time(0), _out(inout)
+    {
+        LARGE_INTEGER time = {};
+        ::QueryPerformanceCounter(&time);
+        _time = time.QuadPart;
+    }
+    AccumulateTimerScope::~AccumulateTimerScope()
+    {
+        LARGE_INTEGER time = {};
+        ::QueryPerformanceCounter(&time);
+        _out += double(time.QuadPart - _time) / double(GetPerformanceFrequency());
+    }
+    
     CoInitializeScope::CoInitializeScope()
     {
         _result = SUCCEEDED(::CoInitializeEx(nullptr, COINIT_MULTITHREADED));
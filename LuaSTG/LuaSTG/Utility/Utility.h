@@ -15,6 +15,16 @@ namespace LuaSTGPlus {
         ~TimerScope();
     };
     
+    // 累计计时域，离开作用域时将流逝的时间（秒）累加到输出上
+    class AccumulateTimerScope {
+    private:
+        int64_t _time;
+        double& _out;
+    public:
+        explicit AccumulateTimerScope(double& InOut);
+        ~AccumulateTimerScope();
+    };
+    
     // 自动配对调用 CoInitializeEx 和 CoUninitialize
     class CoInitializeScope {
     private:
@@ -58,6 +58,11 @@ namespace cpp {
             return N;
         };
         
+        // 按 id 排列的对象数组，包括未分配的对象
+        T* data() noexcept {
+            return _data;
+        };
+        
         void clear() noexcept {
             _free_size = N;
             for (size_t idx_ = 0; idx_ < N; idx_++) {
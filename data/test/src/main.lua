@@ -110,6 +110,19 @@ require("test_object_resource")
 require("test_random")
 require("test_se")
 require("test_window_and_display")
+require("test_bytecode_cache")
+require("test_render_queue")
+require("test_texture_atlas")
+require("test_command_list")
+require("test_spatial_query")
+require("test_object_state_view")
+require("test_userdata_check")
+require("test_cjson_ext")
+require("test_utf8ex")
+require("test_vector2")
+require("test_motion_program")
+require("test_csv")
+require("test_xlsx")
 
 require("test.imgui.all")
 require("test.audio.SoundEffect")
@@ -0,0 +1,66 @@
+local test = require("test")
+
+---@class test.Benchmark.BytecodeCache : test.Base
+local M = {}
+
+---@param directory string
+---@param list string[]
+local function collectScripts(directory, list)
+    for _, v in ipairs(lstg.FileManager.EnumFiles(directory)) do
+        if v[2] then
+            collectScripts(v[1], list)
+        elseif v[1]:sub(-4) == ".lua" then
+            table.insert(list, v[1])
+        end
+    end
+end
+
+---@param path string
+---@return string
+local function toModuleName(path)
+    return (path:gsub("^src/", ""):gsub("%.lua$", ""):gsub("/", "."))
+end
+
+function M:onCreate()
+    local scripts = {}
+    collectScripts("src/", scripts)
+    local loader = package.loaders[#package.loaders]
+    local stopwatch = lstg.StopWatch()
+
+    -- 直接编译源码（不经过字节码缓存）
+    stopwatch:Reset()
+    for _, path in ipairs(scripts) do
+        assert(loadstring(lstg.LoadTextFile(path), path))
+    end
+    local source_time = stopwatch:GetElapsed()
+
+    -- 经过字节码缓存编译，第一轮可能需要写入缓存，第二轮应当全部命中
+    local cached_time = {}
+    for round = 1, 2 do
+        stopwatch:Reset()
+        for _, path in ipairs(scripts) do
+            assert(type(loader(toModuleName(path))) == "function")
+        end
+        cached_time[round] = stopwatch:GetElapsed()
+    end
+
+    -- 第二轮加载的是缓存的字节码，调试信息应当保留，报错时才有行号
+    local f = loader(toModuleName(scripts[1]))
+    assert(next(debug.getinfo(f, "L").activelines) ~= nil, "cached bytecode has no line info")
+
+    lstg.Print(string.format("========== 字节码缓存：%d 个脚本 ==========", #scripts))
+    lstg.Print(string.format("编译源码：%.3fms", source_time * 1000.0))
+    lstg.Print(string.format("字节码缓存（第一轮）：%.3fms", cached_time[1] * 1000.0))
+    lstg.Print(string.format("字节码缓存（第二轮）：%.3fms", cached_time[2] * 1000.0))
+end
+
+function M:onDestroy()
+end
+
+function M:onUpdate()
+end
+
+function M:onRender()
+end
+
+test.registerTest("test.Benchmark.BytecodeCache", M)
@@ -0,0 +1,110 @@
+local test = require("test")
+local cjson = require("cjson")
+
+local function deepEqual(a, b)
+    if type(a) ~= type(b) then
+        return false
+    end
+    if type(a) ~= "table" then
+        return a == b
+    end
+    for k, v in pairs(a) do
+        if not deepEqual(v, b[k]) then
+            return false
+        end
+    end
+    for k in pairs(b) do
+        if a[k] == nil then
+            return false
+        end
+    end
+    return true
+end
+
+---@class test.Module.CJsonExt : test.Base
+local M = {}
+
+function M:onCreate()
+    local samples = {
+        '{"a":1,"b":[1,2,3,{"c":"d"}],"e":{},"f":[],"g":null,"h":true,"i":false}',
+        '[1.5,-2e10,0,-0.25,"\\u4e2d\\ud83d\\ude00\\n\\"\\/"]',
+        '  [ [ ], [ [ ] ], { "x" : [ 1 , 2 ] } ]  ',
+        '"plain"',
+    }
+    for _, text in ipairs(samples) do
+        assert(deepEqual(cjson.decode_presized(text), cjson.decode(text)), text)
+    end
+    assert(cjson.decode_presized('{"n":null}').n == cjson.null)
+    for _, text in ipairs({ '[1,2', '{"a" 1}', '[01]', '[1] 2', '"\\x"', '{1:2}' }) do
+        assert(not pcall(cjson.decode_presized, text), text)
+    end
+
+    local encoder = cjson.encoder()
+    local values = {
+        { 1, 2, 3, "a/b", { x = 1.25 } },
+        { name = "replay", frames = { 1, 2, 3 }, ok = true, none = cjson.null },
+        {},
+        cjson.empty_array,
+        setmetatable({}, cjson.empty_array_mt),
+        "\1\t\"\\",
+        123456789012345,
+        0.1,
+    }
+    for _, value in ipairs(values) do
+        assert(encoder:encode(value) == cjson.encode(value))
+    end
+    assert(not pcall(encoder.encode, encoder, { [1] = 1, [100] = 2 }))
+    assert(not pcall(encoder.encode, encoder, function() end))
+
+    -- 流式写入文件
+    local big = {}
+    for i = 1, 50000 do
+        big[i] = { frame = i, input = i % 16, text = "frame " .. i }
+    end
+    local path = "test_cjson_encoder.json"
+    assert(encoder:encode_file(path, big))
+    local file = assert(io.open(path, "rb"))
+    local text = file:read("*a")
+    file:close()
+    os.remove(path)
+    assert(text == encoder:encode(big))
+    assert(deepEqual(cjson.decode_presized(text), big))
+    assert(not pcall(encoder.encode_file, encoder, path, { function() end }))
+    assert(io.open(path, "rb") == nil)
+
+    lstg.Print("========== cjson 扩展 ==========")
+    local stopwatch = lstg.StopWatch()
+    stopwatch:Reset()
+    for _ = 1, 10 do
+        cjson.decode(text)
+    end
+    local t1 = stopwatch:GetElapsed()
+    stopwatch:Reset()
+    for _ = 1, 10 do
+        cjson.decode_presized(text)
+    end
+    local t2 = stopwatch:GetElapsed()
+    stopwatch:Reset()
+    for _ = 1, 10 do
+        cjson.encode(big)
+    end
+    local t3 = stopwatch:GetElapsed()
+    stopwatch:Reset()
+    for _ = 1, 10 do
+        encoder:encode(big)
+    end
+    local t4 = stopwatch:GetElapsed()
+    lstg.Print(string.format("decode：%.3fms，decode_presized：%.3fms", t1 * 100.0, t2 * 100.0))
+    lstg.Print(string.format("encode：%.3fms，encoder:encode：%.3fms", t3 * 100.0, t4 * 100.0))
+end
+
+function M:onDestroy()
+end
+
+function M:onUpdate()
+end
+
+function M:onRender()
+end
+
+test.registerTest("test.Module.CJsonExt", M)
@@ -0,0 +1,52 @@
+local test = require("test")
+
+---@class test.Module.CommandList : test.Base
+local M = {}
+
+function M:onCreate()
+    local old_pool = lstg.GetResourceStatus()
+    lstg.SetResourceStatus("global")
+    lstg.LoadTexture("test:command_list:tex", "res/block.png", false)
+    local w, h = lstg.GetTextureSize("test:command_list:tex")
+    lstg.LoadImage("test:command_list:img", "test:command_list:tex", 0, 0, w, h)
+    lstg.SetResourceStatus(old_pool)
+
+    -- 静态背景只录制一次，每帧只需要一次 drawCommandList 调用
+    self.timer = 0
+    self.list = lstg.CommandList()
+    local size = 32
+    for y = -window.height, window.height, size do
+        for x = -window.width, window.width, size do
+            self.list:drawSprite("test:command_list:img", x, y, 0, size / w, size / h)
+        end
+    end
+    self.list:drawTexture("test:command_list:tex", "",
+        { -64,  64, 0.5, 0, 0, lstg.Color(255, 255, 0, 0) },
+        {  64,  64, 0.5, w, 0, lstg.Color(255, 0, 255, 0) },
+        {  64, -64, 0.5, w, h, lstg.Color(255, 0, 0, 255) },
+        { -64, -64, 0.5, 0, h, lstg.Color(255, 255, 255, 255) })
+    lstg.Print(string.format("绘制命令列表测试：%d 个顶点，%d 个批次", self.list:getVertexCount(), self.list:getBatchCount()))
+end
+
+function M:onDestroy()
+    self.list:clear()
+    self.list = nil
+    lstg.RemoveResource("global", 2, "test:command_list:img")
+    lstg.RemoveResource("global", 1, "test:command_list:tex")
+end
+
+function M:onUpdate()
+    self.timer = self.timer + 1
+end
+
+function M:onRender()
+    window:applyCameraV()
+    local t = self.timer
+    local alpha = 192 + 63 * math.sin(t / 30)
+    lstg.Renderer.drawCommandList(self.list,
+        window.width / 2, window.height / 2, t * 0.25,
+        1 + 0.25 * math.sin(t / 60), nil,
+        lstg.Color(alpha, 255, 255, 255))
+end
+
+test.registerTest("test.Module.CommandList", M)
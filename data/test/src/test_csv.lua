@@ -0,0 +1,98 @@
+local test = require("test")
+
+local function deepEqual(a, b)
+    if type(a) ~= type(b) then
+        return false
+    end
+    if type(a) ~= "table" then
+        return a == b
+    end
+    for k, v in pairs(a) do
+        if not deepEqual(v, b[k]) then
+            return false
+        end
+    end
+    for k in pairs(b) do
+        if a[k] == nil then
+            return false
+        end
+    end
+    return true
+end
+
+---@param iterator fun():integer, string[]
+---@return string[][]
+local function collectRows(iterator)
+    local rows = {}
+    for ri, row in iterator do
+        assert(ri == #rows + 1)
+        rows[ri] = row
+    end
+    return rows
+end
+
+---@class test.Module.CSV : test.Base
+local M = {}
+
+function M:onCreate()
+    -- 包围的 cell 中可以出现分隔符、换行符和转义的边界符
+    local source = 'a,"b,c",d\r\n1,"x""y",3\r\n"line1\r\nline2",,end\r\n'
+    local expected = {
+        { "a", "b,c", "d" },
+        { "1", 'x"y', "3" },
+        { "line1\r\nline2", "", "end" },
+    }
+    assert(deepEqual(csv.decode(source), expected))
+    assert(deepEqual(collectRows(csv.rows(source)), expected))
+
+    -- 最后一行没有换行符
+    assert(deepEqual(csv.decode("a,b\r\nc,d"), { { "a", "b" }, { "c", "d" } }))
+
+    -- cell 中的 \0 原样保留
+    local nul = csv.decode('a\0b,"c\0,d"\r\n')
+    assert(#nul[1][1] == 3 and nul[1][1] == "a\0b")
+    assert(nul[1][2] == "c\0,d")
+
+    -- 自定义换行符、分隔符和边界符
+    assert(deepEqual(csv.decode("a;'b;c'\nd;e\n", "\n", ";", "'"), { { "a", "b;c" }, { "d", "e" } }))
+
+    -- 按 64 KiB 分块读取文件时，行、换行符和转义的边界符都可能被切开
+    local chunk = 64 * 1024
+    local parts = {
+        string.rep("a", chunk - 1) .. "\r\n", -- \r 是第一块的最后一个字节，\n 在第二块开头
+        '"' .. string.rep("b", chunk - 3) .. '""",x\r\n', -- 转义的边界符 "" 被第二块的结尾切开
+        '"' .. string.rep("c,\r\n\0", chunk) .. '",y\r\n', -- 一个 cell 跨过多个块
+    }
+    for i = 1, 2000 do
+        table.insert(parts, string.format('%d,"q,%d",\0%d\r\n', i, i, i))
+    end
+    table.insert(parts, "last,row")
+    local big = table.concat(parts)
+    local path = "test_csv_filerows.csv"
+    local file = assert(io.open(path, "wb"))
+    file:write(big)
+    file:close()
+    local decoded = csv.decode(big)
+    local ok, rows = pcall(collectRows, csv.filerows(path))
+    os.remove(path)
+    assert(ok, rows)
+    assert(#decoded == 2004)
+    assert(decoded[1][1] == string.rep("a", chunk - 1))
+    assert(decoded[2][1] == string.rep("b", chunk - 3) .. '"' and decoded[2][2] == "x")
+    assert(decoded[3][1] == string.rep("c,\r\n\0", chunk) and decoded[3][2] == "y")
+    assert(deepEqual(decoded[4], { "1", "q,1", "\0" .. "1" }))
+    assert(deepEqual(decoded[2004], { "last", "row" }))
+    assert(deepEqual(rows, decoded))
+    assert(deepEqual(collectRows(csv.rows(big)), decoded))
+end
+
+function M:onDestroy()
+end
+
+function M:onUpdate()
+end
+
+function M:onRender()
+end
+
+test.registerTest("test.Module.CSV", M)
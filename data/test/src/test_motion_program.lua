@@ -0,0 +1,135 @@
+local test = require("test")
+
+local function emptyClass(frame)
+    return {
+        function() end,
+        function() end,
+        frame or function() end,
+        lstg.DefaultRenderFunc,
+        function() end,
+        function() end;
+        is_class = true,
+    }
+end
+
+local program_commands = {
+    { "speed", 0, 90 },
+    { "accel", 3, 30 },
+    { "turn", 2, 45 },
+    { "wait", 10 },
+    { "aim" },
+}
+
+-- 与上面的运动程序等价的 frame 回调
+local lua_class = emptyClass(function(self)
+    local t = self.timer
+    if t < 30 then
+        lstg.SetV(self, 3 * (t + 1) / 30, 90)
+    elseif t < 75 then
+        local v, a = lstg.GetV(self)
+        lstg.SetV(self, v, a + 2)
+    elseif t == 85 then
+        local v = lstg.GetV(self)
+        lstg.SetV(self, v, lstg.Angle(self, self.target))
+    end
+end)
+local motion_class = emptyClass()
+local target_class = emptyClass()
+
+local function newBullet(class, target)
+    local obj = lstg.New(class)
+    obj.x = 0
+    obj.y = 0
+    obj.bound = false
+    obj.colli = false
+    obj.target = target
+    return obj
+end
+
+local function runFrames(n)
+    for _ = 1, n do
+        lstg.ObjFrame(2)
+        lstg.AfterFrame(2)
+    end
+end
+
+---@class test.Module.MotionProgram : test.Base
+local M = {}
+
+function M:onCreate()
+    lstg.ResetPool()
+    for _, commands in ipairs({
+        { { "jump" } },
+        { { "wait", 0 } },
+        { { "accel", -1, 10 } },
+        { { "loop", 1, 2 } },
+        { { "wait", 1 }, { "wait", 1 }, { "loop", 2, 2 }, { "loop", 1, 2 } },
+        { "wait" },
+    }) do
+        assert(not pcall(lstg.MotionProgram, commands))
+    end
+
+    local program = lstg.MotionProgram(program_commands)
+    assert(#program == #program_commands)
+
+    -- 与 frame 回调的结果对比
+    local target = newBullet(target_class)
+    target.x = 200
+    target.y = -100
+    local a = newBullet(lua_class, target)
+    local b = newBullet(motion_class, target)
+    lstg.SetMotion(b, program, target)
+    assert(lstg.GetMotion(b) == 1)
+    runFrames(1)
+    assert(lstg.GetMotion(b) == 2)
+    runFrames(99)
+    assert(lstg.GetMotion(b) == nil)
+    assert(math.abs(a.x - b.x) < 1e-6 and math.abs(a.y - b.y) < 1e-6)
+
+    -- 循环和卸载
+    local looping = lstg.MotionProgram({ { "speed", 1, 0 }, { "turn", 90, 1 }, { "loop", 2, 0 } })
+    local c = newBullet(motion_class)
+    lstg.SetMotion(c, looping)
+    runFrames(8)
+    assert(lstg.GetMotion(c) ~= nil)
+    assert(math.abs(c.x) < 1e-6 and math.abs(c.y) < 1e-6)
+    lstg.SetMotion(c, nil)
+    assert(lstg.GetMotion(c) == nil)
+    lstg.SetMotion(c, looping)
+    lstg.Del(c)
+    runFrames(1)
+    lstg.ResetPool()
+
+    -- 性能对比
+    local n = 2000
+    local stopwatch = lstg.StopWatch()
+    target = newBullet(target_class)
+    for _ = 1, n do
+        newBullet(lua_class, target)
+    end
+    stopwatch:Reset()
+    runFrames(90)
+    local t1 = stopwatch:GetElapsed()
+    lstg.ResetPool()
+    target = newBullet(target_class)
+    for _ = 1, n do
+        lstg.SetMotion(newBullet(motion_class), program, target)
+    end
+    stopwatch:Reset()
+    runFrames(90)
+    local t2 = stopwatch:GetElapsed()
+    lstg.ResetPool()
+    lstg.Print(string.format("运动程序：frame 回调 %.3fms，运动程序 %.3fms", t1 * 1000.0, t2 * 1000.0))
+end
+
+function M:onDestroy()
+    lstg.ResetPool()
+end
+
+function M:onUpdate()
+end
+
+function M:onRender()
+end
+
+test.registerTest("test.Module.MotionProgram", M)
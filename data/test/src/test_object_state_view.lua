@@ -0,0 +1,60 @@
+local test = require("test")
+
+local object_class = {
+    function() end,
+    function() end,
+    function() end,
+    lstg.DefaultRenderFunc,
+    function() end,
+    function() end;
+    is_class = true,
+}
+
+---@class test.Module.ObjectStateView : test.Base
+local M = {}
+
+function M:onCreate()
+    lstg.SetBound(0, window.width, 0, window.height)
+    lstg.ResetPool()
+    self.view, self.capacity, self.version = lstg.GetObjectStateView()
+    lstg.Print(string.format("对象状态视图测试：版本 %d，容量 %d", self.version, self.capacity))
+    -- 记录对象 id 和 uid，之后通过 uid 判断槽位是否已经被其他对象复用
+    self.tracked = {}
+    for _ = 1, 1000 do
+        local obj = lstg.New(object_class)
+        obj.x = math.random() * window.width
+        obj.y = math.random() * window.height
+        obj.bound = false
+        lstg.SetV(obj, 1, math.random() * 360, true)
+        local id = obj[2]
+        table.insert(self.tracked, { object = obj, id = id, uid = self.view[id].uid })
+    end
+end
+
+function M:onDestroy()
+    lstg.ResetPool()
+end
+
+function M:onUpdate()
+    lstg.AfterFrame(2) -- TODO: remove (2)
+    lstg.ObjFrame(2) -- TODO: remove (2)
+
+    local view = self.view
+    local alive = 0
+    for _, item in ipairs(self.tracked) do
+        local state = view[item.id]
+        if state.uid == item.uid and state.status == 1 then
+            alive = alive + 1
+            assert(state.x == item.object.x and state.y == item.object.y, "object state view position mismatch")
+            assert(math.abs(math.deg(state.rot) - item.object.rot) < 1e-6, "object state view rotation mismatch")
+        end
+    end
+    assert(alive == #self.tracked, "object state view status mismatch")
+end
+
+function M:onRender()
+    window:applyCameraV()
+    lstg.ObjRender()
+end
+
+test.registerTest("test.Module.ObjectStateView", M)
@@ -141,6 +141,45 @@ function M:onCreate()
     test_random_case("pcg32_fast")
     test_random_case("pcg64_oneseq")
     test_random_case("pcg64_fast")
+
+    -- 批量生成的结果必须与逐个调用 number 完全一致
+    local function test_bulk_case(name)
+        local random = require("random")
+        ---@class random.generator
+        local rng = random[name]()
+        rng:seed(114514)
+        local expected = {}
+        for i = 1, 1000 do
+            expected[i] = rng:number(-180, 180)
+        end
+        for i = 1001, 1100 do
+            expected[i] = rng:number()
+        end
+        for i = 1101, 1200 do
+            expected[i] = rng:number(8)
+        end
+
+        ---@class random.generator
+        local rng2 = random[name]()
+        rng2:seed(114514)
+        local values = rng2:fill({}, 1000, 180, -180)
+        local view, n = rng2:buffer(100)
+        assert(n == 100)
+        for i = 1, n do
+            values[1000 + i] = view[i - 1]
+        end
+        local tail = { rng2:numbers(100, 8) }
+        for i = 1, #tail do
+            values[1100 + i] = tail[i]
+        end
+        assert(#values == #expected)
+        for i = 1, #expected do
+            assert(values[i] == expected[i])
+        end
+    end
+    test_bulk_case("xoshiro256ss")
+    test_bulk_case("pcg32_fast")
+    test_bulk_case("sfc64")
 end
 
 function M:onDestroy()
@@ -0,0 +1,84 @@
+local test = require("test")
+
+local object_class = {
+    function() end,
+    function() end,
+    function() end,
+    lstg.DefaultRenderFunc,
+    function() end,
+    function() end;
+    is_class = true,
+}
+
+---@class test.Module.RenderQueue : test.Base
+local M = {}
+
+function M:onCreate()
+    self.timer = 0
+    self.mode = 0
+
+    local resource_collection = lstg.ResourceManager.getResourceCollection("global")
+    self.texture1 = resource_collection:createTextureFromFile("test:render_queue:tex:1", "res/block.png")
+    self.texture2 = resource_collection:createTextureFromFile("test:render_queue:tex:2", "res/block.png")
+    self.img1 = resource_collection:createSprite("test:render_queue:img:1", self.texture1, 0, 0, 128, 128)
+    self.img2 = resource_collection:createSprite("test:render_queue:img:2", self.texture2, 128, 0, 128, 128)
+    lstg.SetImageState("test:render_queue:img:2", "mul+add", lstg.Color(255, 255, 255, 255))
+
+    -- 同一图层内交替使用两种纹理与混合模式，且互不重叠，逐个渲染时每个对象都会打断合批
+    lstg.ResetPool()
+    local size = 24
+    for y = size / 2, window.height, size do
+        for x = size / 2, window.width, size do
+            local obj = lstg.New(object_class)
+            obj.x = x
+            obj.y = y
+            obj.layer = 0
+            obj.bound = false
+            obj.img = ((x + y) / size) % 2 < 1 and "test:render_queue:img:1" or "test:render_queue:img:2"
+            obj.hscale = 0.125
+            obj.vscale = 0.125
+        end
+    end
+    lstg.Print(string.format("渲染队列测试：%d 个对象", lstg.GetnObj()))
+end
+
+function M:onDestroy()
+    lstg.SetRenderQueue(false, 16, 1024, 0)
+    lstg.ResetPool()
+
+    local resource_collection = lstg.ResourceManager.getResourceCollection("global")
+    resource_collection:removeSprite(self.img1)
+    resource_collection:removeSprite(self.img2)
+    resource_collection:removeTexture(self.texture1)
+    resource_collection:removeTexture(self.texture2)
+end
+
+function M:onUpdate()
+    -- 每两秒切换一次（关闭、逐顶点绘制、实例化绘制、不重排的实例化绘制），便于在调试窗口中对比绘制耗时
+    if self.timer % 120 == 0 then
+        self.mode = (self.mode + 1) % 4
+        if self.mode == 0 then
+            lstg.SetRenderQueue(false, 16, 1024, 0)
+            lstg.Print("渲染队列：关闭")
+        elseif self.mode == 1 then
+            lstg.SetRenderQueue(true, 16, 128, 0) -- 降低并行阈值，让每个批次都走多线程生成顶点的路径
+            lstg.Print("渲染队列：开启，逐顶点绘制")
+        elseif self.mode == 2 then
+            lstg.SetRenderQueue(true, 16, 128, 16)
+            lstg.Print("渲染队列：开启，实例化绘制")
+        else
+            lstg.SetRenderQueue(false, 16, 1024, 16) -- 交替的纹理让连续的对象无法合批，用于确认不重排时顺序不变
+            lstg.Print("渲染队列：关闭重排，按原顺序实例化绘制")
+        end
+    end
+    self.timer = self.timer + 1
+    lstg.AfterFrame(2) -- TODO: remove (2)
+    lstg.ObjFrame(2) -- TODO: remove (2)
+end
+
+function M:onRender()
+    window:applyCameraV()
+    lstg.ObjRender()
+end
+
+test.registerTest("test.Module.RenderQueue", M)
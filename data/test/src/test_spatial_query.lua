@@ -0,0 +1,82 @@
+local test = require("test")
+
+local GROUP_ENEMY_BULLET = 2
+
+local object_class = {
+    function() end,
+    function() end,
+    function() end,
+    lstg.DefaultRenderFunc,
+    function() end,
+    function() end;
+    is_class = true,
+}
+
+--- 用 ObjList 遍历得到的结果，与空间查询的结果对比
+local function queryCircleSlow(group, x, y, r)
+    local result = {}
+    for _, obj in lstg.ObjList(group) do
+        if obj.status == "normal" and lstg.Dist(obj, x, y) <= r then
+            table.insert(result, obj)
+        end
+    end
+    return result
+end
+
+---@class test.Module.SpatialQuery : test.Base
+local M = {}
+
+function M:onCreate()
+    lstg.SetBound(0, window.width, 0, window.height)
+    lstg.ResetPool()
+    self.timer = 0
+    for _ = 1, 2000 do
+        local obj = lstg.New(object_class)
+        obj.x = math.random() * window.width
+        obj.y = math.random() * window.height
+        obj.group = GROUP_ENEMY_BULLET
+        obj.bound = false
+        obj.rect = false
+        obj.a = 4
+        obj.b = 4
+        lstg.SetV(obj, 0.5 + math.random(), math.random() * 360)
+    end
+end
+
+function M:onDestroy()
+    lstg.ResetPool()
+end
+
+function M:onUpdate()
+    self.timer = self.timer + 1
+    lstg.AfterFrame(2) -- TODO: remove (2)
+    lstg.ObjFrame(2) -- TODO: remove (2)
+
+    local cx, cy = window.width / 2, window.height / 2
+    local r = 64 + 32 * math.sin(self.timer / 30)
+    local fast = lstg.QueryCircle(GROUP_ENEMY_BULLET, cx, cy, r)
+    local slow = queryCircleSlow(GROUP_ENEMY_BULLET, cx, cy, r)
+    -- 两者都按创建顺序（uid）排列
+    assert(#fast == #slow, "QueryCircle count mismatch")
+    for i = 1, #fast do
+        assert(fast[i] == slow[i], "QueryCircle order mismatch")
+    end
+
+    local nearest, dist = lstg.QueryNearest(GROUP_ENEMY_BULLET, cx, cy)
+    if nearest then
+        assert(math.abs(lstg.Dist(nearest, cx, cy) - dist) < 1e-6, "QueryNearest distance mismatch")
+    end
+
+    if self.timer % 120 == 0 then
+        local n = lstg.KillInCircle(GROUP_ENEMY_BULLET, cx, cy, 128)
+        lstg.Print(string.format("空间查询测试：清除 %d 个对象", n))
+    end
+end
+
+function M:onRender()
+    window:applyCameraV()
+    lstg.ObjRender()
+    lstg.RenderGroupCollider(GROUP_ENEMY_BULLET, lstg.Color(128, 255, 0, 0))
+end
+
+test.registerTest("test.Module.SpatialQuery", M)
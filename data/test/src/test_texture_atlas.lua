@@ -0,0 +1,86 @@
+local test = require("test")
+
+local object_class = {
+    function() end,
+    function() end,
+    function() end,
+    lstg.DefaultRenderFunc,
+    function() end,
+    function() end;
+    is_class = true,
+}
+
+local texture_files = {
+    "res/block.png",
+    "res/image_1.png",
+    "res/mask_1.png",
+    "res/linear.png",
+}
+
+---@class test.Module.TextureAtlas : test.Base
+local M = {}
+
+function M:onCreate()
+    local resource_collection = lstg.ResourceManager.getResourceCollection("global")
+    self.textures = {}
+    self.sprites = {}
+    for i, path in ipairs(texture_files) do
+        local texture = resource_collection:createTextureFromFile("test:texture_atlas:tex:" .. i, path)
+        local width, height = texture:getWidth(), texture:getHeight()
+        table.insert(self.textures, texture)
+        table.insert(self.sprites, resource_collection:createSprite("test:texture_atlas:img:" .. i, texture, 0, 0, width, height))
+    end
+
+    -- 图片精灵创建以后再构建图集，已有的图片精灵也会改为引用图集页面
+    local count = resource_collection:buildTextureAtlas(self.textures, 2048, 2)
+    lstg.Print(string.format("纹理图集测试：%d 个纹理放入图集", count))
+
+    -- 构建图集以后修改中心点，坐标仍然是原纹理上的坐标，对象应该保持居中
+    for i, sprite in ipairs(self.sprites) do
+        local texture = self.textures[i]
+        sprite:setCenter(texture:getWidth() / 2, texture:getHeight() / 2)
+    end
+
+    -- 相邻对象使用不同的纹理，不使用图集时每个对象都会打断合批，可以在资源调试窗口中对比绘制命令数量
+    lstg.ResetPool()
+    local size = 32
+    local index = 0
+    for y = size / 2, window.height, size do
+        for x = size / 2, window.width, size do
+            local obj = lstg.New(object_class)
+            obj.x = x
+            obj.y = y
+            obj.layer = 0
+            obj.bound = false
+            obj.img = "test:texture_atlas:img:" .. (index % #texture_files + 1)
+            local texture = self.textures[index % #texture_files + 1]
+            obj.hscale = size / texture:getWidth()
+            obj.vscale = size / texture:getHeight()
+            index = index + 1
+        end
+    end
+end
+
+function M:onDestroy()
+    lstg.ResetPool()
+
+    local resource_collection = lstg.ResourceManager.getResourceCollection("global")
+    for _, sprite in ipairs(self.sprites) do
+        resource_collection:removeSprite(sprite)
+    end
+    for _, texture in ipairs(self.textures) do
+        resource_collection:removeTexture(texture)
+    end
+end
+
+function M:onUpdate()
+    lstg.AfterFrame(2) -- TODO: remove (2)
+    lstg.ObjFrame(2) -- TODO: remove (2)
+end
+
+function M:onRender()
+    window:applyCameraV()
+    lstg.ObjRender()
+end
+
+test.registerTest("test.Module.TextureAtlas", M)
@@ -0,0 +1,58 @@
+local test = require("test")
+
+local ITERATIONS = 1000000
+
+--- 测量 fn 执行 ITERATIONS 次调用的耗时
+local function benchmark(name, fn)
+    local stopwatch = lstg.StopWatch()
+    stopwatch:Reset()
+    fn(ITERATIONS)
+    local elapsed = stopwatch:GetElapsed()
+    lstg.Print(string.format("%s：%.3fms，%.2f M 次调用/秒", name, elapsed * 1000.0, ITERATIONS / elapsed / 1000000.0))
+end
+
+---@class test.Module.UserdataCheck : test.Base
+local M = {}
+
+function M:onCreate()
+    local random = require("random")
+    local color = lstg.Color(255, 128, 64, 32)
+    local rng = random.xoshiro256ss()
+    rng:seed(114514)
+    local mesh = lstg.MeshData(4, 6)
+
+    -- 类型检查失败时仍然给出与 luaL_checkudata 相同的错误信息
+    local argb = color.ARGB
+    assert(not pcall(argb, rng), "lstg.Color method accepted random.xoshiro256ss")
+    assert(not pcall(argb, {}), "lstg.Color method accepted table")
+    assert(not pcall(rng.number, color), "random.xoshiro256ss method accepted lstg.Color")
+    assert(not pcall(mesh.getVertexCount, color), "lstg.Mesh method accepted lstg.Color")
+
+    lstg.Print("========== userdata 类型检查 ==========")
+    benchmark("color:ARGB()", function(n)
+        for _ = 1, n do
+            local _, _, _, _ = color:ARGB()
+        end
+    end)
+    benchmark("rng:number()", function(n)
+        for _ = 1, n do
+            local _ = rng:number()
+        end
+    end)
+    benchmark("mesh:getVertexCount()", function(n)
+        for _ = 1, n do
+            local _ = mesh:getVertexCount()
+        end
+    end)
+end
+
+function M:onDestroy()
+end
+
+function M:onUpdate()
+end
+
+function M:onRender()
+end
+
+test.registerTest("test.Module.UserdataCheck", M)
@@ -0,0 +1,77 @@
+local test = require("test")
+
+---@class test.Module.UTF8Ex : test.Base
+local M = {}
+
+function M:onCreate()
+    local s = "A中文😀b"
+    assert(utf8ex.valid(s))
+    local ok, pos = utf8ex.valid("ab\255c")
+    assert(not ok and pos == 3)
+
+    assert(utf8ex.len(s) == 5)
+    assert(utf8ex.len("") == 0)
+    assert(utf8ex.len(s, 2) == 4)
+    assert(utf8ex.len(s, 2, 4) == 1)
+    local n, err = utf8ex.len(s, 3)
+    assert(n == nil and err == 3)
+
+    assert(utf8ex.offset(s, 1) == 1)
+    assert(utf8ex.offset(s, 2) == 2)
+    assert(utf8ex.offset(s, 4) == 8)
+    assert(utf8ex.offset(s, 6) == #s + 1)
+    assert(utf8ex.offset(s, 7) == nil)
+    assert(utf8ex.offset(s, -1) == #s)
+    assert(utf8ex.offset(s, 0) == nil)
+
+    assert(utf8ex.sub(s, 2, 3) == "中文")
+    assert(utf8ex.sub(s, 4) == "😀b")
+    assert(utf8ex.sub(s, -2) == "😀b")
+    assert(utf8ex.sub(s, -100, 1) == "A")
+    assert(utf8ex.sub(s, 3, 2) == "")
+    assert(utf8ex.sub(s, 6) == "")
+    assert(utf8ex.sub(s, 1, 100) == s)
+
+    -- 长字符串，覆盖按块跳过的路径
+    local long = string.rep("中a", 1000)
+    assert(utf8ex.len(long) == 2000)
+    assert(utf8ex.sub(long, 1001, 1004) == "中a中a")
+    assert(utf8ex.offset(long, 1001) == 2001)
+
+    -- 打字机效果：逐字截取，与逐字节循环相比
+    local text = string.rep("东方弹幕风 LuaSTG ", 200)
+    local count = utf8ex.len(text)
+    local stopwatch = lstg.StopWatch()
+    stopwatch:Reset()
+    for i = 1, count do
+        local _ = utf8ex.sub(text, 1, i)
+    end
+    local t1 = stopwatch:GetElapsed()
+    stopwatch:Reset()
+    for i = 1, count do
+        local bytes = 0
+        local chars = 0
+        while chars < i do
+            local c = text:byte(bytes + 1)
+            if c < 0x80 then bytes = bytes + 1
+            elseif c < 0xE0 then bytes = bytes + 2
+            elseif c < 0xF0 then bytes = bytes + 3
+            else bytes = bytes + 4 end
+            chars = chars + 1
+        end
+        local _ = text:sub(1, bytes)
+    end
+    local t2 = stopwatch:GetElapsed()
+    lstg.Print(string.format("utf8ex.sub：%.3fms，string.byte 循环：%.3fms", t1 * 1000.0, t2 * 1000.0))
+end
+
+function M:onDestroy()
+end
+
+function M:onUpdate()
+end
+
+function M:onRender()
+end
+
+test.registerTest("test.Module.UTF8Ex", M)
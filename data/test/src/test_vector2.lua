@@ -0,0 +1,91 @@
+local test = require("test")
+
+local function near(a, b)
+    return math.abs(a - b) < 1e-9
+end
+
+---@class test.Module.Vector2 : test.Base
+local M = {}
+
+function M:onCreate()
+    local v = lstg.Vector2(3, 4)
+    assert(v.x == 3 and v.y == 4)
+    assert(v:length() == 5)
+    local x, y = v:get()
+    assert(x == 3 and y == 4)
+    v.x = 1
+    assert(v.x == 1)
+    v:set(3, 4)
+
+    local w = lstg.Vector2(1, 2)
+    assert(v + w == lstg.Vector2(4, 6))
+    assert(v - w == lstg.Vector2(2, 2))
+    assert(v * 2 == lstg.Vector2(6, 8))
+    assert(2 * v == lstg.Vector2(6, 8))
+    assert(v / 2 == lstg.Vector2(1.5, 2))
+    assert(-v == lstg.Vector2(-3, -4))
+    assert(v + { x = 1, y = 1 } == lstg.Vector2(4, 5))
+    assert(v:dot(w) == 11)
+    assert(v:cross(w) == 2)
+    assert(v:distance(w) == math.sqrt(8))
+    assert(v.z == nil)
+    assert(not pcall(function() v.z = 1 end))
+
+    -- 原地修改并返回自身
+    local u = v:clone()
+    assert(u:add(w) == u and u == lstg.Vector2(4, 6))
+    u:sub(w):scale(0.5):addScaled(w, 2)
+    assert(u == lstg.Vector2(3.5, 6))
+    u:set(1, 0):rotate(90)
+    assert(near(u.x, 0) and near(u.y, 1))
+    assert(near(u:angle(), 90))
+    u:set(10, 0):normalize()
+    assert(u == lstg.Vector2(1, 0))
+    u:lerp(lstg.Vector2(3, 2), 0.5)
+    assert(u == lstg.Vector2(2, 1))
+
+    -- 贝塞尔曲线采样
+    local points = { lstg.Vector2(0, 0), lstg.Vector2(50, 100), lstg.Vector2(100, 0) }
+    local out = lstg.SampleBezier(points, 5)
+    assert(#out == 5)
+    assert(out[1] == lstg.Vector2(0, 0))
+    assert(out[3] == lstg.Vector2(50, 50))
+    assert(out[5] == lstg.Vector2(100, 0))
+    local first = out[1]
+    assert(lstg.SampleBezier(points, 3, out) == out)
+    assert(#out == 3 and out[1] == first and out[2] == lstg.Vector2(50, 50))
+
+    -- 与表实现的对比
+    local n = 200000
+    local stopwatch = lstg.StopWatch()
+    stopwatch:Reset()
+    local p = lstg.Vector2(0, 0)
+    local d = lstg.Vector2(1, 0)
+    for _ = 1, n do
+        p:addScaled(d, 0.5)
+        d:rotate(1)
+    end
+    local t1 = stopwatch:GetElapsed()
+    stopwatch:Reset()
+    local q = { x = 0, y = 0 }
+    local e = { x = 1, y = 0 }
+    local c, s = math.cos(math.rad(1)), math.sin(math.rad(1))
+    for _ = 1, n do
+        q = { x = q.x + e.x * 0.5, y = q.y + e.y * 0.5 }
+        e = { x = e.x * c - e.y * s, y = e.x * s + e.y * c }
+    end
+    local t2 = stopwatch:GetElapsed()
+    assert(math.abs(p.x - q.x) < 1e-6 and math.abs(p.y - q.y) < 1e-6)
+    lstg.Print(string.format("lstg.Vector2：%.3fms，table：%.3fms", t1 * 1000.0, t2 * 1000.0))
+end
+
+function M:onDestroy()
+end
+
+function M:onUpdate()
+end
+
+function M:onRender()
+end
+
+test.registerTest("test.Module.Vector2", M)
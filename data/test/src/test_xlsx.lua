@@ -0,0 +1,185 @@
+local test = require("test")
+
+local function deepEqual(a, b)
+    if type(a) ~= type(b) then
+        return false
+    end
+    if type(a) ~= "table" then
+        return a == b
+    end
+    for k, v in pairs(a) do
+        if not deepEqual(v, b[k]) then
+            return false
+        end
+    end
+    for k in pairs(b) do
+        if a[k] == nil then
+            return false
+        end
+    end
+    return true
+end
+
+local crc32_table = {}
+for i = 0, 255 do
+    local c = i
+    for _ = 1, 8 do
+        if bit.band(c, 1) ~= 0 then
+            c = bit.bxor(bit.rshift(c, 1), 0xEDB88320)
+        else
+            c = bit.rshift(c, 1)
+        end
+    end
+    crc32_table[i] = c
+end
+
+---@param s string
+---@return integer
+local function crc32(s)
+    local c = 0xFFFFFFFF
+    for i = 1, #s do
+        c = bit.bxor(crc32_table[bit.band(bit.bxor(c, s:byte(i)), 0xFF)], bit.rshift(c, 8))
+    end
+    return bit.bnot(c)
+end
+
+local function u16(v)
+    return string.char(bit.band(v, 0xFF), bit.band(bit.rshift(v, 8), 0xFF))
+end
+
+local function u32(v)
+    return u16(bit.band(v, 0xFFFF)) .. u16(bit.band(bit.rshift(v, 16), 0xFFFF))
+end
+
+--- 生成不压缩 (stored) 的 zip 压缩包
+---@param files { [1]: string, [2]: string }[] 文件名、内容
+---@return string
+local function makeZip(files)
+    local body = {}
+    local central = {}
+    local offset = 0
+    for _, file in ipairs(files) do
+        local name, data = file[1], file[2]
+        local crc = crc32(data)
+        local common = u16(20) .. u16(0) .. u16(0) .. u16(0) .. u16(0x21)
+            .. u32(crc) .. u32(#data) .. u32(#data) .. u16(#name) .. u16(0)
+        local head = u32(0x04034B50) .. common .. name
+        table.insert(body, head)
+        table.insert(body, data)
+        table.insert(central, u32(0x02014B50) .. u16(20) .. common
+            .. u16(0) .. u16(0) .. u16(0) .. u32(0) .. u32(offset) .. name)
+        offset = offset + #head + #data
+    end
+    local directory = table.concat(central)
+    return table.concat(body) .. directory .. u32(0x06054B50) .. u16(0) .. u16(0)
+        .. u16(#files) .. u16(#files) .. u32(#directory) .. u32(offset) .. u16(0)
+end
+
+local XML_HEAD = '<?xml version="1.0" encoding="UTF-8" standalone="yes"?>'
+
+---@param sheets { [1]: string, [2]: string }[] 工作表名称、sheetData 内容
+---@param shared string[]?
+---@return string
+local function makeWorkbook(sheets, shared)
+    local workbook = { XML_HEAD, '<workbook xmlns:r="http://schemas.openxmlformats.org/officeDocument/2006/relationships"><sheets>' }
+    local rels = { XML_HEAD, "<Relationships>" }
+    local files = {}
+    for i, sheet in ipairs(sheets) do
+        table.insert(workbook, string.format('<sheet name="%s" sheetId="%d" r:id="rId%d"/>', sheet[1], i, i))
+        table.insert(rels, string.format('<Relationship Id="rId%d" Target="worksheets/sheet%d.xml"/>', i, i))
+        table.insert(files, { string.format("xl/worksheets/sheet%d.xml", i), XML_HEAD .. "<worksheet><sheetData>" .. sheet[2] .. "</sheetData></worksheet>" })
+    end
+    table.insert(workbook, "</sheets></workbook>")
+    table.insert(rels, "</Relationships>")
+    table.insert(files, { "xl/workbook.xml", table.concat(workbook) })
+    table.insert(files, { "xl/_rels/workbook.xml.rels", table.concat(rels) })
+    if shared then
+        local sst = { XML_HEAD, "<sst>" }
+        for _, s in ipairs(shared) do
+            table.insert(sst, "<si><t>" .. s .. "</t></si>")
+        end
+        table.insert(sst, "</sst>")
+        table.insert(files, { "xl/sharedStrings.xml", table.concat(sst) })
+    end
+    return makeZip(files)
+end
+
+---@class test.Module.XLSX : test.Base
+local M = {}
+
+function M:onCreate()
+    local source = makeWorkbook({
+        { "enemy", table.concat({
+            '<row r="1"><c r="A1" t="s"><v>0</v></c><c r="B1" t="s"><v>1</v></c><c r="C1"><v>1.5</v></c></row>',
+            -- B2 缺失，补空字符串；E2 是布尔值
+            '<row r="2"><c r="A2"><v>2</v></c><c r="C2" t="inlineStr"><is><t>a &lt; b</t></is></c><c r="D2" t="str"><f>X</f><v>text</v></c><c r="E2" t="b"><v>1</v></c></row>',
+            '<row r="3"><c r="A3" t="b"><v>0</v></c></row>',
+        }) },
+        { "config", '<row r="1"><c r="A1" t="s"><v>2</v></c><c r="B1"><v>60</v></c></row>' },
+    }, { "name", "fairy &amp; bullet", "<![CDATA[<fps>]]>" })
+
+    local expected = {
+        enemy = {
+            { "name", "fairy & bullet", "1.5", "", "" },
+            { "2", "", "a < b", "text", "true" },
+            { "false", "", "", "", "" },
+        },
+        config = {
+            { "<fps>", "60" },
+        },
+    }
+    assert(deepEqual(xlsx.decode(source), expected))
+    assert(deepEqual(xlsx.decode(source, "config"), { config = expected.config }))
+    assert(deepEqual(xlsx.decode(source, { "enemy" }), { enemy = expected.enemy }))
+    assert(deepEqual(xlsx.decode(source, "missing"), {}))
+
+    local wb = xlsx.open(source)
+    assert(wb ~= nil)
+    assert(deepEqual(wb:names(), { "enemy", "config" }))
+    assert(deepEqual(wb:sheet("config"), expected.config))
+    assert(deepEqual(wb:sheet("enemy"), expected.enemy))
+    assert(wb:sheet("missing") == nil)
+
+    -- 只有数字的工作簿没有共享字符串表
+    assert(deepEqual(xlsx.decode(makeWorkbook({ { "n", '<row r="1"><c r="A1"><v>1</v></c></row>' } })), { n = { { "1" } } }))
+    -- 不是 zip 压缩包
+    assert(xlsx.decode("not a zip") == nil)
+    assert(xlsx.open("not a zip") == nil)
+
+    -- 5 万行的工作簿，比较解析全部工作表和按需解析单个工作表的耗时
+    local rows = {}
+    for r = 1, 50000 do
+        rows[r] = string.format('<row r="%d"><c r="A%d"><v>%d</v></c><c r="B%d" t="s"><v>%d</v></c><c r="C%d" t="b"><v>%d</v></c><c r="D%d" t="inlineStr"><is><t>wave %d</t></is></c></row>',
+            r, r, r, r, r % 1000, r, r % 2, r, r)
+    end
+    local shared = {}
+    for i = 1, 1000 do
+        shared[i] = "enemy &amp; bullet " .. (i - 1)
+    end
+    local big = makeWorkbook({
+        { "timeline", table.concat(rows) },
+        { "config", '<row r="1"><c r="A1" t="s"><v>0</v></c><c r="B1"><v>60</v></c></row>' },
+    }, shared)
+    local stopwatch = lstg.StopWatch()
+    stopwatch:Reset()
+    local all = xlsx.decode(big)
+    local t1 = stopwatch:GetElapsed()
+    stopwatch:Reset()
+    local config = xlsx.open(big):sheet("config")
+    local t2 = stopwatch:GetElapsed()
+    assert(#all.timeline == 50000 and #all.timeline[1] == 4)
+    assert(deepEqual(all.timeline[50000], { "50000", "enemy & bullet 0", "false", "wave 50000" }))
+    assert(deepEqual(config, { { "enemy & bullet 0", "60" } }))
+    lstg.Print(string.format("xlsx.decode 全部工作表：%.3fms，xlsx.open + sheet('config')：%.3fms", t1 * 1000.0, t2 * 1000.0))
+end
+
+function M:onDestroy()
+end
+
+function M:onUpdate()
+end
+
+function M:onRender()
+end
+
+test.registerTest("test.Module.XLSX", M)
@@ -210,6 +210,36 @@ namespace core {
 					assert_type_is_boolean(single_instance, "/application/single_instance"sv);
 					loader.application.setSingleInstance(single_instance.get<bool>());
 				}
+				if (application.contains("headless"sv)) {
+					auto const& headless = application.at("headless"sv);
+					assert_type_is_boolean(headless, "/application/headless"sv);
+					loader.application.setHeadless(headless.get<bool>());
+				}
+			}
+
+			if (root.contains("benchmark"sv)) {
+				auto const& benchmark = root.at("benchmark"sv);
+				assert_type_is_object(benchmark, "/benchmark"sv);
+				if (benchmark.contains("frames"sv)) {
+					auto const& frames = benchmark.at("frames"sv);
+					assert_type_is_unsigned_integer(frames, "/benchmark/frames"sv);
+					loader.benchmark.setFrames(frames.get<uint32_t>());
+				}
+				if (benchmark.contains("input"sv)) {
+					auto const& input = benchmark.at("input"sv);
+					assert_type_is_string(input, "/benchmark/input"sv);
+					loader.benchmark.setInput(input.get_ref<std::string const&>());
+				}
+				if (benchmark.contains("output"sv)) {
+					auto const& output = benchmark.at("output"sv);
+					assert_type_is_string(output, "/benchmark/output"sv);
+					loader.benchmark.setOutput(output.get_ref<std::string const&>());
+				}
+				if (benchmark.contains("record"sv)) {
+					auto const& record = benchmark.at("record"sv);
+					assert_type_is_string(record, "/benchmark/record"sv);
+					loader.benchmark.setRecord(record.get_ref<std::string const&>());
+				}
 			}
 
 			if (root.contains("logging"sv)) {
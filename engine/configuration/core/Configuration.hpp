@@ -33,9 +33,24 @@ namespace core {
 		public:
 			GetterSetterString(Application, uuid, Uuid);
 			GetterSetterBoolean(Application, single_instance, SingleInstance);
+			GetterSetterBoolean(Application, headless, Headless);
 		private:
 			std::string uuid;
 			bool single_instance{ false };
+			bool headless{ false }; // 无界面模式：不显示窗口、不输出画面和声音、不限制帧率
+		};
+		class Benchmark {
+		public:
+			GetterSetterPrimitive(Benchmark, uint32_t, frames, Frames);
+			GetterSetterString(Benchmark, input, Input);
+			GetterSetterString(Benchmark, output, Output);
+			GetterSetterString(Benchmark, record, Record);
+			inline bool isEnable() const noexcept { return frames > 0; }
+		private:
+			uint32_t frames{}; // 大于 0 时以无界面模式运行指定帧数，结束后输出报告并退出
+			std::string input; // 回放的输入记录文件
+			std::string output; // 报告输出路径
+			std::string record; // 录制输入记录文件，用于正常运行时录制
 		};
 		class Logging {
 			friend class ConfigurationLoader;
@@ -178,6 +193,7 @@ namespace core {
 		std::string getFormattedMessage();
 		inline Debug const& getDebug() const noexcept { return debug; }
 		inline Application const& getApplication() const noexcept { return application; }
+		inline Benchmark const& getBenchmark() const noexcept { return benchmark; }
 		inline Logging const& getLogging() const noexcept { return logging; }
 		inline FileSystem const& getFileSystem() const noexcept { return file_system; }
 		inline Timing const& getTiming() const noexcept { return timing; }
@@ -198,6 +214,7 @@ namespace core {
 		std::vector<std::string> messages;
 		Debug debug;
 		Application application;
+		Benchmark benchmark;
 		Logging logging;
 		FileSystem file_system;
 		Timing timing;
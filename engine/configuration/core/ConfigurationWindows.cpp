@@ -118,6 +118,40 @@ namespace core {
 				}										\
 			}
 
+			access_parent_field(application,
+				{
+					access_field(headless,
+						if (auto const value = to_boolean(arg); value) {
+							application.setHeadless(value.value());
+						}
+						else {
+							write_arg_error(raw_arg);
+							return false;
+						});
+				});
+			access_parent_field(benchmark,
+				{
+					access_field(frames,
+						if (auto const value = to_unsigned_integer<uint32_t>(arg); value) {
+							benchmark.setFrames(value.value());
+						}
+						else {
+							write_arg_error(raw_arg);
+							return false;
+						});
+					access_field(input,
+						if (!arg.empty()) {
+							benchmark.setInput(arg);
+						});
+					access_field(output,
+						if (!arg.empty()) {
+							benchmark.setOutput(arg);
+						});
+					access_field(record,
+						if (!arg.empty()) {
+							benchmark.setRecord(arg);
+						});
+				});
 			access_parent_field(graphics_system,
 				{
 					access_field(preferred_device_name,
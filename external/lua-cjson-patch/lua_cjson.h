@@ -2,3 +2,4 @@
 #include "lua.h"
 
 int luaopen_cjson(lua_State* L);
+int luaopen_cjson_ext(lua_State* L);
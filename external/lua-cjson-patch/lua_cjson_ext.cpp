@@ -0,0 +1,676 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <charconv>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "lua.hpp"
+extern "C" {
+#include "lua_cjson.h"
+}
+
+// cjson 扩展：预先统计容器大小的解码、可复用缓冲区的编码器、流式写入文件
+// 行为与 cjson 的默认配置一致：数字精度 14 位，转义正斜杠，空表编码为对象，
+// 禁止 NaN 和 Infinity，稀疏数组（超过 10 个元素且空洞超过一半）报错，最大嵌套深度 1000
+
+namespace cjson_ext
+{
+    constexpr int max_depth = 1000;
+    constexpr int number_precision = 14;
+    constexpr int sparse_ratio = 2;
+    constexpr int sparse_safe = 10;
+    constexpr size_t flush_size = 64 * 1024;
+
+    // ==================== decode ====================
+
+    class decoder
+    {
+    private:
+        lua_State* L;
+        const char* _begin;
+        const char* _p;
+        const char* _end;
+        std::vector<uint32_t> _counts; // 按出现顺序记录每个容器的元素数量
+        size_t _next_count = 0;
+        std::string _scratch;
+        int _depth = 0;
+    private:
+        static bool is_space(char c) {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+        void skip_space() {
+            while (_p < _end && is_space(*_p)) _p++;
+        }
+        [[noreturn]] void error(const char* expected, const char* found) {
+            luaL_error(L, "Expected %s but found %s at character %d", expected, found, (int)(_p - _begin) + 1);
+            std::abort(); // unreachable
+        }
+        uint32_t next_count() {
+            return _next_count < _counts.size() ? _counts[_next_count++] : 0;
+        }
+
+        // 第一遍扫描：只识别字符串、括号和逗号，统计每个容器的元素数量
+        // 结果只作为 lua_createtable 的提示，格式错误由第二遍解析负责报告
+        void count() {
+            std::vector<uint32_t> stack;
+            bool first = false;
+            for (const char* p = _begin; p < _end; p++) {
+                const char c = *p;
+                if (is_space(c)) {
+                    continue;
+                }
+                if (first) {
+                    first = false;
+                    if (c != ']' && c != '}') {
+                        _counts[stack.back()] = 1;
+                    }
+                }
+                switch (c) {
+                case '"':
+                    for (p++; p < _end && *p != '"'; p++) {
+                        if (*p == '\\') p++;
+                    }
+                    break;
+                case '[':
+                case '{':
+                    stack.push_back((uint32_t)_counts.size());
+                    _counts.push_back(0);
+                    first = true;
+                    break;
+                case ']':
+                case '}':
+                    if (!stack.empty()) stack.pop_back();
+                    break;
+                case ',':
+                    if (!stack.empty()) _counts[stack.back()]++;
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+        static int hex_value(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+        bool read_hex4(const char* p, uint32_t& value) {
+            if (_end - p < 4) return false;
+            value = 0;
+            for (int i = 0; i < 4; i++) {
+                const int v = hex_value(p[i]);
+                if (v < 0) return false;
+                value = (value << 4) | (uint32_t)v;
+            }
+            return true;
+        }
+        static void append_utf8(std::string& out, uint32_t c) {
+            if (c < 0x80) {
+                out.push_back((char)c);
+            }
+            else if (c < 0x800) {
+                out.push_back((char)(0xC0 | (c >> 6)));
+                out.push_back((char)(0x80 | (c & 0x3F)));
+            }
+            else if (c < 0x10000) {
+                out.push_back((char)(0xE0 | (c >> 12)));
+                out.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+                out.push_back((char)(0x80 | (c & 0x3F)));
+            }
+            else {
+                out.push_back((char)(0xF0 | (c >> 18)));
+                out.push_back((char)(0x80 | ((c >> 12) & 0x3F)));
+                out.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+                out.push_back((char)(0x80 | (c & 0x3F)));
+            }
+        }
+
+        // 压入字符串，没有转义字符时直接引用源数据
+        void push_string() {
+            _p++; // "
+            const char* begin = _p;
+            while (_p < _end && *_p != '"' && *_p != '\\') _p++;
+            if (_p < _end && *_p == '"') {
+                lua_pushlstring(L, begin, (size_t)(_p - begin));
+                _p++;
+                return;
+            }
+            _scratch.assign(begin, (size_t)(_p - begin));
+            while (_p < _end && *_p != '"') {
+                if (*_p != '\\') {
+                    _scratch.push_back(*_p++);
+                    continue;
+                }
+                if (_end - _p < 2) {
+                    break;
+                }
+                const char c = _p[1];
+                _p += 2;
+                switch (c) {
+                case '"': _scratch.push_back('"'); break;
+                case '\\': _scratch.push_back('\\'); break;
+                case '/': _scratch.push_back('/'); break;
+                case 'b': _scratch.push_back('\b'); break;
+                case 'f': _scratch.push_back('\f'); break;
+                case 'n': _scratch.push_back('\n'); break;
+                case 'r': _scratch.push_back('\r'); break;
+                case 't': _scratch.push_back('\t'); break;
+                case 'u': {
+                    uint32_t code = 0;
+                    if (!read_hex4(_p, code)) {
+                        error("value", "invalid unicode escape code");
+                    }
+                    _p += 4;
+                    if (code >= 0xD800 && code <= 0xDBFF) {
+                        // 代理对
+                        uint32_t low = 0;
+                        if (_end - _p < 6 || _p[0] != '\\' || _p[1] != 'u' || !read_hex4(_p + 2, low) || low < 0xDC00 || low > 0xDFFF) {
+                            error("value", "invalid unicode escape code");
+                        }
+                        _p += 6;
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    else if (code >= 0xDC00 && code <= 0xDFFF) {
+                        error("value", "invalid unicode escape code");
+                    }
+                    append_utf8(_scratch, code);
+                    break;
+                }
+                default:
+                    error("value", "invalid escape code");
+                }
+            }
+            if (_p >= _end) {
+                error("value", "unexpected end of string");
+            }
+            _p++; // "
+            lua_pushlstring(L, _scratch.data(), _scratch.size());
+        }
+
+        // JSON 数字语法：-?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+        void push_number() {
+            const char* begin = _p;
+            const char* p = _p;
+            auto digits = [&]() -> bool {
+                const char* d = p;
+                while (p < _end && *p >= '0' && *p <= '9') p++;
+                return p != d;
+            };
+            if (p < _end && *p == '-') p++;
+            if (p < _end && *p == '0') {
+                p++;
+            }
+            else if (!digits()) {
+                error("value", "invalid number");
+            }
+            if (p < _end && *p == '.') {
+                p++;
+                if (!digits()) error("value", "invalid number");
+            }
+            if (p < _end && (*p == 'e' || *p == 'E')) {
+                p++;
+                if (p < _end && (*p == '+' || *p == '-')) p++;
+                if (!digits()) error("value", "invalid number");
+            }
+            double value = 0.0;
+            const auto result = std::from_chars(begin, p, value);
+            if (result.ec == std::errc::result_out_of_range) {
+                value = std::strtod(std::string(begin, p).c_str(), nullptr); // 与 cjson 一样得到 ±HUGE_VAL 或 0
+            }
+            else if (result.ec != std::errc()) {
+                error("value", "invalid number");
+            }
+            _p = p;
+            lua_pushnumber(L, value);
+        }
+
+        bool match_literal(std::string_view literal) {
+            if ((size_t)(_end - _p) >= literal.size() && std::memcmp(_p, literal.data(), literal.size()) == 0) {
+                _p += literal.size();
+                return true;
+            }
+            return false;
+        }
+
+        void enter() {
+            _depth++;
+            if (_depth > max_depth || !lua_checkstack(L, 3)) {
+                luaL_error(L, "Found too many nested data structures (%d) at character %d", _depth, (int)(_p - _begin) + 1);
+            }
+        }
+
+        void push_array() {
+            enter();
+            lua_createtable(L, (int)next_count(), 0);                   // ... t
+            _p++; // [
+            skip_space();
+            if (_p < _end && *_p == ']') {
+                _p++;
+                _depth--;
+                return;
+            }
+            for (int i = 1;; i++) {
+                push_value();                                           // ... t v
+                lua_rawseti(L, -2, i);                                  // ... t
+                skip_space();
+                if (_p < _end && *_p == ',') {
+                    _p++;
+                }
+                else if (_p < _end && *_p == ']') {
+                    _p++;
+                    break;
+                }
+                else {
+                    error("comma or array end", _p < _end ? "invalid token" : "T_END");
+                }
+            }
+            _depth--;
+        }
+
+        void push_object() {
+            enter();
+            lua_createtable(L, 0, (int)next_count());                   // ... t
+            _p++; // {
+            skip_space();
+            if (_p < _end && *_p == '}') {
+                _p++;
+                _depth--;
+                return;
+            }
+            for (;;) {
+                skip_space();
+                if (_p >= _end || *_p != '"') {
+                    error("object key string", _p < _end ? "invalid token" : "T_END");
+                }
+                push_string();                                          // ... t k
+                skip_space();
+                if (_p >= _end || *_p != ':') {
+                    error("colon", _p < _end ? "invalid token" : "T_END");
+                }
+                _p++;
+                push_value();                                           // ... t k v
+                lua_rawset(L, -3);                                      // ... t
+                skip_space();
+                if (_p < _end && *_p == ',') {
+                    _p++;
+                }
+                else if (_p < _end && *_p == '}') {
+                    _p++;
+                    break;
+                }
+                else {
+                    error("comma or object end", _p < _end ? "invalid token" : "T_END");
+                }
+            }
+            _depth--;
+        }
+
+        void push_value() {
+            skip_space();
+            if (_p >= _end) {
+                error("value", "T_END");
+            }
+            switch (*_p) {
+            case '{': push_object(); return;
+            case '[': push_array(); return;
+            case '"': push_string(); return;
+            case 't':
+                if (match_literal("true")) { lua_pushboolean(L, 1); return; }
+                break;
+            case 'f':
+                if (match_literal("false")) { lua_pushboolean(L, 0); return; }
+                break;
+            case 'n':
+                if (match_literal("null")) { lua_pushlightuserdata(L, nullptr); return; } // cjson.null
+                break;
+            default:
+                if (*_p == '-' || (*_p >= '0' && *_p <= '9')) { push_number(); return; }
+                break;
+            }
+            error("value", "invalid token");
+        }
+    public:
+        decoder(lua_State* state, const char* data, size_t size) : L(state), _begin(data), _p(data), _end(data + size) {}
+
+        void decode() {
+            count();
+            push_value();
+            skip_space();
+            if (_p < _end) {
+                error("the end", "invalid token");
+            }
+        }
+    };
+
+    // ==================== encode ====================
+
+    struct encoder
+    {
+        std::string buffer;
+        std::FILE* file = nullptr; // 流式写入的目标，缓冲区超过 flush_size 时写出
+        bool write_failed = false;
+        // cjson 模块中的特殊值
+        int array_mt = LUA_NOREF;
+        int empty_array_mt = LUA_NOREF;
+        void* empty_array = nullptr;
+
+        void flush() {
+            if (file != nullptr && !buffer.empty()) {
+                if (std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+                    write_failed = true;
+                }
+                buffer.clear();
+            }
+        }
+        void try_flush() {
+            if (file != nullptr && buffer.size() >= flush_size) {
+                flush();
+            }
+        }
+
+        void append_number(lua_State* L, double value) {
+            if (value != value || value == HUGE_VAL || value == -HUGE_VAL) {
+                luaL_error(L, "Cannot serialise number: must not be NaN or Infinity");
+            }
+            char temp[64];
+            const auto result = std::to_chars(temp, temp + sizeof(temp), value, std::chars_format::general, number_precision);
+            buffer.append(temp, result.ptr);
+        }
+
+        void append_string(std::string_view s) {
+            buffer.push_back('"');
+            size_t i = 0;
+            for (size_t j = 0; j < s.size(); j++) {
+                const unsigned char c = (unsigned char)s[j];
+                const char* escape = nullptr;
+                char temp[8];
+                if (c < 0x20) {
+                    switch (c) {
+                    case '\b': escape = "\\b"; break;
+                    case '\f': escape = "\\f"; break;
+                    case '\n': escape = "\\n"; break;
+                    case '\r': escape = "\\r"; break;
+                    case '\t': escape = "\\t"; break;
+                    default:
+                        std::snprintf(temp, sizeof(temp), "\\u%04x", (unsigned)c);
+                        escape = temp;
+                        break;
+                    }
+                }
+                else if (c == '"') escape = "\\\"";
+                else if (c == '\\') escape = "\\\\";
+                else if (c == '/') escape = "\\/";
+                if (escape != nullptr) {
+                    buffer.append(s.data() + i, j - i);
+                    buffer.append(escape);
+                    i = j + 1;
+                }
+            }
+            buffer.append(s.data() + i, s.size() - i);
+            buffer.push_back('"');
+        }
+
+        // 与 cjson 相同的数组判断，返回 -1 表示不是数组
+        int array_length(lua_State* L, int index) {
+            double max = 0.0;
+            int items = 0;
+            lua_pushnil(L);                                             // ... k
+            while (lua_next(L, index) != 0) {                           // ... k v
+                lua_pop(L, 1);                                          // ... k
+                if (lua_type(L, -1) == LUA_TNUMBER) {
+                    const double k = lua_tonumber(L, -1);
+                    if (std::floor(k) == k && k >= 1.0) {
+                        if (k > max) max = k;
+                        items++;
+                        continue;
+                    }
+                }
+                lua_pop(L, 1);                                          // ...
+                return -1;
+            }
+            if (max > (double)(items * sparse_ratio) && max > (double)sparse_safe) {
+                luaL_error(L, "Cannot serialise table: excessively sparse array");
+            }
+            return (int)max;
+        }
+
+        bool has_metatable(lua_State* L, int index, int ref) {
+            if (ref == LUA_NOREF || !lua_getmetatable(L, index)) {
+                return false;
+            }
+            lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+            const bool result = lua_rawequal(L, -1, -2);
+            lua_pop(L, 2);
+            return result;
+        }
+
+        void append_array(lua_State* L, int index, int length, int depth) {
+            buffer.push_back('[');
+            for (int i = 1; i <= length; i++) {
+                if (i > 1) buffer.push_back(',');
+                lua_rawgeti(L, index, i);                               // ... v
+                append_value(L, depth);
+                lua_pop(L, 1);                                          // ...
+                try_flush();
+            }
+            buffer.push_back(']');
+        }
+
+        void append_object(lua_State* L, int index, int depth) {
+            buffer.push_back('{');
+            bool comma = false;
+            lua_pushnil(L);                                             // ... k
+            while (lua_next(L, index) != 0) {                           // ... k v
+                if (comma) buffer.push_back(',');
+                comma = true;
+                const int key_type = lua_type(L, -2);
+                if (key_type == LUA_TSTRING) {
+                    size_t len = 0;
+                    const char* key = lua_tolstring(L, -2, &len);
+                    append_string(std::string_view(key, len));
+                }
+                else if (key_type == LUA_TNUMBER) {
+                    buffer.push_back('"');
+                    append_number(L, lua_tonumber(L, -2));
+                    buffer.push_back('"');
+                }
+                else {
+                    luaL_error(L, "Cannot serialise %s: table key must be a number or string", lua_typename(L, key_type));
+                }
+                buffer.push_back(':');
+                append_value(L, depth);
+                lua_pop(L, 1);                                          // ... k
+                try_flush();
+            }
+            buffer.push_back('}');
+        }
+
+        // 编码栈顶的值
+        void append_value(lua_State* L, int depth) {
+            const int index = lua_gettop(L);
+            switch (lua_type(L, index)) {
+            case LUA_TSTRING: {
+                size_t len = 0;
+                const char* s = lua_tolstring(L, index, &len);
+                append_string(std::string_view(s, len));
+                break;
+            }
+            case LUA_TNUMBER:
+                append_number(L, lua_tonumber(L, index));
+                break;
+            case LUA_TBOOLEAN:
+                buffer.append(lua_toboolean(L, index) ? "true" : "false");
+                break;
+            case LUA_TNIL:
+                buffer.append("null");
+                break;
+            case LUA_TLIGHTUSERDATA: {
+                void* p = lua_touserdata(L, index);
+                if (p == nullptr) {
+                    buffer.append("null"); // cjson.null
+                    break;
+                }
+                if (p == empty_array && empty_array != nullptr) {
+                    buffer.append("[]");
+                    break;
+                }
+                luaL_error(L, "Cannot serialise %s: type not supported", lua_typename(L, LUA_TLIGHTUSERDATA));
+                break;
+            }
+            case LUA_TTABLE: {
+                depth++;
+                if (depth > max_depth || !lua_checkstack(L, 3)) {
+                    luaL_error(L, "Cannot serialise, excessive nesting (%d)", depth);
+                }
+                if (has_metatable(L, index, array_mt)) {
+                    append_array(L, index, (int)lua_objlen(L, index), depth);
+                    break;
+                }
+                const int length = array_length(L, index);
+                if (length > 0) {
+                    append_array(L, index, length, depth);
+                }
+                else if (length == 0 && has_metatable(L, index, empty_array_mt)) {
+                    buffer.append("[]");
+                }
+                else {
+                    append_object(L, index, depth);
+                }
+                break;
+            }
+            default:
+                luaL_error(L, "Cannot serialise %s: type not supported", luaL_typename(L, index));
+                break;
+            }
+        }
+    };
+
+    static const char* const encoder_name = "cjson.encoder";
+
+    static encoder* check_encoder(lua_State* L, int index) {
+        return (encoder*)luaL_checkudata(L, index, encoder_name);
+    }
+
+    // cjson.decode_presized(text) -> value
+    static int lua_decode_presized(lua_State* L) {
+        size_t size = 0;
+        const char* text = luaL_checklstring(L, 1, &size);
+        lua_settop(L, 1);
+        decoder(L, text, size).decode();
+        return 1;
+    }
+
+    // cjson.encoder() -> encoder
+    static int lua_encoder_create(lua_State* L) {
+        auto* self = (encoder*)lua_newuserdata(L, sizeof(encoder));    // ... self
+        new(self) encoder();
+        luaL_getmetatable(L, encoder_name);                             // ... self mt
+        lua_setmetatable(L, -2);                                        // ... self
+        // 读取 cjson 模块中的特殊值
+        lua_getfield(L, lua_upvalueindex(1), "empty_array");            // ... self empty_array
+        self->empty_array = lua_touserdata(L, -1);
+        lua_getfield(L, lua_upvalueindex(1), "array_mt");               // ... self empty_array array_mt
+        self->array_mt = lua_istable(L, -1) ? luaL_ref(L, LUA_REGISTRYINDEX) : (lua_pop(L, 1), LUA_NOREF); // ... self empty_array
+        lua_getfield(L, lua_upvalueindex(1), "empty_array_mt");         // ... self empty_array empty_array_mt
+        self->empty_array_mt = lua_istable(L, -1) ? luaL_ref(L, LUA_REGISTRYINDEX) : (lua_pop(L, 1), LUA_NOREF); // ... self empty_array
+        lua_pop(L, 1);                                                  // ... self
+        return 1;
+    }
+
+    // encoder:encode(value) -> string
+    // 缓冲区在多次调用之间复用，不会重复分配
+    static int lua_encoder_encode(lua_State* L) {
+        auto* self = check_encoder(L, 1);
+        luaL_argcheck(L, lua_gettop(L) == 2, 2, "expected 1 argument");
+        self->buffer.clear();
+        self->append_value(L, 0);
+        lua_pushlstring(L, self->buffer.data(), self->buffer.size());
+        return 1;
+    }
+
+    static int lua_encoder_encode_protected(lua_State* L) {
+        auto* self = (encoder*)lua_touserdata(L, 1);
+        self->append_value(L, 0);
+        self->flush();
+        return 0;
+    }
+
+    // encoder:encode_file(path, value) -> true | nil, message
+    // 编码结果分块写入文件，内存中最多保留 64KB 左右的数据
+    static int lua_encoder_encode_file(lua_State* L) {
+        auto* self = check_encoder(L, 1);
+        const char* path = luaL_checkstring(L, 2);
+        luaL_argcheck(L, lua_gettop(L) == 3, 3, "expected 2 arguments");
+        std::FILE* file = std::fopen(path, "wb");
+        if (file == nullptr) {
+            lua_pushnil(L);
+            lua_pushfstring(L, "open file '%s' failed", path);
+            return 2;
+        }
+        self->buffer.clear();
+        self->file = file;
+        self->write_failed = false;
+        lua_pushcfunction(L, &lua_encoder_encode_protected);            // self path value f
+        lua_pushlightuserdata(L, self);                                 // self path value f self
+        lua_pushvalue(L, 3);                                            // self path value f self value
+        const int result = lua_pcall(L, 2, 0, 0);                       // self path value (err)
+        self->file = nullptr;
+        self->buffer.clear();
+        const bool write_failed = self->write_failed;
+        const bool close_failed = std::fclose(file) != 0;
+        if (result != 0) {
+            std::remove(path);
+            return lua_error(L); // 编码失败，与 encode 一样抛出错误
+        }
+        if (write_failed || close_failed) {
+            std::remove(path);
+            lua_pushnil(L);
+            lua_pushfstring(L, "write file '%s' failed", path);
+            return 2;
+        }
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+
+    static int lua_encoder_gc(lua_State* L) {
+        auto* self = check_encoder(L, 1);
+        luaL_unref(L, LUA_REGISTRYINDEX, self->array_mt);
+        luaL_unref(L, LUA_REGISTRYINDEX, self->empty_array_mt);
+        self->~encoder();
+        return 0;
+    }
+}
+
+int luaopen_cjson_ext(lua_State* L)
+{
+    using namespace cjson_ext;
+
+    const luaL_Reg methods[] = {
+        { "encode", &lua_encoder_encode },
+        { "encode_file", &lua_encoder_encode_file },
+        { nullptr, nullptr },
+    };
+    luaL_newmetatable(L, encoder_name);                                 // ... mt
+    lua_pushcfunction(L, &lua_encoder_gc);                              // ... mt gc
+    lua_setfield(L, -2, "__gc");                                        // ... mt
+    lua_createtable(L, 0, 2);                                           // ... mt methods
+    luaL_register(L, nullptr, methods);                                 // ... mt methods
+    lua_setfield(L, -2, "__index");                                     // ... mt
+    lua_pop(L, 1);                                                      // ...
+
+    lua_getglobal(L, "cjson");                                          // ... cjson
+    if (!lua_istable(L, -1)) {
+        return luaL_error(L, "cjson must be opened before cjson extensions");
+    }
+    lua_pushcfunction(L, &lua_decode_presized);                         // ... cjson f
+    lua_setfield(L, -2, "decode_presized");                             // ... cjson
+    lua_pushvalue(L, -1);                                               // ... cjson cjson
+    lua_pushcclosure(L, &lua_encoder_create, 1);                        // ... cjson f
+    lua_setfield(L, -2, "encoder");                                     // ... cjson
+    return 1;
+}
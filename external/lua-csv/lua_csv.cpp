@@ -1,9 +1,11 @@
 ﻿#include "lua_xlsx_csv.h"
 
+#include <cstring>
+#include <array>
 #include <fstream>
+#include <new>
 #include <string>
 #include <string_view>
-#include <vector>
 #include "lua.hpp"
 
 namespace csv {
@@ -16,180 +18,345 @@ namespace csv {
         config_t(const std::string& pseq, const std::string& pborder, const std::string& pnext) :
             sep(pseq), border(pborder), next(pnext) {}
     };
-    
-    using row_t = std::vector<std::string>;
-    using table_t = std::vector<row_t>;
-    
-    bool decode(const char* src, const size_t len, table_t& dest, const config_t& cfg) {
-        const auto sep_len = cfg.sep.length();
-        const auto border_len = cfg.border.length();
-        const auto next_len = cfg.next.length();
-        
-        if (!(sep_len > 0 && border_len > 0 && next_len > 0)) {
-            return false; // 兄啊这样怎么解析啊
+
+    // cell的内容，尽量直接引用源数据，只有内容不连续（转义字符、多段包围）时才复制到缓冲区
+    class cell_t {
+    private:
+        const char* _data = nullptr;
+        size_t _size = 0;
+        std::string _buffer;
+        bool _buffered = false;
+    public:
+        void append(const char* data, size_t size) {
+            if (_buffered) {
+                _buffer.append(data, size);
+            }
+            else if (_size == 0) {
+                _data = data;
+                _size = size;
+            }
+            else if (_data + _size == data) {
+                _size += size;
+            }
+            else {
+                _buffer.assign(_data, _size);
+                _buffer.append(data, size);
+                _buffered = true;
+            }
         }
-        
-        const auto border_len2 = 2 * border_len;
-        
-        const char* sep = cfg.sep.c_str();
-        const char* border = cfg.border.c_str();
-        const char* next = cfg.next.c_str();
-        
-        char* view = (char*)src;
-        size_t view_len = len;
-        
-        bool is_cell = false; // 包围cell
-        bool cell_begin = true; // 是否是一个cell的开头
-        row_t row;
-        std::string cell;
-        bool next_end = false; // 是否以换行符结尾
-        if (std::strncmp(view + (view_len - next_len), next, next_len) == 0) {
-            next_end = true;
+        std::string_view view() const {
+            return _buffered ? std::string_view(_buffer) : std::string_view(_data, _size);
         }
-        
-        while (view_len > 0) {
-            if (!is_cell) {
-                // 未进入包围cell
-                if ((view_len >= sep_len) && (std::strncmp(view, sep, sep_len) == 0)) {
-                    // cell结束
-                    view += sep_len;
-                    view_len -= sep_len;
-                    row.push_back(cell);
-                    cell.clear();
-                    cell_begin = true; // 上一个cell结束，又是cell的开头了！
-                }
-                else if ((view_len >= next_len) && (std::strncmp(view, next, next_len) == 0)) {
-                    // 没有在cell内，cell结束，行结束
-                    view += next_len;
-                    view_len -= next_len;
-                    row.push_back(cell);
-                    cell.clear();
-                    dest.push_back(row);
-                    row.clear();
-                    cell_begin = true; // 上一个cell和行结束，又是cell的开头了！
-                }
-                else if (cell_begin && (view_len >= border_len) && (std::strncmp(view, border, border_len) == 0)) {
-                    // 出现边界符，进入包围cell
-                    view += border_len;
-                    view_len -= border_len;
-                    is_cell = true;
-                }
-                else {
-                    // 储存cell的内容
-                    cell.push_back(view[0]);
-                    view++;
-                    view_len--;
-                    cell_begin = false; // 接下来就不是cell的开头了！
-                }
+        void clear() {
+            _data = nullptr;
+            _size = 0;
+            _buffer.clear();
+            _buffered = false;
+        }
+    };
+
+    // 单次扫描的逐行解析器，cell通过回调交给调用方，不构造中间表
+    class reader_t {
+    private:
+        config_t _cfg;
+        std::array<bool, 256> _special{}; // 分隔符、边界符、换行符的首字节
+    private:
+        static bool match(const char* p, const char* end, const std::string& token) {
+            return (size_t)(end - p) >= token.length() && std::memcmp(p, token.data(), token.length()) == 0;
+        }
+    public:
+        explicit reader_t(const config_t& cfg) : _cfg(cfg) {
+            if (valid()) {
+                _special[(uint8_t)_cfg.sep[0]] = true;
+                _special[(uint8_t)_cfg.border[0]] = true;
+                _special[(uint8_t)_cfg.next[0]] = true;
             }
-            else {
-                // 包围cell状态
-                if ((view_len >= border_len) && (std::strncmp(view, border, border_len) == 0)) {
-                    // cell结束？
-                    if ((view_len >= border_len2) && (std::strncmp(view + border_len, border, border_len) == 0)) {
-                        // 还没有，是cell内的转义字符
-                        for (auto* c = view; c < (view + border_len); c++) {
-                            cell.push_back(*c);
-                        }
-                        // 连续前进两次
-                        view += border_len2;
-                        view_len -= border_len2;
+        }
+
+        bool valid() const {
+            return _cfg.sep.length() > 0 && _cfg.border.length() > 0 && _cfg.next.length() > 0; // 兄啊这样怎么解析啊
+        }
+
+        // 从 [p, end) 解析一行，每个cell调用一次 on_cell(std::string_view)，返回该行结束后的位置
+        // is_final 为 false 时，如果直到 end 都没有遇到换行符，则返回 nullptr，调用方补充数据后从同一位置重新解析
+        // is_final 为 true 时，end 视为最后一行的结尾，某些憨批软件生成的csv没结尾的换行符
+        template<typename F>
+        const char* row(const char* p, const char* end, bool is_final, F&& on_cell) const {
+            const auto& sep = _cfg.sep;
+            const auto& border = _cfg.border;
+            const auto& next = _cfg.next;
+
+            bool is_cell = false; // 包围cell
+            bool cell_begin = true; // 是否是一个cell的开头
+            cell_t cell;
+
+            while (p < end) {
+                if (!is_cell) {
+                    // 未进入包围cell，跳过普通字符
+                    const char* q = p;
+                    while (q < end && !_special[(uint8_t)*q]) {
+                        q++;
+                    }
+                    if (q != p) {
+                        cell.append(p, (size_t)(q - p));
+                        p = q;
+                        cell_begin = false; // 接下来就不是cell的开头了！
+                    }
+                    else if (match(p, end, sep)) {
+                        // cell结束
+                        p += sep.length();
+                        on_cell(cell.view());
+                        cell.clear();
+                        cell_begin = true; // 上一个cell结束，又是cell的开头了！
+                    }
+                    else if (match(p, end, next)) {
+                        // 没有在cell内，cell结束，行结束
+                        on_cell(cell.view());
+                        return p + next.length();
+                    }
+                    else if (cell_begin && match(p, end, border)) {
+                        // 出现边界符，进入包围cell
+                        p += border.length();
+                        is_cell = true;
                     }
                     else {
-                        // 出现真·边界符，离开包围cell
-                        view += border_len;
-                        view_len -= border_len;
-                        is_cell = false;
+                        // 首字节相同但不是分隔符，储存cell的内容
+                        cell.append(p, 1);
+                        p++;
+                        cell_begin = false;
                     }
                 }
                 else {
-                    // 储存cell的内容
-                    cell.push_back(view[0]);
-                    view++;
-                    view_len--;
+                    // 包围cell状态，只需要查找边界符
+                    const char* q = (const char*)std::memchr(p, border[0], (size_t)(end - p));
+                    if (q == nullptr) {
+                        q = end;
+                    }
+                    if (q != p) {
+                        cell.append(p, (size_t)(q - p));
+                        p = q;
+                    }
+                    else if (match(p, end, border)) {
+                        // cell结束？
+                        if (match(p + border.length(), end, border)) {
+                            // 还没有，是cell内的转义字符，连续前进两次
+                            cell.append(p, border.length());
+                            p += 2 * border.length();
+                        }
+                        else {
+                            // 出现真·边界符，离开包围cell
+                            p += border.length();
+                            is_cell = false;
+                        }
+                    }
+                    else {
+                        cell.append(p, 1);
+                        p++;
+                    }
                 }
             }
+
+            if (!is_final) {
+                return nullptr;
+            }
+            on_cell(cell.view());
+            return end;
         }
-        
-        // 收尾工作，某些憨批软件生成的csv没结尾的换行符
-        if (!next_end) {
-            row.push_back(cell);
-            dest.push_back(row);
+    };
+
+    // 行迭代器的状态，读取文件时按块读入，内存中只保留未解析完的部分
+    struct row_iterator_t {
+        static constexpr size_t chunk_size = 64 * 1024;
+
+        reader_t reader;
+        std::ifstream file;
+        std::string buffer;
+        size_t position = 0;
+        bool is_eof = false;
+        lua_Integer row_index = 0;
+        int row_width = 0; // 上一行的列数，用于预分配下一行的表
+
+        explicit row_iterator_t(const config_t& cfg) : reader(cfg) {}
+
+        // 读取下一块数据，已经解析的部分会被丢弃
+        void read() {
+            buffer.erase(0, position);
+            position = 0;
+            const size_t size = buffer.size();
+            buffer.resize(size + chunk_size);
+            file.read(buffer.data() + size, (std::streamsize)chunk_size);
+            const size_t count = (size_t)file.gcount();
+            buffer.resize(size + count);
+            if (count == 0) {
+                is_eof = true;
+                file.close();
+            }
         }
-        
-        return true;
+    };
+};
+
+static const char* const ROW_ITERATOR_NAME = "csv.row_iterator";
+
+static csv::config_t csv_check_config(lua_State* L, int index) {
+    csv::config_t cfg;
+    int args = lua_gettop(L);
+    if (args >= index) {
+        cfg.next = luaL_checkstring(L, index);
     }
-    
-    bool decode(const std::string& src, table_t& dest, const config_t& cfg) {
-        return decode(src.c_str(), src.length(), dest, cfg);
+    if (args >= index + 1) {
+        cfg.sep = luaL_checkstring(L, index + 1);
     }
-    
-    bool decode(std::ifstream& file, table_t& dest, const config_t& cfg) {
-        // 计算大小
-        const auto p2 = file.seekg(0, std::ios::end).tellg();
-        const auto p1 = file.seekg(0, std::ios::beg).tellg();
-        const auto dp = p2 - p1;
-        // 读取数据
-        std::string s;
-        s.resize((size_t)dp);
-        file.read(s.data(), dp);
-        file.seekg(0, std::ios::beg); // 恢复
-        // 接锅
-        return decode(s, dest, cfg);
+    if (args >= index + 2) {
+        cfg.border = luaL_checkstring(L, index + 2);
     }
-};
+    return cfg;
+}
+
+// 解析一行并压入行表，width 为预分配的列数，成功时更新为实际列数
+static const char* csv_push_row(lua_State* L, const csv::reader_t& reader, const char* p, const char* end, bool is_final, int& width) {
+    lua_createtable(L, width, 0);                                   // ... row
+    int col_index = 0;
+    const char* result = reader.row(p, end, is_final, [L, &col_index](std::string_view cell) {
+        lua_pushlstring(L, cell.data(), cell.size());               // ... row cell
+        col_index++;
+        lua_rawseti(L, -2, col_index);                              // ... row
+    });
+    if (result != nullptr) {
+        width = col_index;
+    }
+    else {
+        lua_pop(L, 1);                                              // ...
+    }
+    return result;
+}
 
 static int csv_decode(lua_State* L) {
-    const char* source = luaL_checkstring(L, 1);
-    uint32_t size = lua_objlen(L, 1);
-    csv::config_t cfg;
-    int args = lua_gettop(L);
-    if (args >= 2) {
-        cfg.next = luaL_checkstring(L, 2);
+    size_t size = 0;
+    const char* source = luaL_checklstring(L, 1, &size);
+    csv::reader_t reader(csv_check_config(L, 2));
+    if (!reader.valid()) {
+        return 0;
     }
-    if (args >= 3) {
-        cfg.sep = luaL_checkstring(L, 3);
+    const char* p = source;
+    const char* end = source + size;
+    int width = 0;
+    lua_Integer row_index = 0;
+    lua_newtable(L);                                                // ws
+    while (p < end) {
+        p = csv_push_row(L, reader, p, end, true, width);           // ws row
+        row_index++;
+        lua_rawseti(L, -2, (int)row_index);                         // ws
     }
-    if (args >= 4) {
-        cfg.border = luaL_checkstring(L, 4);
+    return 1;
+}
+
+static csv::row_iterator_t* csv_new_row_iterator(lua_State* L, const csv::config_t& cfg) {
+    auto* self = (csv::row_iterator_t*)lua_newuserdata(L, sizeof(csv::row_iterator_t));
+    new(self) csv::row_iterator_t(cfg);
+    luaL_getmetatable(L, ROW_ITERATOR_NAME);
+    lua_setmetatable(L, -2);
+    return self;
+}
+
+static int csv_row_iterator_gc(lua_State* L) {
+    auto* self = (csv::row_iterator_t*)luaL_checkudata(L, 1, ROW_ITERATOR_NAME);
+    self->~row_iterator_t();
+    return 0;
+}
+
+// upvalue 1 为迭代器状态，upvalue 2 为源字符串
+static int csv_rows_next(lua_State* L) {
+    auto* self = (csv::row_iterator_t*)lua_touserdata(L, lua_upvalueindex(1));
+    size_t size = 0;
+    const char* source = lua_tolstring(L, lua_upvalueindex(2), &size);
+    if (self->position >= size) {
+        return 0;
     }
-    csv::table_t ws;
-    if (csv::decode(source, size, ws, cfg)) {
-        lua_createtable(L, (int)ws.size(), 0);     // ws
-        int row_index = 1, col_index = 1;
-        for (auto& r : ws) {
-            lua_pushinteger(L, row_index);                  // ws ri row
-            lua_createtable(L, (int)r.size(), 0);           // ws ri row
-            col_index = 1;
-            for (auto& cell : r) {
-                lua_pushinteger(L, col_index);              // ws ri row ci
-                lua_pushstring(L, cell.c_str());            // ws ri row ci cell
-                lua_settable(L, -3);                        // ws ri row
-                col_index++;
+    const char* p = csv_push_row(L, self->reader, source + self->position, source + size, true, self->row_width); // row
+    self->position = (size_t)(p - source);
+    self->row_index++;
+    lua_pushinteger(L, self->row_index);                            // row ri
+    lua_insert(L, -2);                                              // ri row
+    return 2;
+}
+
+static int csv_filerows_next(lua_State* L) {
+    auto* self = (csv::row_iterator_t*)lua_touserdata(L, lua_upvalueindex(1));
+    for (;;) {
+        if (self->position < self->buffer.size() || self->is_eof) {
+            if (self->position >= self->buffer.size()) {
+                return 0;
+            }
+            const char* source = self->buffer.data();
+            const char* p = csv_push_row(L, self->reader, source + self->position, source + self->buffer.size(), self->is_eof, self->row_width);
+            if (p != nullptr) {                                     // row
+                self->position = (size_t)(p - source);
+                self->row_index++;
+                lua_pushinteger(L, self->row_index);                // row ri
+                lua_insert(L, -2);                                  // ri row
+                return 2;
             }
-            lua_settable(L, -3);                            // ws
-            row_index++;
         }
-        return 1;
+        // 这一行还不完整，读取更多数据后重新解析
+        self->read();
     }
-    else {
-        return 0;
+}
+
+// for ri, row in csv.rows(source [, next, sep, border]) do ... end
+// 逐行解析，不会一次性构造整个表
+static int csv_rows(lua_State* L) {
+    luaL_checkstring(L, 1);
+    csv::config_t cfg = csv_check_config(L, 2);
+    if (!csv::reader_t(cfg).valid()) {
+        return luaL_error(L, "invalid csv config");
+    }
+    csv_new_row_iterator(L, cfg);                                   // ... state
+    lua_pushvalue(L, 1);                                            // ... state source
+    lua_pushcclosure(L, &csv_rows_next, 2);                         // ... next
+    return 1;
+}
+
+// for ri, row in csv.filerows(path [, next, sep, border]) do ... end
+// 按块读取文件并逐行解析，适合处理超大的文件
+static int csv_filerows(lua_State* L) {
+    const char* path = luaL_checkstring(L, 1);
+    csv::config_t cfg = csv_check_config(L, 2);
+    if (!csv::reader_t(cfg).valid()) {
+        return luaL_error(L, "invalid csv config");
+    }
+    auto* self = csv_new_row_iterator(L, cfg);                      // ... state
+    self->file.open(path, std::ios::in | std::ios::binary);
+    if (!self->file.is_open()) {
+        return luaL_error(L, "open file '%s' failed", path);
     }
+    lua_pushcclosure(L, &csv_filerows_next, 1);                     // ... next
+    return 1;
 }
 
 static const luaL_Reg lib[] = {
     { "decode", csv_decode },
+    { "rows", csv_rows },
+    { "filerows", csv_filerows },
     { nullptr, nullptr },
 };
 
+static void csv_register_row_iterator(lua_State* L) {
+    luaL_newmetatable(L, ROW_ITERATOR_NAME);                        // ... mt
+    lua_pushcfunction(L, &csv_row_iterator_gc);                     // ... mt gc
+    lua_setfield(L, -2, "__gc");                                    // ... mt
+    lua_pop(L, 1);                                                  // ...
+}
+
 int lua_csv_open(lua_State* L)
 {
+    csv_register_row_iterator(L);
     luaL_register(L, "csv", lib);
     return 1;
 }
 
 #ifdef BUILD_LUA_DLL_LIB
 extern "C" __declspec(dllexport) int luaopen_csv(lua_State* L) {
+    csv_register_row_iterator(L);
     lua_newtable(L);
     luaL_register(L, nullptr, lib);
     return 1;
@@ -3,13 +3,18 @@
 #include <iostream>
 #include <fstream>
 #include <clocale>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <new>
 #include <string>
 #include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <algorithm>
-#include "zip.h"
+#include "mz.h"
+#include "mz_zip.h"
+#include "mz_zip_rw.h"
 #include "pugixml.hpp"
 #include "lua.hpp"
 
@@ -43,18 +48,20 @@ namespace slow
     class zip {
     private:
         std::vector<uint8_t> _buffer;
-        zip_source* _source;
-        zip_t* _archive;
+        void* _reader;
     private:
         bool _open() {
-            zip_error_t ziperr;
-            _source = zip_source_buffer_create(_buffer.data(), _buffer.size(), 0, &ziperr);
-            if (nullptr != _source) {
-                _archive = zip_open_from_source(_source, ZIP_CHECKCONS | ZIP_RDONLY, &ziperr);
-                if (nullptr != _archive) {
+            if (_buffer.size() > (size_t)INT32_MAX) {
+                return false; // only support 32bit size
+            }
+            _reader = mz_zip_reader_create();
+            if (nullptr != _reader) {
+                // 不复制数据，_buffer 需要保留到 close
+                if (MZ_OK == mz_zip_reader_open_buffer(_reader, _buffer.data(), (int32_t)_buffer.size(), 0)) {
                     return true;
                 }
             }
+            close();
             return false;
         }
     public:
@@ -85,40 +92,33 @@ namespace slow
             return _open();
         }
         void close() {
+            // 先关闭 reader，它还在引用 _buffer
+            if (nullptr != _reader) {
+                mz_zip_reader_close(_reader);
+                mz_zip_reader_delete(&_reader);
+            }
             _buffer.clear();
-            if (nullptr != _archive) zip_discard(_archive);
-            if (nullptr != _source) zip_source_close(_source);
         }
         bool fexist(const char* path) {
-            zip_int64_t i = zip_name_locate(_archive, path, ZIP_FL_ENC_GUESS);
-            return (i >= 0);
+            return (nullptr != _reader) && (MZ_OK == mz_zip_reader_locate_entry(_reader, path, 0));
         }
         uint32_t fsize(const char* path) {
-            zip_int64_t i = zip_name_locate(_archive, path, ZIP_FL_ENC_GUESS);
-            if (i >= 0) {
-                zip_stat_t stat;
-                int flag = ZIP_STAT_NAME | ZIP_STAT_INDEX | ZIP_STAT_SIZE | ZIP_STAT_ENCRYPTION_METHOD;
-                int b = zip_stat_index(_archive, i, flag, &stat);
-                if (b == 0) {
-                    return (uint32_t)(stat.size & 0x000000007FFFFFFF); // only support 32bit size
+            if (fexist(path)) {
+                int32_t size = mz_zip_reader_entry_save_buffer_length(_reader);
+                if (size > 0) {
+                    return (uint32_t)size;
                 }
             }
             return 0;
         }
         bool fread(const char* path, uint8_t* buffer, uint32_t size) {
-            zip_int64_t i = zip_name_locate(_archive, path, ZIP_FL_ENC_GUESS);
-            if (i >= 0) {
-                zip_file_t* _file = zip_fopen_index(_archive, i, ZIP_FL_UNCHANGED);
-                if (nullptr != _file) {
-                    zip_int64_t r = zip_fread(_file, buffer, size);
-                    zip_fclose(_file);
-                    return (r >= 0) && (r == (zip_int64_t)size);
-                }
+            if (fexist(path)) {
+                return MZ_OK == mz_zip_reader_entry_save_buffer(_reader, buffer, (int32_t)size);
             }
             return false;
         }
     public:
-        zip() : _source(nullptr), _archive(nullptr) {}
+        zip() : _reader(nullptr) {}
         ~zip() { close(); }
     };
     
@@ -145,10 +145,10 @@ namespace slow
     }
 };
 
-int cell_coord_to_uint32(const std::string& str) {
+int cell_coord_to_uint32(std::string_view str) {
     int ret = 0;
     int base = 1;
-    for (int idx = (str.length() - 1); idx >= 0; idx--) {
+    for (int idx = ((int)str.length() - 1); idx >= 0; idx--) {
         if (str[idx] >= 'A' && str[idx] <= 'Z') {
             ret += base * (int)(str[idx] - '\x40');
             base *= 26;
@@ -161,344 +161,649 @@ int cell_coord_to_uint32(const std::string& str) {
     return ret;
 }
 
-namespace xlsx
+namespace xml
 {
-    using row = std::vector<std::string>;
-    using worksheet = std::vector<row>;
-    using workbook = std::unordered_map<std::string, worksheet>;
-    
-    bool read(const uint8_t* data, const uint32_t size, workbook& wb) {
-        // try open xlsx (zip)
-        slow::zip zip;
-        if (!zip.open(data, size))
-        {
-            return false;
+    // 极简的拉取式 xml 扫描器，直接在源数据上工作，不构造 DOM
+    // 只处理工作表和共享字符串表用得到的部分：元素、属性、文本、CDATA，声明、注释和 DOCTYPE 会被跳过
+    // 元素名会去掉命名空间前缀，属性值和文本都是未解码的原始数据
+    class scanner {
+    public:
+        enum class token { start, end, text, eof, error };
+    private:
+        const char* _p;
+        const char* _end;
+        std::string_view _name;
+        std::string_view _attrs;
+        std::string_view _text;
+        bool _cdata = false;
+        bool _pending_end = false; // 自闭合元素，下一次返回结束标签
+    private:
+        static bool is_space(char c) {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
         }
-        
-        // common buffer
-        std::vector<uint8_t> buffer;
-        
-        // read cell string resource
-        std::vector<std::string> static_string;
-        if (slow::zip_fread(zip, "xl/sharedStrings.xml", buffer))
-        {
-            pugi::xml_document doc;
-            auto result = doc.load_buffer(buffer.data(), buffer.size());
-            if (result)
-            {
-                for (auto tool : doc.child("sst").children("si"))
-                {
-                    if (!tool.child("t").empty())
-                    {
-                        const auto* nodev = tool.child("t").child_value();
-                        static_string.push_back(nodev);
+        static std::string_view local_name(std::string_view name) {
+            const auto i = name.find(':');
+            return i == std::string_view::npos ? name : name.substr(i + 1);
+        }
+        const char* find(std::string_view s) const {
+            const std::string_view rest(_p, (size_t)(_end - _p));
+            const auto i = rest.find(s);
+            return i == std::string_view::npos ? nullptr : _p + i;
+        }
+    public:
+        scanner(const char* data, size_t size) : _p(data), _end(data + size) {}
+
+        std::string_view name() const { return _name; }
+        std::string_view text() const { return _text; }
+        bool is_cdata() const { return _cdata; }
+
+        token next() {
+            if (_pending_end) {
+                _pending_end = false;
+                return token::end;
+            }
+            while (_p < _end) {
+                if (*_p != '<') {
+                    const char* q = (const char*)std::memchr(_p, '<', (size_t)(_end - _p));
+                    if (q == nullptr) {
+                        q = _end;
                     }
-                    else if (!tool.child("r").empty())
-                    {
-                        std::string str;
-                        for (auto v : tool.children("r"))
-                        {
-                            str += v.child("t").child_value();
+                    _text = std::string_view(_p, (size_t)(q - _p));
+                    _cdata = false;
+                    _p = q;
+                    return token::text;
+                }
+                const std::string_view rest(_p, (size_t)(_end - _p));
+                if (rest.starts_with("<?") || rest.starts_with("<!--")) {
+                    const std::string_view terminator = rest[1] == '?' ? "?>" : "-->";
+                    const char* q = find(terminator);
+                    if (q == nullptr) {
+                        return token::error;
+                    }
+                    _p = q + terminator.length();
+                }
+                else if (rest.starts_with("<![CDATA[")) {
+                    _p += 9;
+                    const char* q = find("]]>");
+                    if (q == nullptr) {
+                        return token::error;
+                    }
+                    _text = std::string_view(_p, (size_t)(q - _p));
+                    _cdata = true;
+                    _p = q + 3;
+                    return token::text;
+                }
+                else if (rest.starts_with("<!")) {
+                    const char* q = find(">");
+                    if (q == nullptr) {
+                        return token::error;
+                    }
+                    _p = q + 1;
+                }
+                else if (rest.starts_with("</")) {
+                    const char* q = find(">");
+                    if (q == nullptr) {
+                        return token::error;
+                    }
+                    const char* b = _p + 2;
+                    const char* e = q;
+                    while (e > b && is_space(e[-1])) {
+                        e--;
+                    }
+                    _name = local_name(std::string_view(b, (size_t)(e - b)));
+                    _p = q + 1;
+                    return token::end;
+                }
+                else {
+                    const char* b = _p + 1;
+                    const char* q = b;
+                    while (q < _end && !is_space(*q) && *q != '/' && *q != '>') {
+                        q++;
+                    }
+                    _name = local_name(std::string_view(b, (size_t)(q - b)));
+                    const char* a = q;
+                    char quote = 0;
+                    while (q < _end) {
+                        if (quote != 0) {
+                            if (*q == quote) quote = 0;
+                        }
+                        else if (*q == '"' || *q == '\'') {
+                            quote = *q;
+                        }
+                        else if (*q == '>') {
+                            break;
                         }
-                        static_string.push_back(std::move(str));
+                        q++;
                     }
-                    else
-                    {
-                        static_string.push_back("<?>");
+                    if (q >= _end) {
+                        return token::error;
                     }
+                    _pending_end = (q > a) && (q[-1] == '/');
+                    _attrs = std::string_view(a, (size_t)(q - a) - (_pending_end ? 1 : 0));
+                    _p = q + 1;
+                    return token::start;
                 }
             }
-            else
-            {
-                return false;
-            }
+            return token::eof;
         }
-        else
-        {
+
+        // 在当前开始标签中查找属性
+        bool attribute(std::string_view name, std::string_view& value) const {
+            const char* p = _attrs.data();
+            const char* e = p + _attrs.size();
+            while (p < e) {
+                while (p < e && is_space(*p)) p++;
+                const char* n = p;
+                while (p < e && *p != '=' && !is_space(*p)) p++;
+                const std::string_view attr_name(n, (size_t)(p - n));
+                while (p < e && *p != '"' && *p != '\'') p++;
+                if (p >= e) {
+                    return false;
+                }
+                const char quote = *p++;
+                const char* v = p;
+                while (p < e && *p != quote) p++;
+                if (attr_name == name) {
+                    value = std::string_view(v, (size_t)(p - v));
+                    return true;
+                }
+                p++;
+            }
             return false;
         }
-        
-        // worksheet list
-        // worksheet attr
-        const std::string_view attr_worksheet_head = "worksheets/sheet";
-        // data map
-        std::unordered_map<std::string, std::string> workbook_entry;
-        std::unordered_map<std::string, std::string> worksheet_name;
-        std::unordered_map<std::string, std::string> worksheet_path;
-        // workbook entry (files)
-        if (slow::zip_fread(zip, "xl/_rels/workbook.xml.rels", buffer))
-        {
-            pugi::xml_document xml;
-            if (xml.load_buffer(buffer.data(), buffer.size()))
+    };
+
+    inline void append_utf8(std::string& out, uint32_t c) {
+        if (c < 0x80) {
+            out.push_back((char)c);
+        }
+        else if (c < 0x800) {
+            out.push_back((char)(0xC0 | (c >> 6)));
+            out.push_back((char)(0x80 | (c & 0x3F)));
+        }
+        else if (c < 0x10000) {
+            out.push_back((char)(0xE0 | (c >> 12)));
+            out.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (c & 0x3F)));
+        }
+        else {
+            out.push_back((char)(0xF0 | (c >> 18)));
+            out.push_back((char)(0x80 | ((c >> 12) & 0x3F)));
+            out.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (c & 0x3F)));
+        }
+    }
+
+    // 解码实体引用并把换行统一为 \n，结果追加到 out
+    inline void append_text(std::string& out, std::string_view raw, bool cdata) {
+        size_t i = 0;
+        while (i < raw.size()) {
+            const size_t j = raw.find_first_of(cdata ? std::string_view("\r") : std::string_view("&\r"), i);
+            if (j == std::string_view::npos) {
+                out.append(raw.data() + i, raw.size() - i);
+                return;
+            }
+            out.append(raw.data() + i, j - i);
+            i = j + 1;
+            if (raw[j] == '\r') {
+                out.push_back('\n');
+                if (i < raw.size() && raw[i] == '\n') i++;
+                continue;
+            }
+            const size_t k = raw.find(';', i);
+            if (k == std::string_view::npos) {
+                out.push_back('&');
+                continue;
+            }
+            const std::string_view entity = raw.substr(i, k - i);
+            if (entity == "lt") out.push_back('<');
+            else if (entity == "gt") out.push_back('>');
+            else if (entity == "amp") out.push_back('&');
+            else if (entity == "quot") out.push_back('"');
+            else if (entity == "apos") out.push_back('\'');
+            else if (entity.length() > 1 && entity[0] == '#') {
+                const bool hex = entity[1] == 'x' || entity[1] == 'X';
+                const std::string digits(entity.substr(hex ? 2 : 1));
+                append_utf8(out, (uint32_t)std::strtoul(digits.c_str(), nullptr, hex ? 16 : 10));
+            }
+            else {
+                out.push_back('&');
+                continue; // 不认识的实体，原样保留
+            }
+            i = k + 1;
+        }
+    }
+};
+
+namespace xlsx
+{
+    // 工作簿，打开时只读取工作表列表，工作表在需要时才解析
+    class workbook {
+    private:
+        slow::zip _zip;
+        std::vector<uint8_t> _buffer; // 读取压缩包内文件的公用缓冲区
+        std::vector<std::pair<std::string, std::string>> _sheets; // 名称、路径，按工作簿中的顺序
+        // 共享字符串表，第一次解析工作表时构建，所有字符串连续储存在 _shared_data 中
+        bool _shared_loaded = false;
+        std::string _shared_data;
+        std::vector<std::string_view> _shared;
+    private:
+        bool load_sheet_list() {
+            // worksheet attr
+            const std::string_view attr_worksheet_head = "worksheets/sheet";
+            // workbook entry (files)
+            std::unordered_map<std::string, std::string> workbook_entry;
+            if (!slow::zip_fread(_zip, "xl/_rels/workbook.xml.rels", _buffer)) {
+                std::printf("read file [xl/_rels/workbook.xml.rels] failed");
+                return false;
+            }
             {
-                for (auto node : xml.child("Relationships").children("Relationship"))
-                {
-                    const std::string_view target = node.attribute("Target").as_string();
-                    if (target.length() > attr_worksheet_head.length() && target.substr(0, attr_worksheet_head.length()) == attr_worksheet_head)
-                    {
-                        std::string key = node.attribute("Id").as_string();
-                        std::string value = "xl/"; value += node.attribute("Target").as_string();
-                        workbook_entry.emplace(std::move(key), std::move(value));
+                pugi::xml_document xml;
+                if (!xml.load_buffer(_buffer.data(), _buffer.size())) {
+                    std::printf("parser xml [xl/_rels/workbook.xml.rels] failed");
+                    return false;
+                }
+                for (auto node : xml.child("Relationships").children("Relationship")) {
+                    std::string_view target = node.attribute("Target").as_string();
+                    std::string value;
+                    if (target.starts_with("/")) {
+                        target.remove_prefix(1); // 绝对路径
+                    }
+                    else {
+                        value = "xl/";
+                    }
+                    value += target;
+                    if (value.length() > 3 + attr_worksheet_head.length() && std::string_view(value).substr(3).starts_with(attr_worksheet_head)) {
+                        workbook_entry.emplace(node.attribute("Id").as_string(), std::move(value));
                     }
                 }
             }
-            else
+            // worksheet name
+            if (!slow::zip_fread(_zip, "xl/workbook.xml", _buffer)) {
+                std::printf("read file [xl/workbook.xml] failed");
+                return false;
+            }
             {
-                std::printf("parser xml [xl/_rels/workbook.xml.rels] failed");
+                pugi::xml_document xml;
+                if (!xml.load_buffer(_buffer.data(), _buffer.size())) {
+                    std::printf("parser xml [xl/workbook.xml] failed");
+                    return false;
+                }
+                for (auto node : xml.child("workbook").child("sheets").children("sheet")) {
+                    auto it = workbook_entry.find(node.attribute("r:id").as_string());
+                    if (it != workbook_entry.end()) {
+                        _sheets.emplace_back(node.attribute("name").as_string(), std::move(it->second));
+                        workbook_entry.erase(it);
+                    }
+                }
+            }
+            // 没有名称的工作表用 Id 作为名称
+            for (auto& v : workbook_entry) {
+                _sheets.emplace_back(v.first, std::move(v.second));
+            }
+            return true;
+        }
+        bool load_shared_strings() {
+            if (_shared_loaded) {
+                return true;
+            }
+            _shared_loaded = true;
+            // 只有数字的工作簿没有共享字符串表
+            if (!_zip.fexist("xl/sharedStrings.xml")) {
+                return true;
+            }
+            if (!slow::zip_fread(_zip, "xl/sharedStrings.xml", _buffer)) {
                 return false;
             }
+            // 先记录偏移，全部读取完以后再生成 string_view，避免 _shared_data 扩容导致失效
+            std::vector<std::pair<size_t, size_t>> ranges;
+            xml::scanner scanner((const char*)_buffer.data(), _buffer.size());
+            bool in_si = false;
+            bool in_t = false;
+            int in_rph = 0; // 注音文字不属于字符串内容
+            size_t begin = 0;
+            for (;;) {
+                const auto token = scanner.next();
+                if (token == xml::scanner::token::eof) {
+                    break;
+                }
+                else if (token == xml::scanner::token::error) {
+                    std::printf("parser xml [xl/sharedStrings.xml] failed");
+                    return false;
+                }
+                else if (token == xml::scanner::token::start) {
+                    const auto name = scanner.name();
+                    if (name == "si") {
+                        in_si = true;
+                        begin = _shared_data.size();
+                    }
+                    else if (name == "rPh") {
+                        in_rph++;
+                    }
+                    else if (name == "t" && in_si && in_rph == 0) {
+                        in_t = true;
+                    }
+                }
+                else if (token == xml::scanner::token::end) {
+                    const auto name = scanner.name();
+                    if (name == "si") {
+                        ranges.emplace_back(begin, _shared_data.size() - begin);
+                        in_si = false;
+                    }
+                    else if (name == "rPh") {
+                        in_rph--;
+                    }
+                    else if (name == "t") {
+                        in_t = false;
+                    }
+                }
+                else if (in_t) {
+                    xml::append_text(_shared_data, scanner.text(), scanner.is_cdata());
+                }
+            }
+            _shared.reserve(ranges.size());
+            for (auto& r : ranges) {
+                _shared.emplace_back(_shared_data.data() + r.first, r.second);
+            }
+            return true;
         }
-        else
-        {
-            std::printf("read file [xl/_rels/workbook.xml.rels] failed");
-            return false;
+    public:
+        bool open(const uint8_t* data, const uint32_t size) {
+            // try open xlsx (zip)
+            if (!_zip.open(data, size)) {
+                return false;
+            }
+            return load_sheet_list();
         }
-        // worksheet name
-        if (slow::zip_fread(zip, "xl/workbook.xml", buffer))
-        {
-            pugi::xml_document xml;
-            if (xml.load_buffer(buffer.data(), buffer.size()))
-            {
-                for (auto node : xml.child("workbook").child("sheets").children("sheet"))
-                {
-                    std::string key = node.attribute("r:id").as_string();
-                    std::string value = node.attribute("name").as_string();
-                    worksheet_name.emplace(std::move(key), std::move(value));
+        const std::vector<std::pair<std::string, std::string>>& sheets() const { return _sheets; }
+        const std::string* find(std::string_view name) const {
+            for (auto& v : _sheets) {
+                if (v.first == name) {
+                    return &v.second;
                 }
             }
-            else
-            {
-                std::printf("parser xml [xl/workbook.xml] failed");
+            return nullptr;
+        }
+        std::string_view shared_string(std::string_view index) const {
+            const std::string digits(index);
+            const auto i = std::strtoul(digits.c_str(), nullptr, 10);
+            return i < _shared.size() ? _shared[i] : std::string_view();
+        }
+        // 读取工作表的原始数据，必要时先构建共享字符串表，返回的数据在下一次读取前有效
+        bool read_sheet(const std::string& path, std::string_view& xml) {
+            if (!load_shared_strings()) {
                 return false;
             }
+            if (!slow::zip_fread(_zip, path, _buffer)) {
+                return false;
+            }
+            xml = std::string_view((const char*)_buffer.data(), _buffer.size());
+            return true;
         }
-        else
-        {
-            std::printf("read file [xl/workbook.xml] failed");
+    };
+};
+
+static const char* const WORKBOOK_NAME = "xlsx.workbook";
+
+// 边扫描边写入 lua 表，不构造中间结构
+static bool xlsx_push_sheet(lua_State* L, xlsx::workbook& wb, const std::string& path) {
+    std::string_view source;
+    if (!wb.read_sheet(path, source)) {
+        return false;
+    }
+
+    enum class cell_type { literal, shared, boolean };
+
+    xml::scanner scanner(source.data(), source.size());
+    lua_newtable(L);                                                    // ws
+    const int ws = lua_gettop(L);
+    int row_count = 0;
+    int width = 0; // 上一行的列数，用于预分配下一行的表
+    int max_width = 0;
+    bool in_sheet_data = false;
+    bool in_row = false;
+    bool in_cell = false;
+    bool in_value = false;
+    int in_rph = 0;
+    int col = 1;
+    cell_type type = cell_type::literal;
+    std::string value;
+    for (;;) {
+        const auto token = scanner.next();
+        if (token == xml::scanner::token::eof) {
+            break;
+        }
+        else if (token == xml::scanner::token::error) {
+            lua_settop(L, ws - 1);
             return false;
         }
-        // worksheet path
-        for (auto& v : workbook_entry)
-        {
-            auto it = worksheet_name.find(v.first);
-            if (it != worksheet_name.end())
-            {
-                worksheet_path.emplace(it->second, v.second);
+        else if (token == xml::scanner::token::start) {
+            const auto name = scanner.name();
+            if (name == "sheetData") {
+                in_sheet_data = true;
             }
-            else
-            {
-                worksheet_path.emplace(v);
-            }
-        }
-        
-        // read workbook
-        // cell attr
-        const std::string_view attr_name_y = "r";
-        const std::string_view attr_name_tpye = "t";
-        const std::string_view cell_type_bool = "b";
-        const std::string_view cell_type_num = "n";
-        const std::string_view cell_type_str = "s";
-        const std::string_view bool_value_false = "0";
-        const std::string_view bool_value_true = "1";
-        // read all workbook
-        for (auto& item : worksheet_path) {
-            pugi::xml_document doc;
-            if (slow::zip_fread(zip, item.second, buffer)) {
-                auto result = doc.load_buffer(buffer.data(), buffer.size());
-                if (result) {
-                    // read worksheet
-                    worksheet ws;
-                    for (auto tool : doc.child("worksheet").child("sheetData").children("row")) {
-                        // read row
-                        row xlrow;
-                        int col = 1;
-                        for (auto cell : tool.children("c")) {
-                            // read cell
-                            
-                            // check attr
-                            bool is_string = false;
-                            bool is_number = false;
-                            bool is_boolean = false;
-                            std::string cellcoord;
-                            for (auto attr : cell.attributes())
-                            {
-                                if (attr_name_y == attr.name())
-                                {
-                                    cellcoord = attr.as_string();
-                                }
-                                else if (attr_name_tpye == attr.name())
-                                {
-                                    if (cell_type_str == attr.value())
-                                    {
-                                        is_string = true;
-                                    }
-                                    else if (cell_type_num == attr.value())
-                                    {
-                                        is_number = true;
-                                    }
-                                    else if (cell_type_bool == attr.value())
-                                    {
-                                        is_boolean = true;
-                                    }
-                                    else
-                                    {
-                                        is_string = true; // unknown type ??? regard it as string
-                                    }
-                                }
-                                else
-                                {
-                                    // ignore attr
-                                }
-                            }
-                            
-                            // add empty cell
-                            int colv = cell_coord_to_uint32(cellcoord);
-                            while ((colv - col) > 0)
-                            {
-                                xlrow.emplace_back("");
-                                col++;
-                            }
-                            
-                            // get value
-                            std::string cellvalue;
-                            for (auto v : cell.children("v"))
-                            {
-                                if (is_string)
-                                {
-                                    char* end = nullptr;
-                                    const auto uv = std::strtoul(v.child_value(), &end, 10);
-                                    cellvalue = static_string[uv];
-                                }
-                                else if (is_number)
-                                {
-                                    cellvalue = v.child_value();
-                                }
-                                else if (is_boolean)
-                                {
-                                    if (bool_value_true == v.child_value())
-                                    {
-                                        cellvalue = "true";
-                                    }
-                                    else // if (bool_value_false == v.child_value())
-                                    {
-                                        cellvalue = "false";
-                                    }
-                                }
-                                else
-                                {
-                                    cellvalue = v.child_value();
-                                }
-                            }
-                            
-                            // save cell
-                            xlrow.push_back(cellvalue);
-                            col++;
-                        }
-                        // save row
-                        ws.push_back(xlrow);
-                    }
-                    // save worksheet
-                    wb.emplace(item.first, ws);
+            else if (name == "row" && in_sheet_data) {
+                lua_createtable(L, width, 0);                           // ws row
+                in_row = true;
+                col = 1;
+            }
+            else if (name == "c" && in_row) {
+                std::string_view attr;
+                type = cell_type::literal;
+                if (scanner.attribute("t", attr)) {
+                    // str 为公式结果，inlineStr 为内联字符串，e 为错误值，都直接使用文本
+                    if (attr == "s") type = cell_type::shared;
+                    else if (attr == "b") type = cell_type::boolean;
                 }
-                else {
-                    // failed parser
+                // add empty cell
+                if (scanner.attribute("r", attr)) {
+                    const int colv = cell_coord_to_uint32(attr);
+                    while ((colv - col) > 0) {
+                        lua_pushlstring(L, "", 0);                      // ws row ""
+                        lua_rawseti(L, -2, col);                        // ws row
+                        col++;
+                    }
                 }
+                value.clear();
+                in_cell = true;
             }
-            else {
-                // failed read file
+            else if (name == "rPh" && in_cell) {
+                in_rph++;
+            }
+            else if ((name == "v" || name == "t") && in_cell && in_rph == 0) {
+                if (name == "v") {
+                    value.clear(); // 以最后一个 v 为准
+                }
+                in_value = true;
             }
         }
-        
-        // make worksheet square
-        for (auto& ws : wb)
-        {
-            size_t length = 0;
-            for (auto& r : ws.second)
-            {
-                length = std::max(length, r.size());
+        else if (token == xml::scanner::token::end) {
+            const auto name = scanner.name();
+            if (name == "v" || name == "t") {
+                in_value = false;
             }
-            for (auto& r : ws.second)
-            {
-                while (r.size() < length) {
-                    r.emplace_back("");
+            else if (name == "rPh" && in_cell) {
+                in_rph--;
+            }
+            else if (name == "c" && in_cell) {
+                // save cell
+                if (type == cell_type::shared) {
+                    const auto s = value.empty() ? std::string_view() : wb.shared_string(value);
+                    lua_pushlstring(L, s.data(), s.size());             // ws row cell
+                }
+                else if (type == cell_type::boolean) {
+                    if (value == "1") {
+                        lua_pushlstring(L, "true", 4);                  // ws row cell
+                    }
+                    else {
+                        lua_pushlstring(L, "false", 5);                 // ws row cell
+                    }
+                }
+                else {
+                    lua_pushlstring(L, value.data(), value.size());     // ws row cell
                 }
+                lua_rawseti(L, -2, col);                                // ws row
+                col++;
+                in_cell = false;
+            }
+            else if (name == "row" && in_row) {
+                // save row
+                width = col - 1;
+                max_width = std::max(max_width, width);
+                row_count++;
+                lua_rawseti(L, ws, row_count);                          // ws
+                in_row = false;
+            }
+            else if (name == "sheetData") {
+                break;
             }
         }
-        
-        // ok
-        return true;
-    }
-    
-    bool read(const std::vector<uint8_t>& data, workbook& wb)
-    {
-        return read(data.data(), data.size(), wb);
+        else if (in_value) {
+            xml::append_text(value, scanner.text(), scanner.is_cdata());
+        }
     }
-};
-
-void idle() {}
 
-int main()
-{
-    std::setlocale(LC_ALL, "zh_CN.UTF-8");
-    
-    std::vector<uint8_t> buffer;
-    if (slow::readfile("txwk/test.xlsx", buffer))
-    {
-        xlsx::workbook wb;
-        if (xlsx::read(buffer, wb))
-        {
-            idle();
+    // make worksheet square
+    for (int i = 1; i <= row_count; i++) {
+        lua_rawgeti(L, ws, i);                                          // ws row
+        for (int j = (int)lua_objlen(L, -1) + 1; j <= max_width; j++) {
+            lua_pushlstring(L, "", 0);                                  // ws row ""
+            lua_rawseti(L, -2, j);                                      // ws row
         }
+        lua_pop(L, 1);                                                  // ws
     }
-    
-    return 0;
+    return true;
+}
+
+static xlsx::workbook* xlsx_open_workbook(lua_State* L) {
+    size_t size = 0;
+    const char* source = luaL_checklstring(L, 1, &size);
+    auto* self = (xlsx::workbook*)lua_newuserdata(L, sizeof(xlsx::workbook)); // ... wb
+    new(self) xlsx::workbook();
+    luaL_getmetatable(L, WORKBOOK_NAME);                                // ... wb mt
+    lua_setmetatable(L, -2);                                            // ... wb
+    if (!self->open((const uint8_t*)source, (uint32_t)size)) {
+        lua_pop(L, 1);                                                  // ...
+        return nullptr;
+    }
+    return self;
 }
 
+// xlsx.decode(source [, sheet | { sheet... }]) -> { [name] = { { cell... }... } }
+// 不指定工作表时解析全部工作表
 static int xlsx_decode(lua_State* L) {
-    const char* source = luaL_checkstring(L, 1);
-    uint32_t size = lua_objlen(L, 1);
-    xlsx::workbook wb;
-    if (xlsx::read((const uint8_t*)source, size, wb)) {
-        lua_createtable(L, 0, (int)wb.size());                  // wb
-        for (auto& item : wb) {
-            lua_pushstring(L, item.first.c_str());              // wb name
-            lua_createtable(L, (int)item.second.size(), 0);     // wb name ws
-            int row_index = 1, col_index = 1;
-            for (auto& r : item.second) {
-                lua_pushinteger(L, row_index);                  // wb name ws ri row
-                lua_createtable(L, (int)r.size(), 0);           // wb name ws ri row
-                col_index = 1;
-                for (auto& cell : r) {
-                    lua_pushinteger(L, col_index);              // wb name ws ri row ci
-                    lua_pushstring(L, cell.c_str());            // wb name ws ri row ci cell
-                    lua_settable(L, -3);                        // wb name ws ri row
-                    col_index++;
+    auto* wb = xlsx_open_workbook(L);                                   // ... wbud
+    if (wb == nullptr) {
+        return 0;
+    }
+    const int filter = lua_isnoneornil(L, 2) ? 0 : 2;
+    if (filter != 0 && !lua_isstring(L, filter)) {
+        luaL_checktype(L, filter, LUA_TTABLE);
+    }
+    lua_createtable(L, 0, (int)wb->sheets().size());                    // ... wbud wb
+    for (auto& item : wb->sheets()) {
+        if (filter != 0) {
+            bool selected = false;
+            if (lua_isstring(L, filter)) {
+                size_t len = 0;
+                const char* name = lua_tolstring(L, filter, &len);
+                selected = (item.first == std::string_view(name, len));
+            }
+            else {
+                const int count = (int)lua_objlen(L, filter);
+                for (int i = 1; i <= count && !selected; i++) {
+                    lua_rawgeti(L, filter, i);                          // ... wbud wb name
+                    size_t len = 0;
+                    const char* name = lua_tolstring(L, -1, &len);
+                    selected = (name != nullptr) && (item.first == std::string_view(name, len));
+                    lua_pop(L, 1);                                      // ... wbud wb
                 }
-                lua_settable(L, -3);                            // wb name ws
-                row_index++;
             }
-            lua_settable(L, -3);                                // wb
+            if (!selected) {
+                continue;
+            }
+        }
+        lua_pushlstring(L, item.first.data(), item.first.size());       // ... wbud wb name
+        if (xlsx_push_sheet(L, *wb, item.second)) {                     // ... wbud wb name ws
+            lua_rawset(L, -3);                                          // ... wbud wb
+        }
+        else {
+            lua_pop(L, 1);                                              // ... wbud wb
         }
-        return 1;
     }
-    else {
+    return 1;
+}
+
+// xlsx.open(source) -> workbook
+static int xlsx_open(lua_State* L) {
+    if (xlsx_open_workbook(L) == nullptr) {
         return 0;
     }
+    return 1;
+}
+
+// workbook:names() -> { name... }
+static int xlsx_workbook_names(lua_State* L) {
+    auto* self = (xlsx::workbook*)luaL_checkudata(L, 1, WORKBOOK_NAME);
+    lua_createtable(L, (int)self->sheets().size(), 0);                  // t
+    int index = 1;
+    for (auto& item : self->sheets()) {
+        lua_pushlstring(L, item.first.data(), item.first.size());       // t name
+        lua_rawseti(L, -2, index);                                      // t
+        index++;
+    }
+    return 1;
+}
+
+// workbook:sheet(name) -> { { cell... }... }
+static int xlsx_workbook_sheet(lua_State* L) {
+    auto* self = (xlsx::workbook*)luaL_checkudata(L, 1, WORKBOOK_NAME);
+    size_t len = 0;
+    const char* name = luaL_checklstring(L, 2, &len);
+    const std::string* path = self->find(std::string_view(name, len));
+    if (path == nullptr || !xlsx_push_sheet(L, *self, *path)) {
+        return 0;
+    }
+    return 1;
+}
+
+static int xlsx_workbook_gc(lua_State* L) {
+    auto* self = (xlsx::workbook*)luaL_checkudata(L, 1, WORKBOOK_NAME);
+    self->~workbook();
+    return 0;
 }
 
 static const luaL_Reg lib[] = {
     { "decode", xlsx_decode },
+    { "open", xlsx_open },
     { nullptr, nullptr },
 };
 
+static void xlsx_register_workbook(lua_State* L) {
+    const luaL_Reg methods[] = {
+        { "names", xlsx_workbook_names },
+        { "sheet", xlsx_workbook_sheet },
+        { nullptr, nullptr },
+    };
+    luaL_newmetatable(L, WORKBOOK_NAME);                                // ... mt
+    lua_pushcfunction(L, &xlsx_workbook_gc);                            // ... mt gc
+    lua_setfield(L, -2, "__gc");                                        // ... mt
+    lua_createtable(L, 0, 2);                                           // ... mt methods
+    luaL_register(L, nullptr, methods);                                 // ... mt methods
+    lua_setfield(L, -2, "__index");                                     // ... mt
+    lua_pop(L, 1);                                                      // ...
+}
+
 int lua_xlsx_open(lua_State* L)
 {
+    xlsx_register_workbook(L);
     luaL_register(L, "xlsx", lib);
     return 1;
 }
 
 #ifdef BUILD_LUA_DLL_LIB
 extern "C" __declspec(dllexport) int luaopen_xlsx(lua_State* L) {
+    xlsx_register_workbook(L);
     lua_newtable(L);
     luaL_register(L, nullptr, lib);
     return 1;
@@ -43,6 +43,78 @@ namespace lua {
 		int const N{};
 	};
 
+	// Caches a named metatable for hot userdata type checks.
+	// luaL_checkudata looks the metatable up by name in the registry on every call;
+	// this keeps a registry integer ref for pushing and the table address for comparing.
+	// Call create or bind whenever the type is registered into a (new) lua_State.
+	// Only one lua_State is supported at a time: the cache follows the most recent bind,
+	// and the ref taken in a previous lua_State is dropped together with that state.
+	class cached_metatable_t {
+	public:
+		constexpr explicit cached_metatable_t(std::string_view const name) : m_name(name) {}
+
+		// same as luaL_newmetatable, leaves the metatable on the stack
+		bool create(lua_State* const L) {
+			bool const result = luaL_newmetatable(L, m_name.data());
+			bind_top(L);
+			return result;
+		}
+
+		// for metatables created elsewhere by name
+		void bind(lua_State* const L) {
+			luaL_getmetatable(L, m_name.data());
+			bind_top(L);
+			lua_pop(L, 1);
+		}
+
+		void push(lua_State* const L) const { lua_rawgeti(L, LUA_REGISTRYINDEX, m_ref); }
+
+		// set the metatable of the value at index
+		void apply(lua_State* const L, int const index) const {
+			push(L);
+			lua_setmetatable(L, index < 0 && index > LUA_REGISTRYINDEX ? index - 1 : index);
+		}
+
+		[[nodiscard]] bool is(lua_State* const L, int const index) const {
+			if (lua_type(L, index) != LUA_TUSERDATA || !lua_getmetatable(L, index)) {
+				return false;
+			}
+			bool const result = lua_topointer(L, -1) == m_pointer;
+			lua_pop(L, 1);
+			return result;
+		}
+
+		// same as luaL_checkudata, falls back to it for the error message
+		[[nodiscard]] void* check(lua_State* const L, int const index) const {
+			if (is(L, index)) {
+				return lua_touserdata(L, index);
+			}
+			return luaL_checkudata(L, index, m_name.data());
+		}
+
+		template<typename T>
+		[[nodiscard]] T* check(lua_State* const L, int const index) const { return static_cast<T*>(check(L, index)); }
+
+		[[nodiscard]] std::string_view name() const noexcept { return m_name; }
+
+	private:
+		void bind_top(lua_State* const L) {
+			// rebinding in the same lua_State must not leak the previous registry slot
+			if (m_ref != LUA_NOREF && m_state == L) {
+				luaL_unref(L, LUA_REGISTRYINDEX, m_ref);
+			}
+			m_state = L;
+			m_pointer = lua_topointer(L, -1);
+			lua_pushvalue(L, -1);
+			m_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+		}
+
+		std::string_view m_name;
+		lua_State* m_state{};
+		void const* m_pointer{};
+		int m_ref{ LUA_NOREF };
+	};
+
 	struct stack_t {
 		lua_State* L{};
 
@@ -1,14 +1,16 @@
 #include "utf8.hpp"
 #include <cassert>
 #include <windows.h>
+#include "simdutf.h"
 
 namespace utf8 {
 	static_assert(CHAR_BIT == 8);
-	std::string to_string(std::wstring_view const& str) {
+	static_assert(sizeof(wchar_t) == sizeof(char16_t));
+
+	// invalid input falls back to the Win32 API, which substitutes U+FFFD
+
+	static std::string to_string_win32(std::wstring_view const& str) {
 		std::string buffer;
-		if (str.empty()) {
-			return buffer;
-		}
 		int const length = WideCharToMultiByte(
 			CP_UTF8, 0,
 			str.data(), static_cast<int>(str.size()),
@@ -30,11 +32,8 @@ namespace utf8 {
 		}
 		return buffer;
 	}
-	std::wstring to_wstring(std::string_view const& str) {
+	static std::wstring to_wstring_win32(std::string_view const& str) {
 		std::wstring buffer;
-		if (str.empty()) {
-			return buffer;
-		}
 		int const length = MultiByteToWideChar(
 			CP_UTF8, 0,
 			str.data(), static_cast<int>(str.length()),
@@ -54,4 +53,34 @@ namespace utf8 {
 		}
 		return buffer;
 	}
+
+	std::string to_string(std::wstring_view const& str) {
+		if (str.empty()) {
+			return {};
+		}
+		auto const source = reinterpret_cast<char16_t const*>(str.data());
+		if (!simdutf::validate_utf16le(source, str.size())) {
+			return to_string_win32(str);
+		}
+		std::string buffer;
+		buffer.resize(simdutf::utf8_length_from_utf16le(source, str.size()));
+		size_t const result = simdutf::convert_valid_utf16le_to_utf8(source, str.size(), buffer.data());
+		assert(result == buffer.size());
+		buffer.resize(result);
+		return buffer;
+	}
+	std::wstring to_wstring(std::string_view const& str) {
+		if (str.empty()) {
+			return {};
+		}
+		if (!simdutf::validate_utf8(str.data(), str.size())) {
+			return to_wstring_win32(str);
+		}
+		std::wstring buffer;
+		buffer.resize(simdutf::utf16_length_from_utf8(str.data(), str.size()));
+		size_t const result = simdutf::convert_valid_utf8_to_utf16le(str.data(), str.size(), reinterpret_cast<char16_t*>(buffer.data()));
+		assert(result == buffer.size());
+		buffer.resize(result);
+		return buffer;
+	}
 }